@@ -3,7 +3,13 @@
 #include "nanocv/measure.hpp"
 #include "nanocv/tabulator.h"
 #include "nanocv/math/conv2d.hpp"
+#include "nanocv/math/winograd.hpp"
+#include "nanocv/math/conv2d_fft.hpp"
+#include "nanocv/nanocv.h"
+#include "nanocv/math/random.hpp"
 #include <iostream>
+#include <algorithm>
+#include <limits>
 
 using namespace ncv;
 
@@ -16,13 +22,23 @@ template
         typename tmatrix,
         typename tscalar = typename tmatrix::Scalar
 >
-static void test_cpu(tabulator_t::row_t& row, top op, const tmatrix& idata, const tmatrix& kdata, tmatrix& odata)
+static size_t test_cpu(tabulator_t::row_t& row, top op, const tmatrix& idata, const tmatrix& kdata, tmatrix& odata)
 {
-        row << ncv::measure_robustly_usec([&] ()
+        const size_t usec = ncv::measure_robustly_usec([&] ()
         {
                 odata.setZero();
                 op(idata, kdata, odata);
         }, trials);
+
+        row << usec;
+        return usec;
+}
+
+// number of floating point operations of the direct method (one multiplication & one addition per kernel value)
+static size_t conv2d_flops(int isize, int ksize)
+{
+        const size_t osize = static_cast<size_t>(isize - ksize + 1);
+        return 2 * osize * osize * static_cast<size_t>(ksize * ksize);
 }
 
 void test_conv2d(tabulator_t::row_t& row, int isize, int ksize)
@@ -41,15 +57,97 @@ void test_conv2d(tabulator_t::row_t& row, int isize, int ksize)
         kdata /= ksize;
         odata /= osize;
 
-        test_cpu(row, ncv::math::conv2d_eig<matrix_t>, idata, kdata, odata);
-        test_cpu(row, ncv::math::conv2d_cpp<matrix_t>, idata, kdata, odata);
-        test_cpu(row, ncv::math::conv2d_dot<matrix_t>, idata, kdata, odata);
-        test_cpu(row, ncv::math::conv2d_mad<matrix_t>, idata, kdata, odata);
-        test_cpu(row, ncv::math::conv2d_dyn<matrix_t>, idata, kdata, odata);
+        // the fastest method
+        size_t usec = std::numeric_limits<size_t>::max();
+
+        usec = std::min(usec, test_cpu(row, ncv::math::conv2d_eig<matrix_t>, idata, kdata, odata));
+        usec = std::min(usec, test_cpu(row, ncv::math::conv2d_cpp<matrix_t>, idata, kdata, odata));
+        usec = std::min(usec, test_cpu(row, ncv::math::conv2d_dot<matrix_t>, idata, kdata, odata));
+        usec = std::min(usec, test_cpu(row, ncv::math::conv2d_mad<matrix_t>, idata, kdata, odata));
+        usec = std::min(usec, test_cpu(row, ncv::math::conv2d_dyn<matrix_t>, idata, kdata, odata));
+        usec = std::min(usec, test_cpu(row, ncv::math::conv2d_wino<matrix_t>, idata, kdata, odata));
+        usec = std::min(usec, test_cpu(row, ncv::math::conv2d_fft<matrix_t>, idata, kdata, odata));
+
+        // FFT with the kernel spectrum computed once (as done by the convolution layer)
+        typedef std::complex<scalar_t> complex_t;
+
+        const math::fft2d_t<scalar_t> plan(math::fft_size(isize), math::fft_size(isize));
+        std::vector<complex_t> fidata(plan.size()), fkdata(plan.size()), fodata(plan.size());
+        plan.forward(kdata, fkdata.data());
+
+        usec = std::min(usec, test_cpu(row, [&] (const matrix_t& idata, const matrix_t&, matrix_t& odata)
+        {
+                std::fill(fodata.begin(), fodata.end(), complex_t(0));
+                plan.forward(idata, fidata.data());
+                math::fft_madc<scalar_t>(fidata.data(), fkdata.data(), plan.size(), fodata.data());
+                plan.inverse(fodata.data(), odata);
+        }, idata, kdata, odata));
+
+        // NB: the effective throughput (the Winograd & the FFT methods perform fewer operations)
+        row << ncv::gflops(conv2d_flops(isize, ksize), usec);
+}
+
+template
+<
+        typename tscalar
+>
+static void test_precision(tabulator_t::row_t& row, int isize, int ksize)
+{
+        typedef typename tensor::matrix_types_t<tscalar>::tmatrix tmatrix;
+
+        const int osize = isize - ksize + 1;
+
+        tmatrix idata(isize, isize);
+        tmatrix kdata(ksize, ksize);
+        tmatrix odata(osize, osize);
+
+        idata.setRandom();
+        kdata.setRandom();
+        odata.setRandom();
+
+        test_cpu(row, ncv::math::conv2d_dot<tmatrix>, idata, kdata, odata);
+        test_cpu(row, ncv::math::conv2d_mad<tmatrix>, idata, kdata, odata);
+        test_cpu(row, ncv::math::conv2d_dyn<tmatrix>, idata, kdata, odata);
+}
+
+void test_layer(tabulator_t::row_t& row, int isize, int ksize, const strings_t& modes)
+{
+        const size_t idims = 4;
+        const size_t odims = 8;
+
+        tensor_t input(idims, isize, isize);
+        input.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+        size_t usec = std::numeric_limits<size_t>::max();
+
+        for (const string_t& mode : modes)
+        {
+                const string_t params =
+                        "dims=" + text::to_string(odims) +
+                        ",rows=" + text::to_string(ksize) +
+                        ",cols=" + text::to_string(ksize) +
+                        ",mode=" + mode;
+
+                const rlayer_t layer = ncv::get_layers().get("conv", params);
+                layer->resize(input);
+                layer->random_params(-1.0, +1.0);
+
+                const size_t musec = ncv::measure_robustly_usec([&] ()
+                {
+                        layer->output(input);
+                }, trials);
+
+                row << musec;
+                usec = std::min(usec, musec);
+        }
+
+        row << ncv::gflops(idims * odims * conv2d_flops(isize, ksize), usec);
 }
 
 int main(int, char* [])
 {
+        ncv::init();
+
         const int min_isize = 12;
         const int max_isize = 48;
         const int min_ksize = 3;
@@ -60,8 +158,10 @@ int main(int, char* [])
                         << "dot [us]"
                         << "mad [us]"
                         << "dyn [us]"
-                        << "toe [us]"
-                        << "toe (buff) [us]";
+                        << "wino [us]"
+                        << "fft [us]"
+                        << "fft (cached) [us]"
+                        << "best [GFLOP/s]";
 
         for (int isize = min_isize; isize <= max_isize; isize += 4)
         {
@@ -82,7 +182,67 @@ int main(int, char* [])
 
                 std::cout << std::endl;
         }
-                
+
+        // convolution layer (the input spectra are shared by all output planes & the kernel spectra are cached)
+        const strings_t modes = { "direct", "im2col", "fft" };
+
+        tabulator_t ltable("4->8 planes\\method");
+        for (const string_t& mode : modes)
+        {
+                ltable.header() << (mode + " [us]");
+        }
+        ltable.header() << "best [GFLOP/s]";
+
+        for (int isize = min_isize; isize <= max_isize; isize += 4)
+        {
+                ltable.clear();
+
+                for (int ksize = min_ksize; ksize <= isize - min_ksize; ksize += 2)
+                {
+                        const string_t header = "(" +
+                                text::to_string(isize) + "x" + text::to_string(isize) + "@" +
+                                text::to_string(ksize) + "x" + text::to_string(ksize) + ")";
+
+                        tabulator_t::row_t& row = ltable.append(header);
+
+                        test_layer(row, isize, ksize, modes);
+                }
+
+                ltable.print(std::cout);
+
+                std::cout << std::endl;
+        }
+
+        // single vs. double precision (the memory traffic is halved with single precision)
+        tabulator_t ptable("size\\precision");
+        ptable.header() << "dot (float) [us]"
+                        << "mad (float) [us]"
+                        << "dyn (float) [us]"
+                        << "dot (double) [us]"
+                        << "mad (double) [us]"
+                        << "dyn (double) [us]";
+
+        for (int isize = min_isize; isize <= max_isize; isize += 4)
+        {
+                ptable.clear();
+
+                for (int ksize = min_ksize; ksize <= isize - min_ksize; ksize += 2)
+                {
+                        const string_t header = "(" +
+                                text::to_string(isize) + "x" + text::to_string(isize) + "@" +
+                                text::to_string(ksize) + "x" + text::to_string(ksize) + ")";
+
+                        tabulator_t::row_t& row = ptable.append(header);
+
+                        test_precision<float>(row, isize, ksize);
+                        test_precision<double>(row, isize, ksize);
+                }
+
+                ptable.print(std::cout);
+
+                std::cout << std::endl;
+        }
+
 	return EXIT_SUCCESS;
 }
 
@@ -2,8 +2,11 @@
 #include "nanocv/tabulator.h"
 #include "nanocv/measure.hpp"
 #include "nanocv/math/dot.hpp"
+#include "nanocv/math/simd.h"
 #include "nanocv/tensor/dot.hpp"
 #include <iostream>
+#include <algorithm>
+#include <limits>
 
 using namespace ncv;
 
@@ -13,15 +16,36 @@ template
         typename tvector,
         typename tscalar = typename tvector::Scalar
 >
-static void test_dot(tabulator_t::row_t& row, top op, const tvector& vec1, const tvector& vec2)
+static size_t test_dot(tabulator_t::row_t& row, top op, const tvector& vec1, const tvector& vec2)
 {
         const size_t trials = 16;
 
-        row << ncv::measure_robustly_usec([&] ()
+        const size_t usec = ncv::measure_robustly_usec([&] ()
         {
                 const volatile tscalar ret = op(vec1.data(), vec2.data(), vec1.size());
                 ret;
         }, trials);
+
+        // NB: one multiplication & one addition per element
+        row << ncv::gflops(2 * static_cast<size_t>(vec1.size()), usec);
+        return usec;
+}
+
+template
+<
+        typename tvector,
+        typename tscalar = typename tvector::Scalar
+>
+static size_t test_dot_simd(tabulator_t::row_t& row, math::simd_isa isa, const tvector& vec1, const tvector& vec2)
+{
+        // NB: the unsupported instruction sets would (misleadingly) time the plain C++ fallback
+        if (!math::simd_supported(isa))
+        {
+                row << "n/a";
+                return std::numeric_limits<size_t>::max();
+        }
+
+        return test_dot(row, ncv::math::simd_dot<tscalar>(isa), vec1, vec2);
 }
 
 static void test_dot(size_t size, tabulator_t::row_t& row)
@@ -30,15 +54,24 @@ static void test_dot(size_t size, tabulator_t::row_t& row)
         vec1.setRandom();
         vec2.setRandom();
 
-        test_dot(row, ncv::math::dot<scalar_t>, vec1, vec2);
-        test_dot(row, ncv::math::dot_unroll<scalar_t, 2>, vec1, vec2);
-        test_dot(row, ncv::math::dot_unroll<scalar_t, 3>, vec1, vec2);
-        test_dot(row, ncv::math::dot_unroll<scalar_t, 4>, vec1, vec2);
-        test_dot(row, ncv::math::dot_unroll<scalar_t, 5>, vec1, vec2);
-        test_dot(row, ncv::math::dot_unroll<scalar_t, 6>, vec1, vec2);
-        test_dot(row, ncv::math::dot_unroll<scalar_t, 7>, vec1, vec2);
-        test_dot(row, ncv::math::dot_unroll<scalar_t, 8>, vec1, vec2);
-        test_dot(row, ncv::tensor::dot<scalar_t>, vec1, vec2);
+        // the fastest method
+        size_t usec = std::numeric_limits<size_t>::max();
+
+        usec = std::min(usec, test_dot(row, ncv::math::dot<scalar_t>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_unroll<scalar_t, 2>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_unroll<scalar_t, 3>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_unroll<scalar_t, 4>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_unroll<scalar_t, 5>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_unroll<scalar_t, 6>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_unroll<scalar_t, 7>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_unroll<scalar_t, 8>, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::tensor::dot<scalar_t>, vec1, vec2));
+        usec = std::min(usec, test_dot_simd(row, math::simd_isa::sse2, vec1, vec2));
+        usec = std::min(usec, test_dot_simd(row, math::simd_isa::avx2, vec1, vec2));
+        usec = std::min(usec, test_dot_simd(row, math::simd_isa::avx512, vec1, vec2));
+        usec = std::min(usec, test_dot(row, ncv::math::dot_simd<scalar_t>, vec1, vec2));
+
+        row << ncv::gflops(2 * size, usec);
 }
 
 int main(int, char* [])
@@ -48,15 +81,20 @@ int main(int, char* [])
 
         tabulator_t table("size\\dot");
 
-        table.header() << "dot [us]"
-                       << "dotul2 [us]"
-                       << "dotul3 [us]"
-                       << "dotul4 [us]"
-                       << "dotul5 [us]"
-                       << "dotul6 [us]"
-                       << "dotul7 [us]"
-                       << "dotul8 [us]"
-                       << "doteig [us]";
+        table.header() << "dot [GFLOP/s]"
+                       << "dotul2 [GFLOP/s]"
+                       << "dotul3 [GFLOP/s]"
+                       << "dotul4 [GFLOP/s]"
+                       << "dotul5 [GFLOP/s]"
+                       << "dotul6 [GFLOP/s]"
+                       << "dotul7 [GFLOP/s]"
+                       << "dotul8 [GFLOP/s]"
+                       << "doteig [GFLOP/s]"
+                       << "dotsse2 [GFLOP/s]"
+                       << "dotavx2 [GFLOP/s]"
+                       << "dotavx512 [GFLOP/s]"
+                       << "dotsimd [GFLOP/s]"
+                       << "best [GFLOP/s]";
 
         for (size_t size = min_size; size <= max_size; size *= 2)
         {
@@ -67,6 +105,8 @@ int main(int, char* [])
 
         table.print(std::cout);
 
+        std::cout << "SIMD: " << text::to_string(math::simd_best()) << " (n/a: instruction set not supported by the CPU)" << std::endl;
+
 	return EXIT_SUCCESS;
 }
 
@@ -2,8 +2,11 @@
 #include "nanocv/tabulator.h"
 #include "nanocv/measure.hpp"
 #include "nanocv/math/mad.hpp"
+#include "nanocv/math/simd.h"
 #include "nanocv/tensor/mad.hpp"
 #include <iostream>
+#include <algorithm>
+#include <limits>
 
 using namespace ncv;
 
@@ -13,17 +16,38 @@ template
         typename tvector,
         typename tscalar = typename tvector::Scalar
 >
-static void test_mad(tabulator_t::row_t& row, top op, const tvector& vec1, const tvector& vec2, tscalar wei)
+static size_t test_mad(tabulator_t::row_t& row, top op, const tvector& vec1, const tvector& vec2, tscalar wei)
 {
         vector_t cvec1 = vec1;
         vector_t cvec2 = vec2;
 
         const size_t trials = 16;
 
-        row << ncv::measure_robustly_usec([&] ()
+        const size_t usec = ncv::measure_robustly_usec([&] ()
         {
                 op(cvec1.data(), wei, cvec1.size(), cvec2.data());
         }, trials);
+
+        // NB: one multiplication & one addition per element
+        row << ncv::gflops(2 * static_cast<size_t>(vec1.size()), usec);
+        return usec;
+}
+
+template
+<
+        typename tvector,
+        typename tscalar = typename tvector::Scalar
+>
+static size_t test_mad_simd(tabulator_t::row_t& row, math::simd_isa isa, const tvector& vec1, const tvector& vec2, tscalar wei)
+{
+        // NB: the unsupported instruction sets would (misleadingly) time the plain C++ fallback
+        if (!math::simd_supported(isa))
+        {
+                row << "n/a";
+                return std::numeric_limits<size_t>::max();
+        }
+
+        return test_mad(row, ncv::math::simd_mad<tscalar>(isa), vec1, vec2, wei);
 }
 
 static void test_mad(size_t size, tabulator_t::row_t& row)
@@ -32,17 +56,26 @@ static void test_mad(size_t size, tabulator_t::row_t& row)
         vec1.setRandom();
         vec2.setRandom();
 
+        // the fastest method
+        size_t usec = std::numeric_limits<size_t>::max();
+
         scalar_t wei = vec1(0) + vec2(3);
 
-        test_mad(row, ncv::math::mad<scalar_t>, vec1, vec2, wei);
-        test_mad(row, ncv::math::mad_unroll<scalar_t, 2>, vec1, vec2, wei);
-        test_mad(row, ncv::math::mad_unroll<scalar_t, 3>, vec1, vec2, wei);
-        test_mad(row, ncv::math::mad_unroll<scalar_t, 4>, vec1, vec2, wei);
-        test_mad(row, ncv::math::mad_unroll<scalar_t, 5>, vec1, vec2, wei);
-        test_mad(row, ncv::math::mad_unroll<scalar_t, 6>, vec1, vec2, wei);
-        test_mad(row, ncv::math::mad_unroll<scalar_t, 7>, vec1, vec2, wei);
-        test_mad(row, ncv::math::mad_unroll<scalar_t, 8>, vec1, vec2, wei);
-        test_mad(row, ncv::tensor::mad<scalar_t>, vec1, vec2, wei);
+        usec = std::min(usec, test_mad(row, ncv::math::mad<scalar_t>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_unroll<scalar_t, 2>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_unroll<scalar_t, 3>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_unroll<scalar_t, 4>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_unroll<scalar_t, 5>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_unroll<scalar_t, 6>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_unroll<scalar_t, 7>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_unroll<scalar_t, 8>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::tensor::mad<scalar_t>, vec1, vec2, wei));
+        usec = std::min(usec, test_mad_simd(row, math::simd_isa::sse2, vec1, vec2, wei));
+        usec = std::min(usec, test_mad_simd(row, math::simd_isa::avx2, vec1, vec2, wei));
+        usec = std::min(usec, test_mad_simd(row, math::simd_isa::avx512, vec1, vec2, wei));
+        usec = std::min(usec, test_mad(row, ncv::math::mad_simd<scalar_t>, vec1, vec2, wei));
+
+        row << ncv::gflops(2 * size, usec);
 }
 
 int main(int, char* [])
@@ -52,15 +85,20 @@ int main(int, char* [])
 
         tabulator_t table("size\\mad");
 
-        table.header() << "mad [us]"
-                       << "madul2 [us]"
-                       << "madul3 [us]"
-                       << "madul4 [us]"
-                       << "madul5 [us]"
-                       << "madul6 [us]"
-                       << "madul7 [us]"
-                       << "madul8 [us]"
-                       << "madeig [us]";
+        table.header() << "mad [GFLOP/s]"
+                       << "madul2 [GFLOP/s]"
+                       << "madul3 [GFLOP/s]"
+                       << "madul4 [GFLOP/s]"
+                       << "madul5 [GFLOP/s]"
+                       << "madul6 [GFLOP/s]"
+                       << "madul7 [GFLOP/s]"
+                       << "madul8 [GFLOP/s]"
+                       << "madeig [GFLOP/s]"
+                       << "madsse2 [GFLOP/s]"
+                       << "madavx2 [GFLOP/s]"
+                       << "madavx512 [GFLOP/s]"
+                       << "madsimd [GFLOP/s]"
+                       << "best [GFLOP/s]";
 
         for (size_t size = min_size; size <= max_size; size *= 2)
         {
@@ -71,6 +109,8 @@ int main(int, char* [])
 
         table.print(std::cout);
 
+        std::cout << "SIMD: " << text::to_string(math::simd_best()) << " (n/a: instruction set not supported by the CPU)" << std::endl;
+
 	return EXIT_SUCCESS;
 }
 
@@ -43,7 +43,7 @@ int main(int, char* [])
         const size_t minsize = 1024;
         const size_t maxsize = 1024 * 1024;
 
-        thread_pool_t pool;
+        thread_pool_t& pool = ncv::get_thread_pool();
 
         // try various data sizes
         for (size_t size = minsize; size <= maxsize; size *= 2)
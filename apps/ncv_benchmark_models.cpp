@@ -4,6 +4,7 @@
 #include "nanocv/measure.hpp"
 #include "nanocv/accumulator.h"
 #include "nanocv/math/random.hpp"
+#include "nanocv/thread/pool.h"
 #include "nanocv/thread/thread.h"
 #include "nanocv/tasks/task_synthetic_shapes.h"
 #include <boost/program_options.hpp>
@@ -49,6 +50,16 @@ int main(int argc, char *argv[])
                 "evaluate the \'forward\' pass (output)");
         po_desc.add_options()("backward",
                 "evaluate the \'backward' pass (gradient)");
+        po_desc.add_options()("mixed",
+                "evaluate the \'forward\' and the \'backward\' passes concurrently (mixed workload)");
+        po_desc.add_options()("latency",
+                "evaluate the latency of the \'forward\' pass for a single sample split between threads");
+        po_desc.add_options()("schedule",
+                boost::program_options::value<string_t>()->default_value("fixed"),
+                "how to split the samples between threads: fixed, dynamic or guided");
+        po_desc.add_options()("chunk",
+                boost::program_options::value<size_t>()->default_value(0),
+                "chunk size hint for the dynamic or guided scheduling (0 = automatic)");
 
         boost::program_options::variables_map po_vm;
         boost::program_options::store(
@@ -67,8 +78,12 @@ int main(int argc, char *argv[])
         const size_t cmd_samples = math::clamp(po_vm["samples"].as<size_t>(), 1000, 100 * 1000);
         const bool cmd_forward = po_vm.count("forward");
         const bool cmd_backward = po_vm.count("backward");
+        const bool cmd_mixed = po_vm.count("mixed");
+        const bool cmd_latency = po_vm.count("latency");
+        const thread_schedule cmd_schedule = text::from_string<thread_schedule>(po_vm["schedule"].as<string_t>());
+        const size_t cmd_chunk = po_vm["chunk"].as<size_t>();
 
-        if (!cmd_forward && !cmd_backward)
+        if (!cmd_forward && !cmd_backward && !cmd_mixed && !cmd_latency)
         {
                 std::cout << po_desc;
                 return EXIT_FAILURE;
@@ -104,6 +119,21 @@ int main(int argc, char *argv[])
         cmodel = cmodel + "conv:dims=32,rows=5,cols=5;pool-max;act-snorm;";
         cmodel = cmodel + "conv:dims=64,rows=3,cols=3;act-snorm;";
 
+        string_t cmodel_im2col;
+        cmodel_im2col = cmodel_im2col + "conv:dims=16,rows=9,cols=9,mode=im2col;pool-max;act-snorm;";
+        cmodel_im2col = cmodel_im2col + "conv:dims=32,rows=5,cols=5,mode=im2col;pool-max;act-snorm;";
+        cmodel_im2col = cmodel_im2col + "conv:dims=64,rows=3,cols=3,mode=im2col;act-snorm;";
+
+        string_t cmodel_winograd;
+        cmodel_winograd = cmodel_winograd + "conv:dims=16,rows=9,cols=9,mode=winograd;pool-max;act-snorm;";
+        cmodel_winograd = cmodel_winograd + "conv:dims=32,rows=5,cols=5,mode=winograd;pool-max;act-snorm;";
+        cmodel_winograd = cmodel_winograd + "conv:dims=64,rows=3,cols=3,mode=winograd;act-snorm;";
+
+        string_t cmodel_blocked;
+        cmodel_blocked = cmodel_blocked + "conv:dims=16,rows=9,cols=9,mode=blocked;pool-max;act-snorm;";
+        cmodel_blocked = cmodel_blocked + "conv:dims=32,rows=5,cols=5,mode=blocked;pool-max;act-snorm;";
+        cmodel_blocked = cmodel_blocked + "conv:dims=64,rows=3,cols=3,mode=blocked;act-snorm;";
+
         const string_t outlayer = "linear:dims=" + text::to_string(cmd_outputs) + ";";
 
         strings_t cmd_networks =
@@ -115,7 +145,10 @@ int main(int argc, char *argv[])
                 lmodel4 + outlayer,
                 lmodel5 + outlayer,
 
-                cmodel + outlayer
+                cmodel + outlayer,
+                cmodel_im2col + outlayer,
+                cmodel_winograd + outlayer,
+                cmodel_blocked + outlayer
         };
 
         strings_t cmd_names =
@@ -127,12 +160,20 @@ int main(int argc, char *argv[])
                 "lmodel4",
                 "lmodel5",
 
-                "cmodel"
+                "cmodel",
+                "cmodel-im2col",
+                "cmodel-winograd",
+                "cmodel-blocked"
         };
 
         const rloss_t loss = ncv::get_losses().get("logistic");
         assert(loss);
 
+        // NB: the scalar type is selected at build time (e.g. NANOCV_WITH_FLOAT), so run the benchmark
+        //      with different builds to compare the throughput of the single & double precision models
+        log_info() << "<<< scalar = " << (8 * sizeof(scalar_t)) << " bits, accumulation = "
+                   << (8 * sizeof(acc_scalar_t)) << " bits.";
+
         // construct tables to compare models
         tabulator_t ftable_rand("model-forward (rand)\\threads");
         tabulator_t ftable_task("model-forward (task)\\threads");
@@ -140,6 +181,10 @@ int main(int argc, char *argv[])
         tabulator_t btable_rand("model-backward (rand)\\threads");
         tabulator_t btable_task("model-backward (task)\\threads");
 
+        tabulator_t mtable_task("model-mixed (task)\\threads");
+
+        tabulator_t ltable_rand("model-latency (rand)\\threads");
+
         for (size_t nthreads = cmd_min_nthreads; nthreads <= cmd_max_nthreads; nthreads ++)
         {
                 ftable_rand.header() << (text::to_string(nthreads) + "xCPU [ms]");
@@ -147,6 +192,10 @@ int main(int argc, char *argv[])
 
                 btable_rand.header() << (text::to_string(nthreads) + "xCPU [ms]");
                 btable_task.header() << (text::to_string(nthreads) + "xCPU [ms]");
+
+                mtable_task.header() << (text::to_string(nthreads) + "xCPU [ms]");
+
+                ltable_rand.header() << (text::to_string(nthreads) + "xCPU [us]");
         }
 
         // evaluate models
@@ -161,6 +210,10 @@ int main(int argc, char *argv[])
                 tabulator_t::row_t& brow_rand = btable_rand.append(cmd_name + "(rand)");
                 tabulator_t::row_t& brow_task = btable_task.append(cmd_name + "(task)");
 
+                tabulator_t::row_t& mrow_task = mtable_task.append(cmd_name + "(task)");
+
+                tabulator_t::row_t& lrow_rand = ltable_rand.append(cmd_name + "(rand)");
+
                 log_info() << "<<< running network [" << cmd_network << "] ...";
 
                 // create feed-forward network
@@ -182,6 +235,7 @@ int main(int argc, char *argv[])
                         if (cmd_forward)
                         {
                                 accumulator_t ldata(*model, nthreads, "l2n-reg", criterion_t::type::value, 0.1);
+                                ldata.set_schedule(cmd_schedule, cmd_chunk);
 
                                 const auto milis_rand = ncv::measure_robustly_usec([&] ()
                                 {
@@ -205,6 +259,7 @@ int main(int argc, char *argv[])
                         if (cmd_backward)
                         {
                                 accumulator_t gdata(*model, nthreads, "l2n-reg", criterion_t::type::vgrad, 0.1);
+                                gdata.set_schedule(cmd_schedule, cmd_chunk);
 
                                 const auto milis_rand = ncv::measure_robustly_usec([&] ()
                                 {
@@ -222,6 +277,54 @@ int main(int argc, char *argv[])
                                 brow_rand << milis_rand;
                                 brow_task << milis_task;
                         }
+
+                        if (cmd_mixed)
+                        {
+                                accumulator_t ldata(*model, nthreads, "l2n-reg", criterion_t::type::value, 0.1);
+                                accumulator_t gdata(*model, nthreads, "l2n-reg", criterion_t::type::vgrad, 0.1);
+                                ldata.set_schedule(cmd_schedule, cmd_chunk);
+                                gdata.set_schedule(cmd_schedule, cmd_chunk);
+
+                                // NB: the (cheaper) value and the (costlier) gradient evaluations share the thread pool
+                                thread_pool_t& pool = ncv::get_thread_pool();
+
+                                const auto milis_task = ncv::measure_robustly_usec([&] ()
+                                {
+                                        ldata.reset();
+                                        gdata.reset();
+
+                                        pool.enqueue([&] () { ldata.update(task, samples, *loss); });
+                                        pool.enqueue([&] () { gdata.update(task, samples, *loss); });
+                                        pool.wait();
+                                }, 1) / 1000;
+
+                                log_info() << "<<< processed [" << ldata.count() << "+" << gdata.count()
+                                           << "] mixed samples in " << milis_task << " ms.";
+
+                                mrow_task << milis_task;
+                        }
+
+                        if (cmd_latency)
+                        {
+                                // NB: one sample at a time, each layer splitting its work between threads
+                                const rmodel_t lmodel = model->clone();
+                                lmodel->set_threads(nthreads);
+
+                                const size_t count = std::min(inputs.size(), size_t(100));
+
+                                const auto usecs = ncv::measure_robustly_usec([&] ()
+                                {
+                                        for (size_t i = 0; i < count; i ++)
+                                        {
+                                                lmodel->output(inputs[i]);
+                                        }
+                                }, 1) / count;
+
+                                log_info() << "<<< processed [" << count
+                                           << "] single samples in " << usecs << " us/sample.";
+
+                                lrow_rand << usecs;
+                        }
                 }
 
                 log_info();
@@ -239,6 +342,16 @@ int main(int argc, char *argv[])
                 btable_rand.print(std::cout);
                 btable_task.print(std::cout);
         }
+        log_info();
+        if (cmd_mixed)
+        {
+                mtable_task.print(std::cout);
+        }
+        log_info();
+        if (cmd_latency)
+        {
+                ltable_rand.print(std::cout);
+        }
 
         // OK
         log_info() << done;
@@ -34,12 +34,12 @@ const size_t trials = 1024;
 
 struct optimizer_stat_t
 {
-        stats_t<scalar_t>       m_time;
-        stats_t<scalar_t>       m_crits;
-        stats_t<scalar_t>       m_fails;
-        stats_t<scalar_t>       m_iters;
-        stats_t<scalar_t>       m_fvals;
-        stats_t<scalar_t>       m_grads;
+        stats_t<opt_scalar_t>   m_time;
+        stats_t<opt_scalar_t>   m_crits;
+        stats_t<opt_scalar_t>   m_fails;
+        stats_t<opt_scalar_t>   m_iters;
+        stats_t<opt_scalar_t>   m_fvals;
+        stats_t<opt_scalar_t>   m_grads;
 };
 
 std::map<string_t, optimizer_stat_t> optimizer_stats;
@@ -47,20 +47,20 @@ std::map<string_t, optimizer_stat_t> optimizer_stats;
 static void check_problem(
         const string_t& problem_name,
         const opt_opsize_t& fn_size, const opt_opfval_t& fn_fval, const opt_opgrad_t& fn_grad,
-        const std::vector<std::pair<vector_t, scalar_t>>&)
+        const std::vector<std::pair<opt_vector_t, opt_scalar_t>>&)
 {
         const size_t iterations = 1024;
-        const scalar_t epsilon = 1e-6;
+        const opt_scalar_t epsilon = 1e-6;
 
         const size_t dims = fn_size();
 
         // generate fixed random trials
-        vectors_t x0s;
+        std::vector<opt_vector_t> x0s;
         for (size_t t = 0; t < trials; t ++)
         {
-                random_t<scalar_t> rgen(-1.0, +1.0);
+                random_t<opt_scalar_t> rgen(-1.0, +1.0);
 
-                vector_t x0(dims);
+                opt_vector_t x0(dims);
                 rgen(x0.data(), x0.data() + x0.size());
 
                 x0s.push_back(x0);
@@ -107,27 +107,27 @@ static void check_problem(
                        << "#fvals"
                        << "#grads";
 
-        thread_pool_t pool;
+        thread_pool_t& pool = ncv::get_thread_pool();
         thread_pool_t::mutex_t mutex;
 
         for (optim::batch_optimizer optimizer : optimizers)
                 for (optim::ls_initializer ls_initializer : ls_initializers)
                         for (optim::ls_strategy ls_strategy : ls_strategies)
         {
-                stats_t<scalar_t> times;
-                stats_t<scalar_t> crits;
-                stats_t<scalar_t> fails;
-                stats_t<scalar_t> iters;
-                stats_t<scalar_t> fvals;
-                stats_t<scalar_t> grads;
+                stats_t<opt_scalar_t> times;
+                stats_t<opt_scalar_t> crits;
+                stats_t<opt_scalar_t> fails;
+                stats_t<opt_scalar_t> iters;
+                stats_t<opt_scalar_t> fvals;
+                stats_t<opt_scalar_t> grads;
 
                 thread_loopi(trials, pool, [&] (size_t t)
                 {
-                        const vector_t& x0 = x0s[t];
+                        const opt_vector_t& x0 = x0s[t];
 
                         // check gradients
                         const opt_problem_t problem(fn_size, fn_fval, fn_grad);
-                        if (problem.grad_accuracy(x0) > math::epsilon2<scalar_t>())
+                        if (problem.grad_accuracy(x0) > math::epsilon2<opt_scalar_t>())
                         {
                                 const thread_pool_t::lock_t lock(mutex);
 
@@ -141,7 +141,7 @@ static void check_problem(
                                 fn_size, fn_fval, fn_grad, nullptr, nullptr, nullptr,
                                 x0, optimizer, iterations, epsilon, ls_initializer, ls_strategy);
 
-                        const scalar_t crit = state.convergence_criteria();
+                        const opt_scalar_t crit = state.convergence_criteria();
 
                         // update stats
                         const thread_pool_t::lock_t lock(mutex);
@@ -80,11 +80,9 @@ int main(int argc, char *argv[])
                 // process the samples
                 for (size_t nthreads = cmd_min_nthreads; nthreads <= cmd_max_nthreads; nthreads ++)
                 {
-                        ncv::thread_pool_t pool(nthreads);
-
                         const auto micros = ncv::measure_robustly_usec([&]
                         {
-                                ncv::thread_loopi(samples.size(), pool, [&] (size_t i)
+                                ncv::thread_loopi(samples.size(), nthreads, [&] (size_t i)
                                 {
                                         const sample_t& sample = samples[i];
                                         const image_t& image = task.image(sample.m_index);
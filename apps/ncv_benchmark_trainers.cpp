@@ -6,6 +6,7 @@
 #include "nanocv/trainers/batch.h"
 #include "nanocv/trainers/minibatch.h"
 #include "nanocv/trainers/stochastic.h"
+#include "nanocv/trainers/stochastic_async.h"
 #include "nanocv/tasks/task_synthetic_shapes.h"
 
 using namespace ncv;
@@ -22,7 +23,7 @@ template
 <
         typename ttrainer
 >
-static void test_optimizer(model_t& model, ttrainer trainer, const string_t& name, tabulator_t& table)
+static void test_optimizer(model_t& model, ttrainer trainer, const string_t& name, size_t samples, tabulator_t& table)
 {
         const size_t cmd_trials = 1;//6;
 
@@ -30,6 +31,7 @@ static void test_optimizer(model_t& model, ttrainer trainer, const string_t& nam
         stats_t<scalar_t> vvalues;
         stats_t<scalar_t> terrors;
         stats_t<scalar_t> verrors;
+        stats_t<scalar_t> oepochs;
 
         log_info() << "<<< running " << name << " ...";
 
@@ -46,6 +48,8 @@ static void test_optimizer(model_t& model, ttrainer trainer, const string_t& nam
                 terrors(state.m_terror_avg);
                 verrors(state.m_verror_avg);
 
+                oepochs(static_cast<scalar_t>(result.optimum_epoch()));
+
                 log_info() << "<<< --- optimum config = {" << text::concatenate(result.optimum_config())
                            << "}, optimum epoch = " << result.optimum_epoch()
                            << ", error " << state.m_terror_avg << "/" << state.m_verror_avg << ".";
@@ -54,7 +58,9 @@ static void test_optimizer(model_t& model, ttrainer trainer, const string_t& nam
         table.append(name)
                 << stats_to_string(tvalues) << stats_to_string(terrors)
                 << stats_to_string(vvalues) << stats_to_string(verrors)
-                << (usec / 1000);
+                << stats_to_string(oepochs)
+                << (usec / 1000)
+                << static_cast<size_t>(1e+6 * samples / std::max(usec, size_t(1)));
 }
 
 static void test_optimizers(
@@ -63,7 +69,8 @@ static void test_optimizers(
 {
         const size_t cmd_iterations = 32;
 //        const size_t cmd_minibatch_epochs = cmd_iterations;
-//        const size_t cmd_stochastic_epochs = cmd_iterations;
+        const size_t cmd_stochastic_epochs = 8;
+        const size_t cmd_stochastic_batch = 16;
         const scalar_t cmd_epsilon = 1e-4;
 
         const size_t n_threads = ncv::n_threads();
@@ -98,6 +105,10 @@ static void test_optimizers(
 
         const string_t basename = "[" + text::to_string(criterion) + "] ";
 
+        // NB: the throughput is the number of training samples (x #epochs) per second, including the tuning
+        const size_t batch_samples = cmd_iterations * tsampler.size();
+        const size_t stoch_samples = cmd_stochastic_epochs * tsampler.size();
+
         // run optimizers and collect results
         for (optim::batch_optimizer optimizer : batch_optimizers)
         {
@@ -106,7 +117,7 @@ static void test_optimizers(
                         return ncv::batch_train(
                                 model, task, tsampler, vsampler, n_threads,
                                 loss, criterion, optimizer, cmd_iterations, cmd_epsilon, verbose);
-                }, basename + "batch-" + text::to_string(optimizer), table);
+                }, basename + "batch-" + text::to_string(optimizer), batch_samples, table);
         }
 
 //        for (optim::batch_optimizer optimizer : minibatch_optimizers)
@@ -119,6 +130,21 @@ static void test_optimizers(
 //                }, basename + "minibatch-" + text::to_string(optimizer), table);
 //        }
 
+        // synchronous vs. asynchronous (Hogwild) stochastic gradient descent
+        test_optimizer(model, [&] ()
+        {
+                return ncv::stochastic_train(
+                        model, task, tsampler, vsampler, n_threads,
+                        loss, criterion, optim::stoch_optimizer::SG, cmd_stochastic_epochs, false, 1, verbose);
+        }, basename + "stochastic-" + text::to_string(optim::stoch_optimizer::SG), stoch_samples, table);
+
+        test_optimizer(model, [&] ()
+        {
+                return ncv::stochastic_async_train(
+                        model, task, tsampler, vsampler, n_threads,
+                        loss, criterion, cmd_stochastic_epochs, cmd_stochastic_batch, verbose);
+        }, basename + "stochastic-async", stoch_samples, table);
+
 //        for (optim::stoch_optimizer optimizer : stoch_optimizers)
 //        {
 //                test_optimizer(model, [&] ()
@@ -195,7 +221,8 @@ int main(int, char* [])
                         assert(loss);
 
                         tabulator_t table("optimizer\\");
-                        table.header() << "train loss" << "train error" << "valid loss" << "valid error" << "time [msec]";
+                        table.header() << "train loss" << "train error" << "valid loss" << "valid error"
+                                       << "optimum epoch" << "time [msec]" << "samples/sec";
 
                         // vary the criteria
                         for (const string_t& cmd_criterion : cmd_criteria)
@@ -1,5 +1,6 @@
 #include "nanocv/nanocv.h"
 #include "nanocv/measure.hpp"
+#include "nanocv/thread/pool.h"
 #include <boost/program_options.hpp>
 
 int main(int argc, char *argv[])
@@ -59,11 +60,18 @@ int main(int argc, char *argv[])
         const rtask_t rtask = ncv::get_tasks().get(cmd_task, cmd_task_params);
 
         // load task data
+        const ncv::timer_t timer;
         ncv::measure_critical_and_log(
                 [&] () { return rtask->load(cmd_task_dir); },
                 "loaded task",
                 "failed to load task from directory <" + cmd_task_dir + ">");
 
+        // report the loading throughput (e.g. to check the parallel decoding)
+        const size_t load_usec = std::max(timer.microseconds(), size_t(1));
+        ncv::log_info() << "loaded " << rtask->n_images() << " images & " << rtask->samples().size()
+                        << " samples using " << ncv::get_thread_pool().n_workers() << " threads ("
+                        << (1e+6 * rtask->n_images() / load_usec) << " images/s).";
+
         // describe task
         rtask->describe();
 
@@ -1,9 +1,36 @@
-#include <thread>
+#include "nanocv/thread/thread.h"
+#include <set>
+#include <cstring>
 #include <iostream>
 
-int main(int, char* [])
+int main(int argc, char* argv[])
 {	
         std::cout << std::thread::hardware_concurrency() << std::endl;
+
+        // optionally describe the detected topology (e.g. to choose a pinning policy)
+        if (argc > 1 && (!std::strcmp(argv[1], "--topology") || !std::strcmp(argv[1], "-t")))
+        {
+                const ncv::cpus_t cpus = ncv::cpu_topology();
+
+                std::set<std::size_t> nodes, packages;
+                std::set<std::pair<std::size_t, std::size_t>> cores;
+                for (const ncv::cpu_t& cpu : cpus)
+                {
+                        std::cout << "cpu " << cpu.m_cpu
+                                  << ": core " << cpu.m_core
+                                  << ", package " << cpu.m_package
+                                  << ", node " << cpu.m_node << std::endl;
+
+                        nodes.insert(cpu.m_node);
+                        packages.insert(cpu.m_package);
+                        cores.emplace(cpu.m_package, cpu.m_core);
+                }
+
+                std::cout << "nodes: " << nodes.size()
+                          << ", packages: " << packages.size()
+                          << ", cores: " << cores.size()
+                          << ", logical CPUs: " << cpus.size() << std::endl;
+        }
+
 	return EXIT_SUCCESS;
 }
-
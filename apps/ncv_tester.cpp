@@ -37,6 +37,9 @@ int main(int argc, char *argv[])
         po_desc.add_options()("model-file",
                 boost::program_options::value<string_t>(),
                 "filepath to load the model from");
+        po_desc.add_options()("threads",
+                boost::program_options::value<size_t>()->default_value(1),
+                "number of threads to compute the output of each test image (1 - sequential, 0 - all available)");
         po_desc.add_options()("save-dir",
                 boost::program_options::value<string_t>(),
                 "directory to save classification results to");
@@ -72,6 +75,7 @@ int main(int argc, char *argv[])
         const string_t cmd_loss = po_vm["loss"].as<string_t>();
         const string_t cmd_model = po_vm["model"].as<string_t>();
         const string_t cmd_input = po_vm["model-file"].as<string_t>();
+        const size_t cmd_threads = po_vm["threads"].as<size_t>();
         const string_t cmd_save_dir = po_vm.count("save-dir") ? po_vm["save-dir"].as<string_t>() : "";
         const size_t cmd_save_group_rows = math::clamp(po_vm["save-group-rows"].as<size_t>(), 1, 128);
         const size_t cmd_save_group_cols = math::clamp(po_vm["save-group-cols"].as<size_t>(), 1, 128);
@@ -127,6 +131,9 @@ int main(int argc, char *argv[])
                 samples_t ok_samples;
                 samples_t nk_samples;
 
+                // NB: one image at a time, so the work of each layer is split between threads (if requested)
+                rmodel->set_threads(cmd_threads);
+
                 for (size_t s = 0; s < samples.size(); s ++)
                 {
                         const sample_t& sample = samples[s];
@@ -145,6 +152,8 @@ int main(int argc, char *argv[])
                         (ok ? ok_samples : nk_samples).push_back(sample);
                 }
 
+                rmodel->set_threads(1);
+
                 log_info() << "miss-classified " << nk_samples.size() << "/" << (samples.size()) 
                            << " = " << ((0.0 + nk_samples.size()) / (0.0 + samples.size())) << ".";
 
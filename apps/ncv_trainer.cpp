@@ -1,6 +1,9 @@
 #include "nanocv/nanocv.h"
 #include "nanocv/tester.h"
 #include "nanocv/measure.hpp"
+#include "nanocv/thread/pool.h"
+#include "nanocv/thread/process_group.h"
+#include "nanocv/text/from_string.hpp"
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
@@ -52,6 +55,13 @@ int main(int argc, char *argv[])
         po_desc.add_options()("task-params",
                 boost::program_options::value<string_t>()->default_value(""),
                 "task parameters (if any)");
+        po_desc.add_options()("cache-size",
+                boost::program_options::value<size_t>()->default_value(0),
+                "memory budget (in MB) to cache the input tensors of the samples (0 - disabled)");
+        po_desc.add_options()("cache-type",
+                boost::program_options::value<string_t>()->default_value("scalar"),
+                "storage of the cached input tensors: scalar (exact), uint8 (exact, the smallest, scaled when read), "
+                "float (lossy: rounded to float, so the results differ from the uncached ones if the scalar is wider)");
         po_desc.add_options()("loss",
                 boost::program_options::value<string_t>(),
                 describe(loss_ids).c_str());
@@ -71,8 +81,13 @@ int main(int argc, char *argv[])
                 boost::program_options::value<string_t>(),
                 describe(criterion_ids, criterion_descriptions).c_str());
         po_desc.add_options()("threads",
-                boost::program_options::value<size_t>()->default_value(0),
-                "number of threads to use (0 - all available)");
+                boost::program_options::value<string_t>()->default_value("0"),
+                "number of threads to use per process (0 - all available, shared between the processes), "\
+                "optionally followed by a pinning policy: "\
+                "<threads>[:compact|:scatter|:<cpu list, e.g. 0,2,4-7>] (split between the processes)");
+        po_desc.add_options()("processes",
+                boost::program_options::value<size_t>()->default_value(1),
+                "number of local processes to train with (data-parallel: each evaluates a shard of the samples)");
         po_desc.add_options()("trials",
                 boost::program_options::value<size_t>(),
                 "number of models to train & evaluate");
@@ -104,15 +119,66 @@ int main(int argc, char *argv[])
         const string_t cmd_task = po_vm["task"].as<string_t>();
         const string_t cmd_task_dir = po_vm["task-dir"].as<string_t>();
         const string_t cmd_task_params = po_vm["task-params"].as<string_t>();
+        const size_t cmd_cache_size = po_vm["cache-size"].as<size_t>();
+        const string_t cmd_cache_type = po_vm["cache-type"].as<string_t>();
         const string_t cmd_loss = po_vm["loss"].as<string_t>();
         const string_t cmd_model = po_vm["model"].as<string_t>();
         const string_t cmd_model_params = po_vm["model-params"].as<string_t>();
         const string_t cmd_trainer = po_vm["trainer"].as<string_t>();
         const string_t cmd_trainer_params = po_vm["trainer-params"].as<string_t>();
         const string_t cmd_criterion = po_vm["criterion"].as<string_t>();
-        const size_t cmd_threads = po_vm["threads"].as<size_t>();
+        const strings_t cmd_threads_tokens = text::split(po_vm["threads"].as<string_t>(), ":");
+        const size_t cmd_threads = text::from_string<size_t>(cmd_threads_tokens[0]);
+        const string_t cmd_affinity = cmd_threads_tokens.size() > 1 ? cmd_threads_tokens[1] : string_t();
         const size_t cmd_trials = po_vm["trials"].as<size_t>();
         const string_t cmd_output = po_vm["output"].as<string_t>();
+        const size_t cmd_processes = po_vm["processes"].as<size_t>();
+
+        // start the data-parallel processes (if requested)
+        // NB: before starting any thread, as only the calling thread is duplicated
+        process_group_t& group = ncv::get_process_group();
+        if (cmd_processes > 1 && !group.spawn(cmd_processes))
+        {
+                log_error() << "failed to start <" << cmd_processes << "> processes!";
+                return EXIT_FAILURE;
+        }
+
+        // NB: only the root process logs & saves the results (the others follow the same steps),
+        //      but the warnings & the errors of all processes are logged (tagged with their rank)
+        if (!group.root())
+        {
+                ncv::set_log_quiet("rank " + text::to_string(group.rank()));
+        }
+
+        // NB: the processes share the cores, so each uses (by default) an equal part of them
+        const size_t nthreads = (cmd_threads == 0) ?
+                std::max(size_t(1), ncv::n_threads() / group.size()) : cmd_threads;
+
+        // NB: ... and starts only as many worker threads (not just uses them)
+        if (group.size() > 1 && !ncv::set_thread_pool_size(nthreads))
+        {
+                log_warning() << "the thread pool is already started, the processes may oversubscribe the cores!";
+        }
+
+        // pin the worker threads (if requested)
+        // NB: each process uses a disjoint slice of the logical CPUs
+        if (!cmd_affinity.empty())
+        {
+                std::vector<size_t> cpus = ncv::affinity_cpus(cmd_affinity);
+                if (group.size() > 1 && !cpus.empty())
+                {
+                        const size_t begin = group.rank() * cpus.size() / group.size();
+                        const size_t end = (group.rank() + 1) * cpus.size() / group.size();
+                        cpus = (begin < end) ?
+                                std::vector<size_t>(cpus.begin() + begin, cpus.begin() + end) :
+                                std::vector<size_t>(1, cpus[group.rank() % cpus.size()]);
+                }
+
+                if (!ncv::get_thread_pool().pin(cpus))
+                {
+                        log_warning() << "failed to pin the worker threads using the policy <" << cmd_affinity << ">!";
+                }
+        }
 
         // create task
         const rtask_t rtask = ncv::get_tasks().get(cmd_task, cmd_task_params);
@@ -126,6 +192,9 @@ int main(int argc, char *argv[])
         // describe task
         rtask->describe();
 
+        // cache the input tensors (if requested)
+        rtask->set_tensor_cache(cmd_cache_size * 1024 * 1024, text::from_string<tensor_cache_type>(cmd_cache_type));
+
         // create loss
         const rloss_t rloss = ncv::get_losses().get(cmd_loss);
 
@@ -151,7 +220,7 @@ int main(int argc, char *argv[])
                         ncv::measure_critical_and_log(
                                 [&] ()
                                 {
-                                        result = rtrainer->train(*rtask, train_fold, *rloss, cmd_threads, cmd_criterion, *rmodel);
+                                        result = rtrainer->train(*rtask, train_fold, *rloss, nthreads, cmd_criterion, *rmodel);
                                         return result.valid();
                                 },
                                 "model trained",
@@ -178,8 +247,15 @@ int main(int argc, char *argv[])
         log_info() << ">>> performance: loss error = " << estats.avg() << " +/- " << estats.stdev()
                    << " in [" << estats.min() << ", " << estats.max() << "].";
 
+        if (rtask->tensor_cache())
+        {
+                const tensor_cache_t& tcache = *rtask->tensor_cache();
+                log_info() << ">>> tensor cache: " << tcache.count() << " tensors (" << (tcache.size() / 1024 / 1024)
+                           << "MB), hits = " << tcache.hits() << ", misses = " << tcache.misses() << ".";
+        }
+
         // save the best model & optimization history (if any trained)
-        if (!models.empty() && !cmd_output.empty())
+        if (group.root() && !models.empty() && !cmd_output.empty())
         {
                 const rmodel_t& opt_model = std::get<0>(models.begin()->second);
                 const trainer_states_t& opt_states = std::get<1>(models.begin()->second);
@@ -198,6 +274,13 @@ int main(int argc, char *argv[])
                         "failed to save state to <" + path + ">");
         }
 
+        // wait for the other processes (if any)
+        if (!group.join())
+        {
+                log_error() << "some of the data-parallel processes have failed!";
+                return EXIT_FAILURE;
+        }
+
         // OK
         log_info() << done;
         return EXIT_SUCCESS;
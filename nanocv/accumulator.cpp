@@ -1,7 +1,13 @@
 #include "accumulator.h"
 #include "criterion.h"
+#include "thread/loopi.hpp"
 #include "thread/loopit.hpp"
+#include "thread/process_group.h"
+#include "logger.h"
 #include <cassert>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
 
 namespace ncv
 {
@@ -10,30 +16,41 @@ namespace ncv
                 // constructor
                 impl_t(const model_t& model, size_t nthreads, const string_t& criterion_name,
                                 criterion_t::type type, scalar_t lambda)
-                        :       m_pool(nthreads),
+                        :       m_nthreads(ncv::get_thread_pool().concurrency(nthreads)),
+                                m_schedule(thread_schedule::fixed),
+                                m_chunk(0),
                                 m_cache(ncv::get_criteria().get(criterion_name))
                 {
                         m_cache->reset(model);
                         m_cache->reset(lambda);
                         m_cache->reset(type);
 
-                        if (m_pool.n_workers() > 1)
+                        if (m_nthreads > 1)
                         {
-                                for (size_t i = 0; i < m_pool.n_workers(); i ++)
+                                // NB: each cache (model clone & buffers) is created by the thread that will use it,
+                                //      so that its memory is first-touched on the thread's NUMA node (if pinned)
+                                m_caches.resize(m_nthreads);
+                                m_chunks.resize(m_nthreads);
+                                thread_loopi(m_nthreads, ncv::get_thread_pool(), m_nthreads, [&] (size_t i)
                                 {
                                         const rcriterion_t cache = ncv::get_criteria().get(criterion_name);
                                         cache->reset(model);
                                         cache->reset(lambda);
                                         cache->reset(type);
-                                        m_caches.push_back(cache);
-                                }
+                                        m_caches[i] = cache;
+                                });
                         }
                 }
                 
                 // attributes
-                thread_pool_t                   m_pool;         ///< thread pool
+                size_t                          m_nthreads;     ///< maximum number of threads to use
+                thread_schedule                 m_schedule;     ///< how to split the samples between threads
+                size_t                          m_chunk;        ///< chunk size hint (if dynamic or guided)
                 rcriterion_t                    m_cache;        ///< global (cumulated) criterion
                 std::vector<rcriterion_t>       m_caches;       ///< cached criterion / thread
+
+                // partial statistics per chunk (first sample, statistics) / thread (dynamic & guided schedules)
+                std::vector<std::vector<std::pair<size_t, acc_scalars_t>>>      m_chunks;
         };        
 
         accumulator_t::accumulator_t(const model_t& model, size_t nthreads,
@@ -68,6 +85,12 @@ namespace ncv
                 }
         }
 
+        void accumulator_t::set_schedule(thread_schedule schedule, size_t chunk)
+        {
+                m_impl->m_schedule = schedule;
+                m_impl->m_chunk = chunk;
+        }
+
         void accumulator_t::update(const task_t& task, const sample_t& sample, const loss_t& loss)
         {
                 m_impl->m_cache->update(task, sample, loss);
@@ -83,78 +106,185 @@ namespace ncv
                 m_impl->m_cache->update(input, target, loss);
         }
 
-        void accumulator_t::update(const task_t& task, const samples_t& samples, const loss_t& loss)
+        template
+        <
+                typename toperator
+        >
+        void accumulator_t::update(size_t count, const toperator& op)
         {
-                if (m_impl->m_pool.n_workers() == 1)
+                // NB: each process evaluates a contiguous shard of the samples (if data-parallel)
+                const process_group_t& group = ncv::get_process_group();
+                const size_t begin = count * group.rank() / group.size();
+                const size_t end = count * (group.rank() + 1) / group.size();
+
+                const acc_scalars_t stats0 = (group.size() > 1) ? m_impl->m_cache->save_stats() : acc_scalars_t();
+
+                if (m_impl->m_nthreads == 1)
                 {
-                        for (size_t i = 0; i < samples.size(); i ++)
+                        op(*m_impl->m_cache, begin, end);
+                }
+
+                else if (m_impl->m_schedule == thread_schedule::fixed)
+                {
+                        // NB: the i-th thread always processes the i-th contiguous range of samples
+                        thread_loopr(end - begin, ncv::get_thread_pool(), m_impl->m_nthreads,
+                                m_impl->m_schedule, m_impl->m_chunk, [&] (size_t tbegin, size_t tend, size_t th)
                         {
-                                update(task, samples[i], loss);
-                        }
+                                op(*m_impl->m_caches[th], begin + tbegin, begin + tend);
+                        });
+
+                        sumup();
                 }
 
                 else
                 {
-                        thread_loopit(samples.size(), m_impl->m_pool, [&] (size_t i, size_t th)
+                        // NB: the chunks are assigned to threads depending on timing (dynamic & guided schedules),
+                        //      so the statistics of each chunk are stored apart to be reduced in the chunk order.
+                        // NB: each chunk stores statistics of the size of the gradient, so the chunks are not too small.
+                        const size_t max_chunks = 64 * m_impl->m_nthreads;
+                        const size_t chunk = std::max(m_impl->m_chunk, (end - begin + max_chunks - 1) / max_chunks);
+
+                        thread_loopr(end - begin, ncv::get_thread_pool(), m_impl->m_nthreads,
+                                m_impl->m_schedule, chunk, [&] (size_t tbegin, size_t tend, size_t th)
                         {
-                                m_impl->m_caches[th]->update(task, samples[i], loss);
+                                criterion_t& cache = *m_impl->m_caches[th];
+                                op(cache, begin + tbegin, begin + tend);
+
+                                m_impl->m_chunks[th].emplace_back(tbegin, cache.save_stats());
+                                cache.reset();
                         });
-                        
-                        sumup();
+
+                        sumup_chunks();
+                }
+
+                if (group.size() > 1)
+                {
+                        allreduce(stats0);
                 }
         }
 
+        void accumulator_t::update(const task_t& task, const samples_t& samples, const loss_t& loss)
+        {
+                update(samples.size(), [&] (criterion_t& cache, size_t begin, size_t end)
+                {
+                        cache.update(task, samples, begin, end, loss);
+                });
+        }
+
         void accumulator_t::update(const tensors_t& inputs, const vectors_t& targets, const loss_t& loss)
         {
-                if (m_impl->m_pool.n_workers() == 1)
+                update(inputs.size(), [&] (criterion_t& cache, size_t begin, size_t end)
                 {
-                        for (size_t i = 0; i < inputs.size(); i ++)
-                        {
-                                update(inputs[i], targets[i], loss);
-                        }
+                        cache.update(inputs, targets, begin, end, loss);
+                });
+        }
+
+        void accumulator_t::update(const vectors_t& inputs, const vectors_t& targets, const loss_t& loss)
+        {
+                update(inputs.size(), [&] (criterion_t& cache, size_t begin, size_t end)
+                {
+                        cache.update(inputs, targets, begin, end, loss);
+                });
+        }
+
+        void accumulator_t::allreduce(const acc_scalars_t& stats0)
+        {
+                // NB: the statistics cumulated before are the same in all processes, so only the update is summed
+                //      (but the minimum & the maximum error, which are combined with the maximum as they are)
+                acc_scalars_t stats = m_impl->m_cache->save_stats();
+                assert(stats.size() == stats0.size());
+
+                const size_t nmax = criterion_t::n_max_stats;
+                for (size_t i = nmax; i < stats.size(); i ++)
+                {
+                        stats[i] -= stats0[i];
                 }
 
-                else
+                process_group_t& group = ncv::get_process_group();
+                if (    !group.allreduce_max(stats.data(), nmax) ||
+                        !group.allreduce(stats.data() + nmax, stats.size() - nmax))
                 {
-                        thread_loopit(inputs.size(), m_impl->m_pool, [&] (size_t i, size_t th)
-                        {
-                                m_impl->m_caches[th]->update(inputs[i], targets[i], loss);
-                        });
-                        
-                        sumup();
+                        log_error() << "accumulator: failed to combine the statistics across processes!";
+                        throw std::runtime_error("accumulator: failed to combine the statistics across processes");
+                }
+
+                for (size_t i = nmax; i < stats.size(); i ++)
+                {
+                        stats[i] += stats0[i];
                 }
+
+                m_impl->m_cache->load_stats(stats);
         }
 
-        void accumulator_t::update(const vectors_t& inputs, const vectors_t& targets, const loss_t& loss)
+        void accumulator_t::sumup() const
         {
-                if (m_impl->m_pool.n_workers() == 1)
+                const std::vector<rcriterion_t>& caches = m_impl->m_caches;
+                const size_t size = caches.size();
+
+                // NB: pairwise tree reduction (the pairs of each level are summed in parallel)
+                //      with a fixed order of the caches, so that the result is deterministic.
+                // NB: the caches are emptied, so that the next update starts from scratch.
+                for (size_t stride = 1; stride < size; stride *= 2)
                 {
-                        for (size_t i = 0; i < inputs.size(); i ++)
+                        const size_t pairs = (size - stride + 2 * stride - 1) / (2 * stride);
+
+                        thread_loopi(pairs, ncv::get_thread_pool(), m_impl->m_nthreads, [&] (size_t p)
                         {
-                                update(inputs[i], targets[i], loss);
-                        }
+                                const size_t i = p * 2 * stride;
+
+                                (*caches[i]) += (*caches[i + stride]);
+                                caches[i + stride]->reset();
+                        });
                 }
 
-                else
+                if (size > 0)
+                {
+                        (*m_impl->m_cache) += (*caches[0]);
+                        caches[0]->reset();
+                }
+        }
+        
+        void accumulator_t::sumup_chunks()
+        {
+                std::vector<std::pair<size_t, acc_scalars_t>> chunks;
+                for (auto& tchunks : m_impl->m_chunks)
+                {
+                        std::move(tchunks.begin(), tchunks.end(), std::back_inserter(chunks));
+                        tchunks.clear();
+                }
+
+                // NB: the chunks are identified by their first sample, so they are sorted in the same order
+                //      whatever the thread that processed them.
+                std::sort(chunks.begin(), chunks.end(), [] (const auto& chunk1, const auto& chunk2)
                 {
-                        thread_loopit(inputs.size(), m_impl->m_pool, [&] (size_t i, size_t th)
+                        return chunk1.first < chunk2.first;
+                });
+
+                // NB: pairwise tree reduction of the chunks (as for the per-thread caches of the fixed schedule)
+                const size_t size = chunks.size();
+                for (size_t stride = 1; stride < size; stride *= 2)
+                {
+                        const size_t pairs = (size - stride + 2 * stride - 1) / (2 * stride);
+
+                        thread_loopi(pairs, ncv::get_thread_pool(), m_impl->m_nthreads, [&] (size_t p)
                         {
-                                m_impl->m_caches[th]->update(inputs[i], targets[i], loss);
-                        });
+                                const size_t i = p * 2 * stride;
 
-                        sumup();
+                                criterion_t::merge_stats(chunks[i].second, chunks[i + stride].second);
+                        });
                 }
-        }
 
-        void accumulator_t::sumup() const
-        {
-                for (const rcriterion_t& cache : m_impl->m_caches)
+                if (size > 0)
                 {
+                        const rcriterion_t& cache = m_impl->m_caches[0];
+
+                        cache->load_stats(chunks[0].second);
                         (*m_impl->m_cache) += (*cache);
+                        cache->reset();
                 }
         }
-        
-        scalar_t accumulator_t::value() const
+
+        acc_scalar_t accumulator_t::value() const
         {
                 return m_impl->m_cache->value();
         }
@@ -169,7 +299,17 @@ namespace ncv
                 return m_impl->m_cache->var_error();
         }
 
-        vector_t accumulator_t::vgrad() const
+        scalar_t accumulator_t::min_error() const
+        {
+                return m_impl->m_cache->min_error();
+        }
+
+        scalar_t accumulator_t::max_error() const
+        {
+                return m_impl->m_cache->max_error();
+        }
+
+        acc_vector_t accumulator_t::vgrad() const
         {
                 return m_impl->m_cache->vgrad();
         }
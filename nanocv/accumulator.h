@@ -1,6 +1,7 @@
 #pragma once
 
 #include "criterion.h"
+#include "thread/schedule.hpp"
 
 namespace ncv
 {
@@ -14,6 +15,9 @@ namespace ncv
                 ///
                 /// \brief constructor
                 ///
+                /// NB: the samples are processed using at most <nthreads> threads of the process-wide thread pool
+                ///     (0 = all available threads).
+                ///
                 accumulator_t(const model_t&, size_t nthreads, 
                               const string_t& criterion_name, criterion_t::type, scalar_t lambda = 0.0);
 
@@ -37,6 +41,18 @@ namespace ncv
                 ///
                 scalar_t set_lambda(scalar_t lambda);
 
+                ///
+                /// \brief change how the samples are split between threads
+                ///     (e.g. dynamic or guided if the cost per sample varies, see thread_loops)
+                ///
+                /// NB: the results are reduced in the order of the samples, so they are deterministic for a given
+                ///     schedule, even if the dynamic & guided schedules assign the samples to threads depending on timing
+                ///     (but the results of different schedules may differ in the last bits).
+                /// NB: the chunk size is raised for the dynamic & guided schedules if needed,
+                ///     so that at most 64 partial results are stored per thread.
+                ///
+                void set_schedule(thread_schedule schedule, size_t chunk = 0);
+
                 ///
                 /// \brief update statistics with a new sample
                 ///
@@ -47,6 +63,10 @@ namespace ncv
                 ///
                 /// \brief update statistics for a set of samples
                 ///
+                /// NB: if the process-wide group has multiple processes (see process_group_t),
+                ///     each process evaluates only its shard of the samples and the statistics are combined
+                ///     across processes, so that all processes obtain the same results (data-parallel).
+                ///
                 void update(const task_t& task, const samples_t& samples, const loss_t& loss);
                 void update(const tensors_t& inputs, const vectors_t& targets, const loss_t& loss);
                 void update(const vectors_t& inputs, const vectors_t& targets, const loss_t& loss);
@@ -54,12 +74,12 @@ namespace ncv
                 ///
                 /// \brief cumulated loss value
                 ///
-                scalar_t value() const;
+                acc_scalar_t value() const;
 
                 ///
                 /// \brief cumulated gradient
                 ///
-                vector_t vgrad() const;
+                acc_vector_t vgrad() const;
 
                 ///
                 /// \brief averaged error value
@@ -71,6 +91,12 @@ namespace ncv
                 ///
                 scalar_t var_error() const;
 
+                ///
+                /// \brief minimum & maximum error value
+                ///
+                scalar_t min_error() const;
+                scalar_t max_error() const;
+
                 ///
                 /// \brief total number of processed samples
                 ///
@@ -94,11 +120,31 @@ namespace ncv
 
         private:
 
+                ///
+                /// \brief update statistics for the current process' shard of the <count> samples,
+                ///     where op(criterion, begin, end) processes the [begin, end) range of samples
+                ///
+                template
+                <
+                        typename toperator
+                >
+                void update(size_t count, const toperator& op);
+
                 ///
                 /// \brief accumulate partial results
                 ///
                 void sumup() const;
 
+                ///
+                /// \brief accumulate the partial results stored per chunk (dynamic & guided schedules)
+                ///
+                void sumup_chunks();
+
+                ///
+                /// \brief combine the statistics cumulated since <stats0> across processes
+                ///
+                void allreduce(const acc_scalars_t& stats0);
+
         private:
 
                 // attributes
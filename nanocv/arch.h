@@ -35,6 +35,8 @@
 // fix "unused variable" warnings (only for release mode)
 #ifdef NANOCV_DEBUG
         #define NANOCV_UNUSED1_RELEASE(x)
+        #define NANOCV_UNUSED2_RELEASE(x, y)
 #else
         #define NANOCV_UNUSED1_RELEASE(x) NANOCV_UNUSED1(x)
+        #define NANOCV_UNUSED2_RELEASE(x, y) NANOCV_UNUSED2(x, y)
 #endif
@@ -1,5 +1,6 @@
 #include "avg_criterion.h"
 #include <cassert>
+#include <algorithm>
 
 namespace ncv
 {        
@@ -24,7 +25,13 @@ namespace ncv
         void avg_criterion_t::accumulate(const vector_t& vgrad, scalar_t value)
         {
                 m_value += value;
-                m_vgrad += vgrad;
+                m_vgrad += vgrad.cast<acc_scalar_t>();
+        }
+
+        void avg_criterion_t::accumulate(const vector_t& values, const matrix_t& vgrads)
+        {
+                m_value += values.cast<acc_scalar_t>().sum();
+                m_vgrad += gparam(vgrads).cast<acc_scalar_t>();
         }
 
         void avg_criterion_t::accumulate(const criterion_t& other)
@@ -36,14 +43,36 @@ namespace ncv
                 m_vgrad += vother->m_vgrad;
         }
         
-        scalar_t avg_criterion_t::value() const
+        void avg_criterion_t::save_state(acc_scalars_t& stats) const
+        {
+                stats.push_back(m_value);
+
+                // NB: the gradient is not cumulated when only evaluating the loss value
+                if (has_vgrad())
+                {
+                        stats.insert(stats.end(), m_vgrad.data(), m_vgrad.data() + m_vgrad.size());
+                }
+        }
+
+        void avg_criterion_t::load_state(const acc_scalars_t& stats, size_t& pos)
+        {
+                m_value = stats[pos ++];
+
+                if (has_vgrad())
+                {
+                        std::copy(stats.begin() + pos, stats.begin() + pos + m_vgrad.size(), m_vgrad.data());
+                        pos += m_vgrad.size();
+                }
+        }
+
+        acc_scalar_t avg_criterion_t::value() const
         {
                 assert(count() > 0);
 
                 return m_value / count();
         }
 
-        vector_t avg_criterion_t::vgrad() const
+        acc_vector_t avg_criterion_t::vgrad() const
         {
                 assert(count() > 0);
 
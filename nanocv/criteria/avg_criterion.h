@@ -26,12 +26,12 @@ namespace ncv
                 ///
                 /// \brief cumulated loss value
                 ///
-                virtual scalar_t value() const override;
+                virtual acc_scalar_t value() const override;
 
                 ///
                 /// \brief cumulated gradient
                 ///
-                virtual vector_t vgrad() const override;
+                virtual acc_vector_t vgrad() const override;
 
                 ///
                 /// \brief check if the criterion has a regularization term to tune
@@ -50,17 +50,24 @@ namespace ncv
                 ///
                 virtual void accumulate(scalar_t value) override;
                 virtual void accumulate(const vector_t& vgrad, scalar_t value) override;
+                virtual void accumulate(const vector_t& values, const matrix_t& vgrads) override;
 
                 ///
                 /// \brief update statistics with cumulated samples
                 ///
                 virtual void accumulate(const criterion_t& other) override;
 
+                ///
+                /// \brief save & load the cumulated statistics
+                ///
+                virtual void save_state(acc_scalars_t& stats) const override;
+                virtual void load_state(const acc_scalars_t& stats, size_t& pos) override;
+
         protected:
 
                 // attributes
-                scalar_t                m_value;        ///< cumulated loss value
-                vector_t                m_vgrad;        ///< cumulated gradient                
+                acc_scalar_t            m_value;        ///< cumulated loss value
+                acc_vector_t            m_vgrad;        ///< cumulated gradient                
         };
 }
 
@@ -22,21 +22,30 @@ namespace ncv
                 avg_criterion_t::accumulate(vgrad, value);
         }
 
+        void avg_l2_criterion_t::accumulate(const vector_t& values, const matrix_t& vgrads)
+        {
+                avg_criterion_t::accumulate(values, vgrads);
+        }
+
         void avg_l2_criterion_t::accumulate(const criterion_t& other)
         {
                 avg_criterion_t::accumulate(other);
         }
         
-        scalar_t avg_l2_criterion_t::value() const
+        acc_scalar_t avg_l2_criterion_t::value() const
         {
-                return  lweight() * (avg_criterion_t::value()) +
-                        rweight() * (0.5 * params().squaredNorm() / psize());
+                const acc_scalar_t lw = lweight(), rw = rweight();
+
+                return  lw * (avg_criterion_t::value()) +
+                        rw * (0.5 * params().cast<acc_scalar_t>().squaredNorm() / psize());
         }
 
-        vector_t avg_l2_criterion_t::vgrad() const
+        acc_vector_t avg_l2_criterion_t::vgrad() const
         {
-                return  lweight() * (avg_criterion_t::vgrad()) +
-                        rweight() * (params() / psize());
+                const acc_scalar_t lw = lweight(), rw = rweight();
+
+                return  lw * (avg_criterion_t::vgrad()) +
+                        rw * (params().cast<acc_scalar_t>() / psize());
         }
 
         bool avg_l2_criterion_t::can_regularize() const
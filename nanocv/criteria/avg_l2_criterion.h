@@ -21,12 +21,12 @@ namespace ncv
                 ///
                 /// \brief cumulated loss value
                 ///
-                virtual scalar_t value() const override;
+                virtual acc_scalar_t value() const override;
 
                 ///
                 /// \brief cumulated gradient
                 ///
-                virtual vector_t vgrad() const override;
+                virtual acc_vector_t vgrad() const override;
 
                 ///
                 /// \brief check if the criterion has a regularization term to tune
@@ -45,6 +45,7 @@ namespace ncv
                 ///
                 virtual void accumulate(scalar_t value) override;
                 virtual void accumulate(const vector_t& vgrad, scalar_t value) override;
+                virtual void accumulate(const vector_t& values, const matrix_t& vgrads) override;
 
                 ///
                 /// \brief update statistics with cumulated samples
@@ -1,5 +1,6 @@
 #include "avg_var_criterion.h"
 #include <cassert>
+#include <algorithm>
 
 namespace ncv
 {        
@@ -23,15 +24,25 @@ namespace ncv
         {
                 avg_criterion_t::accumulate(value);
                 
-                m_value2 += value * value;
+                m_value2 += acc_scalar_t(value) * value;
         }
 
         void avg_var_criterion_t::accumulate(const vector_t& vgrad, scalar_t value)
         {
                 avg_criterion_t::accumulate(vgrad, value);
 
-                m_value2 += value * value;
-                m_vgrad2 += value * vgrad;
+                m_value2 += acc_scalar_t(value) * value;
+                m_vgrad2 += acc_scalar_t(value) * vgrad.cast<acc_scalar_t>();
+        }
+
+        void avg_var_criterion_t::accumulate(const vector_t& values, const matrix_t& vgrads)
+        {
+                avg_criterion_t::accumulate(values, vgrads);
+
+                // NB: the gradient is linear in the loss gradients, so the weighted sum is computed in one pass
+                m_value2 += values.cast<acc_scalar_t>().squaredNorm();
+                m_wgrads.noalias() = values.asDiagonal() * vgrads;
+                m_vgrad2 += gparam(m_wgrads).cast<acc_scalar_t>();
         }
 
         void avg_var_criterion_t::accumulate(const criterion_t& other)
@@ -45,16 +56,45 @@ namespace ncv
                 m_vgrad2 += vother->m_vgrad2;
         }
         
-        scalar_t avg_var_criterion_t::value() const
+        void avg_var_criterion_t::save_state(acc_scalars_t& stats) const
+        {
+                avg_criterion_t::save_state(stats);
+
+                stats.push_back(m_value2);
+
+                if (has_vgrad())
+                {
+                        stats.insert(stats.end(), m_vgrad2.data(), m_vgrad2.data() + m_vgrad2.size());
+                }
+        }
+
+        void avg_var_criterion_t::load_state(const acc_scalars_t& stats, size_t& pos)
+        {
+                avg_criterion_t::load_state(stats, pos);
+
+                m_value2 = stats[pos ++];
+
+                if (has_vgrad())
+                {
+                        std::copy(stats.begin() + pos, stats.begin() + pos + m_vgrad2.size(), m_vgrad2.data());
+                        pos += m_vgrad2.size();
+                }
+        }
+
+        acc_scalar_t avg_var_criterion_t::value() const
         {
-                return  lweight() * (avg_criterion_t::value()) +
-                        rweight() * (count() * m_value2 - m_value * m_value) / (count() * count());
+                const acc_scalar_t lw = lweight(), rw = rweight(), n = count();
+
+                return  lw * (avg_criterion_t::value()) +
+                        rw * (n * m_value2 - m_value * m_value) / (n * n);
         }
 
-        vector_t avg_var_criterion_t::vgrad() const
+        acc_vector_t avg_var_criterion_t::vgrad() const
         {
-                return  lweight() * (avg_criterion_t::vgrad()) +
-                        rweight() * (2.0 * (count() * m_vgrad2 - m_value * m_vgrad) / (count() * count()));
+                const acc_scalar_t lw = lweight(), rw = rweight(), n = count();
+
+                return  lw * (avg_criterion_t::vgrad()) +
+                        rw * (2.0 * (n * m_vgrad2 - m_value * m_vgrad) / (n * n));
         }
 
         bool avg_var_criterion_t::can_regularize() const
@@ -2,9 +2,17 @@
 #include "task.h"
 #include "loss.h"
 #include <cassert>
+#include <algorithm>
 
 namespace ncv
 {        
+        namespace
+        {
+                // maximum number of samples processed with a single (batched) call to the model
+                //      (this bounds the memory used by the batch buffers of the layers)
+                const size_t max_batch_size = 64;
+        }
+
         criterion_manager_t& get_criteria()
         {
                 return criterion_manager_t::instance();
@@ -68,9 +76,12 @@ namespace ncv
         {
                 assert(sample.m_index < task.n_images());
                 
-                const image_t& image = task.image(sample.m_index);
-                const vector_t& target = sample.m_target;                
-                const vector_t& output = m_model->output(image, sample.m_region).vector();
+                // NB: reuse the input buffer & the tensor cache of the task (if enabled)
+                m_input.resize(m_model->idims(), m_model->irows(), m_model->icols());
+                task.load_input(sample.m_index, input_region(sample), m_input.data());
+
+                const vector_t& target = sample.m_target;
+                const vector_t& output = m_model->output(m_input).vector();
 
                 assert(static_cast<size_t>(output.size()) == m_model->osize());
                 assert(static_cast<size_t>(target.size()) == m_model->osize());
@@ -98,6 +109,129 @@ namespace ncv
                 accumulate(output, target, loss);
         }
 
+        void criterion_t::update(const task_t& task, const samples_t& samples, size_t begin, size_t end, const loss_t& loss)
+        {
+                assert(end <= samples.size());
+
+                while (begin < end)
+                {
+                        const size_t count = prepare(begin, end);
+                        for (size_t s = 0; s < count; s ++, begin ++)
+                        {
+                                const sample_t& sample = samples[begin];
+                                assert(sample.m_index < task.n_images());
+
+                                task.load_input(sample.m_index, input_region(sample), m_binputs.data() + s * m_model->isize());
+                                m_btargets.row(s) = sample.m_target.transpose();
+                        }
+
+                        accumulate(count, loss);
+                }
+        }
+
+        void criterion_t::update(const tensors_t& inputs, const vectors_t& targets, size_t begin, size_t end, const loss_t& loss)
+        {
+                assert(end <= inputs.size());
+                assert(end <= targets.size());
+
+                while (begin < end)
+                {
+                        const size_t count = prepare(begin, end);
+                        for (size_t s = 0; s < count; s ++, begin ++)
+                        {
+                                const tensor_t& input = inputs[begin];
+                                assert(input.size() == m_model->isize());
+
+                                m_binputs.vector().segment(s * input.size(), input.size()) = input.vector();
+                                m_btargets.row(s) = targets[begin].transpose();
+                        }
+
+                        accumulate(count, loss);
+                }
+        }
+
+        void criterion_t::update(const vectors_t& inputs, const vectors_t& targets, size_t begin, size_t end, const loss_t& loss)
+        {
+                assert(end <= inputs.size());
+                assert(end <= targets.size());
+
+                while (begin < end)
+                {
+                        const size_t count = prepare(begin, end);
+                        for (size_t s = 0; s < count; s ++, begin ++)
+                        {
+                                const vector_t& input = inputs[begin];
+                                assert(static_cast<size_t>(input.size()) == m_model->isize());
+
+                                m_binputs.vector().segment(s * input.size(), input.size()) = input;
+                                m_btargets.row(s) = targets[begin].transpose();
+                        }
+
+                        accumulate(count, loss);
+                }
+        }
+
+        rect_t criterion_t::input_region(const sample_t& sample) const
+        {
+                return rect_t(sample.m_region.left(), sample.m_region.top(), m_model->icols(), m_model->irows());
+        }
+
+        size_t criterion_t::prepare(size_t begin, size_t end)
+        {
+                const size_t count = std::min(end - begin, max_batch_size);
+
+                m_binputs.resize(count * m_model->idims(), m_model->irows(), m_model->icols());
+                m_btargets.resize(count, m_model->osize());
+                m_bvalues.resize(count);
+                m_bvgrads.resize(m_type == type::vgrad ? count : 0, m_model->osize());
+
+                return count;
+        }
+
+        void criterion_t::accumulate(size_t count, const loss_t& loss)
+        {
+                const size_t osize = m_model->osize();
+                const tensor_t& outputs = m_model->output(m_binputs, count);
+
+                assert(outputs.size() == count * osize);
+
+                // NB: the per-sample outputs, targets & gradients are copied to the workspaces (no allocation)
+                for (size_t s = 0; s < count; s ++)
+                {
+                        m_output = outputs.vector().segment(s * osize, osize);
+                        m_target = m_btargets.row(s).transpose();
+
+                        m_bvalues(s) = loss.value(m_target, m_output);
+                        m_estats(loss.error(m_target, m_output));
+
+                        if (m_type == type::vgrad)
+                        {
+                                loss.vgrad(m_target, m_output, m_ograd);
+                                m_bvgrads.row(s) = m_ograd.transpose();
+                        }
+                }
+
+                switch (m_type)
+                {
+                case type::value:
+                        for (size_t s = 0; s < count; s ++)
+                        {
+                                accumulate(m_bvalues(s));
+                        }
+                        break;
+
+                case type::vgrad:
+                        accumulate(m_bvalues, m_bvgrads);
+                        break;
+                }
+        }
+
+        const vector_t& criterion_t::gparam(const matrix_t& vgrads)
+        {
+                m_model->gparam(vgrads, m_pgrad);
+                return m_pgrad;
+        }
+
         void criterion_t::accumulate(const vector_t& output, const vector_t& target, const loss_t& loss)
         {
                 const scalar_t value = loss.value(target, output);
@@ -112,7 +246,9 @@ namespace ncv
                         break;
 
                 case type::vgrad:
-                        accumulate(m_model->gparam(loss.vgrad(target, output)), value);
+                        loss.vgrad(target, output, m_ograd);
+                        m_model->gparam(m_ograd, m_pgrad);
+                        accumulate(m_pgrad, value);
                         break;
                 }
         }
@@ -126,6 +262,51 @@ namespace ncv
                 return *this;
         }
 
+        acc_scalars_t criterion_t::save_stats() const
+        {
+                acc_scalars_t stats;
+                stats.push_back(-static_cast<acc_scalar_t>(m_estats.min()));
+                stats.push_back(static_cast<acc_scalar_t>(m_estats.max()));
+                stats.push_back(static_cast<acc_scalar_t>(m_estats.count()));
+                stats.push_back(static_cast<acc_scalar_t>(m_estats.sum()));
+                stats.push_back(static_cast<acc_scalar_t>(m_estats.sumsq()));
+
+                save_state(stats);
+
+                return stats;
+        }
+
+        void criterion_t::load_stats(const acc_scalars_t& stats)
+        {
+                assert(stats.size() >= n_max_stats + 3);
+
+                m_estats = stats_t<scalar_t>(
+                        static_cast<size_t>(stats[2] + 0.5),
+                        static_cast<scalar_t>(stats[3]),
+                        static_cast<scalar_t>(stats[4]),
+                        static_cast<scalar_t>(-stats[0]),
+                        static_cast<scalar_t>(stats[1]));
+
+                size_t pos = n_max_stats + 3;
+                load_state(stats, pos);
+
+                assert(pos == stats.size());
+        }
+
+        void criterion_t::merge_stats(acc_scalars_t& stats, const acc_scalars_t& other)
+        {
+                assert(stats.size() == other.size());
+
+                for (size_t i = 0; i < n_max_stats; i ++)
+                {
+                        stats[i] = std::max(stats[i], other[i]);
+                }
+                for (size_t i = n_max_stats; i < stats.size(); i ++)
+                {
+                        stats[i] += other[i];
+                }
+        }
+
         scalar_t criterion_t::avg_error() const
         {
                 assert(m_estats.count() > 0);
@@ -140,6 +321,20 @@ namespace ncv
                 return m_estats.var();
         }
 
+        scalar_t criterion_t::min_error() const
+        {
+                assert(m_estats.count() > 0);
+
+                return m_estats.min();
+        }
+
+        scalar_t criterion_t::max_error() const
+        {
+                assert(m_estats.count() > 0);
+
+                return m_estats.max();
+        }
+
         size_t criterion_t::count() const
         {
                 return m_estats.count();
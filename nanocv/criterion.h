@@ -62,20 +62,47 @@ namespace ncv
                 void update(const tensor_t& input, const vector_t& target, const loss_t& loss);
                 void update(const vector_t& input, const vector_t& target, const loss_t& loss);
 
+                ///
+                /// \brief update statistics with the samples in the [begin, end) range
+                ///     (processed in batches with a single call to the model's batched output & gradient)
+                ///
+                void update(const task_t& task, const samples_t& samples, size_t begin, size_t end, const loss_t& loss);
+                void update(const tensors_t& inputs, const vectors_t& targets, size_t begin, size_t end, const loss_t& loss);
+                void update(const vectors_t& inputs, const vectors_t& targets, size_t begin, size_t end, const loss_t& loss);
+
                 ///
                 /// \brief cumulate statistics
                 ///
                 criterion_t& operator+=(const criterion_t&);
 
+                ///
+                /// \brief the cumulated statistics as a flat buffer (e.g. to combine them across processes) & back
+                ///
+                /// NB: the first <n_max_stats> values (the negated minimum & the maximum error) are combined
+                ///     with the maximum, while the rest are summed (see merge_stats).
+                ///
+                acc_scalars_t save_stats() const;
+                void load_stats(const acc_scalars_t& stats);
+
+                ///
+                /// \brief number of leading values of the flat statistics combined with the maximum (not summed)
+                ///
+                static const size_t n_max_stats = 2;
+
+                ///
+                /// \brief combine the given flat statistics into the first ones
+                ///
+                static void merge_stats(acc_scalars_t& stats, const acc_scalars_t& other);
+
                 ///
                 /// \brief cumulated loss value
                 ///
-                virtual scalar_t value() const = 0;
+                virtual acc_scalar_t value() const = 0;
 
                 ///
                 /// \brief cumulated gradient
                 ///
-                virtual vector_t vgrad() const = 0;
+                virtual acc_vector_t vgrad() const = 0;
 
                 ///
                 /// \brief averaged error value
@@ -87,6 +114,12 @@ namespace ncv
                 ///
                 scalar_t var_error() const;
 
+                ///
+                /// \brief minimum & maximum error value
+                ///
+                scalar_t min_error() const;
+                scalar_t max_error() const;
+
                 ///
                 /// \brief total number of processed samples
                 ///
@@ -125,11 +158,36 @@ namespace ncv
                 virtual void accumulate(scalar_t value) = 0;
                 virtual void accumulate(const vector_t& vgrad, scalar_t value) = 0;
 
+                ///
+                /// \brief update statistics with the loss values and gradients (wrt the outputs, as rows) for a batch
+                ///
+                virtual void accumulate(const vector_t& values, const matrix_t& vgrads) = 0;
+
                 ///
                 /// \brief update statistics with cumulated samples
                 ///
                 virtual void accumulate(const criterion_t& other) = 0;
 
+                ///
+                /// \brief append the cumulated statistics (of the derived criterion) to the given buffer
+                ///     & read them back from the <pos> position
+                ///
+                virtual void save_state(acc_scalars_t& stats) const = 0;
+                virtual void load_state(const acc_scalars_t& stats, size_t& pos) = 0;
+
+                ///
+                /// \brief check if the gradient is cumulated
+                ///
+                bool has_vgrad() const { return m_type == type::vgrad; }
+
+                ///
+                /// \brief gradient wrt parameters summed over the current batch
+                ///     for the given loss gradients wrt the outputs (as rows)
+                ///
+                /// NB: the gradient is stored in a workspace, so it is overwritten by the next call.
+                ///
+                const vector_t& gparam(const matrix_t& vgrads);
+
                 ///
                 /// \brief loss term's weight
                 ///
@@ -147,6 +205,21 @@ namespace ncv
                 ///
                 void accumulate(const vector_t& output, const vector_t& target, const loss_t&);
 
+                ///
+                /// \brief the model's input region for the given sample
+                ///
+                rect_t input_region(const sample_t& sample) const;
+
+                ///
+                /// \brief prepare the batch buffers for the samples in the [begin, end) range, returns the batch size
+                ///
+                size_t prepare(size_t begin, size_t end);
+
+                ///
+                /// \brief update statistics with the batch of samples stored in the batch buffers
+                ///
+                void accumulate(size_t count, const loss_t&);
+
         private:
 
                 // attributes
@@ -157,6 +230,16 @@ namespace ncv
                 type                    m_type;         ///<
 
                 stats_t<scalar_t>       m_estats;       ///< loss error statistics
+
+                tensor_t                m_input;        ///< single input:      idims x irows x icols
+                vector_t                m_output;       ///< single output (of a batch)
+                vector_t                m_target;       ///< single target (of a batch)
+                vector_t                m_ograd;        ///< single gradient wrt outputs
+                vector_t                m_pgrad;        ///< single (or summed over a batch) gradient wrt parameters
+                tensor_t                m_binputs;      ///< batch inputs:      (count x idims) x irows x icols
+                matrix_t                m_btargets;     ///< batch targets:     count x osize
+                vector_t                m_bvalues;      ///< batch loss values: count
+                matrix_t                m_bvgrads;      ///< batch loss gradients wrt outputs: count x osize
         };
 }
 
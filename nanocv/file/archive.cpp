@@ -1,4 +1,5 @@
 #include "archive.h"
+#include "chunk.h"
 #include "bzip.h"
 #include "gzip.h"
 #include "nanocv/text.h"
@@ -72,9 +73,41 @@ namespace ncv
                         return true;
                 }
 
-                bool decode(const io::data_t& mem_data, const std::string& log_header, const io::data_callback_t& callback);
+                bool copy(archive* ar, io::chunk_buffer_t& buffer, bool& read_ok)
+                {
+                        while (true)
+                        {
+                                const void* buff;
+                                size_t size;
+                                off_t offset;
+
+                                const int r = archive_read_data_block(ar, &buff, &size, &offset);
+                                if (r == ARCHIVE_EOF)
+                                        return buffer.flush();
+                                if (r != ARCHIVE_OK)
+                                        return (read_ok = false);
+
+                                if (!buffer.write((const char*)buff, size))
+                                        return false;
+                        }
+
+                        return true;
+                }
 
-                bool decode(archive* ar, const std::string& log_header, const io::data_callback_t& callback)
+                void log_read_error(archive* ar, const std::string& log_header)
+                {
+                        log_error() << log_header << "failed to read archive!";
+                        log_error() << log_header << "error <" << archive_error_string(ar) << ">!";
+                }
+
+                ///
+                /// \brief callback to read the content of a (non-archive) file from the archive
+                ///
+                typedef std::function<bool(archive*, const std::string& filename)> entry_callback_t;
+
+                bool decode(const io::data_t& mem_data, const std::string& log_header, const entry_callback_t& callback);
+
+                bool decode(archive* ar, const std::string& log_header, const entry_callback_t& callback)
                 {
                         bool ok = true;
                         while (ok)
@@ -86,24 +119,13 @@ namespace ncv
                                         break;
                                 if (r != ARCHIVE_OK)
                                 {
-                                        log_error() << log_header << "failed to read archive!";
-                                        log_error() << log_header << "error <" << archive_error_string(ar) << ">!";
+                                        log_read_error(ar, log_header);
                                         ok = false;
                                         break;
                                 }
 
                                 const std::string filename = archive_entry_pathname(entry);
                                 const detail::archive_type filetype = detail::decode_archive_type(filename);
-//                                const int64_t filesize = archive_entry_size(entry);
-
-                                io::data_t data;
-                                if (!detail::copy(ar, data))
-                                {
-                                        log_error() << log_header << "failed to read archive!";
-                                        log_error() << log_header << "error <" << archive_error_string(ar) << ">!";
-                                        ok = false;
-                                        break;
-                                }
 
                                 switch (filetype)
                                 {
@@ -112,11 +134,23 @@ namespace ncv
                                 case detail::archive_type::tar_bz2:
                                 case detail::archive_type::gz:
                                 case detail::archive_type::bz2:
-                                        ok = detail::decode(data, log_header, callback);
+                                        {
+                                                // NB: the embedded archives are decoded from memory
+                                                io::data_t data;
+                                                if (!detail::copy(ar, data))
+                                                {
+                                                        log_read_error(ar, log_header);
+                                                        ok = false;
+                                                }
+                                                else
+                                                {
+                                                        ok = detail::decode(data, log_header, callback);
+                                                }
+                                        }
                                         break;
 
                                 default:
-                                        ok = callback(filename, data);
+                                        ok = callback(ar, filename);
                                         break;
                                 }
                         }
@@ -128,7 +162,7 @@ namespace ncv
                         return ok;
                 }
 
-                bool decode(const io::data_t& mem_data, const std::string& log_header, const io::data_callback_t& callback)
+                bool decode(const io::data_t& mem_data, const std::string& log_header, const entry_callback_t& callback)
                 {
                         archive* ar = archive_read_new();
 
@@ -146,24 +180,63 @@ namespace ncv
 
                         return decode(ar, log_header, callback);
                 }
+
+                bool decode(const std::string& path, const std::string& log_header, const entry_callback_t& callback)
+                {
+                        archive* ar = archive_read_new();
+
+                        archive_read_support_filter_all(ar);
+                        archive_read_support_format_all(ar);
+                        archive_read_support_format_raw(ar);
+
+                        int r;
+                        if ((r = archive_read_open_filename(ar, path.c_str(), 10240)))
+                        {
+                                log_error() << log_header << "failed to open archive <" << path << ">!";
+                                log_error() << log_header << "error <" << archive_error_string(ar) << ">!";
+                                return false;
+                        }
+
+                        return decode(ar, log_header, callback);
+                }
         }
 
         bool io::decode(const std::string& path, const std::string& log_header, const data_callback_t& callback)
         {
-                archive* ar = archive_read_new();
+                const auto op = [&] (archive* ar, const std::string& filename)
+                {
+                        io::data_t data;
+                        if (!detail::copy(ar, data))
+                        {
+                                detail::log_read_error(ar, log_header);
+                                return false;
+                        }
 
-                archive_read_support_filter_all(ar);
-                archive_read_support_format_all(ar);
-                archive_read_support_format_raw(ar);
+                        return callback(filename, data);
+                };
+
+                return detail::decode(path, log_header, op);
+        }
 
-                int r;
-                if ((r = archive_read_open_filename(ar, path.c_str(), 10240)))
+        bool io::decode(const std::string& path, const std::string& log_header, const chunk_callback_t& callback)
+        {
+                const auto op = [&] (archive* ar, const std::string& filename)
                 {
-                        log_error() << log_header << "failed to open archive <" << path << ">!";
-                        log_error() << log_header << "error <" << archive_error_string(ar) << ">!";
-                        return false;
-                }
+                        bool read_ok = true;
+
+                        io::chunk_buffer_t buffer(filename, callback);
+                        if (!detail::copy(ar, buffer, read_ok))
+                        {
+                                if (!read_ok)
+                                {
+                                        detail::log_read_error(ar, log_header);
+                                }
+                                return false;
+                        }
+
+                        return true;
+                };
 
-                return detail::decode(ar, log_header, callback);
+                return detail::decode(path, log_header, op);
         }
 }
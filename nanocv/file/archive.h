@@ -1,6 +1,6 @@
 #pragma once
 
-#include "base.h"
+#include "chunk.h"
 #include "nanocv/arch.h"
 
 namespace ncv
@@ -12,5 +12,12 @@ namespace ncv
                 ///
                 NANOCV_PUBLIC bool decode(const std::string& path, const std::string& log_header,
                         const data_callback_t& callback);
+
+                ///
+                /// \brief decode an archive file, but pass the content of each file in (bounded) chunks
+                ///     as it is decompressed, instead of loading it whole in memory
+                ///
+                NANOCV_PUBLIC bool decode(const std::string& path, const std::string& log_header,
+                        const chunk_callback_t& callback);
         }
 }
@@ -0,0 +1,77 @@
+#include "chunk.h"
+#include <algorithm>
+
+namespace ncv
+{
+        io::chunk_buffer_t::chunk_buffer_t(const std::string& filename, const chunk_callback_t& callback, size_t capacity)
+                :       m_filename(filename),
+                        m_callback(callback),
+                        m_buffer(std::max(capacity, size_t(1))),
+                        m_size(0),
+                        m_count(0)
+        {
+        }
+
+        bool io::chunk_buffer_t::write(const char* data, size_t size)
+        {
+                m_count += size;
+
+                while (size > 0)
+                {
+                        const size_t n = std::min(size, m_buffer.size() - m_size);
+                        std::copy(data, data + n, m_buffer.data() + m_size);
+
+                        m_size += n;
+                        data += n;
+                        size -= n;
+
+                        if (m_size == m_buffer.size() && !dispatch())
+                        {
+                                return false;
+                        }
+                }
+
+                return true;
+        }
+
+        bool io::chunk_buffer_t::flush()
+        {
+                // NB: the trailing bytes not consumed (e.g. an incomplete record) are discarded
+                const bool ok = m_size == 0 || dispatch();
+                m_size = 0;
+                return ok;
+        }
+
+        bool io::chunk_buffer_t::dispatch()
+        {
+                // pass the buffered bytes while the callback consumes them (e.g. the header & then the records)
+                size_t begin = 0;
+                while (begin < m_size)
+                {
+                        size_t used = 0;
+                        if (!m_callback(m_filename, m_buffer.data() + begin, m_size - begin, used))
+                        {
+                                return false;
+                        }
+
+                        if (used == 0)
+                        {
+                                break;
+                        }
+
+                        begin += std::min(used, m_size - begin);
+                }
+
+                // keep the bytes not consumed at the beginning of the buffer
+                std::copy(m_buffer.data() + begin, m_buffer.data() + m_size, m_buffer.data());
+                m_size -= begin;
+
+                // NB: grow the buffer if it cannot hold a whole record
+                if (m_size == m_buffer.size())
+                {
+                        m_buffer.resize(2 * m_buffer.size());
+                }
+
+                return true;
+        }
+}
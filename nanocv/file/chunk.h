@@ -0,0 +1,63 @@
+#pragma once
+
+#include "base.h"
+#include "nanocv/arch.h"
+#include "nanocv/noncopyable.hpp"
+
+namespace ncv
+{
+        namespace io
+        {
+                ///
+                /// \brief callback to execute when a chunk of a file was decompressed
+                ///     - (filename, buffered uncompressed bytes, number of buffered bytes, number of bytes consumed)
+                ///
+                /// NB: the bytes not consumed (e.g. an incomplete record) are passed again with the next chunk,
+                ///     so that the callback decodes only whole records.
+                ///
+                typedef std::function<bool(const std::string&, const char*, size_t, size_t&)> chunk_callback_t;
+
+                ///
+                /// \brief bounded buffer to pass the uncompressed bytes of a file in chunks,
+                ///     as soon as they are decompressed
+                ///
+                class NANOCV_PUBLIC chunk_buffer_t : private noncopyable_t
+                {
+                public:
+
+                        ///
+                        /// \brief constructor
+                        ///
+                        chunk_buffer_t(const std::string& filename, const chunk_callback_t& callback,
+                                size_t capacity = 1024 * 1024);
+
+                        ///
+                        /// \brief append the given bytes (and pass the buffered bytes to the callback when full)
+                        ///
+                        bool write(const char* data, size_t size);
+
+                        ///
+                        /// \brief pass the remaining buffered bytes to the callback (at the end of the file)
+                        ///
+                        bool flush();
+
+                        ///
+                        /// \brief number of bytes written so far
+                        ///
+                        size_t count() const { return m_count; }
+
+                private:
+
+                        bool dispatch();
+
+                private:
+
+                        // attributes
+                        std::string             m_filename;
+                        chunk_callback_t        m_callback;
+                        data_t                  m_buffer;       ///< buffered bytes [0, m_size)
+                        size_t                  m_size;
+                        size_t                  m_count;
+                };
+        }
+}
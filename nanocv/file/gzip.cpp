@@ -1,4 +1,5 @@
 #include "gzip.h"
+#include "chunk.h"
 #include "stream.h"
 #include <zlib.h>
 #include <fstream>
@@ -9,9 +10,10 @@ namespace ncv
 
         template
         <
-                typename tstream
+                typename tstream,
+                typename toperator
         >
-        bool io_uncompress_gzip(tstream& istream, size_t num_bytes, io::data_t& data)
+        bool io_uncompress_gzip(tstream& istream, size_t num_bytes, const toperator& op)
         {
                 // zlib decompression buffers
                 static const std::streamsize chunk_size = 64 * 1024;
@@ -58,7 +60,11 @@ namespace ncv
                                 }
 
                                 const std::streamsize have = chunk_size - strm.avail_out;
-                                data.insert(data.end(), out, out + have);
+                                if (!op(reinterpret_cast<const char*>(out), static_cast<size_t>(have)))
+                                {
+                                        inflateEnd(&strm);
+                                        return false;
+                                }
                         }
                         while (strm.avail_out == 0);
                 }
@@ -71,7 +77,20 @@ namespace ncv
 
         bool io::uncompress_gzip(std::istream& istream, size_t num_bytes, data_t& data)
         {
-                return io_uncompress_gzip(istream, num_bytes, data);
+                return io_uncompress_gzip(istream, num_bytes, [&] (const char* out, size_t size)
+                {
+                        data.insert(data.end(), out, out + size);
+                        return true;
+                });
+        }
+
+        bool io::uncompress_gzip(std::istream& istream, size_t num_bytes, chunk_buffer_t& buffer)
+        {
+                return  io_uncompress_gzip(istream, num_bytes, [&] (const char* out, size_t size)
+                        {
+                                return buffer.write(out, size);
+                        }) &&
+                        buffer.flush();
         }
 
         bool io::uncompress_gzip(std::istream& istream, data_t& data)
@@ -82,6 +101,10 @@ namespace ncv
         bool io::uncompress_gzip(const data_t& istream, data_t& data)
         {
                 stream_t stream(istream.data(), istream.size());
-                return io_uncompress_gzip(stream, stream.size(), data);
+                return io_uncompress_gzip(stream, stream.size(), [&] (const char* out, size_t size)
+                {
+                        data.insert(data.end(), out, out + size);
+                        return true;
+                });
         }
 }
@@ -6,11 +6,18 @@ namespace ncv
 {
         namespace io
         {
+                class chunk_buffer_t;
+
                 ///
                 /// \brief uncompress a stream of bytes (using zlib)
                 ///
                 bool uncompress_gzip(std::istream& istream, size_t num_bytes, data_t& data);
                 bool uncompress_gzip(std::istream& istream, data_t& data);
                 bool uncompress_gzip(const data_t& istream, data_t& data);
+
+                ///
+                /// \brief uncompress a stream of bytes (using zlib) in chunks
+                ///
+                bool uncompress_gzip(std::istream& istream, size_t num_bytes, chunk_buffer_t& buffer);
         }
 }
@@ -76,9 +76,21 @@ namespace ncv
 
         bool mat5::array_t::load(const io::data_t& data)
         {
+                return load(data, data.size());
+        }
+
+        bool mat5::array_t::load(const io::data_t& data, size_t size)
+        {
+                // NB: only the section tags & the header sections need to be available in <data>
+                const auto load_section = [&] (section_t& section, size_t offset)
+                {
+                        return  offset + 8 <= data.size() &&
+                                section.load(offset, size, make_uint32(&data[offset + 0]), make_uint32(&data[offset + 4]));
+                };
+
                 // read & check header
                 section_t header;
-                if (!header.load(data))
+                if (!load_section(header, 0))
                 {
                         log_error() << "failed to load array!";
                         return false;
@@ -91,22 +103,22 @@ namespace ncv
                         return false;
                 }
 
-                if (header.end() != data.size())
+                if (header.end() != size)
                 {
                         log_error() << "invalid array size in bytes!";
                         return false;
                 }
 
                 log_info() << "array header: dtype = " << mat5::to_string(header.m_dtype)
-                           << ", bytes = " << header.size() << "/" << data.size() << ".";
+                           << ", bytes = " << header.size() << "/" << size << ".";
 
                 // read & check sections
                 m_sections.clear();
 
-                for (size_t i = 8; i < data.size(); )
+                for (size_t i = 8; i < size; )
                 {
                         section_t section;
-                        if (!section.load(data, i))
+                        if (!load_section(section, i))
                         {
                                 break;
                         }
@@ -135,6 +147,12 @@ namespace ncv
                 const section_t& sect3 = m_sections[2];
                 const section_t& sect4 = m_sections[3];
 
+                if (sect2.dend() > data.size() || sect3.dend() > data.size())
+                {
+                        log_error() << "invalid array sections! incomplete header!";
+                        return false;
+                }
+
                 m_name = std::string(data.begin() + sect3.dbegin(), data.begin() + sect3.dend());
 
                 m_dims.clear();
@@ -158,6 +158,12 @@ namespace ncv
                         ///
                         bool load(const io::data_t& data);
 
+                        ///
+                        /// \brief parse the array from its first bytes (at least the header sections),
+                        ///     given the size in bytes of the whole array (e.g. the array is decompressed in chunks)
+                        ///
+                        bool load(const io::data_t& data, size_t size);
+
                         ///
                         /// \brief describe the array
                         ///
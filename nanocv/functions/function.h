@@ -5,7 +5,7 @@
 
 namespace ncv
 {
-        typedef std::pair<vector_t, scalar_t>           solution_t;
+        typedef std::pair<opt_vector_t, opt_scalar_t>   solution_t;
         typedef std::vector<solution_t>                 solutions_t;
 
         ///
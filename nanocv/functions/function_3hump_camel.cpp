@@ -12,24 +12,24 @@ namespace ncv
                                 return 2;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
-                                const scalar_t a2 = a * a;
-                                const scalar_t a4 = a2 * a2;
-                                const scalar_t a6 = a4 * a2;
+                                const opt_scalar_t a2 = a * a;
+                                const opt_scalar_t a4 = a2 * a2;
+                                const opt_scalar_t a6 = a4 * a2;
 
                                 return 2 * a2 - 1.05 * a4 + a6 / 6.0 + a * b + b * b;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
-                                const scalar_t a2 = a * a;
-                                const scalar_t a3 = a * a2;
-                                const scalar_t a5 = a3 * a2;
+                                const opt_scalar_t a2 = a * a;
+                                const opt_scalar_t a3 = a * a2;
+                                const opt_scalar_t a5 = a3 * a2;
 
                                 gx.resize(2);
                                 gx(0) = 4 * a - 1.05 * 4 * a3 + a5 + b;
@@ -38,9 +38,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                solutions.emplace_back(vector_t::Zero(2), 0.0);
+                                solutions.emplace_back(opt_vector_t::Zero(2), 0.0);
                         }
 
                         functions.emplace_back("3hump camel",
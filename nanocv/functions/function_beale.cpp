@@ -12,24 +12,24 @@ namespace ncv
                                 return 2;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
-                                const scalar_t z0 = 1.5 - a + a * b;
-                                const scalar_t z1 = 2.25 - a + a * b * b;
-                                const scalar_t z2 = 2.625 - a + a * b * b * b;
+                                const opt_scalar_t z0 = 1.5 - a + a * b;
+                                const opt_scalar_t z1 = 2.25 - a + a * b * b;
+                                const opt_scalar_t z2 = 2.625 - a + a * b * b * b;
 
                                 return z0 * z0 + z1 * z1 + z2 * z2;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
-                                const scalar_t z0 = 1.5 - a + a * b;
-                                const scalar_t z1 = 2.25 - a + a * b * b;
-                                const scalar_t z2 = 2.625 - a + a * b * b * b;
+                                const opt_scalar_t z0 = 1.5 - a + a * b;
+                                const opt_scalar_t z1 = 2.25 - a + a * b * b;
+                                const opt_scalar_t z2 = 2.625 - a + a * b * b * b;
 
                                 gx.resize(2);
                                 gx(0) = 2.0 * (z0 * (-1 + b) + z1 * (-1 + b * b) + z2 * (-1 + b * b * b));
@@ -38,9 +38,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                vector_t x(2);
+                                opt_vector_t x(2);
                                 x(0) = 3.0;
                                 x(1) = 0.5;
                                 solutions.emplace_back(x, 0);
@@ -12,22 +12,22 @@ namespace ncv
                                 return 2;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
-                                const scalar_t u = a + 2 * b - 7;
-                                const scalar_t v = 2 * a + b - 5;
+                                const opt_scalar_t u = a + 2 * b - 7;
+                                const opt_scalar_t v = 2 * a + b - 5;
 
                                 return u * u + v * v;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
-                                const scalar_t u = a + 2 * b - 7;
-                                const scalar_t v = 2 * a + b - 5;
+                                const opt_scalar_t u = a + 2 * b - 7;
+                                const opt_scalar_t v = 2 * a + b - 5;
 
                                 gx.resize(2);
                                 gx(0) = 2 * u + 2 * v * 2;
@@ -36,9 +36,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                vector_t x(2);
+                                opt_vector_t x(2);
                                 x(0) = 1.0;
                                 x(1) = 3.0;
                                 solutions.emplace_back(x, 0.0);
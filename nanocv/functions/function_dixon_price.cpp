@@ -14,9 +14,9 @@ namespace ncv
                                 return dims;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                scalar_t fx = 0;
+                                opt_scalar_t fx = 0;
                                 for (size_t i = 0; i < dims; i ++)
                                 {
                                         if (i == 0)
@@ -32,7 +32,7 @@ namespace ncv
                                 return fx;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
                                 gx.resize(dims);
                                 gx.setZero();
@@ -44,7 +44,7 @@ namespace ncv
                                         }
                                         else
                                         {
-                                                const scalar_t delta = (i + 1) * 2.0 * (2.0 * math::square(x(i)) - x(i - 1));
+                                                const opt_scalar_t delta = (i + 1) * 2.0 * (2.0 * math::square(x(i)) - x(i - 1));
 
                                                 gx(i) += delta * 4.0 * x(i);
                                                 gx(i - 1) += - delta;
@@ -54,11 +54,11 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                const scalar_t fx = 0.0;
+                                const opt_scalar_t fx = 0.0;
 
-                                vector_t x(dims);
+                                opt_vector_t x(dims);
                                 for (size_t i = 0; i < dims; i ++)
                                 {
                                         x(i) = std::pow(2.0, -1.0 + std::pow(2.0, -i));
@@ -12,16 +12,16 @@ namespace ncv
                                 return 2;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
                                 return 0.26 * (a * a + b * b) - 0.48 * a * b;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
                                 gx.resize(2);
                                 gx(0) = 0.26 * 2 * a - 0.48 * b;
@@ -30,9 +30,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                solutions.emplace_back(vector_t::Zero(2), 0.0);
+                                solutions.emplace_back(opt_vector_t::Zero(2), 0.0);
                         }
 
                         functions.emplace_back("Matyas",
@@ -13,16 +13,16 @@ namespace ncv
                                 return 2;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
                                 return sin(a + b) + (a - b) * (a - b) - 1.5 * a + 2.5 * b + 1;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
-                                const scalar_t a = x(0), b = x(1);
+                                const opt_scalar_t a = x(0), b = x(1);
 
                                 gx.resize(2);
                                 gx(0) = cos(a + b) + 2 * (a - b) - 1.5;
@@ -31,9 +31,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                vector_t x(2);
+                                opt_vector_t x(2);
                                 x(0) = -0.54719;
                                 x(1) = -1.54719;
                                 solutions.emplace_back(x, -1.913223);
@@ -14,9 +14,9 @@ namespace ncv
                                 return dims;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                scalar_t fx = 0;
+                                opt_scalar_t fx = 0;
                                 for (size_t i = 0, i4 = 0; i < dims / 4; i ++, i4 += 4)
                                 {
                                         fx += math::square(x(i4 + 0) + x(i4 + 1) * 10.0);
@@ -28,16 +28,16 @@ namespace ncv
                                 return fx;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
                                 gx.resize(dims);
                                 gx.setZero();
                                 for (size_t i = 0, i4 = 0; i < dims / 4; i ++, i4 += 4)
                                 {
-                                        const scalar_t gfx1 = (x(i4 + 0) + x(i4 + 1) * 10.0) * 2.0;
-                                        const scalar_t gfx2 = (x(i4 + 2) - x(i4 + 3)) * 5.0 * 2.0;
-                                        const scalar_t gfx3 = math::cube(x(i4 + 1) - x(i4 + 2) * 2.0) * 4.0;
-                                        const scalar_t gfx4 = math::cube(x(i4 + 0) - x(i4 + 3)) * 10.0 * 4.0;
+                                        const opt_scalar_t gfx1 = (x(i4 + 0) + x(i4 + 1) * 10.0) * 2.0;
+                                        const opt_scalar_t gfx2 = (x(i4 + 2) - x(i4 + 3)) * 5.0 * 2.0;
+                                        const opt_scalar_t gfx3 = math::cube(x(i4 + 1) - x(i4 + 2) * 2.0) * 4.0;
+                                        const opt_scalar_t gfx4 = math::cube(x(i4 + 0) - x(i4 + 3)) * 10.0 * 4.0;
 
                                         gx(i4 + 0) += gfx1 + gfx4;
                                         gx(i4 + 1) += gfx1 * 10.0 + gfx3;
@@ -48,9 +48,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                solutions.emplace_back(vector_t::Zero(dims), 0);
+                                solutions.emplace_back(opt_vector_t::Zero(dims), 0);
                         }
 
                         functions.emplace_back("Powell" + text::to_string(dims) + "D",
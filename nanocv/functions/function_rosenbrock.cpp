@@ -14,9 +14,9 @@ namespace ncv
                                 return dims;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                scalar_t fx = 0;
+                                opt_scalar_t fx = 0;
                                 for (size_t i = 0; i + 1 < dims; i ++)
                                 {
                                         fx += 100.0 * math::square(x(i + 1) - x(i) * x(i)) + math::square(x(i) - 1);
@@ -25,7 +25,7 @@ namespace ncv
                                 return fx;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
                                 gx.resize(dims);
                                 gx.setZero();
@@ -39,12 +39,12 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                solutions.emplace_back(vector_t::Ones(dims), 0);
+                                solutions.emplace_back(opt_vector_t::Ones(dims), 0);
                                 if (dims >= 4 && dims <= 7)
                                 {
-                                        vector_t x = vector_t::Ones(dims);
+                                        opt_vector_t x = opt_vector_t::Ones(dims);
                                         x(0) = -1;
                                         solutions.emplace_back(x, 0);
                                 }
@@ -13,9 +13,9 @@ namespace ncv
                                 return dims;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                scalar_t fx = 0;
+                                opt_scalar_t fx = 0;
                                 for (size_t i = 0; i < dims; i ++)
                                 {
                                         for (size_t j = 0; j <= i; j ++)
@@ -27,7 +27,7 @@ namespace ncv
                                 return fx;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
                                 gx.resize(dims);
                                 gx.setZero();
@@ -42,9 +42,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                solutions.emplace_back(vector_t::Zero(dims), 0);
+                                solutions.emplace_back(opt_vector_t::Zero(dims), 0);
                         }
 
                         functions.emplace_back("rotated ellipsoid" + text::to_string(dims) + "D",
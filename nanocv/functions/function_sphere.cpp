@@ -13,9 +13,9 @@ namespace ncv
                                 return dims;
                         };
 
-                        const opt_opfval_t fn_fval = [=] (const vector_t& x)
+                        const opt_opfval_t fn_fval = [=] (const opt_vector_t& x)
                         {
-                                scalar_t fx = 0;
+                                opt_scalar_t fx = 0;
                                 for (size_t i = 0; i < dims; i ++)
                                 {
                                         fx += x(i) * x(i);
@@ -24,7 +24,7 @@ namespace ncv
                                 return fx;
                         };
 
-                        const opt_opgrad_t fn_grad = [=] (const vector_t& x, vector_t& gx)
+                        const opt_opgrad_t fn_grad = [=] (const opt_vector_t& x, opt_vector_t& gx)
                         {
                                 gx.resize(dims);
                                 for (size_t i = 0; i < dims; i ++)
@@ -35,9 +35,9 @@ namespace ncv
                                 return fn_fval(x);
                         };
 
-                        std::vector<std::pair<vector_t, scalar_t>> solutions;
+                        std::vector<std::pair<opt_vector_t, opt_scalar_t>> solutions;
                         {
-                                solutions.emplace_back(vector_t::Zero(dims), 0);
+                                solutions.emplace_back(opt_vector_t::Zero(dims), 0);
                         }
 
                         functions.emplace_back("sphere" + text::to_string(dims) + "D",
@@ -1,4 +1,6 @@
 #include "layer.h"
+#include "math/simd.h"
+#include <algorithm>
 
 namespace ncv
 {
@@ -6,5 +8,13 @@ namespace ncv
         {
                 return layer_manager_t::instance();
         }
+
+        size_t layer_block_size()
+        {
+                static const size_t block = std::min<size_t>(16,
+                        std::max<size_t>(4, math::simd_width<scalar_t>(math::simd_best())));
+
+                return block;
+        }
 }
 
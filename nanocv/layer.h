@@ -19,6 +19,12 @@ namespace ncv
 
         NANOCV_PUBLIC layer_manager_t& get_layers();
 
+        ///
+        /// \brief number of interleaved planes of the channel-blocked layout (see tensor::block),
+        ///     matching the SIMD width (4, 8 or 16 scalars)
+        ///
+        NANOCV_PUBLIC size_t layer_block_size();
+
         ///
         /// \brief process a set of inputs of size (irows, icols) and produces a set of outputs of size (orows, ocols)
         ///
@@ -81,6 +87,61 @@ namespace ncv
                 ///
                 virtual void gparam(const tensor_t& output, scalar_t* gradient) = 0;
 
+                ///
+                /// \brief compute the output plane by plane (to fuse consecutive layers, see ::planewise):
+                ///     the output planes are computed in increasing order starting with 0
+                ///
+                /// NB: the layer must keep the same state as ::output (for computing the gradients).
+                ///
+                virtual const tensor_t& output_plane(const tensor_t& input, size_t o) = 0;
+
+                ///
+                /// \brief returns true if the o-th output plane depends only on the o-th input plane,
+                ///     such that the output can be computed as soon as the input plane is available
+                ///
+                virtual bool planewise() const = 0;
+
+                ///
+                /// \brief compute the output using the channel-blocked layout (see tensor::block):
+                ///     the planes of both the input & the output are interleaved in groups of <block> planes
+                ///
+                /// NB: the gradients can be computed afterwards as after ::output.
+                ///
+                virtual const tensor_t& output_blocked(const tensor_t& input, size_t block) = 0;
+
+                ///
+                /// \brief returns true if the layer processes the channel-blocked layout natively
+                ///     (without converting its input & output)
+                ///
+                virtual bool blockable() const = 0;
+
+                ///
+                /// \brief compute the output using multiple threads (e.g. to reduce the latency of a single sample):
+                ///     the work is split in independent parts (e.g. output planes, rows or tiles)
+                ///     processed concurrently by at most <nthreads> tasks (0 - all available)
+                ///
+                /// NB: the gradients can be computed afterwards as after ::output.
+                ///
+                virtual const tensor_t& output_parallel(const tensor_t& input, size_t nthreads) = 0;
+
+                ///
+                /// \brief compute the outputs for a batch of samples
+                ///     stored contiguously as (count x idims) x irows x icols
+                ///
+                virtual const tensor_t& output(const tensor_t& inputs, size_t count) = 0;
+
+                ///
+                /// \brief compute the gradients wrt the inputs for a batch of samples
+                ///     stored contiguously as (count x odims) x orows x ocols
+                ///
+                virtual const tensor_t& ginput(const tensor_t& outputs, size_t count) = 0;
+
+                ///
+                /// \brief compute the gradient wrt the parameters summed over the batch of samples
+                ///     (processed by the last batched ::output call)
+                ///
+                virtual void gparam(const tensor_t& outputs, size_t count, scalar_t* gradient) = 0;
+
                 ///
                 /// \brief returns the input/output dimensions
                 ///
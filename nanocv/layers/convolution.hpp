@@ -9,29 +9,76 @@ namespace ncv
         namespace convolution
         {
                 ///
-                /// \brief convolution output
+                /// \brief 2D convolution kernels (plane by plane) of the direct method
+                ///
+                struct conv_dyn_t
+                {
+                        template <typename tmatrixi, typename tmatrixk, typename tmatrixo>
+                        void operator()(const tmatrixi& idata, const tmatrixk& kdata, tmatrixo& odata) const
+                        {
+                                math::conv2d_dyn(idata, kdata, odata);
+                        }
+                };
+
+                struct conv_dot_t
+                {
+                        template <typename tmatrixi, typename tmatrixk, typename tmatrixo>
+                        void operator()(const tmatrixi& idata, const tmatrixk& kdata, tmatrixo& odata) const
+                        {
+                                math::conv2d_dot(idata, kdata, odata);
+                        }
+                };
+
+                struct conv_mad_t
+                {
+                        template <typename tmatrixi, typename tmatrixk, typename tmatrixo>
+                        void operator()(const tmatrixi& idata, const tmatrixk& kdata, tmatrixo& odata) const
+                        {
+                                math::conv2d_mad(idata, kdata, odata);
+                        }
+                };
+
+                ///
+                /// \brief convolution output (for the given output plane)
                 ///
                 template
                 <
                         typename ttensori,
                         typename ttensork,
-                        typename ttensoro
+                        typename tsize,
+                        typename ttensoro,
+                        typename tconv = conv_dyn_t
                 >
-                void output(const ttensori& idata, const ttensork& kdata, ttensoro&& odata)
+                void output_plane(const ttensori& idata, const ttensork& kdata, tsize o, ttensoro&& odata,
+                        tconv conv = tconv())
                 {
-                        odata.setZero();
+                        auto omap = odata.matrix(o);
+                        omap.setZero();
 
-                        for (decltype(odata.dims()) o = 0, k = 0; o < odata.dims(); o ++)
+                        for (decltype(idata.dims()) i = 0, k = o * idata.dims(); i < idata.dims(); i ++, k ++)
                         {
-                                auto omap = odata.matrix(o);
+                                auto imap = idata.matrix(i);
+                                auto kmap = kdata.matrix(k);
 
-                                for (decltype(idata.dims()) i = 0; i < idata.dims(); i ++, k ++)
-                                {
-                                        auto imap = idata.matrix(i);
-                                        auto kmap = kdata.matrix(k);
+                                conv(imap, kmap, omap);
+                        }
+                }
 
-                                        math::conv2d_dyn(imap, kmap, omap);
-                                }
+                ///
+                /// \brief convolution output
+                ///
+                template
+                <
+                        typename ttensori,
+                        typename ttensork,
+                        typename ttensoro,
+                        typename tconv = conv_dyn_t
+                >
+                void output(const ttensori& idata, const ttensork& kdata, ttensoro&& odata, tconv conv = tconv())
+                {
+                        for (decltype(odata.dims()) o = 0; o < odata.dims(); o ++)
+                        {
+                                output_plane(idata, kdata, o, odata, conv);
                         }
                 }
 
@@ -69,9 +116,10 @@ namespace ncv
                 <
                         typename ttensori,
                         typename ttensork,
-                        typename ttensoro
+                        typename ttensoro,
+                        typename tconv = conv_dyn_t
                 >
-                void gparam(const ttensori& idata, ttensork&& gkdata, const ttensoro& odata)
+                void gparam(const ttensori& idata, ttensork&& gkdata, const ttensoro& odata, tconv conv = tconv())
                 {
                         for (decltype(odata.dims()) o = 0, k = 0; o < odata.dims(); o ++)
                         {
@@ -83,7 +131,7 @@ namespace ncv
                                         auto gkmap = gkdata.matrix(k);
 
                                         gkmap.setZero();
-                                        math::conv2d_dyn(imap, omap, gkmap);
+                                        conv(imap, omap, gkmap);
                                 }
                         }
                 }
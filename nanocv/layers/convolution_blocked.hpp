@@ -0,0 +1,245 @@
+#pragma once
+
+#include "nanocv/tensor/blocked.hpp"
+#include <eigen3/Eigen/Core>
+#include <cassert>
+
+namespace ncv
+{
+        namespace convolution
+        {
+                ///
+                /// \brief convolution using the channel-blocked layout (see tensor::block),
+                ///     such that the products for a group of <block> output planes are computed at once
+                ///     for each pixel & each input plane (vectorized across the output planes):
+                ///
+                ///     idata:  blocks(idims) x irows x (icols x block) channel-blocked input
+                ///     pkdata: (blocks(odims) x blocks(idims)) x (krows x kcols) x (block x block) packed kernels
+                ///     pbdata: blocks(odims) x 1 x block packed bias
+                ///     odata:  blocks(odims) x orows x (ocols x block) channel-blocked output
+                ///
+                /// NB: the padded planes have zero kernels & zero bias, so the padded output planes are zero.
+                ///
+                namespace blocked
+                {
+                        ///
+                        /// \brief check if the block size is supported
+                        ///
+                        template
+                        <
+                                typename tsize
+                        >
+                        bool supported(tsize block)
+                        {
+                                return block == 4 || block == 8 || block == 16;
+                        }
+
+                        ///
+                        /// \brief pack the kernels (odims x idims x krows x kcols) & the bias (odims)
+                        ///
+                        template
+                        <
+                                typename ttensork,
+                                typename ttensorb,
+                                typename tsize,
+                                typename ttensorp
+                        >
+                        void kernels(const ttensork& kdata, const ttensorb& bdata, tsize odims, tsize block,
+                                ttensorp& pkdata, ttensorp& pbdata)
+                        {
+                                const tsize idims = kdata.dims() / odims;
+                                const tsize oblocks = tensor::blocks(odims, block);
+                                const tsize iblocks = tensor::blocks(idims, block);
+                                const tsize ksize = kdata.planeSize();
+
+                                pkdata.resize(oblocks * iblocks, ksize, block * block);
+                                pkdata.setZero();
+
+                                for (tsize o = 0; o < odims; o ++)
+                                {
+                                        for (tsize i = 0; i < idims; i ++)
+                                        {
+                                                const auto* pk = kdata.planeData(o * idims + i);
+                                                auto* pp = pkdata.planeData((o / block) * iblocks + i / block) +
+                                                           (i % block) * block + (o % block);
+
+                                                for (tsize k = 0; k < ksize; k ++)
+                                                {
+                                                        pp[k * block * block] = pk[k];
+                                                }
+                                        }
+                                }
+
+                                pbdata.resize(oblocks, 1, block);
+                                pbdata.setZero();
+
+                                for (tsize o = 0; o < odims; o ++)
+                                {
+                                        pbdata(o) = bdata(o);
+                                }
+                        }
+
+                        namespace detail
+                        {
+                                ///
+                                /// \brief compute <tpixels> consecutive output pixels of a group of <tblock> output planes
+                                ///
+                                template
+                                <
+                                        int tblock,
+                                        int tpixels,
+                                        typename tscalar
+                                >
+                                void output(
+                                        const tscalar* idata, int iblocks, int ilast, int irows, int icols,
+                                        const tscalar* pkdata, const tscalar* pbdata, int krows, int kcols,
+                                        tscalar* odata)
+                                {
+                                        // NB: one SIMD register (or a few) per pixel for the <tblock> output planes
+                                        typedef Eigen::Array<tscalar, tblock, 1>        tlanes;
+                                        typedef Eigen::Map<const tlanes>                tclanes;
+                                        typedef Eigen::Map<tlanes>                      tolanes;
+
+                                        tlanes acc[tpixels];
+                                        for (int p = 0; p < tpixels; p ++)
+                                        {
+                                                acc[p] = tclanes(pbdata);
+                                        }
+
+                                        for (int gi = 0; gi < iblocks; gi ++)
+                                        {
+                                                // NB: skip the padded input planes (e.g. for gray-scale images)
+                                                const int bis = (gi + 1 == iblocks) ? ilast : tblock;
+
+                                                for (int kr = 0; kr < krows; kr ++)
+                                                {
+                                                        const tscalar* pi = idata + ((gi * irows + kr) * icols) * tblock;
+                                                        const tscalar* pk = pkdata + ((gi * krows + kr) * kcols) * tblock * tblock;
+
+                                                        for (int kc = 0; kc < kcols; kc ++)
+                                                        {
+                                                                for (int bi = 0; bi < bis; bi ++)
+                                                                {
+                                                                        const tlanes w = tclanes(pk + (kc * tblock + bi) * tblock);
+
+                                                                        for (int p = 0; p < tpixels; p ++)
+                                                                        {
+                                                                                acc[p] += pi[(kc + p) * tblock + bi] * w;
+                                                                        }
+                                                                }
+                                                        }
+                                                }
+                                        }
+
+                                        for (int p = 0; p < tpixels; p ++)
+                                        {
+                                                tolanes(odata + p * tblock) = acc[p];
+                                        }
+                                }
+
+                                template
+                                <
+                                        int tblock,
+                                        typename ttensori,
+                                        typename ttensorp,
+                                        typename ttensoro,
+                                        typename tscalar = typename ttensori::Scalar
+                                >
+                                void output(const ttensori& idata, int idims, const ttensorp& pkdata, const ttensorp& pbdata,
+                                        int krows, int kcols, int gbegin, int gend, ttensoro& odata)
+                                {
+                                        // number of output pixels computed at once (to reuse the loaded kernel coefficients)
+                                        const int pixels = 4;
+
+                                        const int iblocks = static_cast<int>(idata.dims());
+                                        const int irows = static_cast<int>(idata.rows());
+                                        const int icols = static_cast<int>(idata.cols()) / tblock;
+                                        const int ilast = idims - (iblocks - 1) * tblock;
+
+                                        const int orows = static_cast<int>(odata.rows());
+                                        const int ocols = static_cast<int>(odata.cols()) / tblock;
+
+                                        for (int go = gbegin; go < gend; go ++)
+                                        {
+                                                const tscalar* pk = pkdata.planeData(go * iblocks);
+                                                const tscalar* pb = pbdata.planeData(go);
+
+                                                for (int r = 0; r < orows; r ++)
+                                                {
+                                                        const tscalar* pi = idata.data() + r * icols * tblock;
+                                                        tscalar* po = odata.planeData(go) + r * ocols * tblock;
+
+                                                        int c = 0;
+                                                        for ( ; c + pixels <= ocols; c += pixels)
+                                                        {
+                                                                output<tblock, pixels>(
+                                                                        pi + c * tblock, iblocks, ilast, irows, icols,
+                                                                        pk, pb, krows, kcols, po + c * tblock);
+                                                        }
+                                                        for ( ; c < ocols; c ++)
+                                                        {
+                                                                output<tblock, 1>(
+                                                                        pi + c * tblock, iblocks, ilast, irows, icols,
+                                                                        pk, pb, krows, kcols, po + c * tblock);
+                                                        }
+                                                }
+                                        }
+                                }
+                        }
+
+                        ///
+                        /// \brief compute the [gbegin, gend) groups of output planes of the channel-blocked output
+                        ///     (e.g. to split the work between threads), the output must be already resized
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tsize,
+                                typename ttensorp,
+                                typename ttensoro
+                        >
+                        void output_groups(const ttensori& idata, tsize idims, tsize block,
+                                const ttensorp& pkdata, const ttensorp& pbdata, tsize krows, tsize kcols,
+                                tsize gbegin, tsize gend, ttensoro& odata)
+                        {
+                                assert(supported(block));
+                                assert(idata.dims() == tensor::blocks(idims, block));
+                                assert(gend <= static_cast<tsize>(odata.dims()));
+
+                                const int id = static_cast<int>(idims);
+                                const int kr = static_cast<int>(krows);
+                                const int kc = static_cast<int>(kcols);
+                                const int gb = static_cast<int>(gbegin);
+                                const int ge = static_cast<int>(gend);
+
+                                switch (block)
+                                {
+                                case 4:         detail::output<4>(idata, id, pkdata, pbdata, kr, kc, gb, ge, odata); break;
+                                case 8:         detail::output<8>(idata, id, pkdata, pbdata, kr, kc, gb, ge, odata); break;
+                                case 16:        detail::output<16>(idata, id, pkdata, pbdata, kr, kc, gb, ge, odata); break;
+                                default:        break;
+                                }
+                        }
+
+                        ///
+                        /// \brief compute the channel-blocked output (including the bias)
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tsize,
+                                typename ttensorp,
+                                typename ttensoro
+                        >
+                        void output(const ttensori& idata, tsize idims, tsize block,
+                                const ttensorp& pkdata, const ttensorp& pbdata, tsize krows, tsize kcols,
+                                tsize orows, tsize ocols, ttensoro& odata)
+                        {
+                                odata.resize(pbdata.dims(), orows, ocols * block);
+
+                                output_groups(idata, idims, block, pkdata, pbdata, krows, kcols,
+                                              tsize(0), static_cast<tsize>(pbdata.dims()), odata);
+                        }
+                }
+        }
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "nanocv/math/conv2d_fft.hpp"
+#include <cassert>
+
+namespace ncv
+{
+        namespace convolution
+        {
+                ///
+                /// \brief convolution in the frequency domain:
+                ///     the spectra of the (zero-padded) planes are stored as interleaved complex values,
+                ///     such that each spectrum is a plane of size fft_rows x (2 x fft_cols)
+                ///
+                ///     fkdata: (odims x idims) kernel spectra (to be computed once per parameter update)
+                ///     fidata: idims input spectra (shared by all output planes)
+                ///     fodata: odims output gradient spectra (shared by all input planes)
+                ///     fwdata: 1 spectrum buffer
+                ///
+                namespace fft
+                {
+                        ///
+                        /// \brief map a plane of the tensor as a spectrum
+                        ///
+                        template
+                        <
+                                typename ttensor,
+                                typename tindex,
+                                typename tscalar = typename std::remove_reference<ttensor>::type::Scalar
+                        >
+                        std::complex<tscalar>* spectrum(ttensor&& fdata, tindex i)
+                        {
+                                return reinterpret_cast<std::complex<tscalar>*>(fdata.planeData(i));
+                        }
+
+                        template
+                        <
+                                typename ttensor,
+                                typename tindex,
+                                typename tscalar = typename ttensor::Scalar
+                        >
+                        const std::complex<tscalar>* spectrum(const ttensor& fdata, tindex i)
+                        {
+                                return reinterpret_cast<const std::complex<tscalar>*>(fdata.planeData(i));
+                        }
+
+                        ///
+                        /// \brief compute the kernel spectra
+                        ///
+                        template
+                        <
+                                typename ttensork,
+                                typename tplan,
+                                typename ttensorf
+                        >
+                        void kernels(const ttensork& kdata, const tplan& plan, ttensorf& fkdata)
+                        {
+                                assert(fkdata.dims() == kdata.dims());
+
+                                for (decltype(kdata.dims()) k = 0; k < kdata.dims(); k ++)
+                                {
+                                        plan.forward(kdata.matrix(k), spectrum(fkdata, k));
+                                }
+                        }
+
+                        ///
+                        /// \brief compute the input spectra
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tplan,
+                                typename ttensorx
+                        >
+                        void spectra(const ttensori& idata, const tplan& plan, ttensorx&& fidata)
+                        {
+                                for (decltype(idata.dims()) i = 0; i < idata.dims(); i ++)
+                                {
+                                        plan.forward(idata.matrix(i), spectrum(fidata, i));
+                                }
+                        }
+
+                        ///
+                        /// \brief convolution output (for the given output plane) from the input spectra
+                        ///
+                        template
+                        <
+                                typename tplan,
+                                typename ttensorf,
+                                typename ttensorx,
+                                typename ttensorw,
+                                typename tsize,
+                                typename ttensoro,
+                                typename tscalar = typename ttensorf::Scalar
+                        >
+                        void output_plane(const tplan& plan, const ttensorf& fkdata, const ttensorx& fidata,
+                                ttensorw&& fwdata, tsize o, ttensoro& odata)
+                        {
+                                const auto idims = fidata.dims();
+
+                                auto fwmap = spectrum(fwdata, 0);
+                                std::fill(fwmap, fwmap + plan.size(), std::complex<tscalar>(0));
+                                for (decltype(fidata.dims()) i = 0; i < idims; i ++)
+                                {
+                                        math::fft_madc<tscalar>(spectrum(fidata, i), spectrum(fkdata, o * idims + i),
+                                                plan.size(), fwmap);
+                                }
+
+                                plan.inverse(fwmap, odata.matrix(o));
+                        }
+
+                        ///
+                        /// \brief convolution output
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tplan,
+                                typename ttensorf,
+                                typename ttensorx,
+                                typename ttensoro
+                        >
+                        void output(const ttensori& idata, const tplan& plan, const ttensorf& fkdata,
+                                ttensorx&& fidata, ttensorf& fwdata, ttensoro& odata)
+                        {
+                                spectra(idata, plan, fidata);
+
+                                for (decltype(odata.dims()) o = 0; o < odata.dims(); o ++)
+                                {
+                                        output_plane(plan, fkdata, fidata, fwdata, o, odata);
+                                }
+                        }
+
+                        ///
+                        /// \brief gradient wrt the input
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tplan,
+                                typename ttensorf,
+                                typename ttensoro,
+                                typename tscalar = typename ttensoro::Scalar
+                        >
+                        void ginput(ttensori& gidata, const tplan& plan, const ttensorf& fkdata,
+                                ttensorf& fodata, ttensorf& fwdata, const ttensoro& odata)
+                        {
+                                const auto idims = gidata.dims();
+                                const auto odims = odata.dims();
+
+                                for (decltype(odata.dims()) o = 0; o < odims; o ++)
+                                {
+                                        plan.forward(odata.matrix(o), spectrum(fodata, o));
+                                }
+
+                                auto fwmap = spectrum(fwdata, 0);
+                                for (decltype(gidata.dims()) i = 0; i < idims; i ++)
+                                {
+                                        std::fill(fwmap, fwmap + plan.size(), std::complex<tscalar>(0));
+                                        for (decltype(odata.dims()) o = 0; o < odims; o ++)
+                                        {
+                                                math::fft_mad<tscalar>(spectrum(fodata, o), spectrum(fkdata, o * idims + i),
+                                                        plan.size(), fwmap);
+                                        }
+
+                                        plan.inverse(fwmap, gidata.matrix(i));
+                                }
+                        }
+
+                        ///
+                        /// \brief gradient wrt the parameters (fidata are the input spectra from the last ::output call)
+                        ///
+                        template
+                        <
+                                typename ttensorx,
+                                typename tplan,
+                                typename ttensork,
+                                typename ttensorf,
+                                typename ttensoro,
+                                typename tscalar = typename ttensoro::Scalar
+                        >
+                        void gparam(const ttensorx& fidata, const tplan& plan, ttensork&& gkdata,
+                                ttensorf& fodata, ttensorf& fwdata, const ttensoro& odata)
+                        {
+                                const auto odims = odata.dims();
+                                const auto idims = gkdata.dims() / odims;
+
+                                for (decltype(odata.dims()) o = 0; o < odims; o ++)
+                                {
+                                        plan.forward(odata.matrix(o), spectrum(fodata, o));
+                                }
+
+                                auto fwmap = spectrum(fwdata, 0);
+                                for (decltype(odata.dims()) o = 0, k = 0; o < odims; o ++)
+                                {
+                                        for (decltype(odata.dims()) i = 0; i < idims; i ++, k ++)
+                                        {
+                                                std::fill(fwmap, fwmap + plan.size(), std::complex<tscalar>(0));
+                                                math::fft_madc<tscalar>(spectrum(fidata, i), spectrum(fodata, o),
+                                                        plan.size(), fwmap);
+
+                                                plan.inverse(fwmap, gkdata.matrix(k));
+                                        }
+                                }
+                        }
+                }
+        }
+}
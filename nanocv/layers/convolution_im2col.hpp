@@ -0,0 +1,213 @@
+#pragma once
+
+#include "nanocv/tensor/matrix.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace ncv
+{
+        namespace convolution
+        {
+                ///
+                /// \brief convolution by unfolding the input planes into a matrix (im2col),
+                ///     such that all output planes are computed with a single (cache-blocked) matrix product:
+                ///
+                ///     xdata:  (idims x krows x kcols) x (orows x ocols) unfolded input patches
+                ///     kdata:  odims x (idims x krows x kcols) kernels (the storage of the convolution layer)
+                ///     odata:  odims x (orows x ocols) = kdata * xdata
+                ///
+                /// the input patches are sampled every <stride> pixels
+                /// and the kernel coefficients are applied every <dilation> pixels.
+                ///
+                namespace im2col
+                {
+                        ///
+                        /// \brief output size (for each dimension)
+                        ///
+                        template
+                        <
+                                typename tsize
+                        >
+                        tsize osize(tsize isize, tsize ksize, tsize stride, tsize dilation)
+                        {
+                                return (isize - dilation * (ksize - 1) - 1) / stride + 1;
+                        }
+
+                        ///
+                        /// \brief unfold the input planes: xdata = im2col(idata)
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tsize,
+                                typename tmatrixx
+                        >
+                        void unfold(const ttensori& idata, tsize krows, tsize kcols, tsize stride, tsize dilation,
+                                tmatrixx&& xdata)
+                        {
+                                const tsize irows = idata.rows();
+                                const tsize icols = idata.cols();
+                                const tsize orows = osize(irows, krows, stride, dilation);
+                                const tsize ocols = osize(icols, kcols, stride, dilation);
+
+                                assert(static_cast<tsize>(xdata.rows()) == idata.dims() * krows * kcols);
+                                assert(static_cast<tsize>(xdata.cols()) == orows * ocols);
+
+                                auto pxdata = xdata.data();
+                                for (decltype(idata.dims()) i = 0; i < idata.dims(); i ++)
+                                {
+                                        const auto pidata = idata.planeData(i);
+
+                                        for (tsize kr = 0; kr < krows; kr ++)
+                                        {
+                                                for (tsize kc = 0; kc < kcols; kc ++)
+                                                {
+                                                        for (tsize r = 0; r < orows; r ++, pxdata += ocols)
+                                                        {
+                                                                const auto prow = pidata +
+                                                                        (r * stride + kr * dilation) * icols + kc * dilation;
+
+                                                                if (stride == 1)
+                                                                {
+                                                                        std::copy(prow, prow + ocols, pxdata);
+                                                                }
+                                                                else
+                                                                {
+                                                                        for (tsize c = 0; c < ocols; c ++)
+                                                                        {
+                                                                                pxdata[c] = prow[c * stride];
+                                                                        }
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                }
+                        }
+
+                        ///
+                        /// \brief fold back (by summation) the unfolded input planes: gidata = col2im(xdata)
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tsize,
+                                typename tmatrixx
+                        >
+                        void fold(ttensori&& gidata, tsize krows, tsize kcols, tsize stride, tsize dilation,
+                                const tmatrixx& xdata)
+                        {
+                                const tsize irows = gidata.rows();
+                                const tsize icols = gidata.cols();
+                                const tsize orows = osize(irows, krows, stride, dilation);
+                                const tsize ocols = osize(icols, kcols, stride, dilation);
+
+                                assert(static_cast<tsize>(xdata.rows()) == gidata.dims() * krows * kcols);
+                                assert(static_cast<tsize>(xdata.cols()) == orows * ocols);
+
+                                gidata.setZero();
+
+                                auto pxdata = xdata.data();
+                                for (decltype(gidata.dims()) i = 0; i < gidata.dims(); i ++)
+                                {
+                                        const auto pidata = gidata.planeData(i);
+
+                                        for (tsize kr = 0; kr < krows; kr ++)
+                                        {
+                                                for (tsize kc = 0; kc < kcols; kc ++)
+                                                {
+                                                        for (tsize r = 0; r < orows; r ++, pxdata += ocols)
+                                                        {
+                                                                const auto prow = pidata +
+                                                                        (r * stride + kr * dilation) * icols + kc * dilation;
+
+                                                                for (tsize c = 0; c < ocols; c ++)
+                                                                {
+                                                                        prow[c * stride] += pxdata[c];
+                                                                }
+                                                        }
+                                                }
+                                        }
+                                }
+                        }
+
+                        ///
+                        /// \brief map the convolution kernels as a matrix: odims x (idims x krows x kcols)
+                        ///
+                        template
+                        <
+                                typename ttensork,
+                                typename tsize
+                        >
+                        decltype(auto) kmatrix(ttensork&& kdata, tsize odims)
+                        {
+                                return tensor::map_matrix(kdata.data(), odims, kdata.size() / odims);
+                        }
+
+                        ///
+                        /// \brief map the output planes as a matrix: odims x (orows x ocols)
+                        ///
+                        template
+                        <
+                                typename ttensoro
+                        >
+                        decltype(auto) omatrix(ttensoro&& odata)
+                        {
+                                return tensor::map_matrix(odata.data(), odata.dims(), odata.planeSize());
+                        }
+
+                        ///
+                        /// \brief convolution output (xdata is the buffer of the unfolded input)
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename ttensork,
+                                typename tsize,
+                                typename tmatrixx,
+                                typename ttensoro
+                        >
+                        void output(const ttensori& idata, const ttensork& kdata, tsize stride, tsize dilation,
+                                tmatrixx&& xdata, ttensoro&& odata)
+                        {
+                                unfold(idata, static_cast<tsize>(kdata.rows()), static_cast<tsize>(kdata.cols()),
+                                       stride, dilation, xdata);
+
+                                omatrix(odata).noalias() = kmatrix(kdata, odata.dims()) * xdata;
+                        }
+
+                        ///
+                        /// \brief gradient wrt the input (xdata is the buffer of the unfolded input gradient)
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename ttensork,
+                                typename tsize,
+                                typename tmatrixx,
+                                typename ttensoro
+                        >
+                        void ginput(ttensori&& gidata, const ttensork& kdata, tsize stride, tsize dilation,
+                                tmatrixx&& xdata, const ttensoro& odata)
+                        {
+                                xdata.noalias() = kmatrix(kdata, odata.dims()).transpose() * omatrix(odata);
+
+                                fold(gidata, static_cast<tsize>(kdata.rows()), static_cast<tsize>(kdata.cols()),
+                                     stride, dilation, xdata);
+                        }
+
+                        ///
+                        /// \brief gradient wrt the parameters (xdata is the unfolded input from the last ::output call)
+                        ///
+                        template
+                        <
+                                typename tmatrixx,
+                                typename ttensork,
+                                typename ttensoro
+                        >
+                        void gparam(const tmatrixx& xdata, ttensork&& gkdata, const ttensoro& odata)
+                        {
+                                kmatrix(gkdata, odata.dims()).noalias() = omatrix(odata) * xdata.transpose();
+                        }
+                }
+        }
+}
@@ -0,0 +1,122 @@
+#include "convolution_tuning.h"
+#include "layer_convolution.h"
+#include "nanocv/logger.h"
+#include "nanocv/thread/thread.h"
+#include "nanocv/text/algorithms.h"
+#include "nanocv/text/from_string.hpp"
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <map>
+
+namespace ncv
+{
+        namespace
+        {
+                string_t cache_path()
+                {
+                        const char* path = std::getenv("NANOCV_TUNING_CACHE");
+                        if (path)
+                        {
+                                return path;
+                        }
+
+                        const char* home = std::getenv("HOME");
+                        if (home)
+                        {
+                                return string_t(home) + "/.nanocv/conv_tuning.txt";
+                        }
+
+                        return string_t();
+                }
+
+                struct cache_t
+                {
+                        cache_t()
+                                :       m_cpu(ncv::cpu_model()),
+                                        m_path(cache_path())
+                        {
+                                std::ifstream in(m_path.c_str());
+
+                                string_t line;
+                                while (std::getline(in, line))
+                                {
+                                        const strings_t tokens = text::split(line, "\t");
+                                        if (tokens.size() == 3 && tokens[0] == m_cpu)
+                                        {
+                                                if (valid(tokens[2]))
+                                                {
+                                                        m_methods[tokens[1]] = tokens[2];
+                                                }
+                                                else
+                                                {
+                                                        log_warning() << "convolution layer: ignoring the invalid tuning result <"
+                                                                      << tokens[2] << "> from <" << m_path << ">!";
+                                                }
+                                        }
+                                }
+                        }
+
+                        // check if the method is a concrete convolution method (e.g. not corrupted)
+                        static bool valid(const string_t& method)
+                        {
+                                try
+                                {
+                                        const conv_mode mode = text::from_string<conv_mode>(method);
+                                        return mode != conv_mode::automatic && mode != conv_mode::tune;
+                                }
+                                catch (std::exception&)
+                                {
+                                        return false;
+                                }
+                        }
+
+                        std::mutex                      m_mutex;
+                        string_t                        m_cpu;          ///< CPU model
+                        string_t                        m_path;         ///< cache file
+                        std::map<string_t, string_t>    m_methods;      ///< tuned method for each shape
+                };
+
+                cache_t& get_cache()
+                {
+                        static cache_t cache;
+                        return cache;
+                }
+        }
+
+        string_t convolution::find_tuning(const string_t& shape, const std::function<string_t()>& tuner)
+        {
+                cache_t& cache = get_cache();
+                const std::lock_guard<std::mutex> lock(cache.m_mutex);
+
+                const auto it = cache.m_methods.find(shape);
+                if (it != cache.m_methods.end())
+                {
+                        return it->second;
+                }
+
+                const string_t method = tuner();
+                cache.m_methods[shape] = method;
+
+                if (cache.m_path.empty())
+                {
+                        return method;
+                }
+
+                boost::system::error_code ec;
+                const boost::filesystem::path dir = boost::filesystem::path(cache.m_path).parent_path();
+                if (!dir.empty())
+                {
+                        boost::filesystem::create_directories(dir, ec);
+                }
+
+                std::ofstream out(cache.m_path.c_str(), std::ios::app);
+                if (!(out << cache.m_cpu << "\t" << shape << "\t" << method << std::endl))
+                {
+                        log_warning() << "convolution layer: cannot store the tuning results to <" << cache.m_path << ">!";
+                }
+
+                return method;
+        }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "nanocv/string.h"
+#include <functional>
+
+namespace ncv
+{
+        namespace convolution
+        {
+                ///
+                /// \brief persistent cache of the fastest convolution method for each layer shape & CPU model,
+                ///     stored as a text file with one <CPU model> TAB <shape> TAB <method> line per entry
+                ///     (the shape key includes the scalar size & the SIMD instruction set as well):
+                ///     * $NANOCV_TUNING_CACHE, if set
+                ///     * $HOME/.nanocv/conv_tuning.txt, otherwise
+                ///
+                /// NB: the results are kept only in memory if the file cannot be written.
+                ///
+
+                ///
+                /// \brief retrieve the tuned method for the given shape (on the current CPU),
+                ///     otherwise run the given tuner & store its result
+                ///
+                /// NB: the cache stays locked while tuning, so that each shape is tuned only once
+                ///     and the timings are not disturbed by other shapes being tuned concurrently.
+                ///
+                string_t find_tuning(const string_t& shape, const std::function<string_t()>& tuner);
+        }
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "nanocv/math/winograd.hpp"
+#include <cassert>
+#include <cstddef>
+
+namespace ncv
+{
+        namespace convolution
+        {
+                ///
+                /// \brief convolution using the Winograd F(m x m, r x r) minimal filtering algorithm,
+                ///     such that the products between the input and the output planes are computed
+                ///     in the transformed domain with a matrix product for each of the (m + r - 1)^2 coefficients:
+                ///
+                ///     wkdata: (m + r - 1)^2 x odims x idims transformed kernels
+                ///     xdata:  (m + r - 1)^2 x idims x #tiles transformed input tiles
+                ///     wodata: (m + r - 1)^2 x odims x #tiles transformed output tiles = wkdata * xdata
+                ///
+                /// NB: only 3x3 (m = 2 or 4) and 5x5 (m = 2) kernels are supported.
+                ///
+                namespace winograd
+                {
+                        ///
+                        /// \brief check if the kernel size is supported
+                        ///
+                        template
+                        <
+                                typename tsize
+                        >
+                        bool supported(tsize krows, tsize kcols)
+                        {
+                                return krows == kcols && (krows == 3 || krows == 5);
+                        }
+
+                        ///
+                        /// \brief output tile size (m) for the given kernel & output sizes
+                        ///
+                        template
+                        <
+                                typename tsize
+                        >
+                        tsize tile(tsize ksize, tsize orows, tsize ocols)
+                        {
+                                return (ksize == 3 && orows >= 4 && ocols >= 4) ? 4 : 2;
+                        }
+
+                        ///
+                        /// \brief number of output tiles
+                        ///
+                        template
+                        <
+                                typename tsize
+                        >
+                        tsize tiles(tsize tile, tsize orows, tsize ocols)
+                        {
+                                return ((orows + tile - 1) / tile) * ((ocols + tile - 1) / tile);
+                        }
+
+                        ///
+                        /// \brief run the (independent) iterations of a loop sequentially: op(0), op(1), ..., op(n - 1)
+                        ///     (NB: e.g. a thread pool can be used instead to split the planes between threads)
+                        ///
+                        struct sequential_t
+                        {
+                                template
+                                <
+                                        typename toperator
+                                >
+                                void operator()(std::size_t n, const toperator& op) const
+                                {
+                                        for (std::size_t i = 0; i < n; i ++)
+                                        {
+                                                op(i);
+                                        }
+                                }
+                        };
+
+                        namespace detail
+                        {
+                                template
+                                <
+                                        int tm,
+                                        int tr,
+                                        typename ttensork,
+                                        typename tsize,
+                                        typename ttensorw,
+                                        typename tscalar = typename ttensork::Scalar
+                                >
+                                void kernels(const ttensork& kdata, tsize odims, ttensorw& wkdata, ttensorw& wgkdata)
+                                {
+                                        const math::winograd::transform_t<tscalar, tm, tr> transform;
+
+                                        const auto idims = kdata.dims() / odims;
+                                        for (tsize o = 0, k = 0; o < odims; o ++)
+                                        {
+                                                for (tsize i = 0; i < idims; i ++, k ++)
+                                                {
+                                                        const auto kmap = kdata.matrix(k);
+
+                                                        // output: correlation with the kernel
+                                                        const auto udata = transform.kernel(kmap);
+                                                        for (auto x = 0; x < udata.size(); x ++)
+                                                        {
+                                                                wkdata.matrix(x)(o, i) = udata.data()[x];
+                                                        }
+
+                                                        // gradient wrt input: correlation with the 180-degrees rotated kernel
+                                                        const auto gudata = transform.kernel(kmap.reverse());
+                                                        for (auto x = 0; x < gudata.size(); x ++)
+                                                        {
+                                                                wgkdata.matrix(x)(i, o) = gudata.data()[x];
+                                                        }
+                                                }
+                                        }
+                                }
+
+                                template
+                                <
+                                        int tm,
+                                        int tr,
+                                        typename ttensori,
+                                        typename ttensorw,
+                                        typename ttensoro,
+                                        typename tloop,
+                                        typename tscalar = typename ttensori::Scalar
+                                >
+                                void correlate(const ttensori& idata, int pad, const ttensorw& wkdata,
+                                        ttensorw& xdata, ttensorw& wodata, ttensoro& odata, const tloop& loop)
+                                {
+                                        typedef math::winograd::transform_t<tscalar, tm, tr> transform_t;
+                                        typedef typename transform_t::tmatrix_a tmatrix_a;
+
+                                        const transform_t transform;
+
+                                        const auto irows = static_cast<int>(idata.rows());
+                                        const auto icols = static_cast<int>(idata.cols());
+                                        const auto orows = static_cast<int>(odata.rows());
+                                        const auto ocols = static_cast<int>(odata.cols());
+                                        const auto trows = (orows + tm - 1) / tm;
+                                        const auto tcols = (ocols + tm - 1) / tm;
+                                        const auto ntiles = trows * tcols;
+
+                                        assert(xdata.dims() == transform_t::a * transform_t::a);
+                                        assert(static_cast<int>(xdata.rows()) == static_cast<int>(idata.dims()));
+                                        assert(static_cast<int>(xdata.cols()) == ntiles);
+                                        assert(static_cast<int>(wodata.rows()) == static_cast<int>(odata.dims()));
+                                        assert(static_cast<int>(wodata.cols()) == ntiles);
+
+                                        // NB: each step writes disjoint parts of the buffers for each iteration
+
+                                        // transform the input tiles
+                                        loop(static_cast<std::size_t>(idata.dims()), [&] (std::size_t i)
+                                        {
+                                                tmatrix_a ddata;
+                                                for (int tr_ = 0, t = 0; tr_ < trows; tr_ ++)
+                                                {
+                                                        for (int tc_ = 0; tc_ < tcols; tc_ ++, t ++)
+                                                        {
+                                                                transform_t::load(idata.planeData(i), irows, icols,
+                                                                        tr_ * tm - pad, tc_ * tm - pad, ddata);
+
+                                                                const tmatrix_a vdata = transform.input(ddata);
+                                                                for (auto x = 0; x < vdata.size(); x ++)
+                                                                {
+                                                                        xdata.planeData(x)[i * ntiles + t] = vdata.data()[x];
+                                                                }
+                                                        }
+                                                }
+                                        });
+
+                                        // accumulate the input planes in the transformed domain
+                                        loop(static_cast<std::size_t>(xdata.dims()), [&] (std::size_t x)
+                                        {
+                                                wodata.matrix(x).noalias() = wkdata.matrix(x) * xdata.matrix(x);
+                                        });
+
+                                        // inverse transform the output tiles
+                                        loop(static_cast<std::size_t>(odata.dims()), [&] (std::size_t o)
+                                        {
+                                                tmatrix_a mdata;
+                                                typename transform_t::tile_t ydata;
+
+                                                auto omap = odata.matrix(o);
+                                                for (int tr_ = 0, t = 0; tr_ < trows; tr_ ++)
+                                                {
+                                                        for (int tc_ = 0; tc_ < tcols; tc_ ++, t ++)
+                                                        {
+                                                                for (auto x = 0; x < mdata.size(); x ++)
+                                                                {
+                                                                        mdata.data()[x] = wodata.planeData(x)[o * ntiles + t];
+                                                                }
+
+                                                                transform.output(mdata, ydata);
+
+                                                                const int r = tr_ * tm, mrows = std::min(tm, orows - r);
+                                                                const int c = tc_ * tm, mcols = std::min(tm, ocols - c);
+                                                                omap.block(r, c, mrows, mcols) = ydata.map().topLeftCorner(mrows, mcols);
+                                                        }
+                                                }
+                                        });
+                                }
+                        }
+
+                        ///
+                        /// \brief transform the kernels (to be called each time the parameters are changed):
+                        ///     wkdata for computing the output and wgkdata for computing the gradient wrt the input
+                        ///
+                        template
+                        <
+                                typename ttensork,
+                                typename tsize,
+                                typename ttensorw
+                        >
+                        void kernels(const ttensork& kdata, tsize odims, tsize tile, ttensorw& wkdata, ttensorw& wgkdata)
+                        {
+                                assert(supported(kdata.rows(), kdata.cols()));
+
+                                if (kdata.rows() == 5)
+                                {
+                                        detail::kernels<2, 5>(kdata, odims, wkdata, wgkdata);
+                                }
+                                else if (tile == 4)
+                                {
+                                        detail::kernels<4, 3>(kdata, odims, wkdata, wgkdata);
+                                }
+                                else
+                                {
+                                        detail::kernels<2, 3>(kdata, odims, wkdata, wgkdata);
+                                }
+                        }
+
+                        ///
+                        /// \brief convolution output
+                        ///     (xdata & wodata are the buffers of the transformed input & output tiles)
+                        ///
+                        /// NB: the planes are processed using the given loop, see sequential_t.
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tsize,
+                                typename ttensorw,
+                                typename ttensoro,
+                                typename tloop = sequential_t
+                        >
+                        void output(const ttensori& idata, tsize ksize, tsize tile, const ttensorw& wkdata,
+                                ttensorw& xdata, ttensorw& wodata, ttensoro& odata, const tloop& loop = tloop())
+                        {
+                                assert(supported(ksize, ksize));
+
+                                if (ksize == 5)
+                                {
+                                        detail::correlate<2, 5>(idata, 0, wkdata, xdata, wodata, odata, loop);
+                                }
+                                else if (tile == 4)
+                                {
+                                        detail::correlate<4, 3>(idata, 0, wkdata, xdata, wodata, odata, loop);
+                                }
+                                else
+                                {
+                                        detail::correlate<2, 3>(idata, 0, wkdata, xdata, wodata, odata, loop);
+                                }
+                        }
+
+                        ///
+                        /// \brief gradient wrt the input: the full correlation of the output with the rotated kernels
+                        ///     (gxdata & wgodata are the buffers of the transformed output & input tiles)
+                        ///
+                        template
+                        <
+                                typename ttensori,
+                                typename tsize,
+                                typename ttensorw,
+                                typename ttensoro
+                        >
+                        void ginput(ttensori& gidata, tsize ksize, tsize tile, const ttensorw& wgkdata,
+                                ttensorw& gxdata, ttensorw& wgodata, const ttensoro& odata)
+                        {
+                                assert(supported(ksize, ksize));
+
+                                const int pad = static_cast<int>(ksize) - 1;
+                                if (ksize == 5)
+                                {
+                                        detail::correlate<2, 5>(odata, pad, wgkdata, gxdata, wgodata, gidata, sequential_t());
+                                }
+                                else if (tile == 4)
+                                {
+                                        detail::correlate<4, 3>(odata, pad, wgkdata, gxdata, wgodata, gidata, sequential_t());
+                                }
+                                else
+                                {
+                                        detail::correlate<2, 3>(odata, pad, wgkdata, gxdata, wgodata, gidata, sequential_t());
+                                }
+                        }
+                }
+        }
+}
@@ -2,6 +2,8 @@
 
 #include "nanocv/layer.h"
 #include "nanocv/tensor/transform.hpp"
+#include "nanocv/tensor/blocked.hpp"
+#include "nanocv/thread/loopit.hpp"
 
 namespace ncv
 {
@@ -23,7 +25,9 @@ namespace ncv
 
                 // constructor
                 explicit activation_layer_t(const string_t& parameters)
-                        :       layer_t(parameters)
+                        :       layer_t(parameters),
+                                m_block(0),
+                                m_unblock(false)
                 {
                 }
 
@@ -53,6 +57,22 @@ namespace ncv
                 virtual const tensor_t& ginput(const tensor_t& output) override { return _ginput(output); }
                 virtual void gparam(const tensor_t& output, scalar_t*) override { return _gparam(output); }
 
+                // process inputs plane by plane
+                virtual const tensor_t& output_plane(const tensor_t& input, size_t o) override { return _output_plane(input, o); }
+                virtual bool planewise() const override { return true; }
+
+                // process inputs using the channel-blocked layout (coefficient-wise, so any layout works)
+                virtual const tensor_t& output_blocked(const tensor_t& input, size_t block) override { return _output_blocked(input, block); }
+                virtual bool blockable() const override { return true; }
+
+                // process inputs using multiple threads (tiles of consecutive coefficients)
+                virtual const tensor_t& output_parallel(const tensor_t& input, size_t nthreads) override { return _output_parallel(input, nthreads); }
+
+                // process a batch of samples
+                virtual const tensor_t& output(const tensor_t& inputs, size_t count) override { return _output(inputs, count); }
+                virtual const tensor_t& ginput(const tensor_t& outputs, size_t count) override { return _ginput(outputs, count); }
+                virtual void gparam(const tensor_t& outputs, size_t count, scalar_t*) override { return _gparam(outputs, count); }
+
                 // access functions
                 virtual size_t idims() const override { return m_data.dims(); }
                 virtual size_t irows() const override { return m_data.rows(); }
@@ -73,6 +93,7 @@ namespace ncv
                 size_t _resize(const tensor_t& tensor)
                 {
                         m_data.resize(tensor.dims(), tensor.rows(), tensor.cols());
+                        m_unblock = false;
 
                         return 0;
                 }
@@ -87,6 +108,70 @@ namespace ncv
                         tensor::transform(input, m_data,
                                           [op = teval_op()] (auto x) { return op(x); });
 
+                        m_unblock = false;
+
+                        return m_data;
+                }
+
+                // output (channel-blocked)
+                const tensor_t& _output_blocked(const tensor_t& input, size_t block)
+                {
+                        assert(tensor::blocks(m_data.dims(), block) == input.dims());
+                        assert(m_data.rows() == input.rows());
+                        assert(m_data.cols() * block == input.cols());
+
+                        m_xdata.resize(input.dims(), input.rows(), input.cols());
+
+                        tensor::transform(input, m_xdata,
+                                          [op = teval_op()] (auto x) { return op(x); });
+
+                        // NB: the planar output is restored only if the gradients are needed
+                        m_block = block;
+                        m_unblock = true;
+
+                        return m_xdata;
+                }
+
+                // output (plane)
+                const tensor_t& _output_plane(const tensor_t& input, size_t o)
+                {
+                        assert(o < m_data.dims());
+                        assert(m_data.dims() == input.dims());
+                        assert(m_data.rows() == input.rows());
+                        assert(m_data.cols() == input.cols());
+
+                        auto omap = m_data.vector(o);
+                        tensor::transform(input.vector(o), omap,
+                                          [op = teval_op()] (auto x) { return op(x); });
+
+                        m_unblock = false;
+
+                        return m_data;
+                }
+
+                // output (multi-threaded)
+                const tensor_t& _output_parallel(const tensor_t& input, size_t nthreads)
+                {
+                        assert(m_data.dims() == input.dims());
+                        assert(m_data.rows() == input.rows());
+                        assert(m_data.cols() == input.cols());
+
+                        // NB: the tiles are large enough to amortize the scheduling overhead
+                        const size_t tile = 1024;
+                        const size_t tiles = (m_data.size() + tile - 1) / tile;
+
+                        thread_loopr(tiles, ncv::get_thread_pool(), nthreads, [&] (size_t begin, size_t end, size_t)
+                        {
+                                const size_t offset = begin * tile;
+                                const size_t size = std::min(end * tile, m_data.size()) - offset;
+
+                                auto omap = m_data.vector().segment(offset, size);
+                                tensor::transform(input.vector().segment(offset, size), omap,
+                                                  [op = teval_op()] (auto x) { return op(x); });
+                        });
+
+                        m_unblock = false;
+
                         return m_data;
                 }
 
@@ -97,6 +182,12 @@ namespace ncv
                         assert(m_data.rows() == output.rows());
                         assert(m_data.cols() == output.cols());
 
+                        if (m_unblock)
+                        {
+                                tensor::unblock(m_xdata, m_data.dims(), m_block, m_data);
+                                m_unblock = false;
+                        }
+
                         tensor::transform(output, m_data, m_data,
                                           [op = tgrad_op()] (auto g, auto o) { return op(g, o); });
 
@@ -113,10 +204,60 @@ namespace ncv
                         assert(m_data.cols() == output.cols());
                 }
 
+                // output (batch)
+                const tensor_t& _output(const tensor_t& inputs, size_t count)
+                {
+                        NANOCV_UNUSED1_RELEASE(count);
+
+                        assert(count * m_data.dims() == inputs.dims());
+                        assert(m_data.rows() == inputs.rows());
+                        assert(m_data.cols() == inputs.cols());
+
+                        m_bodata.resize(inputs.dims(), inputs.rows(), inputs.cols());
+
+                        tensor::transform(inputs, m_bodata,
+                                          [op = teval_op()] (auto x) { return op(x); });
+
+                        return m_bodata;
+                }
+
+                // gradient (batch)
+                const tensor_t& _ginput(const tensor_t& outputs, size_t count)
+                {
+                        NANOCV_UNUSED1_RELEASE(count);
+
+                        assert(count * m_data.dims() == outputs.dims());
+                        assert(m_bodata.dims() == outputs.dims());
+                        assert(m_bodata.rows() == outputs.rows());
+                        assert(m_bodata.cols() == outputs.cols());
+
+                        m_bgidata.resize(outputs.dims(), outputs.rows(), outputs.cols());
+
+                        tensor::transform(outputs, m_bodata, m_bgidata,
+                                          [op = tgrad_op()] (auto g, auto o) { return op(g, o); });
+
+                        return m_bgidata;
+                }
+
+                // gradient (batch)
+                void _gparam(const tensor_t& outputs, size_t count)
+                {
+                        NANOCV_UNUSED2_RELEASE(outputs, count);
+
+                        assert(count * m_data.dims() == outputs.dims());
+                        assert(m_data.rows() == outputs.rows());
+                        assert(m_data.cols() == outputs.cols());
+                }
+
         private:
 
                 // attributes
                 tensor_t                m_data;         ///< input-output buffer
+                tensor_t                m_xdata;        ///< channel-blocked output buffer
+                size_t                  m_block;        ///< number of interleaved planes of the channel-blocked output
+                bool                    m_unblock;      ///< the output buffer must be restored from the channel-blocked output
+                tensor_t                m_bodata;       ///< batch output buffer:       (count x dims) x rows x cols
+                tensor_t                m_bgidata;      ///< batch input gradient:      (count x dims) x rows x cols
         };
 }
 
@@ -2,16 +2,117 @@
 #include "nanocv/text.h"
 #include "nanocv/logger.h"
 #include "convolution.hpp"
+#include "convolution_im2col.hpp"
+#include "convolution_winograd.hpp"
+#include "convolution_fft.hpp"
+#include "convolution_blocked.hpp"
+#include "convolution_tuning.h"
+#include "nanocv/measure.hpp"
 #include "nanocv/math/clamp.hpp"
 #include "nanocv/math/conv2d.hpp"
 #include "nanocv/math/corr2d.hpp"
 #include "nanocv/math/random.hpp"
+#include "nanocv/math/simd.h"
 #include "nanocv/tensor/serialize.hpp"
+#include "nanocv/thread/loopi.hpp"
+#include "nanocv/thread/loopit.hpp"
+#include <limits>
 
 namespace ncv
 {
+        namespace
+        {
+                // the FFT is faster than the direct method starting with this kernel size
+                //      (see ncv_benchmark_conv2d: the input spectra are shared by all output planes)
+                const size_t fft_min_ksize = 5;
+
+                // number of times each method is benchmarked when tuning
+                const size_t tuning_trials = 4;
+
+                // seed of the benchmark data when tuning
+                const std::uint64_t tuning_seed = 42;
+
+                // benchmark the methods (output + gradients) for the given shape & return the fastest one
+                conv_mode tune(const tensor_t& tensor, size_t odims, size_t krows, size_t kcols)
+                {
+                        const string_t shape =
+                                text::to_string(tensor.dims()) + "x" + text::to_string(tensor.rows()) + "x" +
+                                text::to_string(tensor.cols()) + "->" + text::to_string(odims) + "x" +
+                                text::to_string(krows) + "x" + text::to_string(kcols);
+
+                        // NB: the fastest method depends on the scalar type & the vectorized kernels as well
+                        const string_t key = shape +
+                                ":scalar=" + text::to_string(sizeof(scalar_t)) +
+                                ":simd=" + text::to_string(math::simd_best());
+
+                        const string_t method = convolution::find_tuning(key, [&] ()
+                        {
+                                std::vector<conv_mode> modes = { conv_mode::dot, conv_mode::mad, conv_mode::im2col, conv_mode::fft };
+                                if (convolution::winograd::supported(krows, kcols))
+                                {
+                                        modes.push_back(conv_mode::winograd);
+                                }
+
+                                // NB: the benchmark data is generated with a fixed seed,
+                                //      so that the random sequences of the other generators are not altered
+                                random_t<scalar_t> rgen(-1.0, +1.0, tuning_seed);
+
+                                conv_mode best_mode = conv_mode::direct;
+                                size_t best_usec = std::numeric_limits<size_t>::max();
+
+                                for (conv_mode mode : modes)
+                                {
+                                        conv_layer_t layer(
+                                                "dims=" + text::to_string(odims) +
+                                                ",rows=" + text::to_string(krows) +
+                                                ",cols=" + text::to_string(kcols) +
+                                                ",mode=" + text::to_string(mode));
+
+                                        layer.resize(tensor);
+
+                                        tensor_t input(layer.idims(), layer.irows(), layer.icols());
+                                        tensor_t output(layer.odims(), layer.orows(), layer.ocols());
+                                        vector_t params(layer.psize());
+                                        vector_t gradient(layer.psize());
+
+                                        rgen(params.data(), params.data() + params.size());
+                                        rgen(input.data(), input.data() + input.size());
+                                        rgen(output.data(), output.data() + output.size());
+
+                                        layer.load_params(params.data());
+
+                                        const size_t usec = ncv::measure_robustly_usec([&] ()
+                                        {
+                                                layer.output(input);
+                                                layer.gparam(output, gradient.data());
+                                                layer.ginput(output);
+                                        }, tuning_trials);
+
+                                        if (usec < best_usec)
+                                        {
+                                                best_usec = usec;
+                                                best_mode = mode;
+                                        }
+                                }
+
+                                log_info() << "convolution layer: tuned (" << shape << ") -> "
+                                           << text::to_string(best_mode) << " (" << best_usec << "us).";
+
+                                return text::to_string(best_mode);
+                        });
+
+                        return text::from_string<conv_mode>(method);
+                }
+        }
+
         conv_layer_t::conv_layer_t(const string_t& parameters)
-                :       layer_t(parameters)
+                :       layer_t(parameters),
+                        m_mode(conv_mode::automatic),
+                        m_stride(1),
+                        m_dilation(1),
+                        m_wtile(0),
+                        m_block(0),
+                        m_unblock(false)
         {
         }
 
@@ -28,21 +129,25 @@ namespace ncv
                 const size_t odims = math::clamp(text::from_params<size_t>(configuration(), "dims", 16), 1, 256);
                 const size_t krows = math::clamp(text::from_params<size_t>(configuration(), "rows", 8), 1, 32);
                 const size_t kcols = math::clamp(text::from_params<size_t>(configuration(), "cols", 8), 1, 32);
+                const conv_mode mode = text::from_params<conv_mode>(configuration(), "mode", conv_mode::automatic);
+                const size_t stride = math::clamp(text::from_params<size_t>(configuration(), "stride", 1), 1, 8);
+                const size_t dilation = math::clamp(text::from_params<size_t>(configuration(), "dilation", 1), 1, 8);
 
-                // check convolution size
-                if (irows < krows || icols < kcols)
+                // check convolution size (the dilated kernel must fit the input)
+                if (irows < dilation * (krows - 1) + 1 || icols < dilation * (kcols - 1) + 1)
                 {
                         const string_t message =
                                 "invalid size (" + text::to_string(idims) + "x" + text::to_string(irows) +
                                  "x" + text::to_string(icols) + ") -> (" + text::to_string(odims) + "x" +
-                                 text::to_string(krows) + "x" + text::to_string(kcols) + ")";
+                                 text::to_string(krows) + "x" + text::to_string(kcols) + "@" +
+                                 text::to_string(dilation) + ")";
 
                         log_error() << "convolution layer: " << message;
                         throw std::runtime_error("convolution layer: " + message);
                 }
 
-                const size_t orows = irows - krows + 1;
-                const size_t ocols = icols - kcols + 1;
+                const size_t orows = convolution::im2col::osize(irows, krows, stride, dilation);
+                const size_t ocols = convolution::im2col::osize(icols, kcols, stride, dilation);
 
                 // resize buffers
                 m_idata.resize(idims, irows, icols);
@@ -50,6 +155,96 @@ namespace ncv
                 m_kdata.resize(odims * idims, krows, kcols);
                 m_bdata.resize(odims, 1, 1);
 
+                m_stride = stride;
+                m_dilation = dilation;
+
+                m_mode = mode;
+                if (m_stride > 1 || m_dilation > 1)
+                {
+                        // only the unfolded input matrix skips the discarded output pixels
+                        m_mode = conv_mode::im2col;
+                }
+                if (m_mode == conv_mode::automatic)
+                {
+                        m_mode = std::min(krows, kcols) >= fft_min_ksize ? conv_mode::fft : conv_mode::direct;
+                }
+                if (m_mode == conv_mode::tune)
+                {
+                        m_mode = tune(tensor, odims, krows, kcols);
+                }
+                if (m_mode == conv_mode::winograd && !convolution::winograd::supported(krows, kcols))
+                {
+                        m_mode = conv_mode::direct;
+                }
+
+                m_wtile = 0;
+                m_wkdata.resize(0, 0, 0);
+                m_wgkdata.resize(0, 0, 0);
+                m_wodata.resize(0, 0, 0);
+                m_wgidata.resize(0, 0, 0);
+
+                m_fplan = math::fft2d_t<scalar_t>();
+                m_fkdata.resize(0, 0, 0);
+                m_fwdata.resize(0, 0, 0);
+                m_fplans.clear();
+
+                m_block = 0;
+                m_unblock = false;
+                m_pkdata.resize(0, 0, 0);
+                m_pbdata.resize(0, 0, 0);
+
+                switch (m_mode)
+                {
+                case conv_mode::im2col:
+                        m_xdata.resize(1, idims * krows * kcols, orows * ocols);
+                        m_gxdata.resize(1, idims * krows * kcols, orows * ocols);
+                        break;
+
+                case conv_mode::winograd:
+                        {
+                                m_wtile = convolution::winograd::tile(krows, orows, ocols);
+
+                                const size_t coeffs = (m_wtile + krows - 1) * (m_wtile + kcols - 1);
+                                const size_t otiles = convolution::winograd::tiles(m_wtile, orows, ocols);
+                                const size_t itiles = convolution::winograd::tiles(m_wtile, irows, icols);
+
+                                m_wkdata.resize(coeffs, odims, idims);
+                                m_wgkdata.resize(coeffs, idims, odims);
+                                m_xdata.resize(coeffs, idims, otiles);
+                                m_wodata.resize(coeffs, odims, otiles);
+                                m_gxdata.resize(coeffs, odims, itiles);
+                                m_wgidata.resize(coeffs, idims, itiles);
+                        }
+                        break;
+
+                case conv_mode::fft:
+                        {
+                                m_fplan = math::fft2d_t<scalar_t>(math::fft_size(irows), math::fft_size(icols));
+
+                                const size_t frows = m_fplan.rows();
+                                const size_t fcols = 2 * m_fplan.cols();
+
+                                m_fkdata.resize(odims * idims, frows, fcols);
+                                m_fwdata.resize(1, frows, fcols);
+                                m_xdata.resize(idims, frows, fcols);
+                                m_gxdata.resize(odims, frows, fcols);
+                        }
+                        break;
+
+                case conv_mode::blocked:
+                        m_block = layer_block_size();
+                        m_xdata.resize(tensor::blocks(idims, m_block), irows, icols * m_block);
+                        m_xodata.resize(tensor::blocks(odims, m_block), orows, ocols * m_block);
+                        m_gxdata.resize(0, 0, 0);
+                        break;
+
+                case conv_mode::direct:
+                default:
+                        m_xdata.resize(0, 0, 0);
+                        m_gxdata.resize(0, 0, 0);
+                        break;
+                }
+
                 return psize();
         }
 
@@ -57,12 +252,16 @@ namespace ncv
         {
                 m_kdata.setZero();
                 m_bdata.setZero();
+
+                transform_params();
         }
 
         void conv_layer_t::random_params(scalar_t min, scalar_t max)
         {
                 m_kdata.setRandom(random_t<scalar_t>(min, max));
                 m_bdata.setRandom(random_t<scalar_t>(min, max));
+
+                transform_params();
         }
 
         scalar_t* conv_layer_t::save_params(scalar_t* params) const
@@ -78,9 +277,33 @@ namespace ncv
                 params = tensor::load(m_kdata, params);
                 params = tensor::load(m_bdata, params);
 
+                transform_params();
+
                 return params;
         }
 
+        void conv_layer_t::transform_params()
+        {
+                // the kernels are transformed only once per parameter update (and not for each sample)
+                switch (m_mode)
+                {
+                case conv_mode::winograd:
+                        convolution::winograd::kernels(m_kdata, odims(), m_wtile, m_wkdata, m_wgkdata);
+                        break;
+
+                case conv_mode::fft:
+                        convolution::fft::kernels(m_kdata, m_fplan, m_fkdata);
+                        break;
+
+                case conv_mode::blocked:
+                        convolution::blocked::kernels(m_kdata, m_bdata, odims(), m_block, m_pkdata, m_pbdata);
+                        break;
+
+                default:
+                        break;
+                }
+        }
+
         boost::archive::binary_oarchive& conv_layer_t::save(boost::archive::binary_oarchive& oa) const
         {
                 return oa << m_kdata << m_bdata;
@@ -88,7 +311,11 @@ namespace ncv
 
         boost::archive::binary_iarchive& conv_layer_t::load(boost::archive::binary_iarchive& ia)
         {
-                return ia >> m_kdata >> m_bdata;
+                ia >> m_kdata >> m_bdata;
+
+                transform_params();
+
+                return ia;
         }
 
         size_t conv_layer_t::psize() const
@@ -103,18 +330,231 @@ namespace ncv
                 assert(icols() == input.cols());
 
                 m_idata = input;
+                m_unblock = false;
 
-                // convolution
-                convolution::output(m_idata, m_kdata, m_odata);
+                _output(0);
 
-                // +bias
-                for (size_t o = 0; o < odims(); o ++)
+                return m_odata;
+        }
+
+        const tensor_t& conv_layer_t::output_blocked(const tensor_t& input, size_t block)
+        {
+                assert(tensor::blocks(idims(), block) == input.dims());
+                assert(irows() == input.rows());
+                assert(icols() * block == input.cols());
+
+                if (m_mode != conv_mode::blocked || m_block != block)
+                {
+                        // NB: not processed natively, so convert the input & the output
+                        tensor::unblock(input, idims(), block, m_idata);
+                        m_unblock = false;
+
+                        _output(0);
+
+                        tensor::block(m_odata, block, m_xodata);
+                }
+
+                else
                 {
+                        // NB: the planar input is restored only if the gradients are needed
+                        m_xdata = input;
+                        m_unblock = true;
+
+                        convolution::blocked::output(m_xdata, idims(), m_block, m_pkdata, m_pbdata,
+                                krows(), kcols(), orows(), ocols(), m_xodata);
+                }
+
+                return m_xodata;
+        }
+
+        const tensor_t& conv_layer_t::output_parallel(const tensor_t& input, size_t nthreads)
+        {
+                assert(idims() == input.dims());
+                assert(irows() == input.rows());
+                assert(icols() == input.cols());
+
+                m_idata = input;
+                m_unblock = false;
+
+                thread_pool_t& pool = ncv::get_thread_pool();
+
+                switch (m_mode)
+                {
+                case conv_mode::direct:
+                case conv_mode::dot:
+                case conv_mode::mad:
+                        thread_loopi(odims(), pool, nthreads, [&] (size_t o)
+                        {
+                                switch (m_mode)
+                                {
+                                case conv_mode::dot:
+                                        convolution::output_plane(m_idata, m_kdata, o, m_odata, convolution::conv_dot_t());
+                                        break;
+
+                                case conv_mode::mad:
+                                        convolution::output_plane(m_idata, m_kdata, o, m_odata, convolution::conv_mad_t());
+                                        break;
+
+                                default:
+                                        convolution::output_plane(m_idata, m_kdata, o, m_odata);
+                                        break;
+                                }
+
+                                m_odata.vector(o).array() += m_bdata(o);
+                        });
+                        break;
+
+                case conv_mode::im2col:
+                        {
+                                // NB: the input is unfolded once, then the matrix product is split by output planes
+                                auto xmap = m_xdata.matrix(0);
+                                convolution::im2col::unfold(m_idata, krows(), kcols(), m_stride, m_dilation, xmap);
+
+                                const auto kmap = convolution::im2col::kmatrix(m_kdata, odims());
+                                auto omap = convolution::im2col::omatrix(m_odata);
+
+                                thread_loopr(odims(), pool, nthreads, [&] (size_t begin, size_t end, size_t)
+                                {
+                                        omap.middleRows(begin, end - begin).noalias() =
+                                                kmap.middleRows(begin, end - begin) * xmap;
+
+                                        for (size_t o = begin; o < end; o ++)
+                                        {
+                                                m_odata.vector(o).array() += m_bdata(o);
+                                        }
+                                });
+                        }
+                        break;
+
+                case conv_mode::blocked:
+                        tensor::block(m_idata, m_block, m_xdata);
+                        thread_loopr(m_xodata.dims(), pool, nthreads, [&] (size_t begin, size_t end, size_t)
+                        {
+                                convolution::blocked::output_groups(m_xdata, idims(), m_block, m_pkdata, m_pbdata,
+                                        krows(), kcols(), begin, end, m_xodata);
+                        });
+                        tensor::unblock(m_xodata, odims(), m_block, m_odata);
+                        break;
+
+                case conv_mode::winograd:
+                        convolution::winograd::output(m_idata, krows(), m_wtile, m_wkdata, m_xdata, m_wodata, m_odata,
+                                [&] (size_t n, const auto& op)
+                                {
+                                        thread_loopi(n, pool, nthreads, op);
+                                });
+
+                        for (size_t o = 0; o < odims(); o ++)
+                        {
+                                m_odata.vector(o).array() += m_bdata(o);
+                        }
+                        break;
+
+                case conv_mode::fft:
+                        {
+                                // NB: the FFT plans & the spectrum buffers are not shared between tasks
+                                const size_t ntasks = pool.concurrency(nthreads);
+                                if (m_fplans.size() < ntasks)
+                                {
+                                        m_fplans.resize(ntasks, m_fplan);
+                                }
+                                if (m_fwdata.dims() < ntasks)
+                                {
+                                        m_fwdata.resize(ntasks, m_fwdata.rows(), m_fwdata.cols());
+                                }
+
+                                auto fidata = tensor::map_tensor(m_xdata.data(), idims(), m_xdata.rows(), m_xdata.cols());
+                                thread_loopr(idims(), pool, nthreads, [&] (size_t begin, size_t end, size_t t)
+                                {
+                                        for (size_t i = begin; i < end; i ++)
+                                        {
+                                                m_fplans[t].forward(m_idata.matrix(i), convolution::fft::spectrum(fidata, i));
+                                        }
+                                });
+
+                                thread_loopr(odims(), pool, nthreads, [&] (size_t begin, size_t end, size_t t)
+                                {
+                                        auto fwdata = tensor::map_tensor(m_fwdata.planeData(t), size_t(1), m_fwdata.rows(), m_fwdata.cols());
+                                        for (size_t o = begin; o < end; o ++)
+                                        {
+                                                convolution::fft::output_plane(m_fplans[t], m_fkdata, fidata, fwdata, o, m_odata);
+                                                m_odata.vector(o).array() += m_bdata(o);
+                                        }
+                                });
+                        }
+                        break;
+
+                default:
+                        _output(0);
+                        break;
+                }
+
+                return m_odata;
+        }
+
+        void conv_layer_t::unblock()
+        {
+                if (m_unblock)
+                {
+                        tensor::unblock(m_xdata, idims(), m_block, m_idata);
+                        m_unblock = false;
+                }
+        }
+
+        const tensor_t& conv_layer_t::output_plane(const tensor_t& input, size_t o)
+        {
+                assert(o < odims());
+
+                if (o == 0)
+                {
+                        assert(idims() == input.dims());
+                        assert(irows() == input.rows());
+                        assert(icols() == input.cols());
+
+                        m_idata = input;
+                        m_unblock = false;
+                }
+
+                switch (m_mode)
+                {
+                case conv_mode::fft:
+                        {
+                                auto fidata = tensor::map_tensor(m_xdata.data(), idims(), m_xdata.rows(), m_xdata.cols());
+                                if (o == 0)
+                                {
+                                        convolution::fft::spectra(m_idata, m_fplan, fidata);
+                                }
+
+                                convolution::fft::output_plane(m_fplan, m_fkdata, fidata, m_fwdata, o, m_odata);
+                                m_odata.vector(o).array() += m_bdata(o);
+                        }
+                        break;
+
+                case conv_mode::direct:
+                        convolution::output_plane(m_idata, m_kdata, o, m_odata);
+                        m_odata.vector(o).array() += m_bdata(o);
+                        break;
+
+                case conv_mode::dot:
+                        convolution::output_plane(m_idata, m_kdata, o, m_odata, convolution::conv_dot_t());
                         m_odata.vector(o).array() += m_bdata(o);
+                        break;
+
+                case conv_mode::mad:
+                        convolution::output_plane(m_idata, m_kdata, o, m_odata, convolution::conv_mad_t());
+                        m_odata.vector(o).array() += m_bdata(o);
+                        break;
+
+                default:
+                        // the matrix product (im2col) & the Winograd transform produce all output planes at once
+                        if (o == 0)
+                        {
+                                _output(0);
+                        }
+                        break;
                 }
 
                 return m_odata;
-        }        
+        }
 
         const tensor_t& conv_layer_t::ginput(const tensor_t& output)
         {
@@ -122,9 +562,11 @@ namespace ncv
                 assert(orows() == output.rows());
                 assert(ocols() == output.cols());
 
+                unblock();
+
                 m_odata = output;
-                
-                convolution::ginput(m_idata, m_kdata, m_odata);
+
+                _ginput();
 
                 return m_idata;
         }
@@ -135,10 +577,198 @@ namespace ncv
                 assert(orows() == output.rows());
                 assert(ocols() == output.cols());
 
+                unblock();
+
                 m_odata = output;
-                
+
+                _gparam(0, gradient);
+        }
+
+        const tensor_t& conv_layer_t::output(const tensor_t& inputs, size_t count)
+        {
+                assert(count * idims() == inputs.dims());
+                assert(irows() == inputs.rows());
+                assert(icols() == inputs.cols());
+
+                m_bidata = inputs;
+                m_bodata.resize(count * odims(), orows(), ocols());
+                m_unblock = false;
+
+                // keep the transformed inputs of all samples (as required by the parameter gradient)
+                switch (m_mode)
+                {
+                case conv_mode::im2col:
+                        m_xdata.resize(count, m_xdata.rows(), m_xdata.cols());
+                        break;
+
+                case conv_mode::fft:
+                        m_xdata.resize(count * idims(), m_xdata.rows(), m_xdata.cols());
+                        break;
+
+                default:
+                        break;
+                }
+
+                for (size_t s = 0; s < count; s ++)
+                {
+                        m_idata.vector() = m_bidata.vector().segment(s * m_idata.size(), m_idata.size());
+
+                        _output(s);
+
+                        m_bodata.vector().segment(s * m_odata.size(), m_odata.size()) = m_odata.vector();
+                }
+
+                return m_bodata;
+        }
+
+        const tensor_t& conv_layer_t::ginput(const tensor_t& outputs, size_t count)
+        {
+                assert(count * odims() == outputs.dims());
+                assert(orows() == outputs.rows());
+                assert(ocols() == outputs.cols());
+
+                m_bgidata.resize(count * idims(), irows(), icols());
+
+                for (size_t s = 0; s < count; s ++)
+                {
+                        m_odata.vector() = outputs.vector().segment(s * m_odata.size(), m_odata.size());
+
+                        _ginput();
+
+                        m_bgidata.vector().segment(s * m_idata.size(), m_idata.size()) = m_idata.vector();
+                }
+
+                return m_bgidata;
+        }
+
+        void conv_layer_t::gparam(const tensor_t& outputs, size_t count, scalar_t* gradient)
+        {
+                assert(count * odims() == outputs.dims());
+                assert(orows() == outputs.rows());
+                assert(ocols() == outputs.cols());
+                assert(m_bidata.size() == count * m_idata.size());
+
+                auto gmap = tensor::map_vector(gradient, psize());
+                gmap.setZero();
+
+                m_gdata.resize(psize(), 1, 1);
+                for (size_t s = 0; s < count; s ++)
+                {
+                        if (m_mode != conv_mode::im2col && m_mode != conv_mode::fft)
+                        {
+                                m_idata.vector() = m_bidata.vector().segment(s * m_idata.size(), m_idata.size());
+                        }
+                        m_odata.vector() = outputs.vector().segment(s * m_odata.size(), m_odata.size());
+
+                        _gparam(s, m_gdata.data());
+
+                        gmap += m_gdata.vector();
+                }
+        }
+
+        void conv_layer_t::_output(size_t s)
+        {
+                // convolution
+                switch (m_mode)
+                {
+                case conv_mode::im2col:
+                        convolution::im2col::output(m_idata, m_kdata, m_stride, m_dilation, m_xdata.matrix(s), m_odata);
+                        break;
+
+                case conv_mode::winograd:
+                        convolution::winograd::output(m_idata, krows(), m_wtile, m_wkdata, m_xdata, m_wodata, m_odata);
+                        break;
+
+                case conv_mode::fft:
+                        convolution::fft::output(m_idata, m_fplan, m_fkdata,
+                                tensor::map_tensor(m_xdata.planeData(s * idims()), idims(), m_xdata.rows(), m_xdata.cols()),
+                                m_fwdata, m_odata);
+                        break;
+
+                case conv_mode::dot:
+                        convolution::output(m_idata, m_kdata, m_odata, convolution::conv_dot_t());
+                        break;
+
+                case conv_mode::mad:
+                        convolution::output(m_idata, m_kdata, m_odata, convolution::conv_mad_t());
+                        break;
+
+                case conv_mode::blocked:
+                        tensor::block(m_idata, m_block, m_xdata);
+                        convolution::blocked::output(m_xdata, idims(), m_block, m_pkdata, m_pbdata,
+                                krows(), kcols(), orows(), ocols(), m_xodata);
+                        tensor::unblock(m_xodata, odims(), m_block, m_odata);
+                        break;
+
+                case conv_mode::direct:
+                default:
+                        convolution::output(m_idata, m_kdata, m_odata);
+                        break;
+                }
+
+                // +bias (NB: already added with the packed kernels)
+                if (m_mode != conv_mode::blocked)
+                {
+                        for (size_t o = 0; o < odims(); o ++)
+                        {
+                                m_odata.vector(o).array() += m_bdata(o);
+                        }
+                }
+        }
+
+        void conv_layer_t::_ginput()
+        {
+                switch (m_mode)
+                {
+                case conv_mode::im2col:
+                        convolution::im2col::ginput(m_idata, m_kdata, m_stride, m_dilation, m_gxdata.matrix(0), m_odata);
+                        break;
+
+                case conv_mode::winograd:
+                        convolution::winograd::ginput(m_idata, krows(), m_wtile, m_wgkdata, m_gxdata, m_wgidata, m_odata);
+                        break;
+
+                case conv_mode::fft:
+                        convolution::fft::ginput(m_idata, m_fplan, m_fkdata, m_gxdata, m_fwdata, m_odata);
+                        break;
+
+                case conv_mode::direct:
+                default:
+                        convolution::ginput(m_idata, m_kdata, m_odata);
+                        break;
+                }
+        }
+
+        void conv_layer_t::_gparam(size_t s, scalar_t* gradient)
+        {
                 // wrt convolution
-                convolution::gparam(m_idata, tensor::map_tensor(gradient, m_kdata), m_odata);
+                switch (m_mode)
+                {
+                case conv_mode::im2col:
+                        convolution::im2col::gparam(m_xdata.matrix(s), tensor::map_tensor(gradient, m_kdata), m_odata);
+                        break;
+
+                case conv_mode::fft:
+                        convolution::fft::gparam(
+                                tensor::map_tensor(m_xdata.planeData(s * idims()), idims(), m_xdata.rows(), m_xdata.cols()),
+                                m_fplan, tensor::map_tensor(gradient, m_kdata), m_gxdata, m_fwdata, m_odata);
+                        break;
+
+                case conv_mode::dot:
+                        convolution::gparam(m_idata, tensor::map_tensor(gradient, m_kdata), m_odata,
+                                convolution::conv_dot_t());
+                        break;
+
+                case conv_mode::mad:
+                        convolution::gparam(m_idata, tensor::map_tensor(gradient, m_kdata), m_odata,
+                                convolution::conv_mad_t());
+                        break;
+
+                case conv_mode::direct:
+                default:
+                        convolution::gparam(m_idata, tensor::map_tensor(gradient, m_kdata), m_odata);
+                        break;
+                }
 
                 // wrt bias
                 for (size_t o = 0; o < odims(); o ++)
@@ -147,5 +777,3 @@ namespace ncv
                 }
         }
 }
-
-
@@ -1,9 +1,29 @@
 #pragma once
 
 #include "nanocv/layer.h"
+#include "nanocv/math/fft.hpp"
+#include "nanocv/text/enum_string.hpp"
 
 namespace ncv
 {
+        ///
+        /// \brief methods to compute the convolutions
+        ///
+        enum class conv_mode
+        {
+                direct,                 ///< 2D convolution for each pair of input-output planes
+                dot,                    ///< direct method using dot-products
+                mad,                    ///< direct method using mad-products
+                im2col,                 ///< unfold the input & compute all output planes with a matrix product
+                winograd,               ///< Winograd minimal filtering (3x3 & 5x5 kernels, otherwise the direct method)
+                fft,                    ///< products of spectra in the frequency domain
+                automatic,              ///< FFT for kernels of at least 5x5, otherwise the direct method
+                tune,                   ///< the fastest method for the layer's shape (benchmarked once per CPU model)
+                blocked                 ///< channel-blocked layout: groups of output planes computed with vector kernels
+                                        ///     (consumed & produced natively by the following activation & pooling layers)
+                                        ///     (NB: strided or dilated convolutions always use im2col)
+        };
+
         ///
         /// \brief convolution layer
         ///
@@ -11,6 +31,9 @@ namespace ncv
         ///     dims=16[1,256]          - number of convolutions (output dimension)
         ///     rows=8[1,32]            - convolution size
         ///     cols=8[1,32]            - convolution size
+        ///     mode=auto[,direct,dot,mad,im2col,winograd,fft,tune,blocked] - convolution method
+        ///     stride=1[1,8]           - sampling step of the input patches (output down-sampling factor)
+        ///     dilation=1[1,8]         - sampling step of the kernel coefficients
         ///
         class conv_layer_t : public layer_t
         {
@@ -18,7 +41,8 @@ namespace ncv
 
                 NANOCV_MAKE_CLONABLE(conv_layer_t,
                                      "convolution layer, "\
-                                     "parameters: dims=16[1,256],rows=8[1,32],cols=8[1,32]")
+                                     "parameters: dims=16[1,256],rows=8[1,32],cols=8[1,32],mode=auto[,direct,dot,mad,im2col,winograd,fft,tune,blocked],"\
+                                     "stride=1[1,8],dilation=1[1,8]")
 
                 // constructor
                 explicit conv_layer_t(const string_t& parameters = string_t());
@@ -46,6 +70,22 @@ namespace ncv
                 virtual const tensor_t& ginput(const tensor_t& output) override;
                 virtual void gparam(const tensor_t& output, scalar_t* gradient) override;
 
+                // process inputs plane by plane
+                virtual const tensor_t& output_plane(const tensor_t& input, size_t o) override;
+                virtual bool planewise() const override { return false; }
+
+                // process inputs using the channel-blocked layout
+                virtual const tensor_t& output_blocked(const tensor_t& input, size_t block) override;
+                virtual bool blockable() const override { return m_mode == conv_mode::blocked; }
+
+                // process inputs using multiple threads (groups of output planes)
+                virtual const tensor_t& output_parallel(const tensor_t& input, size_t nthreads) override;
+
+                // process a batch of samples
+                virtual const tensor_t& output(const tensor_t& inputs, size_t count) override;
+                virtual const tensor_t& ginput(const tensor_t& outputs, size_t count) override;
+                virtual void gparam(const tensor_t& outputs, size_t count, scalar_t* gradient) override;
+
                 // access functions
                 virtual size_t idims() const override { return m_idata.dims(); }
                 virtual size_t irows() const override { return m_idata.rows(); }
@@ -55,13 +95,24 @@ namespace ncv
                 virtual size_t ocols() const override { return m_odata.cols(); }
                 virtual size_t psize() const override;
 
-                // flops
+                // flops (one multiply-accumulate per kernel coefficient & output pixel)
                 virtual size_t output_flops() const override { return odims() * idims() * oppsize() * kppsize(); }
-                virtual size_t ginput_flops() const override { return odims() * orows() * oppsize() * kppsize(); }
-                virtual size_t gparam_flops() const override { return odims() * orows() * ippsize() * oppsize(); }
+                virtual size_t ginput_flops() const override { return odims() * idims() * oppsize() * kppsize(); }
+                virtual size_t gparam_flops() const override { return odims() * idims() * oppsize() * kppsize(); }
 
         private:
 
+                void transform_params();
+
+                // restore the (planar) input buffer after processing a channel-blocked input
+                void unblock();
+
+                // process the sample stored in the input/output buffers
+                //      (using the transformed input of the s-th sample of the batch)
+                void _output(size_t s);
+                void _ginput();
+                void _gparam(size_t s, scalar_t* gradient);
+
                 size_t kdims() const { return m_kdata.dims(); }
                 size_t krows() const { return m_kdata.rows(); }
                 size_t kcols() const { return m_kdata.cols(); }
@@ -78,5 +129,55 @@ namespace ncv
                 tensor_t                m_odata;        ///< output buffer:             odims x orows x ocols
                 tensor_t                m_kdata;        ///< convolution kernels:       odims x idims x krows x kcols
                 tensor_t                m_bdata;        ///< convolution bias:          odims x 1 x 1
+
+                conv_mode               m_mode;         ///< convolution method
+                size_t                  m_stride;       ///< sampling step of the input patches
+                size_t                  m_dilation;     ///< sampling step of the kernel coefficients
+                tensor_t                m_xdata;        ///< unfolded (im2col), transformed (winograd), spectra (fft) or channel-blocked (blocked) input (for each sample of the batch)
+                tensor_t                m_gxdata;       ///< unfolded (im2col) input gradient, transformed (winograd) or spectra (fft) of the output gradient
+
+                size_t                  m_wtile;        ///< Winograd output tile size
+                tensor_t                m_wkdata;       ///< Winograd transformed kernels:                      #coeffs x odims x idims
+                tensor_t                m_wgkdata;      ///< Winograd transformed rotated kernels:              #coeffs x idims x odims
+                tensor_t                m_wodata;       ///< Winograd transformed output tiles:                 #coeffs x odims x #tiles
+                tensor_t                m_wgidata;      ///< Winograd transformed input gradient tiles:         #coeffs x idims x #tiles
+
+                size_t                  m_block;        ///< number of interleaved planes of the channel-blocked layout
+                bool                    m_unblock;      ///< the input buffer must be restored from the channel-blocked input
+                tensor_t                m_pkdata;       ///< packed kernels (channel-blocked layout):           (oblocks x iblocks) x (krows x kcols) x (block x block)
+                tensor_t                m_pbdata;       ///< packed bias (channel-blocked layout):              oblocks x 1 x block
+                tensor_t                m_xodata;       ///< channel-blocked output:                            oblocks x orows x (ocols x block)
+
+                math::fft2d_t<scalar_t> m_fplan;        ///< FFT plan (power-of-two size greater than the input)
+                tensor_t                m_fkdata;       ///< kernel spectra:                                    (odims x idims) x fft_rows x (2 x fft_cols)
+                tensor_t                m_fwdata;       ///< spectrum buffer (one per parallel task):           #tasks x fft_rows x (2 x fft_cols)
+                std::vector<math::fft2d_t<scalar_t>>
+                                        m_fplans;       ///< FFT plans (one per parallel task, NB: with a scratch buffer each)
+
+                tensor_t                m_bidata;       ///< batch input buffer:        (count x idims) x irows x icols
+                tensor_t                m_bodata;       ///< batch output buffer:       (count x odims) x orows x ocols
+                tensor_t                m_bgidata;      ///< batch input gradient:      (count x idims) x irows x icols
+                tensor_t                m_gdata;        ///< parameter gradient of a sample from the batch
         };
+
+        // string cast for enumerations
+        namespace text
+        {
+                template <>
+                inline std::map<conv_mode, std::string> enum_string<conv_mode>()
+                {
+                        return
+                        {
+                                { conv_mode::direct,    "direct" },
+                                { conv_mode::dot,       "dot" },
+                                { conv_mode::mad,       "mad" },
+                                { conv_mode::im2col,    "im2col" },
+                                { conv_mode::winograd,  "winograd" },
+                                { conv_mode::fft,       "fft" },
+                                { conv_mode::automatic, "auto" },
+                                { conv_mode::tune,      "tune" },
+                                { conv_mode::blocked,   "blocked" }
+                        };
+                }
+        }
 }
@@ -3,7 +3,9 @@
 #include "nanocv/math/clamp.hpp"
 #include "nanocv/math/random.hpp"
 #include "nanocv/tensor/serialize.hpp"
+#include "nanocv/tensor/blocked.hpp"
 #include "linear.hpp"
+#include "nanocv/thread/loopit.hpp"
 
 namespace ncv
 {
@@ -77,6 +79,42 @@ namespace ncv
                 return m_odata;
         }
 
+        const tensor_t& linear_layer_t::output_plane(const tensor_t& input, size_t o)
+        {
+                return o == 0 ? output(input) : m_odata;
+        }
+
+        const tensor_t& linear_layer_t::output_blocked(const tensor_t& input, size_t block)
+        {
+                assert(tensor::blocks(idims(), block) == input.dims());
+                assert(irows() == input.rows());
+                assert(icols() * block == input.cols());
+
+                tensor::unblock(input, idims(), block, m_idata);
+
+                linear::output(m_idata, m_wdata, m_bdata, m_odata);
+
+                tensor::block(m_odata, block, m_xdata);
+
+                return m_xdata;
+        }
+
+        const tensor_t& linear_layer_t::output_parallel(const tensor_t& input, size_t nthreads)
+        {
+                assert(idims() == input.dims());
+                assert(irows() == input.rows());
+                assert(icols() == input.cols());
+
+                m_idata = input;
+
+                thread_loopr(osize(), ncv::get_thread_pool(), nthreads, [&] (size_t begin, size_t end, size_t)
+                {
+                        linear::output(m_idata, m_wdata, m_bdata, m_odata, begin, end);
+                });
+
+                return m_odata;
+        }
+
         const tensor_t& linear_layer_t::ginput(const tensor_t& output)
         {
                 assert(output.dims() == odims());
@@ -103,5 +141,48 @@ namespace ncv
                                tensor::map_tensor(gradient + m_wdata.size(), m_bdata),
                                m_odata);
         }
-}
 
+        const tensor_t& linear_layer_t::output(const tensor_t& inputs, size_t count)
+        {
+                assert(count * idims() == inputs.dims());
+                assert(irows() == inputs.rows());
+                assert(icols() == inputs.cols());
+
+                m_bidata = inputs;
+                m_bodata.resize(count * osize(), 1, 1);
+
+                linear::batch::output(tensor::map_matrix(m_bidata.data(), count, isize()),
+                                      m_wdata, m_bdata,
+                                      tensor::map_matrix(m_bodata.data(), count, osize()));
+
+                return m_bodata;
+        }
+
+        const tensor_t& linear_layer_t::ginput(const tensor_t& outputs, size_t count)
+        {
+                assert(count * odims() == outputs.dims());
+                assert(orows() == outputs.rows());
+                assert(ocols() == outputs.cols());
+
+                m_bgidata.resize(count * idims(), irows(), icols());
+
+                linear::batch::ginput(tensor::map_matrix(m_bgidata.data(), count, isize()),
+                                      m_wdata, m_bdata,
+                                      tensor::map_matrix(outputs.data(), count, osize()));
+
+                return m_bgidata;
+        }
+
+        void linear_layer_t::gparam(const tensor_t& outputs, size_t count, scalar_t* gradient)
+        {
+                assert(count * odims() == outputs.dims());
+                assert(orows() == outputs.rows());
+                assert(ocols() == outputs.cols());
+                assert(m_bidata.size() == count * isize());
+
+                linear::batch::gparam(tensor::map_matrix(m_bidata.data(), count, isize()),
+                                      tensor::map_tensor(gradient, m_wdata),
+                                      tensor::map_tensor(gradient + m_wdata.size(), m_bdata),
+                                      tensor::map_matrix(outputs.data(), count, osize()));
+        }
+}
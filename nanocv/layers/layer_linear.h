@@ -39,6 +39,22 @@ namespace ncv
                 virtual const tensor_t& ginput(const tensor_t& output) override;
                 virtual void gparam(const tensor_t& output, scalar_t* gradient) override;
 
+                // process inputs plane by plane (all outputs are computed at once)
+                virtual const tensor_t& output_plane(const tensor_t& input, size_t o) override;
+                virtual bool planewise() const override { return false; }
+
+                // process inputs using the channel-blocked layout (converted)
+                virtual const tensor_t& output_blocked(const tensor_t& input, size_t block) override;
+
+                // process inputs using multiple threads (groups of output rows)
+                virtual const tensor_t& output_parallel(const tensor_t& input, size_t nthreads) override;
+                virtual bool blockable() const override { return false; }
+
+                // process a batch of samples (matrix-matrix products)
+                virtual const tensor_t& output(const tensor_t& inputs, size_t count) override;
+                virtual const tensor_t& ginput(const tensor_t& outputs, size_t count) override;
+                virtual void gparam(const tensor_t& outputs, size_t count, scalar_t* gradient) override;
+
                 // access functions
                 virtual size_t idims() const override { return m_idata.dims(); }
                 virtual size_t irows() const override { return m_idata.rows(); }
@@ -63,8 +79,13 @@ namespace ncv
                 // attributes
                 tensor_t                m_idata;        ///< input buffer:      isize x 1 x 1
                 tensor_t                m_odata;        ///< output buffer:     osize x 1 x 1
+                tensor_t                m_xdata;        ///< channel-blocked output buffer
 
                 tensor_t                m_wdata;        ///< weights:           1 x osize x isize
                 tensor_t                m_bdata;        ///< bias:              osize x 1 x 1
+
+                tensor_t                m_bidata;       ///< batch input buffer:        (count x isize) x 1 x 1
+                tensor_t                m_bodata;       ///< batch output buffer:       (count x osize) x 1 x 1
+                tensor_t                m_bgidata;      ///< batch input gradient:      (count x isize) x 1 x 1
         };
 }
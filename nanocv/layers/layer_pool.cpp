@@ -2,12 +2,16 @@
 #include "pooling.hpp"
 #include "nanocv/text.h"
 #include "nanocv/math/clamp.hpp"
+#include "nanocv/tensor/blocked.hpp"
+#include "nanocv/thread/loopi.hpp"
 
 namespace ncv
 {
         pool_layer_t::pool_layer_t(const string_t& parameters)
                 :       layer_t(parameters),
-                        m_alpha(math::clamp(text::from_params<scalar_t>(parameters, "dims", 0.1), -100.0, +100.0))
+                        m_alpha(math::clamp(text::from_params<scalar_t>(parameters, "dims", 0.1), -100.0, +100.0)),
+                        m_block(0),
+                        m_unblock(false)
         {
         }
 
@@ -28,6 +32,8 @@ namespace ncv
                 m_sdata.resize(odims, orows, ocols);
                 m_cdata.resize(odims, orows, ocols);
 
+                m_unblock = false;
+
                 return 0;
         }
 
@@ -37,18 +43,87 @@ namespace ncv
                 assert(irows() <= input.rows());
                 assert(icols() <= input.cols());
 
-                m_idata = input;
-
+                // NB: the input buffer is used only to store the input gradient
                 for (size_t o = 0; o < odims(); o ++)
                 {
-                        pooling::output(
-                                m_idata.matrix(o), m_alpha,
-                                m_wdata.matrix(o),
-                                m_sdata.matrix(o),
-                                m_cdata.matrix(o),
-                                m_odata.matrix(o));
+                        output_plane(input, o);
+                }
+
+                return m_odata;
+        }
+
+        const tensor_t& pool_layer_t::output_plane(const tensor_t& input, size_t o)
+        {
+                assert(o < odims());
+
+                pooling::output(
+                        input.matrix(o), m_alpha,
+                        m_wdata.matrix(o),
+                        m_sdata.matrix(o),
+                        m_cdata.matrix(o),
+                        m_odata.matrix(o));
+
+                m_unblock = false;
+
+                return m_odata;
+        }
+
+        const tensor_t& pool_layer_t::output_blocked(const tensor_t& input, size_t block)
+        {
+                assert(tensor::blocks(idims(), block) == input.dims());
+                assert(irows() == input.rows());
+                assert(icols() * block == input.cols());
+
+                const size_t blocks = input.dims();
+
+                m_xodata.resize(blocks, orows(), ocols() * block);
+                m_xwdata.resize(blocks, irows(), icols() * block);
+                m_xsdata.resize(blocks, orows(), ocols() * block);
+                m_xcdata.resize(blocks, orows(), ocols() * block);
+
+                for (size_t g = 0; g < blocks; g ++)
+                {
+                        pooling::output_blocked(
+                                input.matrix(g), m_alpha, block,
+                                m_xwdata.matrix(g),
+                                m_xsdata.matrix(g),
+                                m_xcdata.matrix(g),
+                                m_xodata.matrix(g));
                 }
 
+                // NB: the planar buffers are restored only if the gradients are needed
+                m_block = block;
+                m_unblock = true;
+
+                return m_xodata;
+        }
+
+        const tensor_t& pool_layer_t::output_parallel(const tensor_t& input, size_t nthreads)
+        {
+                assert(idims() == input.dims());
+                assert(irows() <= input.rows());
+                assert(icols() <= input.cols());
+
+                // NB: each tile pools consecutive pairs of input rows (the output rows are independent)
+                const size_t tile = 8;
+                const size_t tiles = (orows() + tile - 1) / tile;
+
+                thread_loopi(odims() * tiles, ncv::get_thread_pool(), nthreads, [&] (size_t i)
+                {
+                        const size_t o = i / tiles;
+                        const size_t obegin = (i % tiles) * tile, oend = std::min(obegin + tile, orows());
+                        const size_t ibegin = 2 * obegin, iend = std::min(2 * oend, irows());
+
+                        pooling::output(
+                                input.matrix(o).middleRows(ibegin, iend - ibegin), m_alpha,
+                                m_wdata.matrix(o).middleRows(ibegin, iend - ibegin),
+                                m_sdata.matrix(o).middleRows(obegin, oend - obegin),
+                                m_cdata.matrix(o).middleRows(obegin, oend - obegin),
+                                m_odata.matrix(o).middleRows(obegin, oend - obegin));
+                });
+
+                m_unblock = false;
+
                 return m_odata;
         }
 
@@ -58,6 +133,13 @@ namespace ncv
                 assert(orows() == output.rows());
                 assert(ocols() == output.cols());
 
+                if (m_unblock)
+                {
+                        tensor::unblock(m_xwdata, idims(), m_block, m_wdata);
+                        tensor::unblock(m_xsdata, odims(), m_block, m_sdata);
+                        m_unblock = false;
+                }
+
                 m_odata = output;
 
                 for (size_t o = 0; o < odims(); o ++)
@@ -82,6 +164,61 @@ namespace ncv
                 assert(orows() == output.rows());
                 assert(ocols() == output.cols());
         }
-}
 
+        const tensor_t& pool_layer_t::output(const tensor_t& inputs, size_t count)
+        {
+                assert(count * idims() == inputs.dims());
+                assert(irows() <= inputs.rows());
+                assert(icols() <= inputs.cols());
+
+                m_bodata.resize(count * odims(), orows(), ocols());
+                m_bwdata.resize(count * idims(), irows(), icols());
+                m_bsdata.resize(count * odims(), orows(), ocols());
+                m_bcdata.resize(count * odims(), orows(), ocols());
+
+                // NB: the pooling is applied independently to each plane of the batch
+                for (size_t o = 0; o < m_bodata.dims(); o ++)
+                {
+                        pooling::output(
+                                inputs.matrix(o), m_alpha,
+                                m_bwdata.matrix(o),
+                                m_bsdata.matrix(o),
+                                m_bcdata.matrix(o),
+                                m_bodata.matrix(o));
+                }
+
+                return m_bodata;
+        }
+
+        const tensor_t& pool_layer_t::ginput(const tensor_t& outputs, size_t count)
+        {
+                assert(count * odims() == outputs.dims());
+                assert(orows() == outputs.rows());
+                assert(ocols() == outputs.cols());
+                assert(m_bwdata.dims() == count * idims());
+
+                m_bgidata.resize(count * idims(), irows(), icols());
+
+                for (size_t o = 0; o < outputs.dims(); o ++)
+                {
+                        pooling::ginput(
+                                m_bgidata.matrix(o),
+                                m_bwdata.matrix(o),
+                                m_bsdata.matrix(o),
+                                m_bcdata.matrix(o),
+                                outputs.matrix(o));
+                }
+
+                return m_bgidata;
+        }
+
+        void pool_layer_t::gparam(const tensor_t& outputs, size_t count, scalar_t* gradient)
+        {
+                NANOCV_UNUSED1(gradient);
+                NANOCV_UNUSED2_RELEASE(outputs, count);
 
+                assert(count * odims() == outputs.dims());
+                assert(orows() == outputs.rows());
+                assert(ocols() == outputs.cols());
+        }
+}
@@ -44,6 +44,22 @@ namespace ncv
                 virtual const tensor_t& ginput(const tensor_t& output) override;
                 virtual void gparam(const tensor_t& output, scalar_t* gradient) override;
 
+                // process inputs plane by plane
+                virtual const tensor_t& output_plane(const tensor_t& input, size_t o) override;
+                virtual bool planewise() const override { return true; }
+
+                // process inputs using the channel-blocked layout
+                virtual const tensor_t& output_blocked(const tensor_t& input, size_t block) override;
+                virtual bool blockable() const override { return true; }
+
+                // process inputs using multiple threads (tiles of output rows of each plane)
+                virtual const tensor_t& output_parallel(const tensor_t& input, size_t nthreads) override;
+
+                // process a batch of samples
+                virtual const tensor_t& output(const tensor_t& inputs, size_t count) override;
+                virtual const tensor_t& ginput(const tensor_t& outputs, size_t count) override;
+                virtual void gparam(const tensor_t& outputs, size_t count, scalar_t* gradient) override;
+
                 // access functions
                 virtual size_t idims() const override { return m_idata.dims(); }
                 virtual size_t irows() const override { return m_idata.rows(); }
@@ -68,6 +84,19 @@ namespace ncv
                 tensor_t                m_wdata;       	///< weights buffer: exp(input)
                 tensor_t                m_sdata;    	///< sum buffer: cumulated exponents / output pixel    		
 		tensor_t		m_cdata;	///< counts buffer: #hits / output pixel
+
+                size_t                  m_block;        ///< number of interleaved planes of the channel-blocked buffers
+                bool                    m_unblock;      ///< the weights & the sum buffers must be restored from the channel-blocked ones
+                tensor_t                m_xodata;       ///< channel-blocked output buffer
+                tensor_t                m_xwdata;       ///< channel-blocked weights buffer
+                tensor_t                m_xsdata;       ///< channel-blocked sum buffer
+                tensor_t                m_xcdata;       ///< channel-blocked counts buffer
+
+                tensor_t                m_bodata;       ///< batch output buffer:       (count x odims) x orows x ocols
+                tensor_t                m_bgidata;      ///< batch input gradient:      (count x idims) x irows x icols
+                tensor_t                m_bwdata;       ///< batch weights buffer:      (count x idims) x irows x icols
+                tensor_t                m_bsdata;       ///< batch sum buffer:          (count x odims) x orows x ocols
+                tensor_t                m_bcdata;       ///< batch counts buffer:       (count x odims) x orows x ocols
         };
         
         class pool_max_layer_t : public pool_layer_t
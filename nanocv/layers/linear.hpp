@@ -19,7 +19,27 @@ namespace ncv
                 >
                 void output(const ttensori& idata, const ttensorw& wdata, const ttensorb& bdata, ttensoro&& odata)
                 {
-                        odata.vector() = bdata.vector() + wdata.matrix(0) * idata.vector();
+                        odata.vector().noalias() = wdata.matrix(0) * idata.vector();
+                        odata.vector() += bdata.vector();
+                }
+
+                ///
+                /// \brief linear output for the [begin, end) range of outputs (e.g. to split the work between threads)
+                ///
+                template
+                <
+                        typename ttensori,
+                        typename ttensorw,
+                        typename ttensorb,
+                        typename ttensoro,
+                        typename tsize
+                >
+                void output(const ttensori& idata, const ttensorw& wdata, const ttensorb& bdata, ttensoro&& odata,
+                        tsize begin, tsize end)
+                {
+                        auto omap = odata.vector().segment(begin, end - begin);
+                        omap.noalias() = wdata.matrix(0).middleRows(begin, end - begin) * idata.vector();
+                        omap += bdata.vector().segment(begin, end - begin);
                 }
 
                 ///
@@ -34,7 +54,7 @@ namespace ncv
                 >
                 void ginput(ttensori&& gidata, const ttensorw& wdata, const ttensorb&, const ttensoro& odata)
                 {
-                        gidata.vector() = wdata.matrix(0).transpose() * odata.vector();
+                        gidata.vector().noalias() = wdata.matrix(0).transpose() * odata.vector();
                 }
 
                 ///
@@ -50,7 +70,60 @@ namespace ncv
                 void gparam(const ttensori& idata, ttensorw&& gwdata, ttensorb&& gbdata, const ttensoro& odata)
                 {
                         gbdata.vector() = odata.vector();
-                        gwdata.matrix(0) = odata.vector() * idata.vector().transpose();
+                        gwdata.matrix(0).noalias() = odata.vector() * idata.vector().transpose();
+                }
+
+                ///
+                /// \brief batch of samples (stored as rows): matrix-matrix products
+                ///
+                namespace batch
+                {
+                        ///
+                        /// \brief linear outputs
+                        ///
+                        template
+                        <
+                                typename tmatrixi,
+                                typename ttensorw,
+                                typename ttensorb,
+                                typename tmatrixo
+                        >
+                        void output(const tmatrixi& idata, const ttensorw& wdata, const ttensorb& bdata, tmatrixo&& odata)
+                        {
+                                odata.noalias() = idata * wdata.matrix(0).transpose();
+                                odata.rowwise() += bdata.vector().transpose();
+                        }
+
+                        ///
+                        /// \brief gradients wrt the inputs
+                        ///
+                        template
+                        <
+                                typename tmatrixi,
+                                typename ttensorw,
+                                typename ttensorb,
+                                typename tmatrixo
+                        >
+                        void ginput(tmatrixi&& gidata, const ttensorw& wdata, const ttensorb&, const tmatrixo& odata)
+                        {
+                                gidata.noalias() = odata * wdata.matrix(0);
+                        }
+
+                        ///
+                        /// \brief gradient wrt the parameters (summed over the batch)
+                        ///
+                        template
+                        <
+                                typename tmatrixi,
+                                typename ttensorw,
+                                typename ttensorb,
+                                typename tmatrixo
+                        >
+                        void gparam(const tmatrixi& idata, ttensorw&& gwdata, ttensorb&& gbdata, const tmatrixo& odata)
+                        {
+                                gbdata.vector() = odata.colwise().sum().transpose();
+                                gwdata.matrix(0).noalias() = odata.transpose() * idata;
+                        }
                 }
         }
 }
@@ -40,6 +40,48 @@ namespace ncv
                         odata = ialpha * (sdata.array() / cdata.array()).log();
                 }
 
+                ///
+                /// \brief pooling of the channel-blocked planes (see tensor::block):
+                ///     the <block> interleaved planes are processed at once
+                ///
+                template
+                <
+                        typename tmatrixi,
+                        typename tscalar,
+                        typename tsize,
+                        typename tmatrixw,
+                        typename tmatrixs,
+                        typename tmatrixc,
+                        typename tmatrixo
+                >
+                void output_blocked(
+                        const tmatrixi& idata, tscalar alpha, tsize block,
+                        tmatrixw&& wdata, tmatrixs&& sdata, tmatrixc&& cdata, tmatrixo&& odata)
+                {
+                        const tsize irows = static_cast<tsize>(idata.rows());
+                        const tsize icols = static_cast<tsize>(idata.cols()) / block;
+                        const tscalar ialpha = 1 / alpha;
+
+                        wdata = (idata.array() * alpha).exp();
+
+                        sdata.setZero();
+                        cdata.setZero();
+
+                        for (tsize r = 0, rr = 0; r < irows; r ++, rr = r / 2)
+                        {
+                                for (tsize c = 0, cc = 0; c < icols; c ++, cc = c / 2)
+                                {
+                                        for (tsize b = 0; b < block; b ++)
+                                        {
+                                                sdata(rr, cc * block + b) += wdata(r, c * block + b);
+                                                cdata(rr, cc * block + b) += 1;
+                                        }
+                                }
+                        }
+
+                        odata = ialpha * (sdata.array() / cdata.array()).log();
+                }
+
                 template
                 <
                         typename tmatrixi,
@@ -95,6 +95,10 @@ namespace ncv
         /// \brief multi-threaded search for a 1D parameter that minimizes a given operator, 
         ///     using a greedy approach on the base 10 logarithmic scale in the range [minlog, maxlog].
         ///
+        /// NB: the candidate parameters of each refinement step are evaluated concurrently
+        ///     (e.g. independent training runs, each using a part of the thread budget),
+        ///     such that the optimum is the same as for the single-threaded version.
+        ///
         /// \returns { the result associated to the optimum parameter, the optimum parameter }.
         ///
         template
@@ -113,33 +117,29 @@ namespace ncv
 
                 std::set<tvalue> history;
 
-                // synchronization
-                typedef typename tpool::mutex_t         tmutex;
-                typedef typename tpool::lock_t          tlock;
-
-                tmutex mutex;
-                
                 splits = std::max(tsize(4), splits);
+
+                std::vector<tvalue> values(splits);
                 
                 // greedy sort-of-branch-and-bound search
                 while ((maxlog - minlog) > epslog && epslog > tscalar(0))
                 {
                         const tscalar varlog = (maxlog - minlog) / tscalar(splits - 1);
 
+                        // NB: a separate group, so that the search can be nested in other tasks of the pool
+                        typename tpool::group_t group;
                         for (tsize i = 0; i < splits; i ++)
                         {
-                                pool.enqueue([=,&history,&mutex]()
+                                pool.enqueue(group, [=, &op, &values] ()
                                 {
-                                        const tvalue value = min_search_detail::evaluate(op, minlog + i * varlog);
-
-                                        // synchronize per thread
-                                        const tlock lock(mutex);
-                                        history.insert(value);
+                                        values[i] = min_search_detail::evaluate(op, minlog + i * varlog);
                                 });
                         }
                         
                         // synchronize per search step
-                        pool.wait();
+                        pool.wait(group);
+
+                        history.insert(values.begin(), values.end());
                         
                         min_search_detail::update_range(*history.begin(), varlog, splits, minlog, maxlog);
                 }
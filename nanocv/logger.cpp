@@ -2,13 +2,41 @@
 #include <iomanip>
 #include <string>
 #include <ctime>
+#include <cstring>
 
 namespace ncv
 {
+        namespace
+        {
+                // tag of the process if only the warnings & the errors are logged (see set_log_quiet)
+                std::string quiet_tag;
+
+                // discard the logged messages
+                std::ostream& null_stream()
+                {
+                        thread_local std::ostream stream(nullptr);      // NB: its (failed) state is not shared
+                        return stream;
+                }
+
+                bool muted(const char* header)
+                {
+                        return !quiet_tag.empty() && std::strcmp(header, "info") == 0;
+                }
+        }
+
+        void set_log_quiet(const std::string& tag)
+        {
+                quiet_tag = tag;
+        }
+
         logger_t::logger_t(std::ostream& stream, const char* header, bool flush)
-                :       m_stream(stream), m_flush(flush)
+                :       m_stream(muted(header) ? null_stream() : stream), m_flush(flush)
         {
                 log_time();
+                if (!quiet_tag.empty())
+                {
+                        m_stream << "[" << quiet_tag << "]";
+                }
                 m_stream << "[" << header << "] ";
         }
 
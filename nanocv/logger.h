@@ -2,6 +2,7 @@
 
 #include "arch.h"
 #include <iostream>
+#include <string>
 
 namespace ncv
 {
@@ -47,6 +48,14 @@ namespace ncv
                 bool            m_flush;
         };
 
+        ///
+        /// \brief log only the warnings & the errors of the current process, prefixed with the given tag
+        ///     (e.g. the rank of a data-parallel worker process), or everything again if the tag is empty
+        ///
+        /// NB: it should be called before starting any thread.
+        ///
+        NANOCV_PUBLIC void set_log_quiet(const std::string& tag);
+
         // stream particular tags
         inline logger_t& newl(logger_t& logger_t)         { return logger_t.newl(); }
         inline logger_t& endl(logger_t& logger_t)         { return logger_t.endl(); }
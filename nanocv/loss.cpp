@@ -18,5 +18,12 @@ namespace ncv
                 }
                 return target;
         }
+
+        vector_t loss_t::vgrad(const vector_t& targets, const vector_t& scores) const
+        {
+                vector_t grad;
+                vgrad(targets, scores, grad);
+                return grad;
+        }
 }
 	
@@ -71,7 +71,13 @@ namespace ncv
                 ///
                 /// \brief compute the loss gradient
                 ///
-                virtual vector_t vgrad(const vector_t& targets, const vector_t& scores) const = 0;
+                vector_t vgrad(const vector_t& targets, const vector_t& scores) const;
+
+                ///
+                /// \brief compute the loss gradient into the given workspace
+                ///     (NB: no allocation if it has already the right size)
+                ///
+                virtual void vgrad(const vector_t& targets, const vector_t& scores, vector_t& grad) const = 0;
 
                 ///
                 /// \brief predicted label indices (if classification problem)
@@ -22,11 +22,11 @@ namespace ncv
                 return ((targets - scores).array().square() + 1.0).log().sum();
         }
         
-        vector_t cauchy_loss_t::vgrad(const vector_t& targets, const vector_t& scores) const
+        void cauchy_loss_t::vgrad(const vector_t& targets, const vector_t& scores, vector_t& grad) const
         {
                 assert(targets.size() == scores.size());
                 
-                return 2.0 * (scores - targets).array() / (1.0 + (scores - targets).array().square());
+                grad = 2.0 * (scores - targets).array() / (1.0 + (scores - targets).array().square());
         }
 
         indices_t cauchy_loss_t::labels(const vector_t& scores) const
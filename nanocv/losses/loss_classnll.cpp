@@ -23,18 +23,16 @@ namespace ncv
         {
                 assert(targets.size() == scores.size());
                 
-                const vector_t escores = scores.array().exp();
-                
-                return std::log(escores.array().sum()) - 0.5 * (1.0 + targets.array()).matrix().dot(scores);
+                return std::log(scores.array().exp().sum()) - 0.5 * (1.0 + targets.array()).matrix().dot(scores);
         }
         
-        vector_t classnll_loss_t::vgrad(const vector_t& targets, const vector_t& scores) const
+        void classnll_loss_t::vgrad(const vector_t& targets, const vector_t& scores, vector_t& grad) const
         {
                 assert(targets.size() == scores.size());
                 
-                const vector_t escores = scores.array().exp();
-                
-                return escores.array() / escores.sum() - 0.5 * (1.0 + targets.array());
+                // NB: the exponentials are stored in the workspace (no temporary)
+                grad = scores.array().exp();
+                grad = grad.array() / grad.sum() - 0.5 * (1.0 + targets.array());
         }
 
         indices_t classnll_loss_t::labels(const vector_t& scores) const
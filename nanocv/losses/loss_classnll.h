@@ -13,6 +13,8 @@ namespace ncv
 
                 NANOCV_MAKE_CLONABLE(classnll_loss_t, "multi-class negative log-likelihood loss")
 
+                using loss_t::vgrad;
+
                 // constructor
                 classnll_loss_t(const string_t& = string_t());
 
@@ -21,7 +23,7 @@ namespace ncv
 
                 // compute the loss value & derivatives
                 virtual scalar_t value(const vector_t& targets, const vector_t& scores) const override;
-                virtual vector_t vgrad(const vector_t& targets, const vector_t& scores) const override;
+                virtual void vgrad(const vector_t& targets, const vector_t& scores, vector_t& grad) const override;
 
                 // predict label indices
                 virtual indices_t labels(const vector_t& scores) const override;
@@ -1,5 +1,6 @@
 #include "loss_logistic.h"
 #include <cassert>
+#include <algorithm>
 
 namespace ncv
 {
@@ -25,18 +26,23 @@ namespace ncv
         {
                 assert(targets.size() == scores.size());
 
-                const auto edges_exp = (-beta * targets.array() * scores.array()).exp();
+                // NB: shift the exponents by their maximum to avoid overflows (e.g. with single precision)
+                const auto edges = -beta * targets.array() * scores.array();
+                const scalar_t emax = std::max(scalar_t(0), edges.maxCoeff());
 
-                return ibeta * std::log(1.0 + edges_exp.array().sum());
+                return ibeta * (emax + std::log(std::exp(-emax) + (edges - emax).exp().sum()));
         }
         
-        vector_t logistic_loss_t::vgrad(const vector_t& targets, const vector_t& scores) const
+        void logistic_loss_t::vgrad(const vector_t& targets, const vector_t& scores, vector_t& grad) const
         {
                 assert(targets.size() == scores.size());
                 
-                const auto edges_exp = (-beta * targets.array() * scores.array()).exp();
+                // NB: the (shifted) exponentials are stored in the workspace (no temporary)
+                const auto edges = -beta * targets.array() * scores.array();
+                const scalar_t emax = std::max(scalar_t(0), edges.maxCoeff());
 
-                return (-targets.array() * edges_exp.array()) / (1.0 + edges_exp.array().sum());
+                grad = (edges - emax).exp();
+                grad = (-targets.array() * grad.array()) / (std::exp(-emax) + grad.sum());
         }
 
         indices_t logistic_loss_t::labels(const vector_t& scores) const
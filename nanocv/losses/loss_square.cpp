@@ -22,11 +22,11 @@ namespace ncv
                 return 0.5 * (scores - targets).array().square().sum();
         }
         
-        vector_t square_loss_t::vgrad(const vector_t& targets, const vector_t& scores) const
+        void square_loss_t::vgrad(const vector_t& targets, const vector_t& scores, vector_t& grad) const
         {
                 assert(targets.size() == scores.size());
                 
-                return scores - targets;
+                grad = scores - targets;
         }
 
         indices_t square_loss_t::labels(const vector_t& scores) const
@@ -15,6 +15,8 @@ namespace ncv
 
                 NANOCV_MAKE_CLONABLE(square_loss_t, "square loss")
 
+                using loss_t::vgrad;
+
                 // constructor
                 square_loss_t(const string_t& = string_t());
 
@@ -23,7 +25,7 @@ namespace ncv
 
                 // compute the loss value & derivatives
                 virtual scalar_t value(const vector_t& targets, const vector_t& scores) const override;
-                virtual vector_t vgrad(const vector_t& targets, const vector_t& scores) const override;
+                virtual void vgrad(const vector_t& targets, const vector_t& scores, vector_t& grad) const override;
 
                 // predict label indices
                 virtual indices_t labels(const vector_t& scores) const override;
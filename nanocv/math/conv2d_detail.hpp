@@ -2,6 +2,7 @@
 
 #include "dot.hpp"
 #include "mad.hpp"
+#include "simd.h"
 
 namespace ncv
 {
@@ -120,10 +121,23 @@ namespace ncv
                 void conv_dyn(const tmatrixi& idata, const tmatrixk& kdata, tmatrixo& odata)
                 {
                         const auto kcols = kdata.cols();
-                        const auto ocols = odata.cols();                        
+                        const auto ocols = odata.cols();
+
+                        // NB: the explicitly vectorized kernels are used for the long rows (e.g. of the outputs,
+                        //      as the kernels are usually small), the fixed-size ones otherwise
+                        const auto simd_min_cols = 16;
+
+                        if (kcols < ocols && kcols >= simd_min_cols)
+                        {
+                                conv_dot(idata, kdata, odata, math::dot_simd<tscalar>);
+                        }
+                        else if (ocols >= simd_min_cols)
+                        {
+                                conv_mad(idata, kdata, odata, math::mad_simd<tscalar>);
+                        }
 
                         // decode at run-time the kernel size
-                        if (kcols < ocols)
+                        else if (kcols < ocols)
                         {
                                 switch (kcols)
                                 {
@@ -142,7 +156,7 @@ namespace ncv
                                 case 13:        conv_dot(idata, kdata, odata, math::dot<tscalar, 13>); break;
                                 case 14:        conv_dot(idata, kdata, odata, math::dot<tscalar, 14>); break;
                                 case 15:        conv_dot(idata, kdata, odata, math::dot<tscalar, 15>); break;
-                                default:        conv_dot(idata, kdata, odata, math::dot<tscalar>); break;
+                                default:        conv_dot(idata, kdata, odata, math::dot_simd<tscalar>); break;
                                 }
                         }
                         else
@@ -164,7 +178,7 @@ namespace ncv
                                 case 13:        conv_mad(idata, kdata, odata, math::mad<tscalar, 13>); break;
                                 case 14:        conv_mad(idata, kdata, odata, math::mad<tscalar, 14>); break;
                                 case 15:        conv_mad(idata, kdata, odata, math::mad<tscalar, 15>); break;
-                                default:        conv_mad(idata, kdata, odata, math::mad<tscalar>); break;
+                                default:        conv_mad(idata, kdata, odata, math::mad_simd<tscalar>); break;
                                 }
                         }
                 }
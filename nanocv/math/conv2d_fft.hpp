@@ -0,0 +1,84 @@
+#pragma once
+
+#include "fft.hpp"
+#include "nanocv/tensor/matrix.hpp"
+#include <algorithm>
+
+namespace ncv
+{
+        namespace math
+        {
+                ///
+                /// \brief multiply-accumulate two spectra: cdata += adata * bdata
+                ///
+                template
+                <
+                        typename tscalar,
+                        typename tcomplex = std::complex<tscalar>
+                >
+                void fft_mad(const tcomplex* adata, const tcomplex* bdata, std::size_t size, tcomplex* cdata)
+                {
+                        const tscalar* pa = reinterpret_cast<const tscalar*>(adata);
+                        const tscalar* pb = reinterpret_cast<const tscalar*>(bdata);
+                        tscalar* pc = reinterpret_cast<tscalar*>(cdata);
+
+                        for (std::size_t k = 0; k < 2 * size; k += 2)
+                        {
+                                pc[k + 0] += pa[k + 0] * pb[k + 0] - pa[k + 1] * pb[k + 1];
+                                pc[k + 1] += pa[k + 0] * pb[k + 1] + pa[k + 1] * pb[k + 0];
+                        }
+                }
+
+                ///
+                /// \brief multiply-accumulate a spectrum with a conjugated spectrum: cdata += adata * conj(bdata)
+                ///
+                template
+                <
+                        typename tscalar,
+                        typename tcomplex = std::complex<tscalar>
+                >
+                void fft_madc(const tcomplex* adata, const tcomplex* bdata, std::size_t size, tcomplex* cdata)
+                {
+                        const tscalar* pa = reinterpret_cast<const tscalar*>(adata);
+                        const tscalar* pb = reinterpret_cast<const tscalar*>(bdata);
+                        tscalar* pc = reinterpret_cast<tscalar*>(cdata);
+
+                        for (std::size_t k = 0; k < 2 * size; k += 2)
+                        {
+                                pc[k + 0] += pa[k + 0] * pb[k + 0] + pa[k + 1] * pb[k + 1];
+                                pc[k + 1] += pa[k + 1] * pb[k + 0] - pa[k + 0] * pb[k + 1];
+                        }
+                }
+
+                ///
+                /// \brief 2D convolution: odata += idata @ kdata (using the FFT)
+                ///
+                /// NB: the circular correlation of power-of-two size greater than the input matches the valid one.
+                ///
+                template
+                <
+                        typename tmatrixi,
+                        typename tmatrixk = tmatrixi,
+                        typename tmatrixo = tmatrixi,
+                        typename tscalar = typename tmatrixi::Scalar
+                >
+                void conv2d_fft(const tmatrixi& idata, const tmatrixk& kdata, tmatrixo& odata)
+                {
+                        assert(idata.rows() + 1 == kdata.rows() + odata.rows());
+                        assert(idata.cols() + 1 == kdata.cols() + odata.cols());
+
+                        typedef std::complex<tscalar> tcomplex;
+
+                        const fft2d_t<tscalar> plan(fft_size(idata.rows()), fft_size(idata.cols()));
+
+                        std::vector<tcomplex> fidata(plan.size()), fkdata(plan.size()), fodata(plan.size(), tcomplex(0));
+                        plan.forward(idata, fidata.data());
+                        plan.forward(kdata, fkdata.data());
+                        fft_madc<tscalar>(fidata.data(), fkdata.data(), plan.size(), fodata.data());
+
+                        typename tensor::matrix_types_t<tscalar>::tmatrix cdata(odata.rows(), odata.cols());
+                        plan.inverse(fodata.data(), cdata);
+                        odata += cdata;
+                }
+        }
+}
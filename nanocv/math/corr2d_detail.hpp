@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mad.hpp"
+#include "simd.h"
 
 namespace ncv
 {
@@ -117,6 +118,17 @@ namespace ncv
                 void corr_dyn(const tmatrixo& odata, const tmatrixk& kdata, tmatrixi& idata)
                 {
                         const auto kcols = kdata.cols();
+                        const auto ocols = odata.cols();
+
+                        // NB: the explicitly vectorized kernels are used for the long rows (e.g. of the outputs,
+                        //      as the kernels are usually small), the fixed-size ones otherwise
+                        const auto simd_min_cols = 16;
+
+                        if (kcols < simd_min_cols && ocols >= simd_min_cols)
+                        {
+                                corr_mado(odata, kdata, idata, math::mad_simd<tscalar>);
+                                return;
+                        }
 
                         // decode at run-time the kernel size
                         switch (kcols)
@@ -136,7 +148,7 @@ namespace ncv
                         case 13:        corr_madk(odata, kdata, idata, math::mad<tscalar, 13>); break;
                         case 14:        corr_madk(odata, kdata, idata, math::mad<tscalar, 14>); break;
                         case 15:        corr_madk(odata, kdata, idata, math::mad<tscalar, 15>); break;
-                        default:        corr_madk(odata, kdata, idata, math::mad<tscalar>); break;
+                        default:        corr_madk(odata, kdata, idata, math::mad_simd<tscalar>); break;
                         }
                 }
         }
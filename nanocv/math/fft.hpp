@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <utility>
+
+namespace ncv
+{
+        namespace math
+        {
+                ///
+                /// \brief smallest power of two greater or equal to the given size
+                ///
+                template
+                <
+                        typename tsize
+                >
+                tsize fft_size(tsize size)
+                {
+                        tsize n = 1;
+                        while (n < size)
+                        {
+                                n <<= 1;
+                        }
+
+                        return n;
+                }
+
+                ///
+                /// \brief in-place radix-2 FFT of power-of-two size
+                ///     (the twiddle factors & the bit-reversal permutation are computed once per plan)
+                ///
+                template
+                <
+                        typename tscalar
+                >
+                class fft_t
+                {
+                public:
+
+                        typedef std::complex<tscalar>   tcomplex;
+
+                        ///
+                        /// \brief constructor
+                        ///
+                        explicit fft_t(std::size_t n = 1)
+                                :       m_n(n),
+                                        m_twiddles(n / 2),
+                                        m_reversed(n)
+                        {
+                                assert(n > 0 && (n & (n - 1)) == 0);
+
+                                const long double pi = 3.14159265358979323846264338327950288L;
+                                for (std::size_t k = 0; k < m_twiddles.size(); k ++)
+                                {
+                                        const long double angle = -2.0L * pi * k / n;
+                                        m_twiddles[k] = tcomplex(static_cast<tscalar>(std::cos(angle)),
+                                                                 static_cast<tscalar>(std::sin(angle)));
+                                }
+
+                                std::size_t bits = 0;
+                                while ((std::size_t(1) << bits) < n)
+                                {
+                                        bits ++;
+                                }
+
+                                for (std::size_t k = 0; k < n; k ++)
+                                {
+                                        std::size_t r = 0;
+                                        for (std::size_t b = 0; b < bits; b ++)
+                                        {
+                                                r |= ((k >> b) & 1) << (bits - 1 - b);
+                                        }
+                                        m_reversed[k] = r;
+                                }
+                        }
+
+                        ///
+                        /// \brief transform @count interleaved sequences:
+                        ///     the k-th element of the c-th sequence is stored at data[k * stride + c]
+                        ///
+                        /// NB: the inverse transform is not normalized.
+                        ///
+                        void transform(tcomplex* data, std::size_t stride, std::size_t count, bool inverse) const
+                        {
+                                // bit-reversal permutation
+                                for (std::size_t k = 0; k < m_n; k ++)
+                                {
+                                        const std::size_t r = m_reversed[k];
+                                        if (k < r)
+                                        {
+                                                tcomplex* pk = data + k * stride;
+                                                tcomplex* pr = data + r * stride;
+                                                for (std::size_t c = 0; c < count; c ++)
+                                                {
+                                                        std::swap(pk[c], pr[c]);
+                                                }
+                                        }
+                                }
+
+                                // butterflies (NB: the complex products are expanded to avoid the slow IEEE checks)
+                                tscalar* const pdata = reinterpret_cast<tscalar*>(data);
+                                for (std::size_t len = 2; len <= m_n; len <<= 1)
+                                {
+                                        const std::size_t half = len / 2;
+                                        const std::size_t tstep = m_n / len;
+
+                                        for (std::size_t i = 0; i < m_n; i += len)
+                                        {
+                                                for (std::size_t k = 0; k < half; k ++)
+                                                {
+                                                        const tscalar wr = m_twiddles[k * tstep].real();
+                                                        const tscalar wi = inverse ?
+                                                                -m_twiddles[k * tstep].imag() :
+                                                                +m_twiddles[k * tstep].imag();
+
+                                                        tscalar* pa = pdata + 2 * (i + k) * stride;
+                                                        tscalar* pb = pdata + 2 * (i + k + half) * stride;
+                                                        for (std::size_t c = 0; c < 2 * count; c += 2)
+                                                        {
+                                                                const tscalar tr = wr * pb[c + 0] - wi * pb[c + 1];
+                                                                const tscalar ti = wr * pb[c + 1] + wi * pb[c + 0];
+
+                                                                pb[c + 0] = pa[c + 0] - tr;
+                                                                pb[c + 1] = pa[c + 1] - ti;
+                                                                pa[c + 0] += tr;
+                                                                pa[c + 1] += ti;
+                                                        }
+                                                }
+                                        }
+                                }
+                        }
+
+                        ///
+                        /// \brief size
+                        ///
+                        std::size_t size() const { return m_n; }
+
+                private:
+
+                        // attributes
+                        std::size_t                     m_n;
+                        std::vector<tcomplex>           m_twiddles;
+                        std::vector<std::size_t>        m_reversed;
+                };
+
+                ///
+                /// \brief 2D FFT of power-of-two sizes for real planes (row-major storage):
+                ///     the FFTs along the rows are computed only for the (non-zero) rows of the plane and
+                ///     all 1D FFTs are computed in batches of interleaved sequences (cache-friendly & vectorizable).
+                ///
+                /// NB: not thread-safe (an internal buffer is used for transposing).
+                ///
+                template
+                <
+                        typename tscalar
+                >
+                class fft2d_t
+                {
+                public:
+
+                        typedef std::complex<tscalar>   tcomplex;
+
+                        ///
+                        /// \brief constructor
+                        ///
+                        explicit fft2d_t(std::size_t rows = 1, std::size_t cols = 1)
+                                :       m_rfft(rows),
+                                        m_cfft(cols),
+                                        m_buffer(rows * cols)
+                        {
+                        }
+
+                        ///
+                        /// \brief spectrum (of size ::rows() x ::cols()) of the given zero-padded plane
+                        ///
+                        template
+                        <
+                                typename tmatrix
+                        >
+                        void forward(const tmatrix& data, tcomplex* fdata) const
+                        {
+                                const std::size_t drows = static_cast<std::size_t>(data.rows());
+                                const std::size_t dcols = static_cast<std::size_t>(data.cols());
+
+                                assert(drows <= rows() && dcols <= cols());
+
+                                // FFT along the (non-zero) rows: on the transposed plane
+                                tcomplex* const pbuffer = m_buffer.data();
+                                for (std::size_t c = 0; c < cols(); c ++)
+                                {
+                                        for (std::size_t r = 0; r < drows; r ++)
+                                        {
+                                                pbuffer[c * rows() + r] = tcomplex(c < dcols ? data(r, c) : tscalar(0), tscalar(0));
+                                        }
+                                }
+
+                                m_cfft.transform(pbuffer, rows(), drows, false);
+
+                                // FFT along the columns
+                                for (std::size_t r = 0; r < rows(); r ++)
+                                {
+                                        for (std::size_t c = 0; c < cols(); c ++)
+                                        {
+                                                fdata[r * cols() + c] = r < drows ? pbuffer[c * rows() + r] : tcomplex(0);
+                                        }
+                                }
+
+                                m_rfft.transform(fdata, cols(), cols(), false);
+                        }
+
+                        ///
+                        /// \brief the (real) plane of the given spectrum, cropped to the size of the plane
+                        ///
+                        /// NB: the spectrum is overwritten.
+                        ///
+                        template
+                        <
+                                typename tmatrix
+                        >
+                        void inverse(tcomplex* fdata, tmatrix&& data) const
+                        {
+                                const std::size_t drows = static_cast<std::size_t>(data.rows());
+                                const std::size_t dcols = static_cast<std::size_t>(data.cols());
+
+                                assert(drows <= rows() && dcols <= cols());
+
+                                // inverse FFT along the columns
+                                m_rfft.transform(fdata, cols(), cols(), true);
+
+                                // inverse FFT along the (cropped) rows: on the transposed plane
+                                tcomplex* const pbuffer = m_buffer.data();
+                                for (std::size_t c = 0; c < cols(); c ++)
+                                {
+                                        for (std::size_t r = 0; r < drows; r ++)
+                                        {
+                                                pbuffer[c * rows() + r] = fdata[r * cols() + c];
+                                        }
+                                }
+
+                                m_cfft.transform(pbuffer, rows(), drows, true);
+
+                                const tscalar scale = tscalar(1) / static_cast<tscalar>(size());
+                                for (std::size_t r = 0; r < drows; r ++)
+                                {
+                                        for (std::size_t c = 0; c < dcols; c ++)
+                                        {
+                                                data(r, c) = pbuffer[c * rows() + r].real() * scale;
+                                        }
+                                }
+                        }
+
+                        ///
+                        /// \brief dimensions
+                        ///
+                        std::size_t rows() const { return m_rfft.size(); }
+                        std::size_t cols() const { return m_cfft.size(); }
+                        std::size_t size() const { return rows() * cols(); }
+
+                private:
+
+                        // attributes
+                        fft_t<tscalar>                  m_rfft;         ///< FFT along the columns (of size #rows)
+                        fft_t<tscalar>                  m_cfft;         ///< FFT along the rows (of size #cols)
+                        mutable std::vector<tcomplex>   m_buffer;       ///< transposed plane
+                };
+        }
+}
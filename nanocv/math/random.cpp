@@ -0,0 +1,45 @@
+#include "random.hpp"
+#include <atomic>
+
+namespace ncv
+{
+        namespace
+        {
+                std::atomic<bool>               fixed_seed(false);
+                std::atomic<std::uint64_t>      next_seed(0);
+
+                // the seeds of the calling thread (if set by random_seed_scope_t)
+                thread_local bool               scoped_seed = false;
+                thread_local std::uint64_t      scoped_next_seed = 0;
+        }
+
+        void set_random_seed(std::uint64_t seed)
+        {
+                next_seed = seed;
+                fixed_seed = true;
+        }
+
+        std::uint64_t random_seed()
+        {
+                if (scoped_seed)
+                {
+                        return scoped_next_seed ++;
+                }
+
+                return fixed_seed ? next_seed ++ : static_cast<std::uint64_t>(std::random_device()());
+        }
+
+        random_seed_scope_t::random_seed_scope_t(std::uint64_t seed)
+                :       m_scoped(scoped_seed),
+                        m_next(scoped_next_seed)
+        {
+                scoped_seed = true;
+                scoped_next_seed = seed;
+        }
+
+        random_seed_scope_t::~random_seed_scope_t()
+        {
+                scoped_seed = m_scoped;
+                scoped_next_seed = m_next;
+        }
+}
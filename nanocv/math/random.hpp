@@ -1,10 +1,53 @@
 #pragma once
 
 #include <random>
+#include <cstdint>
 #include <type_traits>
+#include "nanocv/arch.h"
 
 namespace ncv
 {
+        ///
+        /// \brief seed the random number generators created from now on with consecutive values
+        ///     (e.g. to draw the same random sequences in several processes)
+        ///
+        NANOCV_PUBLIC void set_random_seed(std::uint64_t seed);
+
+        ///
+        /// \brief seed for a new random number generator: non-deterministic unless set_random_seed was called
+        ///
+        NANOCV_PUBLIC std::uint64_t random_seed();
+
+        ///
+        /// \brief seed the random number generators created from now on by the calling thread
+        ///     with consecutive values starting from the given seed, until the object is destroyed
+        ///     (e.g. so that concurrent tasks draw the same random sequences whatever their schedule)
+        ///
+        class NANOCV_PUBLIC random_seed_scope_t
+        {
+        public:
+
+                ///
+                /// \brief constructor
+                ///
+                explicit random_seed_scope_t(std::uint64_t seed);
+
+                ///
+                /// \brief destructor (restores the previous seeding of the calling thread)
+                ///
+                ~random_seed_scope_t();
+
+                // disable copying
+                random_seed_scope_t(const random_seed_scope_t&) = delete;
+                random_seed_scope_t& operator=(const random_seed_scope_t&) = delete;
+
+        private:
+
+                // attributes
+                bool            m_scoped;       ///< previous seeding of the calling thread (if scoped)
+                std::uint64_t   m_next;         ///< previous next seed of the calling thread (if scoped)
+        };
+
         ///
         /// \brief uniform random number generator in the [min, max] range.
         ///
@@ -20,7 +63,17 @@ namespace ncv
                 /// \brief constructor
                 ///
                 random_t(tscalar min, tscalar max)
-                        :       m_gen(std::random_device()()),
+                        :       m_gen(ncv::random_seed()),
+                                m_die(std::min(min, max),
+                                      std::max(min, max))
+                {
+                }
+
+                ///
+                /// \brief constructor with the given seed (e.g. to not alter the seeds of the other generators)
+                ///
+                random_t(tscalar min, tscalar max, std::uint64_t seed)
+                        :       m_gen(seed),
                                 m_die(std::min(min, max),
                                       std::max(min, max))
                 {
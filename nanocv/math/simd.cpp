@@ -0,0 +1,434 @@
+#include "simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        #define NANOCV_SIMD_X86
+        #include <immintrin.h>
+#endif
+
+namespace ncv
+{
+        namespace
+        {
+#ifdef NANOCV_SIMD_X86
+                ///
+                /// SSE2 kernels
+                ///
+                __attribute__((target("sse2")))
+                float dot_sse2(const float* a, const float* b, int n)
+                {
+                        int i = 0;
+
+                        __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+                        for ( ; i + 8 <= n; i += 8)
+                        {
+                                sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i + 0), _mm_loadu_ps(b + i + 0)));
+                                sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+                        }
+
+                        float buff[4];
+                        _mm_storeu_ps(buff, _mm_add_ps(sum0, sum1));
+
+                        float sum = buff[0] + buff[1] + buff[2] + buff[3];
+                        for ( ; i < n; i ++)
+                        {
+                                sum += a[i] * b[i];
+                        }
+
+                        return sum;
+                }
+
+                __attribute__((target("sse2")))
+                double dot_sse2(const double* a, const double* b, int n)
+                {
+                        int i = 0;
+
+                        __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+                        for ( ; i + 4 <= n; i += 4)
+                        {
+                                sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a + i + 0), _mm_loadu_pd(b + i + 0)));
+                                sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+                        }
+
+                        double buff[2];
+                        _mm_storeu_pd(buff, _mm_add_pd(sum0, sum1));
+
+                        double sum = buff[0] + buff[1];
+                        for ( ; i < n; i ++)
+                        {
+                                sum += a[i] * b[i];
+                        }
+
+                        return sum;
+                }
+
+                __attribute__((target("sse2")))
+                void mad_sse2(const float* idata, float weight, int n, float* odata)
+                {
+                        int i = 0;
+
+                        const __m128 w = _mm_set1_ps(weight);
+                        for ( ; i + 4 <= n; i += 4)
+                        {
+                                _mm_storeu_ps(odata + i, _mm_add_ps(_mm_loadu_ps(odata + i), _mm_mul_ps(_mm_loadu_ps(idata + i), w)));
+                        }
+                        for ( ; i < n; i ++)
+                        {
+                                odata[i] += idata[i] * weight;
+                        }
+                }
+
+                __attribute__((target("sse2")))
+                void mad_sse2(const double* idata, double weight, int n, double* odata)
+                {
+                        int i = 0;
+
+                        const __m128d w = _mm_set1_pd(weight);
+                        for ( ; i + 2 <= n; i += 2)
+                        {
+                                _mm_storeu_pd(odata + i, _mm_add_pd(_mm_loadu_pd(odata + i), _mm_mul_pd(_mm_loadu_pd(idata + i), w)));
+                        }
+                        for ( ; i < n; i ++)
+                        {
+                                odata[i] += idata[i] * weight;
+                        }
+                }
+
+                ///
+                /// AVX2 + FMA kernels
+                ///
+                __attribute__((target("avx2,fma")))
+                float dot_avx2(const float* a, const float* b, int n)
+                {
+                        int i = 0;
+
+                        __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+                        for ( ; i + 16 <= n; i += 16)
+                        {
+                                sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 0), _mm256_loadu_ps(b + i + 0), sum0);
+                                sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+                        }
+
+                        float buff[8];
+                        _mm256_storeu_ps(buff, _mm256_add_ps(sum0, sum1));
+
+                        float sum = buff[0] + buff[1] + buff[2] + buff[3] + buff[4] + buff[5] + buff[6] + buff[7];
+                        for ( ; i < n; i ++)
+                        {
+                                sum += a[i] * b[i];
+                        }
+
+                        return sum;
+                }
+
+                __attribute__((target("avx2,fma")))
+                double dot_avx2(const double* a, const double* b, int n)
+                {
+                        int i = 0;
+
+                        __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();
+                        for ( ; i + 8 <= n; i += 8)
+                        {
+                                sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 0), _mm256_loadu_pd(b + i + 0), sum0);
+                                sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), sum1);
+                        }
+
+                        double buff[4];
+                        _mm256_storeu_pd(buff, _mm256_add_pd(sum0, sum1));
+
+                        double sum = buff[0] + buff[1] + buff[2] + buff[3];
+                        for ( ; i < n; i ++)
+                        {
+                                sum += a[i] * b[i];
+                        }
+
+                        return sum;
+                }
+
+                __attribute__((target("avx2,fma")))
+                void mad_avx2(const float* idata, float weight, int n, float* odata)
+                {
+                        int i = 0;
+
+                        const __m256 w = _mm256_set1_ps(weight);
+                        for ( ; i + 8 <= n; i += 8)
+                        {
+                                _mm256_storeu_ps(odata + i, _mm256_fmadd_ps(_mm256_loadu_ps(idata + i), w, _mm256_loadu_ps(odata + i)));
+                        }
+                        for ( ; i < n; i ++)
+                        {
+                                odata[i] += idata[i] * weight;
+                        }
+                }
+
+                __attribute__((target("avx2,fma")))
+                void mad_avx2(const double* idata, double weight, int n, double* odata)
+                {
+                        int i = 0;
+
+                        const __m256d w = _mm256_set1_pd(weight);
+                        for ( ; i + 4 <= n; i += 4)
+                        {
+                                _mm256_storeu_pd(odata + i, _mm256_fmadd_pd(_mm256_loadu_pd(idata + i), w, _mm256_loadu_pd(odata + i)));
+                        }
+                        for ( ; i < n; i ++)
+                        {
+                                odata[i] += idata[i] * weight;
+                        }
+                }
+
+                ///
+                /// AVX-512 kernels (the tails are processed with masked loads & stores)
+                ///
+                __attribute__((target("avx512f")))
+                float dot_avx512(const float* a, const float* b, int n)
+                {
+                        int i = 0;
+
+                        __m512 sum0 = _mm512_setzero_ps(), sum1 = _mm512_setzero_ps();
+                        for ( ; i + 32 <= n; i += 32)
+                        {
+                                sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 0), _mm512_loadu_ps(b + i + 0), sum0);
+                                sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), sum1);
+                        }
+                        for ( ; i < n; i += 16)
+                        {
+                                const __mmask16 mask = n - i >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << (n - i)) - 1);
+                                sum0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), sum0);
+                        }
+
+                        float buff[16];
+                        _mm512_storeu_ps(buff, _mm512_add_ps(sum0, sum1));
+
+                        float sum = 0;
+                        for (int k = 0; k < 16; k ++)
+                        {
+                                sum += buff[k];
+                        }
+
+                        return sum;
+                }
+
+                __attribute__((target("avx512f")))
+                double dot_avx512(const double* a, const double* b, int n)
+                {
+                        int i = 0;
+
+                        __m512d sum0 = _mm512_setzero_pd(), sum1 = _mm512_setzero_pd();
+                        for ( ; i + 16 <= n; i += 16)
+                        {
+                                sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 0), _mm512_loadu_pd(b + i + 0), sum0);
+                                sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), sum1);
+                        }
+                        for ( ; i < n; i += 8)
+                        {
+                                const __mmask8 mask = n - i >= 8 ? 0xFF : static_cast<__mmask8>((1u << (n - i)) - 1);
+                                sum0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, a + i), _mm512_maskz_loadu_pd(mask, b + i), sum0);
+                        }
+
+                        double buff[8];
+                        _mm512_storeu_pd(buff, _mm512_add_pd(sum0, sum1));
+
+                        double sum = 0;
+                        for (int k = 0; k < 8; k ++)
+                        {
+                                sum += buff[k];
+                        }
+
+                        return sum;
+                }
+
+                __attribute__((target("avx512f")))
+                void mad_avx512(const float* idata, float weight, int n, float* odata)
+                {
+                        int i = 0;
+
+                        const __m512 w = _mm512_set1_ps(weight);
+                        for ( ; i + 16 <= n; i += 16)
+                        {
+                                _mm512_storeu_ps(odata + i, _mm512_fmadd_ps(_mm512_loadu_ps(idata + i), w, _mm512_loadu_ps(odata + i)));
+                        }
+                        if (i < n)
+                        {
+                                const __mmask16 mask = static_cast<__mmask16>((1u << (n - i)) - 1);
+                                _mm512_mask_storeu_ps(odata + i, mask, _mm512_fmadd_ps(
+                                        _mm512_maskz_loadu_ps(mask, idata + i), w, _mm512_maskz_loadu_ps(mask, odata + i)));
+                        }
+                }
+
+                __attribute__((target("avx512f")))
+                void mad_avx512(const double* idata, double weight, int n, double* odata)
+                {
+                        int i = 0;
+
+                        const __m512d w = _mm512_set1_pd(weight);
+                        for ( ; i + 8 <= n; i += 8)
+                        {
+                                _mm512_storeu_pd(odata + i, _mm512_fmadd_pd(_mm512_loadu_pd(idata + i), w, _mm512_loadu_pd(odata + i)));
+                        }
+                        if (i < n)
+                        {
+                                const __mmask8 mask = static_cast<__mmask8>((1u << (n - i)) - 1);
+                                _mm512_mask_storeu_pd(odata + i, mask, _mm512_fmadd_pd(
+                                        _mm512_maskz_loadu_pd(mask, idata + i), w, _mm512_maskz_loadu_pd(mask, odata + i)));
+                        }
+                }
+#endif
+
+                template
+                <
+                        typename tscalar
+                >
+                math::simd_dot_t<tscalar> get_dot(math::simd_isa isa)
+                {
+                        if (!math::simd_supported(isa))
+                        {
+                                return math::dot<tscalar>;
+                        }
+
+                        switch (isa)
+                        {
+#ifdef NANOCV_SIMD_X86
+                        case math::simd_isa::sse2:      return dot_sse2;
+                        case math::simd_isa::avx2:      return dot_avx2;
+                        case math::simd_isa::avx512:    return dot_avx512;
+#endif
+                        default:                        return math::dot<tscalar>;
+                        }
+                }
+
+                template
+                <
+                        typename tscalar
+                >
+                math::simd_mad_t<tscalar> get_mad(math::simd_isa isa)
+                {
+                        if (!math::simd_supported(isa))
+                        {
+                                return math::mad<tscalar>;
+                        }
+
+                        switch (isa)
+                        {
+#ifdef NANOCV_SIMD_X86
+                        case math::simd_isa::sse2:      return mad_sse2;
+                        case math::simd_isa::avx2:      return mad_avx2;
+                        case math::simd_isa::avx512:    return mad_avx512;
+#endif
+                        default:                        return math::mad<tscalar>;
+                        }
+                }
+
+                math::simd_isa detect_best()
+                {
+                        const math::simd_isa isas[] =
+                        {
+                                math::simd_isa::avx512,
+                                math::simd_isa::avx2,
+                                math::simd_isa::sse2
+                        };
+
+                        for (const auto isa : isas)
+                        {
+                                if (math::simd_supported(isa))
+                                {
+                                        return isa;
+                                }
+                        }
+
+                        return math::simd_isa::none;
+                }
+
+                // the kernels are selected once (at the first call)
+                template
+                <
+                        typename tscalar
+                >
+                const math::simd_dot_t<tscalar>& best_dot()
+                {
+                        static const auto op = get_dot<tscalar>(math::simd_best());
+                        return op;
+                }
+
+                template
+                <
+                        typename tscalar
+                >
+                const math::simd_mad_t<tscalar>& best_mad()
+                {
+                        static const auto op = get_mad<tscalar>(math::simd_best());
+                        return op;
+                }
+        }
+
+        bool math::simd_supported(simd_isa isa)
+        {
+#ifdef NANOCV_SIMD_X86
+                __builtin_cpu_init();
+
+                switch (isa)
+                {
+                case simd_isa::none:    return true;
+                case simd_isa::sse2:    return __builtin_cpu_supports("sse2");
+                case simd_isa::avx2:    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+                case simd_isa::avx512:  return __builtin_cpu_supports("avx512f");
+                default:                return false;
+                }
+#else
+                return isa == simd_isa::none;
+#endif
+        }
+
+        math::simd_isa math::simd_best()
+        {
+                static const simd_isa isa = detect_best();
+                return isa;
+        }
+
+        template <>
+        math::simd_dot_t<float> math::simd_dot<float>(simd_isa isa)
+        {
+                return get_dot<float>(isa);
+        }
+
+        template <>
+        math::simd_dot_t<double> math::simd_dot<double>(simd_isa isa)
+        {
+                return get_dot<double>(isa);
+        }
+
+        template <>
+        math::simd_mad_t<float> math::simd_mad<float>(simd_isa isa)
+        {
+                return get_mad<float>(isa);
+        }
+
+        template <>
+        math::simd_mad_t<double> math::simd_mad<double>(simd_isa isa)
+        {
+                return get_mad<double>(isa);
+        }
+
+        template <>
+        float math::dot_simd<float>(const float* a, const float* b, int n)
+        {
+                return best_dot<float>()(a, b, n);
+        }
+
+        template <>
+        double math::dot_simd<double>(const double* a, const double* b, int n)
+        {
+                return best_dot<double>()(a, b, n);
+        }
+
+        template <>
+        void math::mad_simd<float>(const float* idata, float weight, int n, float* odata)
+        {
+                best_mad<float>()(idata, weight, n, odata);
+        }
+
+        template <>
+        void math::mad_simd<double>(const double* idata, double weight, int n, double* odata)
+        {
+                best_mad<double>()(idata, weight, n, odata);
+        }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "dot.hpp"
+#include "mad.hpp"
+#include "nanocv/text/enum_string.hpp"
+#include <cstddef>
+
+namespace ncv
+{
+        namespace math
+        {
+                ///
+                /// \brief SIMD instruction sets with explicitly vectorized kernels
+                ///
+                enum class simd_isa
+                {
+                        none = 0,               ///< plain C++ (auto-vectorized by the compiler, if possible)
+                        sse2,                   ///< SSE2 (128-bit)
+                        avx2,                   ///< AVX2 + FMA (256-bit)
+                        avx512                  ///< AVX-512F (512-bit)
+                };
+
+                ///
+                /// \brief number of scalars processed at once with the given instruction set
+                ///
+                template
+                <
+                        typename tscalar
+                >
+                std::size_t simd_width(simd_isa isa)
+                {
+                        switch (isa)
+                        {
+                        case simd_isa::avx512:  return 64 / sizeof(tscalar);
+                        case simd_isa::avx2:    return 32 / sizeof(tscalar);
+                        default:                return 16 / sizeof(tscalar);
+                        }
+                }
+
+                ///
+                /// \brief dot-product & mad-product kernels
+                ///
+                template <typename tscalar>
+                using simd_dot_t = tscalar (*)(const tscalar*, const tscalar*, int);
+
+                template <typename tscalar>
+                using simd_mad_t = void (*)(const tscalar*, tscalar, int, tscalar*);
+
+                ///
+                /// \brief check if the given instruction set is supported by the CPU (using CPUID)
+                ///
+                NANOCV_PUBLIC bool simd_supported(simd_isa isa);
+
+                ///
+                /// \brief the best instruction set supported by the CPU (detected once at startup)
+                ///
+                NANOCV_PUBLIC simd_isa simd_best();
+
+                ///
+                /// \brief the kernels implemented with the given instruction set
+                ///     (plain C++ for unsupported instruction sets and scalar types)
+                ///
+                template
+                <
+                        typename tscalar
+                >
+                simd_dot_t<tscalar> simd_dot(simd_isa)
+                {
+                        return math::dot<tscalar>;
+                }
+
+                template
+                <
+                        typename tscalar
+                >
+                simd_mad_t<tscalar> simd_mad(simd_isa)
+                {
+                        return math::mad<tscalar>;
+                }
+
+                template <>
+                NANOCV_PUBLIC simd_dot_t<float> simd_dot<float>(simd_isa);
+
+                template <>
+                NANOCV_PUBLIC simd_dot_t<double> simd_dot<double>(simd_isa);
+
+                template <>
+                NANOCV_PUBLIC simd_mad_t<float> simd_mad<float>(simd_isa);
+
+                template <>
+                NANOCV_PUBLIC simd_mad_t<double> simd_mad<double>(simd_isa);
+
+                ///
+                /// \brief general dot-product using the best available instruction set
+                ///
+                template
+                <
+                        typename tscalar
+                >
+                tscalar dot_simd(const tscalar* a, const tscalar* b, int n)
+                {
+                        return math::dot<tscalar>(a, b, n);
+                }
+
+                template <>
+                NANOCV_PUBLIC float dot_simd<float>(const float* a, const float* b, int n);
+
+                template <>
+                NANOCV_PUBLIC double dot_simd<double>(const double* a, const double* b, int n);
+
+                ///
+                /// \brief general mad-product using the best available instruction set
+                ///
+                template
+                <
+                        typename tscalar
+                >
+                void mad_simd(const tscalar* idata, tscalar weight, int n, tscalar* odata)
+                {
+                        math::mad<tscalar>(idata, weight, n, odata);
+                }
+
+                template <>
+                NANOCV_PUBLIC void mad_simd<float>(const float* idata, float weight, int n, float* odata);
+
+                template <>
+                NANOCV_PUBLIC void mad_simd<double>(const double* idata, double weight, int n, double* odata);
+        }
+
+        // string cast for enumerations
+        namespace text
+        {
+                template <>
+                inline std::map<math::simd_isa, std::string> enum_string<math::simd_isa>()
+                {
+                        return
+                        {
+                                { math::simd_isa::none,         "none" },
+                                { math::simd_isa::sse2,         "sse2" },
+                                { math::simd_isa::avx2,         "avx2" },
+                                { math::simd_isa::avx512,       "avx512" }
+                        };
+                }
+        }
+}
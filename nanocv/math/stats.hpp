@@ -31,6 +31,16 @@ namespace ncv
                         clear();
                 }
 
+                ///
+                /// \brief constructor (e.g. from statistics merged across processes)
+                ///
+                stats_t(tsize count, tscalar sum, tscalar sumsq, tscalar min, tscalar max)
+                        :       m_count(count),
+                                m_sum(sum), m_sumsq(sumsq),
+                                m_min(min), m_max(max)
+                {
+                }
+
                 ///
                 /// \brief update statistics with a new value
                 ///
@@ -91,6 +101,7 @@ namespace ncv
                 tscalar var() const { return _var() / m_count; }
                 tscalar stdev() const { return std::sqrt(m_count > 1 ? _var() / (m_count - 1) : tscalar(0)); }
                 tscalar sum() const { return m_sum; }
+                tscalar sumsq() const { return m_sumsq; }
 
         private:
 
@@ -0,0 +1,342 @@
+#pragma once
+
+#include "conv2d.hpp"
+#include "nanocv/tensor/matrix.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace ncv
+{
+        namespace math
+        {
+                ///
+                /// \brief Winograd minimal filtering algorithms F(m x m, r x r):
+                ///     the m x m output tile Y of the r x r kernel g applied to the (m + r - 1)^2 input tile d is:
+                ///
+                ///     Y = AT * [(G * g * GT) .* (BT * d * B)] * A
+                ///
+                /// NB: the transformation matrices are generated with the Toom-Cook method (points 0, 1, -1, 2, -2).
+                ///
+                namespace winograd
+                {
+                        template
+                        <
+                                int tm,
+                                int tr
+                        >
+                        struct coefficients_t;
+
+                        template <>
+                        struct coefficients_t<2, 3>
+                        {
+                                static const double* AT()
+                                {
+                                        static const double at[] =
+                                        {
+                                                1.0,    1.0,    1.0,    0.0,
+                                                0.0,    1.0,    -1.0,   1.0
+                                        };
+                                        return at;
+                                }
+
+                                static const double* G()
+                                {
+                                        static const double g[] =
+                                        {
+                                                -1.0,   0.0,    0.0,
+                                                0.5,    0.5,    0.5,
+                                                0.5,    -0.5,   0.5,
+                                                0.0,    0.0,    1.0
+                                        };
+                                        return g;
+                                }
+
+                                static const double* BT()
+                                {
+                                        static const double bt[] =
+                                        {
+                                                -1.0,   0.0,    1.0,    0.0,
+                                                0.0,    1.0,    1.0,    0.0,
+                                                0.0,    -1.0,   1.0,    0.0,
+                                                0.0,    -1.0,   0.0,    1.0
+                                        };
+                                        return bt;
+                                }
+                        };
+
+                        template <>
+                        struct coefficients_t<4, 3>
+                        {
+                                static const double* AT()
+                                {
+                                        static const double at[] =
+                                        {
+                                                1.0,    1.0,    1.0,    1.0,    1.0,    0.0,
+                                                0.0,    1.0,    -1.0,   2.0,    -2.0,   0.0,
+                                                0.0,    1.0,    1.0,    4.0,    4.0,    0.0,
+                                                0.0,    1.0,    -1.0,   8.0,    -8.0,   1.0
+                                        };
+                                        return at;
+                                }
+
+                                static const double* G()
+                                {
+                                        static const double g[] =
+                                        {
+                                                1.0 / 4.0,      0.0,            0.0,
+                                                -1.0 / 6.0,     -1.0 / 6.0,     -1.0 / 6.0,
+                                                -1.0 / 6.0,     1.0 / 6.0,      -1.0 / 6.0,
+                                                1.0 / 24.0,     1.0 / 12.0,     1.0 / 6.0,
+                                                1.0 / 24.0,     -1.0 / 12.0,    1.0 / 6.0,
+                                                0.0,            0.0,            1.0
+                                        };
+                                        return g;
+                                }
+
+                                static const double* BT()
+                                {
+                                        static const double bt[] =
+                                        {
+                                                4.0,    0.0,    -5.0,   0.0,    1.0,    0.0,
+                                                0.0,    -4.0,   -4.0,   1.0,    1.0,    0.0,
+                                                0.0,    4.0,    -4.0,   -1.0,   1.0,    0.0,
+                                                0.0,    -2.0,   -1.0,   2.0,    1.0,    0.0,
+                                                0.0,    2.0,    -1.0,   -2.0,   1.0,    0.0,
+                                                0.0,    4.0,    0.0,    -5.0,   0.0,    1.0
+                                        };
+                                        return bt;
+                                }
+                        };
+
+                        template <>
+                        struct coefficients_t<2, 5>
+                        {
+                                static const double* AT()
+                                {
+                                        static const double at[] =
+                                        {
+                                                1.0,    1.0,    1.0,    1.0,    1.0,    0.0,
+                                                0.0,    1.0,    -1.0,   2.0,    -2.0,   1.0
+                                        };
+                                        return at;
+                                }
+
+                                static const double* G()
+                                {
+                                        static const double g[] =
+                                        {
+                                                1.0 / 4.0,      0.0,            0.0,            0.0,            0.0,
+                                                -1.0 / 6.0,     -1.0 / 6.0,     -1.0 / 6.0,     -1.0 / 6.0,     -1.0 / 6.0,
+                                                -1.0 / 6.0,     1.0 / 6.0,      -1.0 / 6.0,     1.0 / 6.0,      -1.0 / 6.0,
+                                                1.0 / 24.0,     1.0 / 12.0,     1.0 / 6.0,      1.0 / 3.0,      2.0 / 3.0,
+                                                1.0 / 24.0,     -1.0 / 12.0,    1.0 / 6.0,      -1.0 / 3.0,     2.0 / 3.0,
+                                                0.0,            0.0,            0.0,            0.0,            1.0
+                                        };
+                                        return g;
+                                }
+
+                                static const double* BT()
+                                {
+                                        return coefficients_t<4, 3>::BT();
+                                }
+                        };
+
+                        ///
+                        /// \brief Winograd transformations for the given output tile size (m) and kernel size (r)
+                        ///
+                        template
+                        <
+                                typename tscalar,
+                                int tm,
+                                int tr
+                        >
+                        class transform_t
+                        {
+                        public:
+
+                                static const int m = tm;                ///< output tile size
+                                static const int r = tr;                ///< kernel size
+                                static const int a = tm + tr - 1;       ///< input tile size
+
+                                typedef typename tensor::fixed_size_matrix_types_t<tscalar, m, a>::tmatrix      tmatrix_at;
+                                typedef typename tensor::fixed_size_matrix_types_t<tscalar, a, r>::tmatrix      tmatrix_g;
+                                typedef typename tensor::fixed_size_matrix_types_t<tscalar, a, a>::tmatrix      tmatrix_a;
+                                typedef typename tensor::fixed_size_matrix_types_t<tscalar, m, m>::tmatrix      tmatrix_m;
+
+                                ///
+                                /// \brief constructor
+                                ///
+                                transform_t()
+                                        :       m_at(tensor::map_matrix(coefficients_t<tm, tr>::AT(), m, a).template cast<tscalar>()),
+                                                m_g(tensor::map_matrix(coefficients_t<tm, tr>::G(), a, r).template cast<tscalar>()),
+                                                m_bt(tensor::map_matrix(coefficients_t<tm, tr>::BT(), a, a).template cast<tscalar>())
+                                {
+                                }
+
+                                ///
+                                /// \brief kernel transform: G * g * GT
+                                ///
+                                template
+                                <
+                                        typename tmatrixk
+                                >
+                                tmatrix_a kernel(const tmatrixk& kdata) const
+                                {
+                                        assert(kdata.rows() == r && kdata.cols() == r);
+
+                                        return m_g * kdata * m_g.transpose();
+                                }
+
+                                ///
+                                /// \brief input tile transform: BT * d * B
+                                ///
+                                tmatrix_a input(const tmatrix_a& ddata) const
+                                {
+                                        return m_bt * ddata * m_bt.transpose();
+                                }
+
+                                ///
+                                /// \brief output tile stored in a padded & aligned buffer, at least as large as the widest vector
+                                ///     (NB: only the first m x m values are used, the padding silences GCC's -Warray-bounds
+                                ///     false positives on the vectorized code for the small tiles, e.g. 2x2)
+                                ///
+                                struct tile_t
+                                {
+                                        static const int size = std::max(m * m, static_cast<int>(64 / sizeof(tscalar)));
+
+                                        Eigen::Map<tmatrix_m> map() { return Eigen::Map<tmatrix_m>(m_data); }
+
+                                        alignas(64) tscalar     m_data[size];
+                                };
+
+                                ///
+                                /// \brief output tile (inverse) transform into the given tile: AT * x * A
+                                ///
+                                void output(const tmatrix_a& xdata, tile_t& ydata) const
+                                {
+                                        ydata.map().noalias() = m_at * xdata * m_at.transpose();
+                                }
+
+                                ///
+                                /// \brief load the input tile starting at (r0, c0) from a plane (zero-padded outside the plane)
+                                ///
+                                template
+                                <
+                                        typename tindex
+                                >
+                                static void load(const tscalar* idata, tindex irows, tindex icols,
+                                        tindex r0, tindex c0, tmatrix_a& ddata)
+                                {
+                                        if (r0 >= 0 && c0 >= 0 && r0 + a <= irows && c0 + a <= icols)
+                                        {
+                                                ddata = Eigen::Map<const tmatrix_a, Eigen::Unaligned, Eigen::OuterStride<>>(
+                                                        idata + r0 * icols + c0, Eigen::OuterStride<>(icols));
+                                        }
+                                        else
+                                        {
+                                                ddata.setZero();
+
+                                                const tindex rbeg = std::max(r0, tindex(0)), rend = std::min(r0 + a, irows);
+                                                const tindex cbeg = std::max(c0, tindex(0)), cend = std::min(c0 + a, icols);
+                                                for (tindex rr = rbeg; rr < rend; rr ++)
+                                                {
+                                                        for (tindex cc = cbeg; cc < cend; cc ++)
+                                                        {
+                                                                ddata(rr - r0, cc - c0) = idata[rr * icols + cc];
+                                                        }
+                                                }
+                                        }
+                                }
+
+                        private:
+
+                                // attributes
+                                tmatrix_at      m_at;
+                                tmatrix_g       m_g;
+                                tmatrix_a       m_bt;
+                        };
+                }
+
+                ///
+                /// \brief 2D convolution: odata += idata @ kdata (using the Winograd F(m x m, r x r) algorithm)
+                ///
+                template
+                <
+                        int tm,
+                        int tr,
+                        typename tmatrixi,
+                        typename tmatrixk = tmatrixi,
+                        typename tmatrixo = tmatrixi,
+                        typename tscalar = typename tmatrixi::Scalar
+                >
+                void conv2d_winograd(const tmatrixi& idata, const tmatrixk& kdata, tmatrixo& odata)
+                {
+                        assert(idata.rows() + 1 == kdata.rows() + odata.rows());
+                        assert(idata.cols() + 1 == kdata.cols() + odata.cols());
+
+                        typedef winograd::transform_t<tscalar, tm, tr> transform_t;
+                        typedef typename transform_t::tmatrix_a tmatrix_a;
+
+                        const transform_t transform;
+                        const tmatrix_a udata = transform.kernel(kdata);
+
+                        const auto irows = static_cast<int>(idata.rows());
+                        const auto icols = static_cast<int>(idata.cols());
+                        const auto orows = static_cast<int>(odata.rows());
+                        const auto ocols = static_cast<int>(odata.cols());
+
+                        tmatrix_a ddata;
+                        typename transform_t::tile_t ydata;
+                        for (int r = 0; r < orows; r += tm)
+                        {
+                                for (int c = 0; c < ocols; c += tm)
+                                {
+                                        transform_t::load(idata.data(), irows, icols, r, c, ddata);
+
+                                        transform.output(udata.cwiseProduct(transform.input(ddata)), ydata);
+
+                                        const int mrows = std::min(tm, orows - r);
+                                        const int mcols = std::min(tm, ocols - c);
+                                        odata.block(r, c, mrows, mcols) += ydata.map().topLeftCorner(mrows, mcols);
+                                }
+                        }
+                }
+
+                ///
+                /// \brief 2D convolution: odata += idata @ kdata
+                ///     (using the Winograd algorithm for 3x3 and 5x5 kernels and the direct method otherwise)
+                ///
+                template
+                <
+                        typename tmatrixi,
+                        typename tmatrixk = tmatrixi,
+                        typename tmatrixo = tmatrixi,
+                        typename tscalar = typename tmatrixi::Scalar
+                >
+                void conv2d_wino(const tmatrixi& idata, const tmatrixk& kdata, tmatrixo& odata)
+                {
+                        assert(idata.rows() + 1 == kdata.rows() + odata.rows());
+                        assert(idata.cols() + 1 == kdata.cols() + odata.cols());
+
+                        if (kdata.rows() == 3 && kdata.cols() == 3)
+                        {
+                                if (odata.rows() >= 4 && odata.cols() >= 4)
+                                {
+                                        conv2d_winograd<4, 3>(idata, kdata, odata);
+                                }
+                                else
+                                {
+                                        conv2d_winograd<2, 3>(idata, kdata, odata);
+                                }
+                        }
+                        else if (kdata.rows() == 5 && kdata.cols() == 5)
+                        {
+                                conv2d_winograd<2, 5>(idata, kdata, odata);
+                        }
+                        else
+                        {
+                                conv2d_dyn(idata, kdata, odata);
+                        }
+                }
+        }
+}
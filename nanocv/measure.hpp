@@ -4,6 +4,7 @@
 #include "timer.h"
 #include "math/stats.hpp"
 #include <cstdlib>
+#include <algorithm>
 
 namespace ncv
 {
@@ -66,4 +67,13 @@ namespace ncv
 
                 return static_cast<std::size_t>(stats.min());
         }
+
+        ///
+        /// \brief throughput (in GFLOP/s) of an operation with the given number of floating point operations
+        ///     that takes the given number of microseconds
+        ///
+        inline double gflops(std::size_t flops, std::size_t usec)
+        {
+                return static_cast<double>(flops) / static_cast<double>(std::max(usec, std::size_t(1))) / 1e+3;
+        }
 }
@@ -67,7 +67,7 @@ namespace ncv
 
 //                opt_state_t minimize(
 //                        const opt_problem_t& problem,
-//                        const vector_t& x0, size_t iterations, scalar_t epsilon, size_t history_size)
+//                        const opt_vector_t& x0, size_t iterations, opt_scalar_t epsilon, size_t history_size)
 //                {
 //                        lbfgs_parameter_t lbfgsparams;
 //                        lbfgs_parameter_init(&lbfgsparams);
@@ -98,8 +98,8 @@ namespace ncv
                 const opt_opwlog_t& fn_wlog,
                 const opt_opelog_t& fn_elog,
                 const opt_opulog_t& fn_ulog,
-                const vector_t& x0,
-                optim::batch_optimizer optimizer, size_t iterations, scalar_t epsilon, size_t history_size)
+                const opt_vector_t& x0,
+                optim::batch_optimizer optimizer, size_t iterations, opt_scalar_t epsilon, size_t history_size)
         {
                 switch (optimizer)
                 {
@@ -140,8 +140,8 @@ namespace ncv
                 const opt_opwlog_t& fn_wlog,
                 const opt_opelog_t& fn_elog,
                 const opt_opulog_t& fn_ulog,
-                const vector_t& x0,
-                optim::batch_optimizer optimizer, size_t iterations, scalar_t epsilon,
+                const opt_vector_t& x0,
+                optim::batch_optimizer optimizer, size_t iterations, opt_scalar_t epsilon,
                 optim::ls_initializer lsinit, optim::ls_strategy lsstrat,
                 size_t history_size)
         {
@@ -222,8 +222,8 @@ namespace ncv
                 const opt_opwlog_t& fn_wlog,
                 const opt_opelog_t& fn_elog,
                 const opt_opulog_t& fn_ulog,
-                const vector_t& x0,
-                optim::stoch_optimizer optimizer, size_t epochs, size_t epoch_size, scalar_t alpha0, scalar_t decay)
+                const opt_vector_t& x0,
+                optim::stoch_optimizer optimizer, size_t epochs, size_t epoch_size, opt_scalar_t alpha0, opt_scalar_t decay)
         {
                 const opt_problem_t problem(fn_size, fn_fval, fn_grad);
 
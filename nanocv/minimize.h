@@ -14,8 +14,8 @@ namespace ncv
                 const opt_opwlog_t& fn_wlog,
                 const opt_opelog_t& fn_elog,
                 const opt_opulog_t& fn_ulog,
-                const vector_t& x0,
-                optim::batch_optimizer, size_t iterations, scalar_t epsilon,
+                const opt_vector_t& x0,
+                optim::batch_optimizer, size_t iterations, opt_scalar_t epsilon,
                 size_t history_size = 6);
 
         ///
@@ -28,8 +28,8 @@ namespace ncv
                 const opt_opwlog_t& fn_wlog,
                 const opt_opelog_t& fn_elog,
                 const opt_opulog_t& fn_ulog,
-                const vector_t& x0,
-                optim::batch_optimizer, size_t iterations, scalar_t epsilon,
+                const opt_vector_t& x0,
+                optim::batch_optimizer, size_t iterations, opt_scalar_t epsilon,
                 optim::ls_initializer,
                 optim::ls_strategy,
                 size_t history_size = 6);
@@ -44,8 +44,8 @@ namespace ncv
                 const opt_opwlog_t& fn_wlog,
                 const opt_opelog_t& fn_elog,
                 const opt_opulog_t& fn_ulog,
-                const vector_t& x0,
-                optim::stoch_optimizer, size_t epochs, size_t epoch_size, scalar_t alpha0, scalar_t decay = 0.50);
+                const opt_vector_t& x0,
+                optim::stoch_optimizer, size_t epochs, size_t epoch_size, opt_scalar_t alpha0, opt_scalar_t decay = 0.50);
 
         ///
         /// \brief warning logging operator
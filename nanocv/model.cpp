@@ -19,7 +19,8 @@ namespace ncv
                         m_rows(0),
                         m_cols(0),
                         m_outputs(0),
-                        m_color(color_mode::luma)
+                        m_color(color_mode::luma),
+                        m_threads(1)
         {
         }
 
@@ -56,23 +57,26 @@ namespace ncv
 
         const tensor_t& model_t::output(const image_t& image, coord_t x, coord_t y) const
         {
-                return output(make_input(image, x, y));
+                make_input(image, x, y, m_input);
+
+                return output(m_input);
         }
 
         const tensor_t& model_t::output(const vector_t& input) const
         {
                 assert(static_cast<size_t>(input.size()) == isize());
 
-                tensor_t xinput(idims(), irows(), icols());
-                xinput.vector() = input;
+                m_input.resize(idims(), irows(), icols());
+                m_input.vector() = input;
 
-                return output(xinput);
+                return output(m_input);
         }
 
         tensor_t model_t::make_input(const image_t& image, coord_t x, coord_t y) const
         {
-                const rect_t region = rect_t(x, y, icols(), irows());
-                return image.to_tensor(region);
+                tensor_t input;
+                make_input(image, x, y, input);
+                return input;
         }
 
         tensor_t model_t::make_input(const image_t& image, const rect_t& region) const
@@ -80,6 +84,31 @@ namespace ncv
                 return make_input(image, region.left(), region.top());
         }
 
+        void model_t::make_input(const image_t& image, coord_t x, coord_t y, tensor_t& input) const
+        {
+                const rect_t region = rect_t(x, y, icols(), irows());
+                image.to_tensor(region, input);
+        }
+
+        void model_t::make_input(const image_t& image, const rect_t& region, tensor_t& input) const
+        {
+                make_input(image, region.left(), region.top(), input);
+        }
+
+        vector_t model_t::gparam(const vector_t& output) const
+        {
+                vector_t gradient;
+                gparam(output, gradient);
+                return gradient;
+        }
+
+        vector_t model_t::gparam(const matrix_t& outputs) const
+        {
+                vector_t gradient;
+                gparam(outputs, gradient);
+                return gradient;
+        }
+
         size_t model_t::idims() const
         {
                 switch (m_color)
@@ -126,19 +155,19 @@ namespace ncv
                         return isize();
                 };
 
-                auto fn_fval = [&] (const vector_t& x)
+                auto fn_fval = [&] (const opt_vector_t& x)
                 {
-                        const tensor_t output = this->output(x);
+                        const tensor_t output = this->output(x.cast<scalar_t>());
 
                         return loss.value(target, output.vector());
                 };
 
-                auto fn_grad = [&] (const vector_t& x, vector_t& gx)
+                auto fn_grad = [&] (const opt_vector_t& x, opt_vector_t& gx)
                 {
-                        const tensor_t output = this->output(x);
+                        const tensor_t output = this->output(x.cast<scalar_t>());
                         const vector_t ograd = loss.vgrad(target, output.vector());
 
-                        gx = this->ginput(ograd).vector();
+                        gx = this->ginput(ograd).vector().cast<opt_scalar_t>();
 
                         return loss.value(target, output.vector());
                 };
@@ -171,9 +200,9 @@ namespace ncv
 
                 const opt_state_t result = ncv::minimize(
                         fn_size, fn_fval, fn_grad, fn_wlog, fn_elog, fn_ulog,
-                        input.vector(), optimizer, iterations, epsilon);
+                        input.vector().cast<opt_scalar_t>(), optimizer, iterations, epsilon);
 
-                input.vector() = result.x;
+                input.vector() = result.x.cast<scalar_t>();
 
                 log_info() << "[loss = " << result.f
                            << ", grad = " << result.g.lpNorm<Eigen::Infinity>()
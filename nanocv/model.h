@@ -57,6 +57,35 @@ namespace ncv
                 const tensor_t& output(const vector_t& input) const;
                 virtual const tensor_t& output(const tensor_t& input) const = 0;
 
+                ///
+                /// \brief set the number of threads used to compute the output of a single sample
+                ///     (1 - sequential, 0 - all available), e.g. to reduce the latency of online evaluation
+                ///
+                /// NB: the samples are usually processed in parallel (e.g. by the accumulator),
+                ///     so this is useful only when evaluating one sample at a time.
+                ///
+                void set_threads(size_t nthreads) { m_threads = nthreads; }
+
+                ///
+                /// \brief compute the model's outputs for a batch of samples:
+                ///     the inputs are stored contiguously as (count x idims) x irows x icols and
+                ///     the outputs are returned as (count x osize) x 1 x 1
+                ///
+                virtual const tensor_t& output(const tensor_t& inputs, size_t count) const = 0;
+
+                ///
+                /// \brief compose the input data
+                ///
+                tensor_t make_input(const image_t& image, coord_t x, coord_t y) const;
+                tensor_t make_input(const image_t& image, const rect_t& region) const;
+
+                ///
+                /// \brief compose the input data into the given workspace
+                ///     (NB: no allocation if it has already the right size, e.g. when reused for each sample)
+                ///
+                void make_input(const image_t& image, coord_t x, coord_t y, tensor_t& input) const;
+                void make_input(const image_t& image, const rect_t& region, tensor_t& input) const;
+
                 ///
                 /// \brief save its parameters to file
                 ///
@@ -90,7 +119,20 @@ namespace ncv
                 ///
                 /// \brief compute the model's gradient wrt parameters
                 ///
-                virtual vector_t gparam(const vector_t& output) const = 0;
+                vector_t gparam(const vector_t& output) const;
+
+                ///
+                /// \brief compute the model's gradient wrt parameters into the given workspace
+                ///     (NB: no allocation if it has already the right size)
+                ///
+                virtual void gparam(const vector_t& output, vector_t& gradient) const = 0;
+
+                ///
+                /// \brief compute the model's gradient wrt parameters summed over the batch of samples
+                ///     processed by the last batched ::output call (the gradients wrt the outputs are given as rows)
+                ///
+                vector_t gparam(const matrix_t& outputs) const;
+                virtual void gparam(const matrix_t& outputs, vector_t& gradient) const = 0;
 
                 ///
                 /// \brief compute the model's gradient wrt inputs
@@ -110,15 +152,10 @@ namespace ncv
                 size_t osize() const { return m_outputs; }
                 virtual size_t psize() const = 0;
                 color_mode color() const { return m_color; }
+                size_t threads() const { return m_threads; }
 
         protected:
 
-                ///
-                /// \brief compose the input data
-                ///
-                tensor_t make_input(const image_t& image, coord_t x, coord_t y) const;
-                tensor_t make_input(const image_t& image, const rect_t& region) const;
-
                 // save/load from file
                 virtual bool save(boost::archive::binary_oarchive& oa) const = 0;
                 virtual bool load(boost::archive::binary_iarchive& ia) = 0;
@@ -132,6 +169,8 @@ namespace ncv
                 size_t          m_rows, m_cols;         ///< input patch size
                 size_t          m_outputs;              ///< output size
                 color_mode      m_color;                ///< input color mode
+                size_t          m_threads;              ///< number of threads to compute the output of a single sample
+                mutable tensor_t m_input;               ///< input workspace (e.g. to compute the output of an image patch)
         };
 }
 
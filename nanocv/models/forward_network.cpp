@@ -3,6 +3,7 @@
 #include "nanocv/math/numeric.hpp"
 #include "nanocv/math/cast.hpp"
 #include "nanocv/tensor/serialize.hpp"
+#include "nanocv/tensor/blocked.hpp"
 #include <iomanip>
 
 namespace ncv
@@ -14,7 +15,9 @@ namespace ncv
 
         forward_network_t::forward_network_t(const forward_network_t& other)
                 :       model_t(other),
-                        m_layers(other.m_layers)
+                        m_layers(other.m_layers),
+                        m_groups(other.m_groups),
+                        m_blocked(other.m_blocked)
         {
                 for (size_t l = 0; l < n_layers(); l ++)
                 {
@@ -28,6 +31,8 @@ namespace ncv
                 {
                         model_t::operator=(other);
                         std::swap(m_layers, other.m_layers);
+                        std::swap(m_groups, other.m_groups);
+                        std::swap(m_blocked, other.m_blocked);
                 }
 
                 return *this;
@@ -36,14 +41,81 @@ namespace ncv
         const tensor_t& forward_network_t::output(const tensor_t& _input) const
         {
                 const tensor_t* input = &_input;
+
+                // multi-threaded: the work of each layer is split between threads (e.g. to reduce the latency)
+                //      NB: the layers are not fused, as the planes are computed concurrently
+                if (threads() != 1)
+                {
+                        for (const rlayer_t& layer : m_layers)
+                        {
+                                input = &layer->output_parallel(*input, threads());
+                        }
+
+                        return *input;
+                }
+
+                size_t begin = 0;
+                for (size_t g = 0; g < m_groups.size(); g ++)
+                {
+                        const size_t size = m_groups[g];
+                        const size_t end = begin + size;
+
+                        if (m_blocked[g])
+                        {
+                                // channel-blocked layers: convert only the group's input & output
+                                const size_t block = layer_block_size();
+
+                                tensor::block(*input, block, m_xdata);
+
+                                input = &m_xdata;
+                                for (size_t l = begin; l < end; l ++)
+                                {
+                                        input = &m_layers[l]->output_blocked(*input, block);
+                                }
+
+                                tensor::unblock(*input, m_layers[end - 1]->odims(), block, m_odata);
+
+                                input = &m_odata;
+                        }
+
+                        else if (size == 1)
+                        {
+                                input = &m_layers[begin]->output(*input);
+                        }
+
+                        else
+                        {
+                                // fused layers: process each output plane through all layers of the group
+                                const tensor_t* group_input = input;
+                                for (size_t o = 0; o < m_layers[begin]->odims(); o ++)
+                                {
+                                        input = group_input;
+                                        for (size_t l = begin; l < end; l ++)
+                                        {
+                                                input = &m_layers[l]->output_plane(*input, o);
+                                        }
+                                }
+                        }
+
+                        begin = end;
+                }
+
+		return *input;
+        }
+
+        const tensor_t& forward_network_t::output(const tensor_t& _inputs, size_t count) const
+        {
+                assert(_inputs.dims() == count * idims());
+
+                const tensor_t* inputs = &_inputs;
                 for (rlayers_t::const_iterator it = m_layers.begin(); it != m_layers.end(); ++ it)
                 {
                         const rlayer_t& layer = *it;
 
-                        input = &layer->output(*input);
+                        inputs = &layer->output(*inputs, count);
                 }
 
-		return *input;
+                return *inputs;
         }
 
         const tensor_t& forward_network_t::ginput(const vector_t& _output) const
@@ -52,11 +124,11 @@ namespace ncv
                 assert(!m_layers.empty());
 
                 // output (gradient)
-                tensor_t output(osize(), 1, 1);
-                tensor::load(output, _output.data());
+                m_ograd.resize(osize(), 1, 1);
+                tensor::load(m_ograd, _output.data());
 
                 // backward step
-                const tensor_t* poutput = &output;
+                const tensor_t* poutput = &m_ograd;
                 for (rlayers_t::const_reverse_iterator it = m_layers.rbegin(); it != m_layers.rend(); ++ it)
                 {
                         const rlayer_t& layer = *it;
@@ -67,20 +139,20 @@ namespace ncv
                 return *poutput;
         }
 
-        vector_t forward_network_t::gparam(const vector_t& _output) const
+        void forward_network_t::gparam(const vector_t& _output, vector_t& gradient) const
         {
                 assert(static_cast<size_t>(_output.size()) == osize());
                 assert(!m_layers.empty());
 
                 // output (gradient)
-                tensor_t output(osize(), 1, 1);
-                tensor::load(output, _output.data());
+                m_ograd.resize(osize(), 1, 1);
+                tensor::load(m_ograd, _output.data());
 
                 // parameter gradient
-                vector_t gradient(psize());
+                gradient.resize(psize());
 
                 // backward step
-                const tensor_t* poutput = &output;
+                const tensor_t* poutput = &m_ograd;
                 scalar_t* gparamient = gradient.data() + gradient.size();
 
                 for (rlayers_t::const_reverse_iterator it = m_layers.rbegin(); it != m_layers.rend(); ++ it)
@@ -97,8 +169,40 @@ namespace ncv
                         }
                         -- it;
                 }
+        }
+
+        void forward_network_t::gparam(const matrix_t& _outputs, vector_t& gradient) const
+        {
+                assert(static_cast<size_t>(_outputs.cols()) == osize());
+                assert(!m_layers.empty());
+
+                const size_t count = static_cast<size_t>(_outputs.rows());
+
+                // outputs (gradients): one row per sample
+                m_ograd.resize(count * osize(), 1, 1);
+                tensor::load(m_ograd, _outputs.data());
+
+                // parameter gradient (summed over the batch)
+                gradient.resize(psize());
+
+                // backward step
+                const tensor_t* poutputs = &m_ograd;
+                scalar_t* gparamient = gradient.data() + gradient.size();
+
+                for (rlayers_t::const_reverse_iterator it = m_layers.rbegin(); it != m_layers.rend(); ++ it)
+                {
+                        const rlayer_t& layer = *it;
+
+                        gparamient -= layer->psize();
+                        layer->gparam(*poutputs, count, gparamient);
 
-                return gradient;
+                        ++ it;
+                        if (it != m_layers.rend())
+                        {
+                                poutputs = &layer->ginput(*poutputs, count);
+                        }
+                        -- it;
+                }
         }
 
         bool forward_network_t::save_params(vector_t& x) const
@@ -250,6 +354,8 @@ namespace ncv
                         throw std::runtime_error(message);
                 }
 
+                fuse();
+
                 if (verbose)
                 {
                         print(layer_ids);
@@ -258,6 +364,43 @@ namespace ncv
                 return n_params;
         }
 
+        void forward_network_t::fuse()
+        {
+                m_groups.clear();
+                m_blocked.clear();
+
+                for (size_t l = 0; l < n_layers(); )
+                {
+                        size_t size = 1;
+
+                        // NB: the plane-wise layers (e.g. activation, pooling) are blocked only after a blocked convolution
+                        const bool blocked = m_layers[l]->blockable() && !m_layers[l]->planewise();
+                        if (blocked)
+                        {
+                                while ( l + size < n_layers() &&
+                                        m_layers[l + size]->blockable())
+                                {
+                                        size ++;
+                                }
+                        }
+
+                        else
+                        {
+                                // NB: not worth it for 1x1 planes (e.g. the outputs of linear layers)
+                                while ( l + size < n_layers() &&
+                                        m_layers[l + size]->planewise() &&
+                                        m_layers[l + size]->irows() * m_layers[l + size]->icols() > 1)
+                                {
+                                        size ++;
+                                }
+                        }
+
+                        m_groups.push_back(size);
+                        m_blocked.push_back(blocked);
+                        l += size;
+                }
+        }
+
         void forward_network_t::print(const strings_t& layer_ids) const
         {
                 assert(n_layers() == layer_ids.size());
@@ -286,6 +429,26 @@ namespace ncv
                         model_gparam_mflops += gparam_mflops;
                 }
 
+                size_t begin = 0;
+                for (size_t g = 0; g < m_groups.size(); g ++)
+                {
+                        const size_t size = m_groups[g];
+
+                        if (m_blocked[g])
+                        {
+                                log_info() << "forward network: blocking layers [" << (begin + 1) << "-" << (begin + size)
+                                           << "] (channel-blocked layout, " << layer_block_size() << " planes).";
+                        }
+
+                        else if (size > 1)
+                        {
+                                log_info() << "forward network: fusing layers [" << (begin + 1) << "-" << (begin + size)
+                                           << "] (plane by plane).";
+                        }
+
+                        begin += size;
+                }
+
                 const std::streamsize old_precision = std::cout.precision();
 
                 log_info() << "forward network [MFLOPs]"
@@ -16,6 +16,7 @@ namespace ncv
                 NANOCV_MAKE_CLONABLE(forward_network_t, "parameters: [layer_id[:layer_parameters][;]]*")
 
                 using model_t::resize;
+                using model_t::gparam;
                 
                 ///
                 /// \brief constructor
@@ -36,11 +37,13 @@ namespace ncv
                 /// \brief compute the model's output
                 ///
                 virtual const tensor_t& output(const tensor_t& input) const override;
+                virtual const tensor_t& output(const tensor_t& inputs, size_t count) const override;
 
                 ///
                 /// \brief compute the model's gradient wrt parameters
                 ///
-                virtual vector_t gparam(const vector_t& output) const override;
+                virtual void gparam(const vector_t& output, vector_t& gradient) const override;
+                virtual void gparam(const matrix_t& outputs, vector_t& gradient) const override;
 
                 ///
                 /// \brief compute the model's gradient wrt inputs
@@ -76,6 +79,17 @@ namespace ncv
 
         private:
 
+                ///
+                /// \brief group consecutive layers to compute their outputs plane by plane:
+                ///     a layer is fused with the next plane-wise layers (e.g. conv + activation + pooling),
+                ///     such that each intermediate plane is processed while still in cache
+                ///
+                ///     or using the channel-blocked layout (see tensor::block):
+                ///     a blocked convolution is grouped with the next blockable layers (e.g. activation + pooling),
+                ///     such that the layout is converted only at the group's boundaries
+                ///
+                void fuse();
+
                 ///
                 /// \brief display the model structure
                 ///
@@ -85,6 +99,13 @@ namespace ncv
 
                 // attributes
                 rlayers_t               m_layers;               ///< feed-forward layers
+                indices_t               m_groups;               ///< number of consecutive layers evaluated together
+                                                                ///     (fused plane by plane if more than one)
+                std::vector<bool>       m_blocked;              ///< groups evaluated using the channel-blocked layout
+
+                mutable tensor_t        m_xdata;                ///< channel-blocked input of a blocked group
+                mutable tensor_t        m_odata;                ///< (planar) output of a blocked group
+                mutable tensor_t        m_ograd;                ///< gradient wrt the output(s) (backward step's input)
         };
 }
 
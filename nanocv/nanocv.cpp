@@ -26,6 +26,7 @@
 #include "trainers/batch_trainer.h"
 #include "trainers/minibatch_trainer.h"
 #include "trainers/stochastic_trainer.h"
+#include "trainers/stochastic_async_trainer.h"
 
 #include "criteria/avg_criterion.h"
 #include "criteria/avg_l2_criterion.h"
@@ -83,6 +84,7 @@ namespace ncv
                 ncv::get_trainers().add("batch", batch_trainer_t());
                 ncv::get_trainers().add("minibatch", minibatch_trainer_t());
                 ncv::get_trainers().add("stochastic", stochastic_trainer_t());
+                ncv::get_trainers().add("stochastic-async", stochastic_async_trainer_t());
                 
                 // register criteria
                 ncv::get_criteria().add("avg", avg_criterion_t());
@@ -7,14 +7,17 @@
 
 namespace ncv
 {
-        // optimization data types
+        // optimization data types (NB: the optimization state may be more accurate than the model's parameters)
+        typedef acc_scalar_t                                            opt_scalar_t;
+        typedef acc_vector_t                                            opt_vector_t;
+
         typedef std::function<size_t(void)>                             opt_opsize_t;
-        typedef std::function<scalar_t(const vector_t&)>                opt_opfval_t;
-        typedef std::function<scalar_t(const vector_t&, vector_t&)>     opt_opgrad_t;
+        typedef std::function<opt_scalar_t(const opt_vector_t&)>        opt_opfval_t;
+        typedef std::function<opt_scalar_t(const opt_vector_t&, opt_vector_t&)> opt_opgrad_t;
 
         typedef optim::problem_t
         <
-                scalar_t,
+                opt_scalar_t,
                 size_t,
                 opt_opsize_t,
                 opt_opfval_t,
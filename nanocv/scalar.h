@@ -8,16 +8,21 @@ namespace ncv
         typedef std::size_t                                     size_t;
         typedef std::vector<size_t>                             indices_t;
 
-#ifdef NANOCV_WITH_FLOAT
+#if defined(NANOCV_WITH_FLOAT)
         typedef float                                           scalar_t;
-#elseif MANOCV_WITH_DOUBLE
-        typedef double                                          scalar_t;
-#elseif NANOCV_WIDTH_LONG_DOUBLE
+#elif defined(NANOCV_WITH_LONG_DOUBLE)
         typedef long double                                     scalar_t;
 #else
         typedef double                                          scalar_t;
 #endif
         typedef std::vector<scalar_t>                           scalars_t;
-}
-
 
+        // numerical type to accumulate sums over many samples (e.g. loss values & gradients)
+        //      and to store the optimization state (more accurate than the single precision scalar)
+#if defined(NANOCV_WITH_FLOAT) && defined(NANOCV_WITH_DOUBLE_ACCUMULATION)
+        typedef double                                          acc_scalar_t;
+#else
+        typedef scalar_t                                        acc_scalar_t;
+#endif
+        typedef std::vector<acc_scalar_t>                       acc_scalars_t;
+}
@@ -1,10 +1,109 @@
 #include "task.h"
+#include "timer.h"
 #include "logger.h"
 #include "sampler.h"
+#include "file/stream.h"
 #include "vision/image_grid.h"
+#include "thread/pool.h"
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <algorithm>
+#include <cassert>
+#include <fstream>
 
 namespace ncv
 {
+        namespace
+        {
+                ///
+                /// \brief describe the cache format & the source files (to check if the cache is up-to-date)
+                ///
+                /// NB: increment the version when the cache format or the decoding of the source files changes.
+                ///
+                bool cache_header(const string_t& configuration, const strings_t& sources, string_t& header)
+                {
+                        header = "nanocv-task-cache:v2:scalar=" + text::to_string(sizeof(scalar_t)) +
+                                 ":config=" + configuration;
+
+                        for (const string_t& source : sources)
+                        {
+                                boost::system::error_code ec;
+                                const auto size = boost::filesystem::file_size(source, ec);
+                                if (ec)
+                                {
+                                        return false;
+                                }
+
+                                const auto mtime = boost::filesystem::last_write_time(source, ec);
+                                if (ec)
+                                {
+                                        return false;
+                                }
+
+                                header += ":source=" + source +
+                                          "," + text::to_string(size) +
+                                          "," + text::to_string(mtime);
+                        }
+
+                        return true;
+                }
+
+                // NB: the pixels are aligned in the cache file, so that they can be read directly from the mapping
+                const size_t cache_alignment = 8;
+
+                size_t cache_padding(size_t pos)
+                {
+                        return (cache_alignment - pos % cache_alignment) % cache_alignment;
+                }
+
+                template
+                <
+                        typename tpod
+                >
+                bool write(std::ostream& os, const tpod& pod)
+                {
+                        return static_cast<bool>(os.write(reinterpret_cast<const char*>(&pod), sizeof(pod)));
+                }
+
+                bool write(std::ostream& os, const string_t& str)
+                {
+                        return  write(os, static_cast<uint64_t>(str.size())) &&
+                                os.write(str.data(), static_cast<std::streamsize>(str.size()));
+                }
+
+                bool write(std::ostream& os, const char* data, size_t size)
+                {
+                        static const char zeros[cache_alignment] = { 0 };
+
+                        const size_t padding = cache_padding(static_cast<size_t>(os.tellp()));
+                        return  os.write(zeros, static_cast<std::streamsize>(padding)) &&
+                                os.write(data, static_cast<std::streamsize>(size));
+                }
+
+                bool read(io::stream_t& stream, string_t& str)
+                {
+                        uint64_t size;
+                        if (!stream.read(size) || size > stream.size() - stream.tellg())
+                        {
+                                return false;
+                        }
+
+                        str.resize(size);
+                        return stream.read(&str[0], size);
+                }
+
+                const char* read(io::stream_t& stream, const char* data, size_t size)
+                {
+                        if (!stream.skip(cache_padding(stream.tellg())))
+                        {
+                                return nullptr;
+                        }
+
+                        const char* pdata = data + stream.tellg();
+                        return stream.skip(size) ? pdata : nullptr;
+                }
+        }
+
         task_manager_t& get_tasks()
         {
                 return task_manager_t::instance();
@@ -94,11 +193,41 @@ namespace ncv
                 }
         }
 
+        void task_t::set_tensor_cache(size_t budget, tensor_cache_type type)
+        {
+                m_tcache = (budget > 0) ? std::make_shared<tensor_cache_t>(budget, type) : nullptr;
+        }
+
+        thread_pool_t& task_t::thread_pool() const
+        {
+                return m_pool ? *m_pool : ncv::get_thread_pool();
+        }
+
+        void task_t::load_input(size_t index, const rect_t& region, scalar_t* data) const
+        {
+                assert(index < n_images());
+
+                const image_t& image = m_images[index];
+                if (m_tcache)
+                {
+                        m_tcache->load(index, image, region, data);
+                }
+                else
+                {
+                        image.to_tensor(region, data);
+                }
+        }
+
         void task_t::add_image(const image_t& image)
         {
                 m_images.push_back(image);
         }
 
+        void task_t::add_image(image_t&& image)
+        {
+                m_images.push_back(std::move(image));
+        }
+
         void task_t::add_sample(const sample_t& sample)
         {
                 // check sample to correspond to a valid region of a valid image
@@ -118,6 +247,225 @@ namespace ncv
                 }
         }
 
+        bool task_t::load_cached(const strings_t& sources, const std::function<bool()>& op)
+        {
+                string_t path = sources.empty() ? string_t() : sources[0] + ".cache";
+
+                // NB: the sources must be the actual files (e.g. not their common prefix) to check the cache
+                for (const string_t& source : sources)
+                {
+                        boost::system::error_code ec;
+                        if (!path.empty() && !boost::filesystem::is_regular_file(source, ec))
+                        {
+                                log_warning() << "task: the cache source <" << source << "> is not a file, "
+                                              << "the cache is disabled!";
+                                path.clear();
+                        }
+                }
+
+                const ncv::timer_t timer;
+                if (!path.empty() && load_cache(path, sources))
+                {
+                        log_info() << "task: loaded " << n_images() << " images & " << m_samples.size()
+                                   << " samples from the cache <" << path << "> in " << timer.elapsed() << ".";
+                        return true;
+                }
+
+                // NB: the operator should reset the images & the samples (e.g. partially loaded from the cache)
+                if (!op())
+                {
+                        return false;
+                }
+
+                if (!path.empty())
+                {
+                        if (save_cache(path, sources))
+                        {
+                                log_info() << "task: saved the cache <" << path << ">.";
+                        }
+                        else
+                        {
+                                log_warning() << "task: failed to save the cache <" << path << ">!";
+                        }
+                }
+
+                return true;
+        }
+
+        bool task_t::load_cache(const string_t& path, const strings_t& sources)
+        {
+                string_t header;
+                if (    !cache_header(configuration(), sources, header) ||
+                        !boost::filesystem::exists(path))
+                {
+                        return false;
+                }
+
+                try
+                {
+                        const boost::iostreams::mapped_file_source file(path);
+                        io::stream_t stream(file.data(), file.size());
+
+                        string_t cheader;
+                        uint64_t icount, scount;
+                        if (    !read(stream, cheader) || cheader != header ||
+                                !stream.read(icount) ||
+                                !stream.read(scount))
+                        {
+                                return false;
+                        }
+
+                        clear_images(icount);
+                        clear_samples(scount);
+
+                        // images
+                        for (uint64_t i = 0; i < icount; i ++)
+                        {
+                                coord_t rows, cols;
+                                color_mode mode;
+                                if (    !stream.read(rows) || rows < 0 ||
+                                        !stream.read(cols) || cols < 0 ||
+                                        !stream.read(mode))
+                                {
+                                        return false;
+                                }
+
+                                const size_t size = static_cast<size_t>(rows) * static_cast<size_t>(cols);
+
+                                image_t image;
+                                if (mode == color_mode::rgba)
+                                {
+                                        const char* data = read(stream, file.data(), size * sizeof(rgba_t));
+                                        if (    !data ||
+                                                !image.load_rgba(tensor::map_matrix(
+                                                        reinterpret_cast<const rgba_t*>(data), rows, cols)))
+                                        {
+                                                return false;
+                                        }
+                                }
+                                else
+                                {
+                                        const char* data = read(stream, file.data(), size * sizeof(luma_t));
+                                        if (    !data ||
+                                                !image.load_luma(data, rows, cols))
+                                        {
+                                                return false;
+                                        }
+                                }
+
+                                m_images.push_back(std::move(image));
+                        }
+
+                        // samples
+                        for (uint64_t i = 0; i < scount; i ++)
+                        {
+                                uint64_t index, tsize, fold;
+                                coord_t x, y, w, h;
+                                protocol p;
+
+                                sample_t sample;
+                                if (    !stream.read(index) ||
+                                        !stream.read(x) || !stream.read(y) || !stream.read(w) || !stream.read(h) ||
+                                        !read(stream, sample.m_label) ||
+                                        !stream.read(tsize) || tsize > stream.size() / sizeof(scalar_t))
+                                {
+                                        return false;
+                                }
+
+                                sample.m_index = index;
+                                sample.m_region = rect_t(x, y, w, h);
+                                sample.m_target.resize(static_cast<vector_t::Index>(tsize));
+                                if (    !stream.read(reinterpret_cast<char*>(sample.m_target.data()), tsize * sizeof(scalar_t)) ||
+                                        !stream.read(fold) ||
+                                        !stream.read(p))
+                                {
+                                        return false;
+                                }
+
+                                sample.m_fold = { fold, p };
+                                add_sample(sample);
+                        }
+
+                        return stream.tellg() == stream.size();
+                }
+
+                catch (std::exception& e)
+                {
+                        log_warning() << "task: failed to load the cache <" << path << "> (" << e.what() << ")!";
+                        return false;
+                }
+        }
+
+        bool task_t::save_cache(const string_t& path, const strings_t& sources) const
+        {
+                string_t header;
+                if (!cache_header(configuration(), sources, header))
+                {
+                        return false;
+                }
+
+                // NB: write to a temporary file first, so that a (concurrently) loaded cache is always complete
+                boost::system::error_code ec;
+                const boost::filesystem::path tpath = boost::filesystem::unique_path(path + ".%%%%-%%%%-%%%%", ec);
+                if (ec)
+                {
+                        return false;
+                }
+
+                std::ofstream os(tpath.string().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+                bool ok =
+                        write(os, header) &&
+                        write(os, static_cast<uint64_t>(m_images.size())) &&
+                        write(os, static_cast<uint64_t>(m_samples.size()));
+
+                // images
+                for (size_t i = 0; i < m_images.size() && ok; i ++)
+                {
+                        const image_t& image = m_images[i];
+
+                        ok =    write(os, image.rows()) &&
+                                write(os, image.cols()) &&
+                                write(os, image.mode()) &&
+                                (image.is_rgba() ?
+                                write(os, reinterpret_cast<const char*>(image.rgba().data()), image.rgba().size() * sizeof(rgba_t)) :
+                                write(os, reinterpret_cast<const char*>(image.luma().data()), image.luma().size() * sizeof(luma_t)));
+                }
+
+                // samples
+                for (size_t i = 0; i < m_samples.size() && ok; i ++)
+                {
+                        const sample_t& sample = m_samples[i];
+
+                        ok =    write(os, static_cast<uint64_t>(sample.m_index)) &&
+                                write(os, sample.m_region.left()) &&
+                                write(os, sample.m_region.top()) &&
+                                write(os, sample.m_region.width()) &&
+                                write(os, sample.m_region.height()) &&
+                                write(os, sample.m_label) &&
+                                write(os, static_cast<uint64_t>(sample.m_target.size())) &&
+                                os.write(reinterpret_cast<const char*>(sample.m_target.data()),
+                                         static_cast<std::streamsize>(sample.m_target.size() * sizeof(scalar_t))) &&
+                                write(os, static_cast<uint64_t>(sample.m_fold.first)) &&
+                                write(os, sample.m_fold.second);
+                }
+
+                os.close();
+                ok = ok && os;
+
+                if (ok)
+                {
+                        boost::filesystem::rename(tpath, path, ec);
+                        ok = !ec;
+                }
+                if (!ok)
+                {
+                        boost::filesystem::remove(tpath, ec);
+                }
+
+                return ok;
+        }
+
         void task_t::describe() const
         {
                 log_info() << "images: " << n_images() << ".";
@@ -2,11 +2,15 @@
 
 #include "sample.h"
 #include "manager.hpp"
+#include "tensor_cache.h"
 #include "vision/image.h"
+#include <functional>
+#include <memory>
 
 namespace ncv
 {
         class task_t;
+        class thread_pool_t;
 
         ///
         /// \brief manage tasks (register new ones, query and clone them)
@@ -34,7 +38,8 @@ namespace ncv
                 /// \brief constructor
                 ///
                 explicit task_t(const string_t& configuration)
-                        : clonable_t<task_t>(configuration)
+                        :       clonable_t<task_t>(configuration),
+                                m_pool(nullptr)
                 {
                 }
                 
@@ -92,6 +97,36 @@ namespace ncv
 
                 const samples_t& samples() const { return m_samples; }
 
+                ///
+                /// \brief cache the input tensors of the samples within the given memory budget (in bytes)
+                ///     to skip converting the image pixels at each pass over the samples (0 - disabled)
+                ///
+                void set_tensor_cache(size_t budget, tensor_cache_type type = tensor_cache_type::scalar);
+
+                ///
+                /// \brief the tensor cache (if enabled)
+                ///
+                const tensor_cache_t* tensor_cache() const { return m_tcache.get(); }
+
+                ///
+                /// \brief write the input tensor of the given region of the <index>th image
+                ///     to the given buffer (of idims x rows x cols values), using the tensor cache if enabled
+                ///
+                void load_input(size_t index, const rect_t& region, scalar_t* data) const;
+
+                ///
+                /// \brief decode the images using the given thread pool (e.g. with a given number of workers)
+                ///     instead of the process-wide one
+                ///
+                /// NB: the loaded images & samples are the same for any number of threads.
+                ///
+                void set_thread_pool(thread_pool_t& pool) { m_pool = &pool; }
+
+                ///
+                /// \brief the thread pool used to decode the images
+                ///
+                thread_pool_t& thread_pool() const;
+
         protected:
 
                 ///
@@ -101,6 +136,11 @@ namespace ncv
                 {
                         m_images.clear();
                         m_images.reserve(capacity);
+
+                        if (m_tcache)
+                        {
+                                m_tcache->clear();
+                        }
                 }
 
                 ///
@@ -125,16 +165,40 @@ namespace ncv
                 /// \brief add a new image
                 ///
                 void add_image(const image_t& image);
+                void add_image(image_t&& image);
 
                 ///
                 /// \brief add a new sample
                 ///
                 void add_sample(const sample_t& sample);
 
+                ///
+                /// \brief load the images & the samples using the given operator (e.g. decoding the source files)
+                ///     only if the binary cache of the given source files is missing or out-of-date
+                ///
+                /// NB: the cache is saved next to the first source file after a successful load and
+                ///     it is valid as long as the source files have the same sizes & modification times.
+                ///
+                bool load_cached(const strings_t& sources, const std::function<bool()>& op);
+
+        private:
+
+                ///
+                /// \brief load the images & the samples from the (memory-mapped) cache file
+                ///
+                bool load_cache(const string_t& path, const strings_t& sources);
+
+                ///
+                /// \brief save the images & the samples to the cache file
+                ///
+                bool save_cache(const string_t& path, const strings_t& sources) const;
+
         private:
 
                 // attributes
                 images_t                m_images;       ///< input images (can be bigger than the samples)
                 samples_t               m_samples;      ///< patch samples in images
+                std::shared_ptr<tensor_cache_t> m_tcache;       ///< cached input tensors (if enabled)
+                thread_pool_t*          m_pool;         ///< decoding thread pool (the process-wide one if null)
         };
 }
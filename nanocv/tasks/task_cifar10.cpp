@@ -2,8 +2,10 @@
 #include "nanocv/loss.h"
 #include "nanocv/logger.h"
 #include "nanocv/math/cast.hpp"
-#include "nanocv/file/stream.h"
 #include "nanocv/file/archive.h"
+#include "nanocv/thread/loopi.hpp"
+#include <algorithm>
+#include <map>
 
 namespace ncv
 {
@@ -30,65 +32,92 @@ namespace ncv
         {
                 const string_t bfile = dir + "/cifar-10-binary.tar.gz";
 
-                const string_t train_bfile1 = "data_batch_1.bin";
-                const string_t train_bfile2 = "data_batch_2.bin";
-                const string_t train_bfile3 = "data_batch_3.bin";
-                const string_t train_bfile4 = "data_batch_4.bin";
-                const string_t train_bfile5 = "data_batch_5.bin";
+                const strings_t train_bfiles =
+                {
+                        "data_batch_1.bin",
+                        "data_batch_2.bin",
+                        "data_batch_3.bin",
+                        "data_batch_4.bin",
+                        "data_batch_5.bin"
+                };
                 const size_t n_train_samples = 10000;// * 5
 
                 const string_t test_bfile = "test_batch.bin";
                 const size_t n_test_samples = 10000;
 
-                clear_memory(n_train_samples + n_test_samples);
+                // number of samples loaded from each file
+                std::map<string_t, size_t> counts;
 
-                const auto op = [&] (const string_t& filename, const io::data_t& data)
+                const auto op = [&] (const string_t& filename, const char* bdata, size_t bdata_size, size_t& used)
                 {
-                        if (    text::iends_with(filename, train_bfile1) ||
-                                text::iends_with(filename, train_bfile2) ||
-                                text::iends_with(filename, train_bfile3) ||
-                                text::iends_with(filename, train_bfile4) ||
-                                text::iends_with(filename, train_bfile5))
+                        if (std::any_of(train_bfiles.begin(), train_bfiles.end(),
+                                [&] (const string_t& train_bfile) { return text::iends_with(filename, train_bfile); }))
                         {
-                                return load(filename, data.data(), data.size(), protocol::train, n_train_samples);
+                                used = decode(bdata, bdata_size, protocol::train, counts[filename]);
                         }
                         else if (text::iends_with(filename, test_bfile))
-                        {                                
-                                return load(filename, data.data(), data.size(), protocol::test, n_test_samples);
-                        }                        
+                        {
+                                used = decode(bdata, bdata_size, protocol::test, counts[filename]);
+                        }
                         else
                         {
-                                return true;
+                                used = bdata_size;
                         }
+
+                        return true;
                 };
 
-                log_info() << "CIFAR-10: loading file <" << bfile << "> ...";
+                return load_cached({ bfile }, [&] ()
+                {
+                        clear_memory(n_train_samples * train_bfiles.size() + n_test_samples);
+
+                        log_info() << "CIFAR-10: loading file <" << bfile << "> ...";
 
-                return io::decode(bfile, "CIFAR-10: ", op);
+                        if (!io::decode(bfile, "CIFAR-10: ", op))
+                        {
+                                return false;
+                        }
+
+                        // check the number of samples loaded from each file
+                        bool ok = counts.size() == train_bfiles.size() + 1;
+                        for (const auto& count : counts)
+                        {
+                                log_info() << "CIFAR-10: loaded " << count.second << " samples from <" << count.first << ">.";
+
+                                ok = ok && count.second == (text::iends_with(count.first, test_bfile) ?
+                                        n_test_samples : n_train_samples);
+                        }
+
+                        return ok;
+                });
         }
 
-        bool cifar10_task_t::load(const string_t& filename, const char* bdata, size_t bdata_size, protocol p, size_t count)
+        size_t cifar10_task_t::decode(const char* bdata, size_t bdata_size, protocol p, size_t& count)
         {
-                log_info() << "CIFAR-10: loading file <" << filename << "> ...";
-                
-                std::vector<char> buffer(irows() * icols() * 3);
-                char label[1];
+                const size_t record_size = 1 + irows() * icols() * 3;
+                const size_t n_records = bdata_size / record_size;
 
-                io::stream_t stream(bdata, bdata_size);
+                // decode the whole records (label + image) in parallel ...
+                images_t images(n_records);
+                thread_loopi(n_records, thread_pool(), [&] (size_t i)
+                {
+                        const char* record = bdata + i * record_size;
+                        if (math::cast<size_t>(record[0]) < osize())
+                        {
+                                images[i].load_rgba(record + 1, irows(), icols(), irows() * icols());
+                        }
+                });
 
-                size_t icount = 0;
-                while ( stream.read(label, 1) &&
-                        stream.read(buffer.data(), buffer.size()))
+                // ... and add them in order
+                for (size_t i = 0; i < n_records; i ++)
                 {
-                        const size_t ilabel = math::cast<size_t>(label[0]);
+                        const size_t ilabel = math::cast<size_t>(bdata[i * record_size + 0]);
                         if (ilabel >= osize())
                         {
                                 continue;
                         }
 
-                        image_t image;
-                        image.load_rgba(buffer.data(), irows(), icols(), irows() * icols());
-                        add_image(image);
+                        add_image(std::move(images[i]));
 
                         sample_t sample(n_images() - 1, sample_region(0, 0));
                         sample.m_label = tlabels[ilabel];
@@ -96,11 +125,9 @@ namespace ncv
                         sample.m_fold = { 0, p };
                         add_sample(sample);
 
-                        ++ icount;
+                        ++ count;
                 }
 
-                // OK
-                log_info() << "CIFAR-10: loaded " << icount << " samples.";
-                return (count == icount);
+                return n_records * record_size;
         }
 }
@@ -12,7 +12,7 @@ namespace ncv
         ///
         /// http://www.cs.toronto.edu/~kriz/cifar.html
         ///
-        class cifar10_task_t : public task_t
+        class NANOCV_PUBLIC cifar10_task_t : public task_t
         {
         public:
 
@@ -31,10 +31,8 @@ namespace ncv
                 virtual size_t fsize() const override { return 1; }
                 virtual color_mode color() const override { return color_mode::rgba; }
 
-        private:
-
-                // load binary file
-                bool load(const string_t& filename, const char* bdata, size_t bdata_size, protocol p, size_t count);
+                // decode the whole records of a binary file chunk (returns the number of bytes decoded)
+                size_t decode(const char* bdata, size_t bdata_size, protocol p, size_t& count);
         };
 }
 
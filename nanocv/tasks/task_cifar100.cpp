@@ -1,9 +1,9 @@
 #include "task_cifar100.h"
 #include "nanocv/loss.h"
 #include "nanocv/logger.h"
-#include "nanocv/file/stream.h"
 #include "nanocv/math/cast.hpp"
 #include "nanocv/file/archive.h"
+#include "nanocv/thread/loopi.hpp"
 
 namespace ncv
 {
@@ -126,51 +126,71 @@ namespace ncv
                 const string_t test_bfile = "test.bin";
                 const size_t n_test_samples = 10000;
 
-                clear_memory(n_train_samples + n_test_samples);
+                size_t train_count = 0, test_count = 0;
 
-                const auto op = [&] (const string_t& filename, const io::data_t& data)
+                const auto op = [&] (const string_t& filename, const char* bdata, size_t bdata_size, size_t& used)
                 {
                         if (text::ends_with(filename, train_bfile))
                         {
-                                return load(filename, data.data(), data.size(), protocol::train, n_train_samples);
+                                used = decode(bdata, bdata_size, protocol::train, train_count);
                         }
                         else if (text::ends_with(filename, test_bfile))
                         {
-                                return load(filename, data.data(), data.size(), protocol::test, n_test_samples);
-                        }                        
+                                used = decode(bdata, bdata_size, protocol::test, test_count);
+                        }
                         else
                         {
-                                return true;
+                                used = bdata_size;
                         }
+
+                        return true;
                 };
 
-                log_info() << "CIFAR-100: loading file <" << bfile << "> ...";
+                return load_cached({ bfile }, [&] ()
+                {
+                        clear_memory(n_train_samples + n_test_samples);
+
+                        log_info() << "CIFAR-100: loading file <" << bfile << "> ...";
+
+                        if (!io::decode(bfile, "CIFAR-100: ", op))
+                        {
+                                return false;
+                        }
+
+                        log_info() << "CIFAR-100: loaded " << train_count << " training samples.";
+                        log_info() << "CIFAR-100: loaded " << test_count << " testing samples.";
 
-                return io::decode(bfile, "CIFAR-100: ", op);
+                        return  train_count == n_train_samples &&
+                                test_count == n_test_samples;
+                });
         }
-        
-        bool cifar100_task_t::load(const string_t& filename, const char* bdata, size_t bdata_size, protocol p, size_t count)
+
+        size_t cifar100_task_t::decode(const char* bdata, size_t bdata_size, protocol p, size_t& count)
         {
-                log_info() << "CIFAR-100: loading file <" << filename << "> ...";                
-                
-                std::vector<char> buffer(irows() * icols() * 3);
-                char label[2];
+                const size_t record_size = 2 + irows() * icols() * 3;
+                const size_t n_records = bdata_size / record_size;
 
-                io::stream_t stream(bdata, bdata_size);
+                // decode the whole records (coarse & fine labels + image) in parallel ...
+                images_t images(n_records);
+                thread_loopi(n_records, thread_pool(), [&] (size_t i)
+                {
+                        const char* record = bdata + i * record_size;
+                        if (math::cast<size_t>(record[1]) < osize())
+                        {
+                                images[i].load_rgba(record + 2, irows(), icols(), irows() * icols());
+                        }
+                });
 
-                size_t icount = 0;
-                while ( stream.read(label, 2) &&       // coarse & fine labels!
-                        stream.read(buffer.data(), buffer.size()))
+                // ... and add them in order
+                for (size_t i = 0; i < n_records; i ++)
                 {
-                        const size_t ilabel = math::cast<size_t>(label[1]);
+                        const size_t ilabel = math::cast<size_t>(bdata[i * record_size + 1]);
                         if (ilabel >= osize())
                         {
                                 continue;
                         }
 
-                        image_t image;
-                        image.load_rgba(buffer.data(), irows(), icols(), irows() * icols());
-                        add_image(image);
+                        add_image(std::move(images[i]));
 
                         sample_t sample(n_images() - 1, sample_region(0, 0));
                         sample.m_label = tlabels[ilabel];
@@ -178,11 +198,9 @@ namespace ncv
                         sample.m_fold = { 0, p };
                         add_sample(sample);
 
-                        icount ++;
+                        ++ count;
                 }
 
-                // OK
-                log_info() << "CIFAR-100: loaded " << icount << " samples.";
-                return (count == icount);
+                return n_records * record_size;
         }
 }
@@ -33,8 +33,8 @@ namespace ncv
 
         private:
 
-                // load binary file
-                bool load(const string_t& filename, const char* bdata, size_t bdata_size, protocol p, size_t count);
+                // decode the whole records of a binary file chunk (returns the number of bytes decoded)
+                size_t decode(const char* bdata, size_t bdata_size, protocol p, size_t& count);
         };
 }
 
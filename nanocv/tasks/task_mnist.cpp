@@ -2,8 +2,9 @@
 #include "nanocv/loss.h"
 #include "nanocv/logger.h"
 #include "nanocv/math/cast.hpp"
-#include "nanocv/file/stream.h"
 #include "nanocv/file/archive.h"
+#include "nanocv/thread/loopi.hpp"
+#include <algorithm>
 
 namespace ncv
 {
@@ -22,36 +23,58 @@ namespace ncv
                 const string_t train_gfile = dir + "/train-labels-idx1-ubyte.gz";
                 const size_t n_train_samples = 60000;
 
-                clear_memory(n_train_samples + n_test_samples);
+                return load_cached({ train_ifile, train_gfile, test_ifile, test_gfile }, [&] ()
+                {
+                        clear_memory(n_train_samples + n_test_samples);
+
+                        // decode the image & the label files concurrently ...
+                        const strings_t ifiles = { train_ifile, test_ifile };
+                        const strings_t gfiles = { train_gfile, test_gfile };
 
-                return  load(train_ifile, train_gfile, protocol::train, n_train_samples) &&
-                        load(test_ifile, test_gfile, protocol::test, n_test_samples);
+                        std::vector<images_t> images(ifiles.size());
+                        std::vector<indices_t> labels(gfiles.size());
+                        std::vector<char> oks(ifiles.size() + gfiles.size(), 0);
+
+                        thread_loopi(oks.size(), thread_pool(), [&] (size_t i)
+                        {
+                                const size_t f = i / 2;
+                                oks[i] = (i % 2 == 0) ?
+                                        load_images(ifiles[f], images[f]) :
+                                        load_labels(gfiles[f], labels[f]);
+                        });
+
+                        // ... and add them in order
+                        return  std::all_of(oks.begin(), oks.end(), [] (char ok) { return ok != 0; }) &&
+                                add(images[0], labels[0], protocol::train, n_train_samples) &&
+                                add(images[1], labels[1], protocol::test, n_test_samples);
+                });
         }
 
-        bool mnist_task_t::load(const string_t& ifile, const string_t& gfile, protocol p, size_t count)
+        bool mnist_task_t::load_images(const string_t& ifile, images_t& images) const
         {
-                size_t iindex = n_images();
-                size_t icount = 0;
-                size_t gcount = 0;
+                const size_t isize = irows() * icols();
 
-                std::vector<char> buffer(irows() * icols());
-                char label[2];
-
-                // load images
-                const auto iop = [&] (const string_t&, const io::data_t& data)
+                // load images (header + records)
+                size_t iheader = 16;
+                const auto iop = [&] (const string_t&, const char* data, size_t size, size_t& used)
                 {
-                        io::stream_t stream(data.data(), data.size());
+                        if (iheader > 0)
+                        {
+                                used = std::min(size, iheader);
+                                iheader -= used;
+                                return true;
+                        }
+
+                        const size_t offset = images.size();
+                        const size_t count = size / isize;
 
-                        stream.read(buffer.data(), 16);
-                        while (stream.read(buffer.data(), buffer.size()))
+                        images.resize(offset + count);
+                        thread_loopi(count, thread_pool(), [&] (size_t i)
                         {
-                                image_t image;
-                                image.load_luma(buffer.data(), irows(), icols());
-                                add_image(image);
+                                images[offset + i].load_luma(data + i * isize, irows(), icols());
+                        });
 
-                                ++ icount;
-                        }                        
-                        
+                        used = count * isize;
                         return true;
                 };
 
@@ -62,30 +85,27 @@ namespace ncv
                         return false;
                 }
 
-                // load ground truth
-                const auto gop = [&] (const string_t&, const io::data_t& data)
+                return true;
+        }
+
+        bool mnist_task_t::load_labels(const string_t& gfile, indices_t& labels) const
+        {
+                // load ground truth (header + records)
+                size_t gheader = 8;
+                const auto gop = [&] (const string_t&, const char* data, size_t size, size_t& used)
                 {
-                        io::stream_t stream(data.data(), data.size());
+                        if (gheader > 0)
+                        {
+                                used = std::min(size, gheader);
+                                gheader -= used;
+                                return true;
+                        }
 
-                        stream.read(buffer.data(), 8);
-                        while (stream.read(label, 1) && stream.gcount() == 1)
+                        for (used = 0; used < size; used ++)
                         {
-                                const size_t ilabel = math::cast<size_t>(label[0]);
-                                if (ilabel >= osize())
-                                {
-                                        continue;
-                                }
-
-                                sample_t sample(iindex, sample_region(0, 0));
-                                sample.m_label = "digit" + text::to_string(ilabel);
-                                sample.m_target = ncv::class_target(ilabel, osize());
-                                sample.m_fold = { 0, p };
-                                add_sample(sample);
-
-                                ++ gcount;
-                                ++ iindex;
+                                labels.push_back(math::cast<size_t>(data[used]));
                         }
-                        
+
                         return true;
                 };
 
@@ -96,8 +116,36 @@ namespace ncv
                         return false;
                 }
 
+                return true;
+        }
+
+        bool mnist_task_t::add(images_t& images, const indices_t& labels, protocol p, size_t count)
+        {
+                size_t icount = 0;
+                size_t gcount = 0;
+
+                for (size_t i = 0; i < images.size() && i < labels.size(); i ++)
+                {
+                        const size_t ilabel = labels[i];
+                        if (ilabel >= osize())
+                        {
+                                continue;
+                        }
+
+                        add_image(std::move(images[i]));
+                        ++ icount;
+
+                        sample_t sample(n_images() - 1, sample_region(0, 0));
+                        sample.m_label = "digit" + text::to_string(ilabel);
+                        sample.m_target = ncv::class_target(ilabel, osize());
+                        sample.m_fold = { 0, p };
+                        add_sample(sample);
+                        ++ gcount;
+                }
+
                 // OK
                 log_info() << "MNIST: loaded " << icount << "/" << gcount << " samples.";
-                return (count == gcount) && (count == icount);
+                return  (count == images.size()) && (count == labels.size()) &&
+                        (count == gcount) && (count == icount);
         }
 }
@@ -33,7 +33,11 @@ namespace ncv
 
         private:
 
-                // load binary file
-                bool load(const string_t& ifile, const string_t& gfile, protocol p, size_t count);
+                // decode the image & the label files (thread-safe)
+                bool load_images(const string_t& ifile, images_t& images) const;
+                bool load_labels(const string_t& gfile, indices_t& labels) const;
+
+                // add the decoded images & labels
+                bool add(images_t& images, const indices_t& labels, protocol p, size_t count);
         };
 }
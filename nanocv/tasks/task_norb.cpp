@@ -3,6 +3,8 @@
 #include "nanocv/logger.h"
 #include "nanocv/file/stream.h"
 #include "nanocv/file/archive.h"
+#include "nanocv/thread/loopi.hpp"
+#include <algorithm>
 
 namespace ncv
 {
@@ -26,21 +28,51 @@ namespace ncv
                 const size_t n_train_samples = 29160;// * 10;
                 const size_t n_test_samples = 29160;// * 2;
 
-                clear_memory(n_train_samples + n_test_samples);
-
-                return  load(dir + "/norb-5x46789x9x18x6x2x108x108-training-01", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-02", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-03", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-04", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-05", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-06", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-07", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-08", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-09", protocol::train, n_train_samples) &&
-                        load(dir + "/norb-5x46789x9x18x6x2x108x108-training-10", protocol::train, n_train_samples) &&
-
-                        load(dir + "/norb-5x01235x9x18x6x2x108x108-testing-01", protocol::test, n_test_samples) &&
-                        load(dir + "/norb-5x01235x9x18x6x2x108x108-testing-02", protocol::test, n_test_samples);
+                strings_t train_files, test_files;
+                for (const char* suffix : { "01", "02", "03", "04", "05", "06", "07", "08", "09", "10" })
+                {
+                        train_files.push_back(dir + "/norb-5x46789x9x18x6x2x108x108-training-" + suffix);
+                }
+                for (const char* suffix : { "01", "02" })
+                {
+                        test_files.push_back(dir + "/norb-5x01235x9x18x6x2x108x108-testing-" + suffix);
+                }
+
+                strings_t bfiles = train_files;
+                bfiles.insert(bfiles.end(), test_files.begin(), test_files.end());
+
+                strings_t sources;
+                for (const string_t& bfile : bfiles)
+                {
+                        sources.push_back(bfile + "-dat.mat.gz");
+                        sources.push_back(bfile + "-cat.mat.gz");
+                }
+
+                return load_cached(sources, [&] ()
+                {
+                        clear_memory(n_train_samples + n_test_samples);
+
+                        // decode the files concurrently ...
+                        std::vector<images_t> images(bfiles.size());
+                        std::vector<indices_t> labels(bfiles.size());
+                        std::vector<char> oks(bfiles.size(), 0);
+
+                        thread_loopi(bfiles.size(), thread_pool(), [&] (size_t f)
+                        {
+                                oks[f] = load(bfiles[f], images[f], labels[f]);
+                        });
+
+                        // ... and add them in order
+                        bool ok = std::all_of(oks.begin(), oks.end(), [] (char f_ok) { return f_ok != 0; });
+                        for (size_t f = 0; f < bfiles.size() && ok; f ++)
+                        {
+                                ok = (f < train_files.size()) ?
+                                        add(images[f], labels[f], protocol::train, n_train_samples) :
+                                        add(images[f], labels[f], protocol::test, n_test_samples);
+                        }
+
+                        return ok;
+                });
         }
 
         static bool read_header(io::stream_t& stream, int32_t& magic, std::vector<int32_t>& dims)
@@ -75,69 +107,72 @@ namespace ncv
                 return true;
         }
 
-        bool norb_task_t::load(const string_t& bfile, protocol p, size_t count)
+        bool norb_task_t::load(const string_t& bfile, images_t& images, indices_t& labels) const
         {
-                return load(bfile + "-dat.mat.gz", bfile + "-cat.mat.gz", p, count);
+                return load(bfile + "-dat.mat.gz", bfile + "-cat.mat.gz", images, labels);
         }
 
-        bool norb_task_t::load(const string_t& ifile, const string_t& gfile, protocol p, size_t count)
+        bool norb_task_t::load(const string_t& ifile, const string_t& gfile, images_t& images, indices_t& labels) const
         {
 //                 static const int magic_f32 = 0x1E3D4C51;
 //                 static const int magic_f64 = 0x1E3D4C53;
                 static const int magic_i32 = 0x1E3D4C54;
                 static const int magic_i08 = 0x1E3D4C55;
 //                 static const int magic_i16 = 0x1E3D4C56;
-                
-                size_t iindex = n_images();
-                size_t icount = 0;
-                size_t gcount = 0;
-                
-                // load images
-                const auto iop = [&] (const string_t&, const io::data_t& data)
+
+                const size_t n_cameras = 2;
+
+                // load images (header + records, decoded in chunks as the file is decompressed)
+                size_t cnt = 0;                 // number of images in the file (0 = header not decoded yet)
+                const auto iop = [&] (const string_t&, const char* data, size_t size, size_t& used)
                 {
-                        io::stream_t stream(data.data(), data.size());
-                        
-                        // read header
-                        int32_t magic;
-                        std::vector<int32_t> dims;
-                        if (!read_header(stream, magic, dims))
-                        {
-                                log_error() << "NORB: failed to read header!";
-                                return false;
-                        }
-                        
-                        if (    magic != magic_i08 ||
-                                
-                                dims.size() != 4 ||                                
-                                dims[1] != 2 ||
-                                dims[2] != static_cast<int>(irows()) ||
-                                dims[3] != static_cast<int>(icols()))
-                        {
-                                log_error() << "NORB: invalid header!";
-                                return false;
-                        }
-                        
-                        // load images
-                        const size_t n_cameras = 2;
                         const size_t n_pixels = irows() * icols();
-                        const size_t cnt = dims[0];
-                        
-                        std::vector<char> dimage(n_pixels);                        
-                        for (size_t i = 0; i < cnt; i ++)
+
+                        // read header (NB: the first chunk is large enough to contain it)
+                        if (cnt == 0)
                         {
-                                for (size_t cam = 0; cam < n_cameras && stream.read(dimage.data(), dimage.size()); cam ++)
+                                io::stream_t stream(data, size);
+
+                                int32_t magic;
+                                std::vector<int32_t> dims;
+                                if (!read_header(stream, magic, dims))
+                                {
+                                        log_error() << "NORB: failed to read header!";
+                                        return false;
+                                }
+
+                                if (    magic != magic_i08 ||
+
+                                        dims.size() != 4 ||
+                                        dims[0] <= 0 ||
+                                        dims[1] != 2 ||
+                                        dims[2] != static_cast<int>(irows()) ||
+                                        dims[3] != static_cast<int>(icols()))
                                 {
-                                        image_t image;
-                                        image.load_luma(dimage.data(), irows(), icols());
-                                        add_image(image);
+                                        log_error() << "NORB: invalid header!";
+                                        return false;
                                 }
-                                
-                                ++ icount;
+
+                                cnt = dims[0];
+                                used = stream.tellg();
+                                return true;
                         }
-                        
-                        return stream.tellg() == stream.size();
+
+                        // load images (in parallel)
+                        const size_t offset = images.size();
+                        const size_t count = std::min(size / n_pixels, cnt * n_cameras - offset);
+
+                        images.resize(offset + count);
+                        thread_loopi(count, thread_pool(), [&] (size_t i)
+                        {
+                                images[offset + i].load_luma(data + i * n_pixels, irows(), icols());
+                        });
+
+                        // NB: wait for more bytes if no whole image is buffered, skip the bytes after the last image
+                        used = (count > 0) ? count * n_pixels : (offset == cnt * n_cameras ? size : 0);
+                        return true;
                 };
-                                
+
                 log_info() << "NORB: loading file <" << ifile << "> ...";
                 if (!io::decode(ifile, "NORB: ", iop))
                 {
@@ -171,28 +206,12 @@ namespace ncv
                         }
 
                         // load annotations
-                        const size_t n_cameras = 2;
-                        const size_t cnt = dims[0];
+                        const size_t n_labels = dims[0];
 
                         int32_t label;
-                        for (size_t i = 0; i < cnt && stream.read(reinterpret_cast<char*>(&label), sizeof(label)); i ++)
+                        for (size_t i = 0; i < n_labels && stream.read(reinterpret_cast<char*>(&label), sizeof(label)); i ++)
                         {
-                                const size_t ilabel = label;                                
-                                for (size_t cam = 0; cam < n_cameras; cam ++)
-                                {
-                                        sample_t sample(iindex, sample_region(0, 0));
-                                        if (ilabel < osize())
-                                        {
-                                                sample.m_label = tlabels[ilabel];
-                                                sample.m_target = ncv::class_target(ilabel, osize());
-                                        }
-                                        sample.m_fold = { 0, p };
-                                        add_sample(sample);
-                                        
-                                        ++ iindex;
-                                }
-                                
-                                ++ gcount;
+                                labels.push_back(static_cast<size_t>(label));
                         }
                         
                         return stream.tellg() == stream.size();
@@ -204,9 +223,36 @@ namespace ncv
                         log_error() << "NORB: failed to load file <" << gfile << ">!";
                         return false;
                 }
-                
+
+                // OK
+                return  images.size() == n_cameras * cnt &&
+                        labels.size() == cnt;
+        }
+
+        bool norb_task_t::add(images_t& images, const indices_t& labels, protocol p, size_t count)
+        {
+                const size_t n_cameras = 2;
+
+                for (size_t i = 0; i < labels.size(); i ++)
+                {
+                        const size_t ilabel = labels[i];
+                        for (size_t cam = 0; cam < n_cameras; cam ++)
+                        {
+                                add_image(std::move(images[i * n_cameras + cam]));
+
+                                sample_t sample(n_images() - 1, sample_region(0, 0));
+                                if (ilabel < osize())
+                                {
+                                        sample.m_label = tlabels[ilabel];
+                                        sample.m_target = ncv::class_target(ilabel, osize());
+                                }
+                                sample.m_fold = { 0, p };
+                                add_sample(sample);
+                        }
+                }
+
                 // OK
-                log_info() << "NORB: loaded " << icount << "/" << gcount << " samples.";
-                return (count == gcount) && (count == icount);
+                log_info() << "NORB: loaded " << labels.size() << " samples.";
+                return count == labels.size();
         }
 }
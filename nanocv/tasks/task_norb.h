@@ -33,9 +33,12 @@ namespace ncv
 
         private:
 
-                // load binary file
-                bool load(const string_t& bfile, protocol p, size_t count);
-                bool load(const string_t& ifile, const string_t& gfile, protocol p, size_t count);
+                // decode the images & the labels of a binary file (thread-safe)
+                bool load(const string_t& bfile, images_t& images, indices_t& labels) const;
+                bool load(const string_t& ifile, const string_t& gfile, images_t& images, indices_t& labels) const;
+
+                // add the decoded images & labels
+                bool add(images_t& images, const indices_t& labels, protocol p, size_t count);
         };
 }
 
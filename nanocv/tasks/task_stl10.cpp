@@ -4,6 +4,7 @@
 #include "nanocv/math/cast.hpp"
 #include "nanocv/file/stream.h"
 #include "nanocv/file/archive.h"
+#include "nanocv/thread/loopi.hpp"
 
 namespace ncv
 {
@@ -76,28 +77,35 @@ namespace ncv
                         }
                 };
                 
-                log_info() << "STL-10: loading file <" << bfile << "> ...";
+                return load_cached({ bfile }, [&] ()
+                {
+                        clear_memory(n_test + n_train + n_unlabeled);
+
+                        log_info() << "STL-10: loading file <" << bfile << "> ...";
 
-                return  io::decode(bfile, "STL-10: ", op);
+                        return io::decode(bfile, "STL-10: ", op);
+                });
         }
         
         bool stl10_task_t::load_ifile(const string_t& ifile, const char* bdata, size_t bdata_size, bool unlabeled, size_t count)
         {
                 log_info() << "STL-10: loading file <" << ifile << "> ...";
 
-                io::stream_t stream(bdata, bdata_size);
+                const size_t record_size = irows() * icols() * 3;
+                const size_t icount = bdata_size / record_size;
 
-                std::vector<char> buffer(irows() * icols() * 3);
+                // decode images (in parallel) ...
+                images_t images(icount);
+                thread_loopi(icount, thread_pool(), [&] (size_t i)
+                {
+                        images[i].load_rgba(bdata + i * record_size, irows(), icols(), irows() * icols());
+                        images[i].transpose_in_place();
+                });
 
-                size_t icount = 0;
-                
-                // load images
-                while (stream.read(buffer.data(), buffer.size()))
+                // ... and add them in order
+                for (size_t i = 0; i < icount; i ++)
                 {
-                        image_t image;
-                        image.load_rgba(buffer.data(), irows(), icols(), irows() * icols());
-                        image.transpose_in_place();
-                        add_image(image);
+                        add_image(std::move(images[i]));
 
                         if (unlabeled)
                         {
@@ -105,8 +113,6 @@ namespace ncv
                                 // no annotation
                                 add_sample(sample);
                         }
-
-                        ++ icount;
                 }
 
                 log_info() << "STL-10: loaded " << icount << " images.";
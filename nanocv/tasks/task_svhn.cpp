@@ -3,10 +3,13 @@
 #include "nanocv/logger.h"
 #include "nanocv/file/gzip.h"
 #include "nanocv/file/mat5.h"
+#include "nanocv/file/chunk.h"
 #include "nanocv/vision/color.h"
 #include "nanocv/math/numeric.hpp"
+#include "nanocv/thread/loopi.hpp"
 #include <fstream>
 #include <memory>
+#include <algorithm>
 
 namespace ncv
 {
@@ -24,14 +27,42 @@ namespace ncv
                 const string_t test_file = dir + "/test_32x32.mat";
                 const size_t n_test_samples = 26032;
 
-                clear_memory(n_train_samples + n_test_samples);
+                return load_cached({ train_file, extra_file, test_file }, [&] ()
+                {
+                        clear_memory(n_train_samples + n_test_samples);
+
+                        // decode the files concurrently ...
+                        const strings_t files = { train_file, extra_file, test_file };
+                        const std::vector<protocol> protocols = { protocol::train, protocol::train, protocol::test };
+
+                        std::vector<images_t> images(files.size());
+                        std::vector<indices_t> labels(files.size());
+                        std::vector<char> oks(files.size(), 0);
+
+                        thread_loopi(files.size(), thread_pool(), [&] (size_t f)
+                        {
+                                oks[f] = load(files[f], images[f], labels[f]);
+                        });
 
-                return  load(train_file, protocol::train) +
-                        load(extra_file, protocol::train) == n_train_samples &&
-                        load(test_file, protocol::test) == n_test_samples;
+                        if (!std::all_of(oks.begin(), oks.end(), [] (char ok) { return ok != 0; }))
+                        {
+                                return false;
+                        }
+
+                        // ... and add them in order
+                        size_t n_train = 0, n_test = 0;
+                        for (size_t f = 0; f < files.size(); f ++)
+                        {
+                                (protocols[f] == protocol::train ? n_train : n_test) +=
+                                        add(images[f], labels[f], protocols[f]);
+                        }
+
+                        return  n_train == n_train_samples &&
+                                n_test == n_test_samples;
+                });
         }
 
-        size_t svhn_task_t::load(const string_t& bfile, protocol p)
+        bool svhn_task_t::load(const string_t& bfile, images_t& images, indices_t& labels) const
         {
                 log_info() << "SVHN: processing file <" << bfile << "> ...";
 
@@ -39,7 +70,7 @@ namespace ncv
                 if (!istream.is_open())
                 {
                         log_error() << "SVHN: failed to open file!";
-                        return 0;
+                        return false;
                 }
 
                 // header section
@@ -47,7 +78,7 @@ namespace ncv
                 if (!istream.read(header, 116))
                 {
                         log_error() << "SVHN: failed to read header!";
-                        return 0;
+                        return false;
                 }
                 log_info() << "SVHN: read header <" << string_t(header, header + 116) << ">.";
 
@@ -56,134 +87,185 @@ namespace ncv
                         !istream.read(byte, 4))         // version + endian
                 {
                         log_error() << "SVHN: failed to read offset & version!";
-                        return 0;
+                        return false;
                 }
 
-                // data sections (image rgb + labels)
-                io::data_t image_data;
-                io::data_t label_data;
-                for (int isection = 0; isection < 2; isection ++)
+                // image section: decoded in chunks as it is decompressed (NB: the images are stored contiguously)
+                mat5::section_t isection;
+                if (!load_section(istream, isection))
                 {
-                        // section header
-                        mat5::section_t section;
-                        if (!section.load(istream))
-                        {
-                                log_error() << "SVHN: failed to read section!";
-                                return 0;
-                        }
+                        return false;
+                }
+
+                mat5::array_t iarray;
+                size_t n_samples = 0;           // number of images in the array (0 = header not decoded yet)
 
-                        if (section.m_dtype != mat5::data_type::miCOMPRESSED)
+                const auto iop = [&] (const string_t&, const char* data, size_t size, size_t& used)
+                {
+                        // header (NB: the first chunk is large enough to contain it)
+                        if (n_samples == 0)
                         {
-                                log_error() << "SVHN: invalid data type <" << mat5::to_string(section.m_dtype)
-                                            << ">! expecting " << mat5::to_string(mat5::data_type::miCOMPRESSED) << "!";
-                                return 0;
-                        }
+                                if (    size < 8 ||
+                                        !iarray.load(io::data_t(data, data + std::min(size, size_t(4096))),
+                                                     8 + *reinterpret_cast<const uint32_t*>(data + 4)))
+                                {
+                                        log_error() << "SVHN: invalid image array!";
+                                        return false;
+                                }
 
-                        log_info() << "SVHN: uncompressing " << section.dsize() << " bytes ...";
+                                iarray.log(log_info() << "SVHN: image array: ");
 
-                        io::data_t& data = (isection == 0) ? image_data : label_data;
-                        if (!io::uncompress_gzip(istream, section.dsize(), data))
-                        {
-                                log_error() << "SVHN: failed to read compressed data!";
-                                return 0;
+                                const mat5::section_t& dsection = iarray.m_sections[3];
+                                const indices_t& idims = iarray.m_dims;
+                                if (    idims.size() != 4 ||
+                                        idims[0] != irows() ||
+                                        idims[1] != icols() ||
+                                        idims[2] != 3 ||
+                                        idims[3] == 0 ||
+                                        dsection.m_dtype != mat5::data_type::miUINT8)
+                                {
+                                        log_error() << "SVHN: invalid image array size or type (expecting UINT8)!";
+                                        return false;
+                                }
+
+                                n_samples = idims[3];
+                                used = dsection.dbegin();
+                                return true;
                         }
 
-                        log_info() << "SVHN: uncompressed " << data.size() << " bytes.";
+                        // images
+                        used = (images.size() < n_samples) ? decode(data, size, n_samples - images.size(), images) : size;
+                        return true;
+                };
+
+                log_info() << "SVHN: uncompressing " << isection.dsize() << " bytes ...";
+
+                io::chunk_buffer_t ibuffer(bfile, iop);
+                if (!io::uncompress_gzip(istream, isection.dsize(), ibuffer))
+                {
+                        log_error() << "SVHN: failed to read compressed data!";
+                        return false;
                 }
 
-                // decode the uncompressed bytes
-                return decode(image_data, label_data, p);
-        }
+                log_info() << "SVHN: uncompressed " << ibuffer.count() << " bytes.";
 
-        size_t svhn_task_t::decode(const io::data_t& idata, const io::data_t& ldata, protocol p)
-        {
-                // decode image & label arrays
-                mat5::array_t iarray, larray;
-                if (!iarray.load(idata))
+                // label section: decoded at once (NB: it is small)
+                mat5::section_t lsection;
+                if (!load_section(istream, lsection))
                 {
-                        log_error() << "SVHN: invalid image array!";
-                        return 0;
+                        return false;
                 }
+
+                log_info() << "SVHN: uncompressing " << lsection.dsize() << " bytes ...";
+
+                io::data_t ldata;
+                if (!io::uncompress_gzip(istream, lsection.dsize(), ldata))
+                {
+                        log_error() << "SVHN: failed to read compressed data!";
+                        return false;
+                }
+
+                log_info() << "SVHN: uncompressed " << ldata.size() << " bytes.";
+
+                mat5::array_t larray;
                 if (!larray.load(ldata))
                 {
                         log_error() << "SVHN: invalid label array!";
-                        return 0;
+                        return false;
                 }
 
-                iarray.log(log_info() << "SVHN: image array: ");
                 larray.log(log_info() << "SVHN: label array: ");
 
-                const mat5::section_t& isection = iarray.m_sections[3];
-                const mat5::section_t& lsection = larray.m_sections[3];
-
-                const indices_t& idims = iarray.m_dims;
+                const mat5::section_t& dsection = larray.m_sections[3];
                 const indices_t& ldims = larray.m_dims;
-
-                // check array size
-                if (    idims.size() != 4 ||
-                        idims[0] != irows() ||
-                        idims[1] != icols() ||
-                        idims[2] != 3 ||
-
-                        ldims.size() != 2 ||
+                if (    ldims.size() != 2 ||
                         ldims[1] != 1 ||
-
-                        idims[3] != ldims[0])
+                        ldims[0] != n_samples ||
+                        images.size() != n_samples ||
+                        dsection.m_dtype != mat5::data_type::miUINT8)
                 {
                         log_error() << "SVHN: invalid or mis-matching image & label array size!";
-                        return 0;
+                        return false;
                 }
 
-                // check data type
-                if (    isection.m_dtype != mat5::data_type::miUINT8 ||
-                        lsection.m_dtype != mat5::data_type::miUINT8)
+                // labels
+                labels.resize(n_samples);
+                for (size_t i = 0; i < n_samples; i ++)
                 {
-                        log_error() << "SVHN: expecting UINT8 image & label arrays!";
-                        return 0;
+                        labels[i] = static_cast<unsigned char>(ldata[dsection.dbegin() + i]);
                 }
 
-                // load images & labels
-                const size_t n_samples = idims[3];
+                return true;
+        }
 
-                size_t cnt = 0;
-                for (size_t i = 0; i < n_samples; i ++)
+        bool svhn_task_t::load_section(std::ifstream& istream, mat5::section_t& section) const
+        {
+                if (!section.load(istream))
                 {
-                        const size_t lbeg = lsection.dbegin() + i;
+                        log_error() << "SVHN: failed to read section!";
+                        return false;
+                }
 
-                        // label ...
-                        size_t ilabel = ldata[lbeg + 0];
-                        if (ilabel == 10)
-                        {
-                                ilabel = 0;
-                        }
-                        else if (ilabel < 1 || ilabel > 9)
-                        {
-                                continue;
-                        }
+                if (section.m_dtype != mat5::data_type::miCOMPRESSED)
+                {
+                        log_error() << "SVHN: invalid data type <" << mat5::to_string(section.m_dtype)
+                                    << ">! expecting " << mat5::to_string(mat5::data_type::miCOMPRESSED) << "!";
+                        return false;
+                }
+
+                return true;
+        }
+
+        size_t svhn_task_t::decode(const char* idata, size_t isize, size_t max_count, images_t& images) const
+        {
+                const size_t px = irows() * icols();
+                const size_t ix = irows() * icols() * 3;
 
-                        // image ...
-                        image_t image(irows(), icols(), color());
+                const size_t offset = images.size();
+                const size_t count = std::min(isize / ix, max_count);
 
-                        const size_t px = irows() * icols();
-                        const size_t ix = irows() * icols() * 3;
-                        const size_t ibeg = isection.dbegin() + i * ix;
+                // decode the whole images in parallel (NB: stored as RGB planes in column-major order)
+                images.resize(offset + count);
+                thread_loopi(count, thread_pool(), [&] (size_t i)
+                {
+                        const unsigned char* data = reinterpret_cast<const unsigned char*>(idata + i * ix);
 
+                        image_t& image = images[offset + i];
+                        image.resize(irows(), icols(), color());
                         for (size_t r = 0, p = 0; r < irows(); r ++)
                         {
                                 for (size_t c = 0; c < icols(); c ++, p ++)
                                 {
-                                        const size_t ir = ibeg + (px * 0 + p);
-                                        const size_t ig = ibeg + (px * 1 + p);
-                                        const size_t ib = ibeg + (px * 2 + p);
-
-                                        image.set(c, r, color::make_rgba(idata[ir], idata[ig], idata[ib]));
+                                        image.set(c, r, color::make_rgba(data[px * 0 + p], data[px * 1 + p], data[px * 2 + p]));
                                 }
                         }
+                });
+
+                return count * ix;
+        }
 
-                        add_image(image);
+        size_t svhn_task_t::add(images_t& images, const indices_t& labels, protocol p)
+        {
+                const size_t iindex = n_images();
+                for (image_t& image : images)
+                {
+                        add_image(std::move(image));
+                }
+
+                size_t cnt = 0;
+                for (size_t i = 0; i < labels.size(); i ++)
+                {
+                        size_t ilabel = labels[i];
+                        if (ilabel == 10)
+                        {
+                                ilabel = 0;
+                        }
+                        else if (ilabel < 1 || ilabel > 9)
+                        {
+                                continue;
+                        }
 
-                        // sample
-                        sample_t sample(n_images() - 1, sample_region(0, 0));
+                        sample_t sample(iindex + i, sample_region(0, 0));
                         sample.m_label = "digit" + text::to_string(ilabel);
                         sample.m_target = ncv::class_target(ilabel, osize());
                         sample.m_fold = { 0, p };
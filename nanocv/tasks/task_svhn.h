@@ -1,7 +1,8 @@
 #pragma once
 
 #include "nanocv/task.h"
-#include "nanocv/file/base.h"
+#include "nanocv/file/mat5.h"
+#include <iosfwd>
 
 namespace ncv
 {
@@ -34,11 +35,17 @@ namespace ncv
 
         private:
 
-                // load binary file
-                size_t load(const string_t& bfile, protocol p);
+                // decode the images & the labels of a binary file (thread-safe)
+                bool load(const string_t& bfile, images_t& images, indices_t& labels) const;
 
-                // decode the uncompressed bytes (images + labels)
-                size_t decode(const io::data_t& image_data, const io::data_t& label_data, protocol p);
+                // load the header of a compressed data section
+                bool load_section(std::ifstream& istream, mat5::section_t& section) const;
+
+                // decode at most <max_count> whole images of an uncompressed chunk (returns the number of bytes decoded)
+                size_t decode(const char* idata, size_t isize, size_t max_count, images_t& images) const;
+
+                // add the decoded images & labels (returns the number of samples added)
+                size_t add(images_t& images, const indices_t& labels, protocol p);
         };
 }
 
@@ -9,6 +9,8 @@ namespace ncv
         typedef tensor::vector_types_t<scalar_t>::tvector       vector_t;
         typedef tensor::vector_types_t<scalar_t>::tvectors      vectors_t;
 
+        typedef tensor::vector_types_t<acc_scalar_t>::tvector   acc_vector_t;
+
         typedef tensor::matrix_types_t<scalar_t>::tmatrix       matrix_t;
         typedef tensor::matrix_types_t<scalar_t>::tmatrices     matrices_t;
 
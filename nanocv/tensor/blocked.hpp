@@ -0,0 +1,83 @@
+#pragma once
+
+namespace ncv
+{
+        namespace tensor
+        {
+                ///
+                /// \brief number of groups of interleaved planes in the channel-blocked layout
+                ///
+                template
+                <
+                        typename tsize
+                >
+                tsize blocks(tsize dims, tsize block)
+                {
+                        return (dims + block - 1) / block;
+                }
+
+                ///
+                /// \brief convert a tensor to the channel-blocked layout:
+                ///     the planes are interleaved in groups of <block> planes, such that the coefficient (d, r, c)
+                ///     is stored at (d / block, r, c * block + d % block) and
+                ///     the coefficients of the same pixel from consecutive planes are contiguous in memory
+                ///
+                /// NB: the last group is padded with zero planes.
+                ///
+                template
+                <
+                        typename ttensori,
+                        typename ttensoro,
+                        typename tsize
+                >
+                void block(const ttensori& idata, tsize block, ttensoro& odata)
+                {
+                        const tsize dims = idata.dims();
+                        const tsize size = idata.planeSize();
+
+                        odata.resize(blocks(dims, block), idata.rows(), idata.cols() * block);
+                        if (dims % block)
+                        {
+                                odata.vector(odata.dims() - 1).setZero();
+                        }
+
+                        for (tsize d = 0; d < dims; d ++)
+                        {
+                                const auto* pi = idata.planeData(d);
+                                auto* po = odata.planeData(d / block) + d % block;
+
+                                for (tsize k = 0; k < size; k ++)
+                                {
+                                        po[k * block] = pi[k];
+                                }
+                        }
+                }
+
+                ///
+                /// \brief convert a tensor from the channel-blocked layout (see ::block) with <dims> planes
+                ///
+                template
+                <
+                        typename ttensori,
+                        typename ttensoro,
+                        typename tsize
+                >
+                void unblock(const ttensori& idata, tsize dims, tsize block, ttensoro& odata)
+                {
+                        odata.resize(dims, idata.rows(), idata.cols() / block);
+
+                        const tsize size = odata.planeSize();
+
+                        for (tsize d = 0; d < dims; d ++)
+                        {
+                                const auto* pi = idata.planeData(d / block) + d % block;
+                                auto* po = odata.planeData(d);
+
+                                for (tsize k = 0; k < size; k ++)
+                                {
+                                        po[k] = pi[k * block];
+                                }
+                        }
+                }
+        }
+}
@@ -0,0 +1,169 @@
+#include "tensor_cache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ncv
+{
+        tensor_cache_t::tensor_cache_t(size_t budget, tensor_cache_type type)
+                :       m_budget(budget),
+                        m_type(type),
+                        m_size(0),
+                        m_hits(0),
+                        m_misses(0)
+        {
+        }
+
+        void tensor_cache_t::load(size_t index, const image_t& image, const rect_t& region, scalar_t* data)
+        {
+                const key_t key(index, region.left(), region.top(), region.rows(), region.cols());
+
+                // cached: move it to the front (as the most recently used)
+                {
+                        const std::lock_guard<std::mutex> lock(m_mutex);
+
+                        const auto it = m_map.find(key);
+                        if (it != m_map.end())
+                        {
+                                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                                copy(*it->second, data);
+
+                                m_hits ++;
+                                return;
+                        }
+
+                        m_misses ++;
+                }
+
+                // not cached: convert from the image pixels (NB: without locking) ...
+                image.to_tensor(region, data);
+
+                const size_t dims = image.is_rgba() ? 3 : (image.is_luma() ? 1 : 0);
+                if (!dims)
+                {
+                        return;         // NB: unknown image mode, nothing to cache
+                }
+
+                const size_t count = dims * static_cast<size_t>(region.rows() * region.cols());
+
+                entry_t entry;
+                entry.m_key = key;
+
+                switch (m_type)
+                {
+                case tensor_cache_type::uint8:
+                        entry.m_bdata.resize(count);
+                        std::transform(data, data + count, entry.m_bdata.begin(), [] (scalar_t v)
+                        {
+                                return static_cast<uint8_t>(std::lround(v * scalar_t(255)));
+                        });
+                        break;
+
+                case tensor_cache_type::float32:
+                        entry.m_fdata.resize(count);
+                        std::transform(data, data + count, entry.m_fdata.begin(), [] (scalar_t v)
+                        {
+                                return static_cast<float>(v);
+                        });
+                        break;
+
+                case tensor_cache_type::scalar:
+                default:
+                        entry.m_sdata.assign(data, data + count);
+                        break;
+                }
+
+                const size_t esize = size(entry);
+                if (esize > m_budget)
+                {
+                        return;
+                }
+
+                // ... and cache it by evicting the least recently used tensors (if needed)
+                const std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (m_map.find(key) != m_map.end())
+                {
+                        return;         // NB: cached meanwhile by another thread
+                }
+
+                while (m_size + esize > m_budget)
+                {
+                        m_size -= size(m_entries.back());
+                        m_map.erase(m_entries.back().m_key);
+                        m_entries.pop_back();
+                }
+
+                m_entries.push_front(std::move(entry));
+                m_map[key] = m_entries.begin();
+                m_size += esize;
+        }
+
+        void tensor_cache_t::clear()
+        {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+
+                m_entries.clear();
+                m_map.clear();
+                m_size = 0;
+        }
+
+        size_t tensor_cache_t::size() const
+        {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                return m_size;
+        }
+
+        size_t tensor_cache_t::count() const
+        {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                return m_entries.size();
+        }
+
+        size_t tensor_cache_t::hits() const
+        {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                return m_hits;
+        }
+
+        size_t tensor_cache_t::misses() const
+        {
+                const std::lock_guard<std::mutex> lock(m_mutex);
+                return m_misses;
+        }
+
+        size_t tensor_cache_t::size(const entry_t& entry) const
+        {
+                return  sizeof(entry_t) +
+                        entry.m_sdata.size() * sizeof(scalar_t) +
+                        entry.m_fdata.size() * sizeof(float) +
+                        entry.m_bdata.size() * sizeof(uint8_t);
+        }
+
+        void tensor_cache_t::copy(const entry_t& entry, scalar_t* data) const
+        {
+                // NB: the same scaling as image_t::to_tensor, so the uint8 tensors are restored exactly
+                const scalar_t scale = scalar_t(1) / scalar_t(255);
+
+                switch (m_type)
+                {
+                case tensor_cache_type::uint8:
+                        std::transform(entry.m_bdata.begin(), entry.m_bdata.end(), data, [=] (uint8_t v)
+                        {
+                                return scale * v;
+                        });
+                        break;
+
+                case tensor_cache_type::float32:
+                        std::transform(entry.m_fdata.begin(), entry.m_fdata.end(), data, [] (float v)
+                        {
+                                return static_cast<scalar_t>(v);
+                        });
+                        break;
+
+                case tensor_cache_type::scalar:
+                default:
+                        std::copy(entry.m_sdata.begin(), entry.m_sdata.end(), data);
+                        break;
+                }
+        }
+}
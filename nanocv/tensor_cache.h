@@ -0,0 +1,111 @@
+#pragma once
+
+#include "tensor.h"
+#include "vision/image.h"
+#include "noncopyable.hpp"
+#include "text/enum_string.hpp"
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace ncv
+{
+        ///
+        /// \brief storage type of the cached input tensors
+        ///
+        enum class tensor_cache_type
+        {
+                scalar,                 ///< scaled values as scalars (exact, no conversion when reading)
+                float32,                ///< scaled values as floats (lossy if the scalar type is wider than float)
+                uint8                   ///< raw pixel values (exact, the smallest, scaled when reading)
+        };
+
+        ///
+        /// \brief cache the (scaled) input tensors of image regions within a memory budget,
+        ///     such that repeated passes over the same samples (e.g. epochs, line-search probes)
+        ///     skip the conversion from the image pixels
+        ///
+        /// NB: the least recently used tensors are evicted to stay within the memory budget.
+        /// NB: it is thread-safe.
+        ///
+        class NANOCV_PUBLIC tensor_cache_t : private noncopyable_t
+        {
+        public:
+
+                ///
+                /// \brief constructor
+                ///
+                tensor_cache_t(size_t budget, tensor_cache_type type);
+
+                ///
+                /// \brief write the input tensor of the given region of the <index>th image
+                ///     to the given buffer (of idims x rows x cols values)
+                ///
+                void load(size_t index, const image_t& image, const rect_t& region, scalar_t* data);
+
+                ///
+                /// \brief remove all cached tensors (e.g. the images have changed)
+                ///
+                void clear();
+
+                // access functions
+                size_t budget() const { return m_budget; }
+                tensor_cache_type type() const { return m_type; }
+                size_t size() const;            ///< memory used by the cached tensors (in bytes)
+                size_t count() const;           ///< number of cached tensors
+                size_t hits() const;
+                size_t misses() const;
+
+        private:
+
+                typedef std::tuple<size_t, coord_t, coord_t, coord_t, coord_t>  key_t;
+
+                struct entry_t
+                {
+                        key_t                   m_key;
+                        std::vector<scalar_t>   m_sdata;        ///< scaled values (scalar)
+                        std::vector<float>      m_fdata;        ///< scaled values (float32)
+                        std::vector<uint8_t>    m_bdata;        ///< pixel values (uint8)
+                };
+
+                typedef std::list<entry_t>                      entries_t;
+                typedef std::map<key_t, entries_t::iterator>    entry_map_t;
+
+                ///
+                /// \brief memory used by a cached tensor (in bytes)
+                ///
+                size_t size(const entry_t& entry) const;
+
+                ///
+                /// \brief write the cached tensor to the given buffer
+                ///
+                void copy(const entry_t& entry, scalar_t* data) const;
+
+        private:
+
+                // attributes
+                size_t                  m_budget;       ///< maximum memory (in bytes)
+                tensor_cache_type       m_type;
+                mutable std::mutex      m_mutex;
+                entries_t               m_entries;      ///< cached tensors (the most recently used first)
+                entry_map_t             m_map;          ///< cached tensors by key
+                size_t                  m_size;         ///< memory used (in bytes)
+                size_t                  m_hits, m_misses;
+        };
+
+        // string cast for enumerations
+        namespace text
+        {
+                template <>
+                inline std::map<tensor_cache_type, std::string> enum_string<tensor_cache_type>()
+                {
+                        return
+                        {
+                                { tensor_cache_type::scalar,    "scalar" },
+                                { tensor_cache_type::float32,   "float" },
+                                { tensor_cache_type::uint8,     "uint8" }
+                        };
+                }
+        }
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace ncv
+{
+        ///
+        /// \brief lock-free work-stealing deque of pointers:
+        ///     the owner thread pushes & pops at the bottom (LIFO), while the other threads steal from the top (FIFO)
+        ///
+        /// NB: this follows Chase & Lev, "Dynamic circular work-stealing deque" with the memory ordering from
+        ///     Le et al., "Correct and efficient work-stealing for weak memory models".
+        /// NB: the buffers are released only by the destructor, so that a concurrent steal never reads freed memory.
+        ///
+        template
+        <
+                typename tvalue
+        >
+        class steal_deque_t
+        {
+        public:
+
+                ///
+                /// \brief constructor
+                ///
+                explicit steal_deque_t(std::size_t capacity = 256)
+                        :       m_top(0),
+                                m_bottom(0)
+                {
+                        m_buffers.emplace_back(new buffer_t(capacity));
+                        m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+                }
+
+                ///
+                /// \brief disable copying
+                ///
+                steal_deque_t(const steal_deque_t&) = delete;
+                steal_deque_t& operator=(const steal_deque_t&) = delete;
+
+                ///
+                /// \brief add a new value at the bottom (owner thread only)
+                ///
+                void push(tvalue* value)
+                {
+                        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+                        const int64_t t = m_top.load(std::memory_order_acquire);
+
+                        buffer_t* buffer = m_buffer.load(std::memory_order_relaxed);
+                        if (b - t > buffer->size() - 1)
+                        {
+                                buffer = grow(buffer, t, b);
+                        }
+
+                        buffer->put(b, value);
+                        std::atomic_thread_fence(std::memory_order_release);
+                        m_bottom.store(b + 1, std::memory_order_relaxed);
+                }
+
+                ///
+                /// \brief remove the value at the bottom (owner thread only), returns nullptr if empty
+                ///
+                tvalue* pop()
+                {
+                        const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+                        buffer_t* buffer = m_buffer.load(std::memory_order_relaxed);
+                        m_bottom.store(b, std::memory_order_relaxed);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        int64_t t = m_top.load(std::memory_order_relaxed);
+
+                        tvalue* value = nullptr;
+                        if (t <= b)
+                        {
+                                value = buffer->get(b);
+                                if (t == b)
+                                {
+                                        // last value: race against the thieves
+                                        if (!m_top.compare_exchange_strong(t, t + 1,
+                                                std::memory_order_seq_cst, std::memory_order_relaxed))
+                                        {
+                                                value = nullptr;
+                                        }
+                                        m_bottom.store(b + 1, std::memory_order_relaxed);
+                                }
+                        }
+                        else
+                        {
+                                m_bottom.store(b + 1, std::memory_order_relaxed);
+                        }
+
+                        return value;
+                }
+
+                ///
+                /// \brief remove the value at the top (any thread), returns nullptr if empty or if the race is lost
+                ///
+                tvalue* steal()
+                {
+                        int64_t t = m_top.load(std::memory_order_acquire);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+                        tvalue* value = nullptr;
+                        if (t < b)
+                        {
+                                buffer_t* buffer = m_buffer.load(std::memory_order_acquire);
+                                value = buffer->get(t);
+                                if (!m_top.compare_exchange_strong(t, t + 1,
+                                        std::memory_order_seq_cst, std::memory_order_relaxed))
+                                {
+                                        value = nullptr;
+                                }
+                        }
+
+                        return value;
+                }
+
+                ///
+                /// \brief check if there are values to pop or steal (approximate if called concurrently)
+                ///
+                bool empty() const
+                {
+                        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+                        const int64_t t = m_top.load(std::memory_order_relaxed);
+                        return b <= t;
+                }
+
+        private:
+
+                ///
+                /// \brief circular buffer of atomic values
+                ///
+                struct buffer_t
+                {
+                        explicit buffer_t(std::size_t capacity)
+                                :       m_mask(static_cast<int64_t>(capacity) - 1),
+                                        m_data(new std::atomic<tvalue*>[capacity])
+                        {
+                        }
+
+                        int64_t size() const
+                        {
+                                return m_mask + 1;
+                        }
+
+                        tvalue* get(int64_t i) const
+                        {
+                                return m_data[i & m_mask].load(std::memory_order_relaxed);
+                        }
+
+                        void put(int64_t i, tvalue* value)
+                        {
+                                m_data[i & m_mask].store(value, std::memory_order_relaxed);
+                        }
+
+                        int64_t                                         m_mask;
+                        std::unique_ptr<std::atomic<tvalue*>[]>         m_data;
+                };
+
+                ///
+                /// \brief double the capacity (owner thread only)
+                ///
+                buffer_t* grow(buffer_t* buffer, int64_t t, int64_t b)
+                {
+                        m_buffers.emplace_back(new buffer_t(2 * static_cast<std::size_t>(buffer->size())));
+
+                        buffer_t* gbuffer = m_buffers.back().get();
+                        for (int64_t i = t; i < b; i ++)
+                        {
+                                gbuffer->put(i, buffer->get(i));
+                        }
+
+                        m_buffer.store(gbuffer, std::memory_order_release);
+                        return gbuffer;
+                }
+
+        private:
+
+                // attributes (NB: the indices modified by the thieves & by the owner are on different cache lines)
+                std::atomic<int64_t>                            m_top;          ///< steal position
+                char                                            m_pad0[64];
+                std::atomic<int64_t>                            m_bottom;       ///< push/pop position
+                char                                            m_pad1[64];
+                std::atomic<buffer_t*>                          m_buffer;       ///< current buffer
+                std::vector<std::unique_ptr<buffer_t>>          m_buffers;      ///< all buffers (owner thread only)
+        };
+}
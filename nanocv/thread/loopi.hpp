@@ -1,11 +1,12 @@
 #pragma once
 
-#include "pool.h"
+#include "schedule.hpp"
 
 namespace ncv
 {
         ///
         /// \brief split a loop computation of the given size using a thread pool
+        ///     with at most the given number of concurrent tasks (0 = all workers) and the given scheduling
         /// NB: the operator receives the index of the sample to process: op(i)
         ///
         template
@@ -13,27 +14,48 @@ namespace ncv
                 typename tsize,
                 class toperator
         >
-        void thread_loopi(tsize N, thread_pool_t& pool, toperator op)
+        void thread_loopi(tsize N, thread_pool_t& pool, tsize nthreads, thread_schedule schedule, tsize chunk,
+                toperator op)
         {
-                const tsize n_tasks = static_cast<tsize>(pool.n_workers());
-                const tsize task_size = (N + n_tasks - 1) / n_tasks;
-
-                for (tsize t = 0; t < n_tasks; t ++)
+                thread_loops(N, pool, nthreads, schedule, chunk, [&op] (tsize begin, tsize end, tsize)
                 {
-                        pool.enqueue([=,&op]()
+                        for (tsize i = begin; i < end; i ++)
                         {
-                                for (tsize i = t * task_size, iend = std::min(i + task_size, N); i < iend; i ++)
-                                {
-                                        op(i);
-                                }
-                        });
-                }
+                                op(i);
+                        }
+                });
+        }
+
+        ///
+        /// \brief split a loop computation of the given size using a thread pool
+        ///     with at most the given number of concurrent tasks (0 = all workers)
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loopi(tsize N, thread_pool_t& pool, tsize nthreads, toperator op)
+        {
+                thread_loopi(N, pool, nthreads, thread_schedule::fixed, tsize(0), op);
+        }
 
-                pool.wait();
+        ///
+        /// \brief split a loop computation of the given size using a thread pool
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loopi(tsize N, thread_pool_t& pool, toperator op)
+        {
+                thread_loopi(N, pool, tsize(0), op);
         }
 
         ///
-        /// \brief split a loop computation of the given size using multiple threads
+        /// \brief split a loop computation of the given size using at most the given number of threads
+        ///     (of the process-wide thread pool)
         ///
         template
         <
@@ -42,8 +64,7 @@ namespace ncv
         >
         void thread_loopi(tsize N, tsize nthreads, toperator op)
         {
-                thread_pool_t pool(nthreads);
-                thread_loopi(N, pool, op);
+                thread_loopi(N, get_thread_pool(), nthreads, op);
         }
         
         ///
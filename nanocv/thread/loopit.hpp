@@ -1,11 +1,12 @@
 #pragma once
 
-#include "pool.h"
+#include "schedule.hpp"
 
 namespace ncv
 {
         ///
         /// \brief split a loop computation of the given size using a thread pool
+        ///     with at most the given number of concurrent tasks (0 = all workers) and the given scheduling
         /// NB: the operator receives the index of the sample to process and the assigned thread index: op(i, t)
         ///
         template
@@ -13,27 +14,91 @@ namespace ncv
                 typename tsize,
                 class toperator
         >
-        void thread_loopit(tsize N, thread_pool_t& pool, toperator op)
+        void thread_loopit(tsize N, thread_pool_t& pool, tsize nthreads, thread_schedule schedule, tsize chunk,
+                toperator op)
         {
-                const tsize n_tasks = static_cast<tsize>(pool.n_workers());
-                const tsize task_size = (N + n_tasks - 1) / n_tasks;
-                
-                for (tsize t = 0; t < n_tasks; t ++)
+                thread_loops(N, pool, nthreads, schedule, chunk, [&op] (tsize begin, tsize end, tsize t)
                 {
-                        pool.enqueue([=,&op]()
+                        for (tsize i = begin; i < end; i ++)
                         {
-                                for (tsize i = t * task_size, iend = std::min(i + task_size, N); i < iend; i ++)
-                                {
-                                        op(i, t);
-                                }
-                        });
-                }
-                
-                pool.wait();
+                                op(i, t);
+                        }
+                });
+        }
+
+        ///
+        /// \brief split a loop computation of the given size using a thread pool
+        ///     with at most the given number of concurrent tasks (0 = all workers)
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loopit(tsize N, thread_pool_t& pool, tsize nthreads, toperator op)
+        {
+                thread_loopit(N, pool, nthreads, thread_schedule::fixed, tsize(0), op);
+        }
+
+        ///
+        /// \brief split a loop computation of the given size using a thread pool
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loopit(tsize N, thread_pool_t& pool, toperator op)
+        {
+                thread_loopit(N, pool, tsize(0), op);
         }
         
         ///
-        /// \brief split a loop computation of the given size using multiple threads
+        /// \brief split a loop computation of the given size in contiguous chunks using a thread pool
+        ///     with at most the given number of concurrent tasks (0 = all workers) and the given scheduling
+        /// NB: the operator receives the range of samples to process and the assigned thread index: op(begin, end, t)
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loopr(tsize N, thread_pool_t& pool, tsize nthreads, thread_schedule schedule, tsize chunk,
+                toperator op)
+        {
+                thread_loops(N, pool, nthreads, schedule, chunk, op);
+        }
+
+        ///
+        /// \brief split a loop computation of the given size in contiguous chunks using a thread pool
+        ///     with at most the given number of concurrent tasks (0 = all workers)
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loopr(tsize N, thread_pool_t& pool, tsize nthreads, toperator op)
+        {
+                thread_loopr(N, pool, nthreads, thread_schedule::fixed, tsize(0), op);
+        }
+
+        ///
+        /// \brief split a loop computation of the given size in contiguous chunks using a thread pool
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loopr(tsize N, thread_pool_t& pool, toperator op)
+        {
+                thread_loopr(N, pool, tsize(0), op);
+        }
+
+        ///
+        /// \brief split a loop computation of the given size using at most the given number of threads
+        ///     (of the process-wide thread pool)
         ///
         template
         <
@@ -42,8 +107,7 @@ namespace ncv
         >
         void thread_loopit(tsize N, tsize nthreads, toperator op)
         {
-                thread_pool_t pool(nthreads);
-                thread_loopit(N, pool, op);
+                thread_loopit(N, get_thread_pool(), nthreads, op);
         }
         
         ///
@@ -1,96 +1,359 @@
 #include "pool.h"
+#include <cstdlib>
 
 namespace ncv
 {
-        void thread_pool_t::worker_t::operator()()
+        namespace
         {
-                task_t task;
-                while (true)
+                // the pool & the index of the current worker thread (if any)
+                thread_local const thread_pool_t*       this_pool = nullptr;
+                thread_local std::size_t                this_worker = 0;
+
+                // number of failed attempts to find a task before sleeping
+                const std::size_t                       max_spins = 64;
+
+                // number of worker threads of the process-wide pool (if set) & if the pool is started
+                std::atomic<std::size_t>                global_size(0);
+                std::atomic<bool>                       global_started(false);
+        }
+
+        thread_pool_t::thread_pool_t(std::size_t nthreads)
+                :       m_ntasks(0),
+                        m_queued(0),
+                        m_sleeping(0),
+                        m_stop(false),
+                        m_pinned(false)
+        {
+                nthreads = (nthreads == 0) ? ncv::n_threads() :
+                                             std::max(size_t(1), std::min(nthreads, ncv::max_n_threads()));
+
+                for (size_t i = 0; i < nthreads; i ++)
+                {
+                        m_deques.emplace_back(new deque_t());
+                        m_inboxes.emplace_back(new inbox_t());
+                }
+
+                for (size_t i = 0; i < nthreads; i ++)
+                {
+                        m_workers.push_back(std::thread([this, i] () { work(i); }));
+                }
+        }
+
+        thread_pool_t::~thread_pool_t()
+        {
+                // stop & join
+                {
+                        const lock_t lock(m_mutex);
+
+                        m_stop = true;
+                }
+                m_condition.notify_all();
+
+                for (size_t i = 0; i < m_workers.size(); i ++)
+                {
+                        m_workers[i].join();
+                }
+
+                // discard the tasks not yet started
+                for (item_t* item : m_tasks)
                 {
-                        // wait for a new task to be available in the queue
+                        delete item;
+                }
+                for (const auto& inbox : m_inboxes)
+                {
+                        for (item_t* item : inbox->m_items)
+                        {
+                                delete item;
+                        }
+                }
+                for (const auto& deque : m_deques)
+                {
+                        while (item_t* item = deque->pop())
                         {
-                                lock_t lock(m_data.m_mutex);
+                                delete item;
+                        }
+                }
+        }
 
-                                while ( !m_data.m_stop &&
-                                        m_data.m_tasks.empty())
-                                {
-                                        m_data.m_condition.wait(lock);
-                                }
+        void thread_pool_t::work(std::size_t worker)
+        {
+                this_pool = this;
+                this_worker = worker;
+
+                for (std::size_t spins = 0; !m_stop; )
+                {
+                        item_t* item = take(worker);
+                        if (item)
+                        {
+                                run(item);
+                                spins = 0;
+                        }
+
+                        else if (++ spins < max_spins)
+                        {
+                                std::this_thread::yield();
+                        }
+
+                        // wait for a new task to be available
+                        else
+                        {
+                                lock_t lock(m_mutex);
 
-                                if (m_data.m_stop)
+                                m_sleeping ++;
+                                if (!m_stop && m_queued == 0)
                                 {
-                                        m_data.m_running = 0;
-                                        m_data.m_tasks.clear();
-                                        m_data.m_condition.notify_all();
-                                        break;
+                                        m_condition.wait(lock);
                                 }
+                                m_sleeping --;
 
-                                task = m_data.m_tasks.front();
-                                m_data.m_tasks.pop_front();
-                                m_data.m_running ++;
+                                spins = 0;
                         }
+                }
+        }
 
-                        // execute the task
-                        task();
+        void thread_pool_t::_enqueue(item_t* item)
+        {
+                // NB: the new task is counted before checking for sleeping workers,
+                //      while a worker goes to sleep only after checking that there is no task to run.
+                m_queued ++;
 
-                        // announce that a task was completed
-                        {
-                                const lock_t lock(m_data.m_mutex);
+                const std::size_t worker = this->worker();
+                if (worker < n_workers())
+                {
+                        m_deques[worker]->push(item);
+                }
+                else
+                {
+                        const lock_t lock(m_tmutex);
 
-                                m_data.m_running --;
-                                m_data.m_condition.notify_all();
-                        }
+                        m_tasks.push_back(item);
+                        m_ntasks ++;
                 }
+
+                notify();
         }
 
-        thread_pool_t::thread_pool_t(std::size_t nthreads)
+        void thread_pool_t::_enqueue(item_t* item, std::size_t worker)
         {
-                nthreads = (nthreads == 0) ? ncv::n_threads() :
-                                             std::max(size_t(1), std::min(nthreads, ncv::max_n_threads()));
+                m_queued ++;
 
-                for (size_t i = 0; i < nthreads; i ++)
+                inbox_t& inbox = *m_inboxes[worker % n_workers()];
+                {
+                        const lock_t lock(inbox.m_mutex);
+
+                        inbox.m_items.push_back(item);
+                        inbox.m_size ++;
+                }
+
+                // NB: all workers are woken up, so that the given worker is likely to run its task
+                if (m_sleeping > 0)
                 {
-                        m_workers.push_back(std::thread(thread_pool_t::worker_t(m_data)));
+                        const lock_t lock(m_mutex);
+
+                        m_condition.notify_all();
                 }
         }
 
-        thread_pool_t::~thread_pool_t()
+        void thread_pool_t::notify()
         {
-                // stop & join
+                if (m_sleeping > 0)
                 {
-                        const lock_t lock(m_data.m_mutex);
-                        
-                        m_data.m_stop = true;
+                        const lock_t lock(m_mutex);
+
+                        m_condition.notify_one();
                 }
-                m_data.m_condition.notify_all();
+        }
 
-                for (size_t i = 0; i < m_workers.size(); i ++)
+        thread_pool_t::item_t* thread_pool_t::take(inbox_t& inbox)
+        {
+                item_t* item = nullptr;
+                if (inbox.m_size > 0)
                 {
-                        m_workers[i].join();
+                        const lock_t lock(inbox.m_mutex);
+
+                        if (!inbox.m_items.empty())
+                        {
+                                item = inbox.m_items.front();
+                                inbox.m_items.pop_front();
+                                inbox.m_size --;
+                        }
                 }
+
+                return item;
+        }
+
+        thread_pool_t::item_t* thread_pool_t::take(std::size_t worker)
+        {
+                item_t* item = nullptr;
+
+                // own tasks first (LIFO, cache-friendly) ...
+                if (worker < n_workers())
+                {
+                        item = m_deques[worker]->pop();
+                }
+
+                // ... then the tasks enqueued for this worker ...
+                if (!item && worker < n_workers())
+                {
+                        item = take(*m_inboxes[worker]);
+                }
+
+                // ... then the tasks enqueued by other threads (FIFO) ...
+                if (!item && m_ntasks > 0)
+                {
+                        const lock_t lock(m_tmutex);
+
+                        if (!m_tasks.empty())
+                        {
+                                item = m_tasks.front();
+                                m_tasks.pop_front();
+                                m_ntasks --;
+                        }
+                }
+
+                // ... then steal from the other workers (FIFO, the largest pieces of work)
+                const std::size_t size = n_workers();
+                for (std::size_t i = 1; !item && i <= size; i ++)
+                {
+                        const std::size_t victim = (worker + i) % size;
+                        if (victim != worker && !m_deques[victim]->empty())
+                        {
+                                item = m_deques[victim]->steal();
+                        }
+                }
+
+                // ... and finally the tasks enqueued for the other workers (if busy)
+                for (std::size_t i = 1; !item && i <= size; i ++)
+                {
+                        const std::size_t victim = (worker + i) % size;
+                        if (victim != worker)
+                        {
+                                item = take(*m_inboxes[victim]);
+                        }
+                }
+
+                if (item)
+                {
+                        m_queued --;
+                }
+
+                return item;
+        }
+
+        void thread_pool_t::run(item_t* item)
+        {
+                item->m_task();
+
+                group_t& group = item->m_group;
+                delete item;
+
+                // announce that the group was completed
+                if (-- group.m_count == 0)
+                {
+                        const lock_t lock(m_mutex);
+
+                        m_finished.notify_all();
+                }
+        }
+
+        std::size_t thread_pool_t::worker() const
+        {
+                return (this_pool == this) ? this_worker : n_workers();
         }
 
         void thread_pool_t::wait()
         {
-                // wait for all tasks to be taken and the workers to finish
-                lock_t lock(m_data.m_mutex);
+                wait(m_group);
+        }
+
+        void thread_pool_t::wait(group_t& group)
+        {
+                const std::size_t worker = this->worker();
+
+                // nested: help running the tasks meanwhile
+                if (worker < n_workers())
+                {
+                        while (group.m_count > 0)
+                        {
+                                item_t* item = take(worker);
+                                if (item)
+                                {
+                                        run(item);
+                                }
+                                else
+                                {
+                                        std::this_thread::yield();
+                                }
+                        }
+                }
 
-                while (!m_data.m_tasks.empty() || m_data.m_running > 0)
+                // wait for all tasks of the group to be finished
+                else
                 {
-                        m_data.m_condition.wait(lock);
+                        lock_t lock(m_mutex);
+
+                        while (group.m_count > 0)
+                        {
+                                m_finished.wait(lock);
+                        }
                 }
         }
 
         std::size_t thread_pool_t::n_workers() const
         {
-                return m_workers.size();
+                // NB: the deques are created before starting the worker threads
+                return m_deques.size();
+        }
+
+        bool thread_pool_t::pin(const std::vector<std::size_t>& cpus)
+        {
+                bool ok = !cpus.empty();
+                for (std::size_t i = 0; i < m_workers.size() && !cpus.empty(); i ++)
+                {
+                        ok = ncv::set_affinity(m_workers[i], cpus[i % cpus.size()]) && ok;
+                }
+
+                m_pinned = ok;
+                return ok;
+        }
+
+        bool thread_pool_t::pinned() const
+        {
+                return m_pinned;
+        }
+
+        std::size_t thread_pool_t::concurrency(std::size_t nthreads) const
+        {
+                return (nthreads == 0) ? n_workers() : std::min(nthreads, n_workers());
         }
 
         std::size_t thread_pool_t::n_tasks() const
         {
-                const lock_t lock(m_data.m_mutex);
-                return m_data.m_tasks.size();
+                return m_queued;
         }
-}
 
+        thread_pool_t& get_thread_pool()
+        {
+                static thread_pool_t pool([] ()
+                {
+                        global_started = true;
+                        return global_size.load();
+                }());
 
+                // optional pinning policy (see affinity_cpus) from the environment
+                static const bool pinned = [] ()
+                {
+                        const char* policy = std::getenv("NANOCV_AFFINITY");
+                        return policy && pool.pin(ncv::affinity_cpus(policy));
+                }();
+                NANOCV_UNUSED1(pinned);
+
+                return pool;
+        }
+
+        bool set_thread_pool_size(std::size_t nthreads)
+        {
+                global_size = nthreads;
+                return !global_started;
+        }
+}
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <deque>
+#include <mutex>
+#include <atomic>
 #include <thread>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "thread.h"
+#include "deque.hpp"
 #include <condition_variable>
 #include "nanocv/noncopyable.hpp"
 
@@ -14,7 +18,11 @@ namespace ncv
         /// \brief asynchronously runs multiple workers/jobs/threads
         /// by enqueing and distribute them on all available threads
         ///
-        /// NB: this is heavily copied/inspired by http://progsch.net/wordpress/?p=81
+        /// NB: each worker has its own lock-free deque: the tasks enqueued by a worker (e.g. nested loops)
+        ///     are pushed & popped locally and the idle workers steal from the others,
+        ///     while the tasks enqueued by other threads are distributed through a shared queue.
+        /// NB: the workers can be pinned to logical CPUs (see affinity_cpus), in which case the tasks
+        ///     enqueued for a given worker (e.g. the i-th chunk of a loop) are run by it unless it is busy.
         ///
         class NANOCV_PUBLIC thread_pool_t : private noncopyable_t
         {
@@ -26,6 +34,37 @@ namespace ncv
                 typedef std::unique_lock<mutex_t>       lock_t;
                 typedef std::condition_variable         condition_t;
 
+                ///
+                /// \brief a group of tasks to wait for (e.g. the chunks of a parallel loop),
+                ///     so that the parallel loops can be nested
+                ///
+                class group_t : private noncopyable_t
+                {
+                public:
+
+                        ///
+                        /// \brief constructor
+                        ///
+                        group_t() : m_count(0)
+                        {
+                        }
+
+                        ///
+                        /// \brief number of unfinished tasks
+                        ///
+                        std::size_t n_tasks() const
+                        {
+                                return m_count.load();
+                        }
+
+                private:
+
+                        friend class thread_pool_t;
+
+                        // attributes
+                        std::atomic<std::size_t>        m_count;        ///< #unfinished tasks
+                };
+
                 ///
                 /// \brief constructor
                 ///
@@ -37,34 +76,70 @@ namespace ncv
                 ~thread_pool_t();
 
                 ///
-                /// \brief movable
+                /// \brief enqueue a new task to execute
                 ///
-                thread_pool_t(thread_pool_t&&) = default;
+                template<class F>
+                void enqueue(F f)
+                {
+                        enqueue(m_group, f);
+                }
 
                 ///
-                /// \brief movable
+                /// \brief enqueue a new task to execute as part of the given group
                 ///
-                thread_pool_t& operator=(thread_pool_t&&) = default;
+                template<class F>
+                void enqueue(group_t& group, F f)
+                {
+                        group.m_count ++;
+                        _enqueue(new item_t(task_t(f), group));
+                }
 
                 ///
-                /// \brief enqueue a new task to execute
+                /// \brief enqueue a new task to execute as part of the given group, preferably by the given worker
                 ///
                 template<class F>
-                void enqueue(F f)
+                void enqueue(group_t& group, std::size_t worker, F f)
                 {
-                        _enqueue(f);
+                        group.m_count ++;
+                        _enqueue(new item_t(task_t(f), group), worker);
                 }
 
+                ///
+                /// \brief pin the workers to the given logical CPUs (in order, round-robin)
+                ///
+                /// NB: returns false if pinning is not supported or failed for some worker.
+                ///
+                bool pin(const std::vector<std::size_t>& cpus);
+
+                ///
+                /// \brief check if the workers are pinned to logical CPUs
+                ///
+                bool pinned() const;
+
                 ///
                 /// \brief wait for all workers to finish running the tasks
                 ///
+                /// NB: use a group to wait from within a task (e.g. nested loops)!
+                ///
                 void wait();
 
+                ///
+                /// \brief wait for the tasks of the given group to finish
+                ///
+                /// NB: if called from a worker thread, it runs the available tasks meanwhile.
+                ///
+                void wait(group_t& group);
+
                 ///
                 /// \brief number of available worker threads
                 ///
                 std::size_t n_workers() const;
 
+                ///
+                /// \brief number of workers to use for the given concurrency limit (0 = all workers)
+                ///
+                std::size_t concurrency(std::size_t nthreads) const;
+
                 ///
                 /// \brief number of tasks to run
                 ///
@@ -73,66 +148,107 @@ namespace ncv
         private:
 
                 ///
-                /// \brief collect the tasks to run
+                /// \brief task to execute and its group
                 ///
-                struct data_t
+                struct item_t
                 {
-                        ///
-                        /// \brief constructor
-                        ///
-                        data_t() :      m_running(0),
-                                        m_stop(false)
+                        item_t(task_t&& task, group_t& group)
+                                :       m_task(std::move(task)),
+                                        m_group(group)
                         {
                         }
 
                         // attributes
-                        std::deque<task_t>      m_tasks;                ///< tasks (functors) to execute
-                        std::size_t             m_running;              ///< #running threads
-                        mutex_t                 m_mutex;                ///< synchronize task access
-                        condition_t             m_condition;            ///< signaling
-                        bool                    m_stop;                 ///< stop requested
+                        task_t                  m_task;
+                        group_t&                m_group;
                 };
 
+                typedef steal_deque_t<item_t>   deque_t;
+
                 ///
-                /// \brief worker unit (to execute tasks)
+                /// \brief tasks enqueued for a given worker
                 ///
-                struct worker_t
+                struct inbox_t
                 {
-                        ///
-                        /// \brief constructor
-                        ///
-                        worker_t(data_t& data) : m_data(data)
+                        inbox_t() : m_size(0)
                         {
                         }
 
-                        ///
-                        /// \brief execute tasks when available
-                        ///
-                        void operator()();
-
                         // attributes
-                        data_t&                 m_data;                 ///< Tasks
+                        mutex_t                         m_mutex;
+                        std::deque<item_t*>             m_items;
+                        std::atomic<std::size_t>        m_size;
                 };
 
+                ///
+                /// \brief execute tasks when available (worker thread)
+                ///
+                void work(std::size_t worker);
+
                 ///
                 /// \brief add a new task to execute (implementation)
                 ///
-                template<class F>
-                void _enqueue(F f)
-                {
-                        {
-                                const lock_t lock(m_data.m_mutex);                                
-                                m_data.m_tasks.push_back(task_t(f));
-                        }
-                        {
-                                m_data.m_condition.notify_one();
-                        }
-                }
+                void _enqueue(item_t* item);
+                void _enqueue(item_t* item, std::size_t worker);
+
+                ///
+                /// \brief wake up a worker (if any is sleeping) to run the new task
+                ///
+                void notify();
+
+                ///
+                /// \brief retrieve a task enqueued for the given worker, returns nullptr if none
+                ///
+                static item_t* take(inbox_t& inbox);
+
+                ///
+                /// \brief retrieve a task to execute: from the worker's own deque & inbox, from the shared queue or
+                ///     by stealing from the other workers (if called from a worker thread), returns nullptr if none
+                ///
+                item_t* take(std::size_t worker);
+
+                ///
+                /// \brief execute the given task and signal its group
+                ///
+                void run(item_t* item);
+
+                ///
+                /// \brief index of the current thread if it is a worker of this pool, otherwise n_workers()
+                ///
+                std::size_t worker() const;
 
         private:
 
                 // attributes
-                std::vector<thread_t>           m_workers;              ///< worker threads
-                mutable data_t                  m_data;                 ///< tasks to execute + synchronization
+                std::vector<thread_t>                   m_workers;      ///< worker threads
+                std::vector<std::unique_ptr<deque_t>>   m_deques;       ///< tasks enqueued by each worker
+                std::vector<std::unique_ptr<inbox_t>>   m_inboxes;      ///< tasks enqueued for each worker
+                std::deque<item_t*>                     m_tasks;        ///< tasks enqueued by other threads
+                mutable mutex_t                         m_tmutex;       ///< synchronize the shared queue
+                std::atomic<std::size_t>                m_ntasks;       ///< #tasks in the shared queue
+
+                std::atomic<std::size_t>                m_queued;       ///< #tasks to run
+                std::atomic<std::size_t>                m_sleeping;     ///< #sleeping workers
+                std::atomic<bool>                       m_stop;         ///< stop requested
+                std::atomic<bool>                       m_pinned;       ///< workers pinned to logical CPUs
+                mutex_t                                 m_mutex;        ///< synchronize signaling
+                condition_t                             m_condition;    ///< signaling new tasks
+                condition_t                             m_finished;     ///< signaling finished groups
+
+                group_t                                 m_group;        ///< default group
         };
+
+        ///
+        /// \brief process-wide thread pool shared by all components
+        ///     (started lazily using all available threads, unless set_thread_pool_size was called before)
+        ///
+        NANOCV_PUBLIC thread_pool_t& get_thread_pool();
+
+        ///
+        /// \brief set the number of worker threads of the process-wide thread pool (0 = all available threads),
+        ///     returns false if the pool is already started
+        ///
+        /// NB: e.g. the data-parallel processes share the cores, so each should start only its part of the threads.
+        ///
+        NANOCV_PUBLIC bool set_thread_pool_size(std::size_t nthreads);
 }
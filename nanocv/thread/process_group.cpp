@@ -0,0 +1,323 @@
+#include "process_group.h"
+#include "nanocv/math/random.hpp"
+#include <random>
+#include <cerrno>
+#include <algorithm>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+namespace ncv
+{
+        process_group_t::process_group_t()
+                :       m_rank(0),
+                        m_size(1),
+                        m_sendfd(-1),
+                        m_recvfd(-1)
+        {
+        }
+
+        process_group_t::~process_group_t()
+        {
+                join();
+
+                if (m_sendfd >= 0)
+                {
+                        ::close(m_sendfd);
+                }
+                if (m_recvfd >= 0)
+                {
+                        ::close(m_recvfd);
+                }
+        }
+
+        bool process_group_t::spawn(std::size_t size)
+        {
+                if (m_size > 1 || size < 1)
+                {
+                        return false;
+                }
+                if (size == 1)
+                {
+                        return true;
+                }
+
+                // the i-th socket pair connects the i-th process to the next one in the ring
+                std::vector<int> fds(2 * size, -1);
+                for (std::size_t i = 0; i < size; i ++)
+                {
+                        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, &fds[2 * i]) != 0)
+                        {
+                                for (int fd : fds)
+                                {
+                                        if (fd >= 0) ::close(fd);
+                                }
+                                return false;
+                        }
+                }
+
+                // the same random sequences in all processes
+                ncv::set_random_seed(std::random_device()());
+
+                std::size_t rank = 0;
+                for (std::size_t r = 1; r < size && rank == 0; r ++)
+                {
+                        const pid_t pid = ::fork();
+                        if (pid < 0)
+                        {
+                                // NB: the processes already started exit when their sockets are closed
+                                for (int fd : fds)
+                                {
+                                        ::close(fd);
+                                }
+                                join();
+                                return false;
+                        }
+                        else if (pid == 0)
+                        {
+                                rank = r;
+                                m_children.clear();
+                        }
+                        else
+                        {
+                                m_children.push_back(pid);
+                        }
+                }
+
+                // keep only the sockets to the neighbours
+                const int sendfd = fds[2 * rank + 0];
+                const int recvfd = fds[2 * ((rank + size - 1) % size) + 1];
+                for (int fd : fds)
+                {
+                        if (fd != sendfd && fd != recvfd)
+                        {
+                                ::close(fd);
+                        }
+                }
+
+                m_rank = rank;
+                m_size = size;
+                m_sendfd = sendfd;
+                m_recvfd = recvfd;
+
+                return true;
+        }
+
+        bool process_group_t::join()
+        {
+                bool ok = true;
+                for (int pid : m_children)
+                {
+                        int status = 0;
+                        ok = ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0 && ok;
+                }
+
+                m_children.clear();
+                return ok;
+        }
+
+        bool process_group_t::sendrecv(const void* sdata, std::size_t ssize, void* rdata, std::size_t rsize)
+        {
+                const char* ps = static_cast<const char*>(sdata);
+                char* pr = static_cast<char*>(rdata);
+
+                while (ssize > 0 || rsize > 0)
+                {
+                        pollfd pfds[2];
+                        nfds_t npfds = 0;
+                        if (ssize > 0)
+                        {
+                                pfds[npfds ++] = { m_sendfd, POLLOUT, 0 };
+                        }
+                        if (rsize > 0)
+                        {
+                                pfds[npfds ++] = { m_recvfd, POLLIN, 0 };
+                        }
+
+                        if (::poll(pfds, npfds, -1) < 0)
+                        {
+                                if (errno == EINTR) continue;
+                                return false;
+                        }
+
+                        for (nfds_t i = 0; i < npfds; i ++)
+                        {
+                                if (pfds[i].revents & (POLLERR | POLLNVAL))
+                                {
+                                        return false;
+                                }
+
+                                if (pfds[i].fd == m_sendfd && (pfds[i].revents & POLLOUT))
+                                {
+                                        const ssize_t n = ::send(m_sendfd, ps, ssize, MSG_NOSIGNAL | MSG_DONTWAIT);
+                                        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                                        {
+                                                return false;
+                                        }
+                                        else if (n > 0)
+                                        {
+                                                ps += n;
+                                                ssize -= static_cast<std::size_t>(n);
+                                        }
+                                }
+
+                                else if (pfds[i].fd == m_recvfd && (pfds[i].revents & (POLLIN | POLLHUP)))
+                                {
+                                        const ssize_t n = ::recv(m_recvfd, pr, rsize, MSG_DONTWAIT);
+                                        if (n == 0)
+                                        {
+                                                // the previous process has exited
+                                                return false;
+                                        }
+                                        else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                                        {
+                                                return false;
+                                        }
+                                        else if (n > 0)
+                                        {
+                                                pr += n;
+                                                rsize -= static_cast<std::size_t>(n);
+                                        }
+                                }
+                        }
+                }
+
+                return true;
+        }
+
+        template
+        <
+                typename tscalar,
+                typename toperator
+        >
+        bool process_group_t::_allreduce(tscalar* data, std::size_t count, const toperator& op)
+        {
+                const std::size_t size = m_size;
+                const std::size_t rank = m_rank;
+                if (size == 1)
+                {
+                        return true;
+                }
+
+                // the buffer is split in <size> chunks: the c-th chunk is [begin(c), begin(c + 1))
+                const auto begin = [=] (std::size_t c) { return (count * c) / size; };
+                const auto chunk = [=] (std::size_t step) { return (rank + size - step % size) % size; };
+
+                std::vector<tscalar> buffer(count / size + 1);
+
+                // reduce-scatter: after <size - 1> steps, each process has the reduction of one chunk ...
+                for (std::size_t s = 0; s + 1 < size; s ++)
+                {
+                        const std::size_t sc = chunk(s), rc = chunk(s + 1);
+                        const std::size_t scount = begin(sc + 1) - begin(sc);
+                        const std::size_t rcount = begin(rc + 1) - begin(rc);
+
+                        if (!sendrecv(data + begin(sc), scount * sizeof(tscalar), buffer.data(), rcount * sizeof(tscalar)))
+                        {
+                                return false;
+                        }
+
+                        tscalar* pr = data + begin(rc);
+                        for (std::size_t i = 0; i < rcount; i ++)
+                        {
+                                pr[i] = op(pr[i], buffer[i]);
+                        }
+                }
+
+                // ... all-gather: which is passed along the ring (NB: copied, so bitwise identical everywhere)
+                for (std::size_t s = 0; s + 1 < size; s ++)
+                {
+                        const std::size_t sc = chunk(s + size - 1), rc = chunk(s);
+                        const std::size_t scount = begin(sc + 1) - begin(sc);
+                        const std::size_t rcount = begin(rc + 1) - begin(rc);
+
+                        if (!sendrecv(data + begin(sc), scount * sizeof(tscalar), data + begin(rc), rcount * sizeof(tscalar)))
+                        {
+                                return false;
+                        }
+                }
+
+                return true;
+        }
+
+        bool process_group_t::allreduce(double* data, std::size_t count)
+        {
+                return _allreduce(data, count, [] (auto a, auto b) { return a + b; });
+        }
+
+        bool process_group_t::allreduce(float* data, std::size_t count)
+        {
+                return _allreduce(data, count, [] (auto a, auto b) { return a + b; });
+        }
+
+        bool process_group_t::allreduce(long double* data, std::size_t count)
+        {
+                return _allreduce(data, count, [] (auto a, auto b) { return a + b; });
+        }
+
+        bool process_group_t::allreduce_max(double* data, std::size_t count)
+        {
+                return _allreduce(data, count, [] (auto a, auto b) { return std::max(a, b); });
+        }
+
+        bool process_group_t::allreduce_max(float* data, std::size_t count)
+        {
+                return _allreduce(data, count, [] (auto a, auto b) { return std::max(a, b); });
+        }
+
+        bool process_group_t::allreduce_max(long double* data, std::size_t count)
+        {
+                return _allreduce(data, count, [] (auto a, auto b) { return std::max(a, b); });
+        }
+
+
+        bool process_group_t::_broadcast(void* data, std::size_t size)
+        {
+                // receive from the previous process (but the root) & forward to the next one (but the last)
+                if (!root() && !sendrecv(nullptr, 0, data, size))
+                {
+                        return false;
+                }
+
+                if (m_rank + 1 < m_size && !sendrecv(data, size, nullptr, 0))
+                {
+                        return false;
+                }
+
+                return true;
+        }
+
+        bool process_group_t::broadcast(double* data, std::size_t count)
+        {
+                return _broadcast(data, count * sizeof(double));
+        }
+
+        bool process_group_t::broadcast(float* data, std::size_t count)
+        {
+                return _broadcast(data, count * sizeof(float));
+        }
+
+        bool process_group_t::broadcast(long double* data, std::size_t count)
+        {
+                return _broadcast(data, count * sizeof(long double));
+        }
+
+        bool process_group_t::broadcast(std::uint64_t* data, std::size_t count)
+        {
+                return _broadcast(data, count * sizeof(std::uint64_t));
+        }
+
+        bool process_group_t::barrier()
+        {
+                double dummy = 0.0;
+                return allreduce(&dummy, 1);
+        }
+
+        process_group_t& get_process_group()
+        {
+                static process_group_t group;
+                return group;
+        }
+}
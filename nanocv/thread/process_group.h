@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "nanocv/arch.h"
+#include "nanocv/noncopyable.hpp"
+
+namespace ncv
+{
+        ///
+        /// \brief group of local processes (e.g. for data-parallel training),
+        ///     connected in a ring with Unix-domain sockets
+        ///
+        /// NB: the collective operations (e.g. allreduce) must be called in the same order by all processes.
+        /// NB: the default (process-wide) group has only the current process, so that the collective operations
+        ///     are no-ops until the worker processes are spawned.
+        ///
+        class NANOCV_PUBLIC process_group_t : private noncopyable_t
+        {
+        public:
+
+                ///
+                /// \brief constructor (single process)
+                ///
+                process_group_t();
+
+                ///
+                /// \brief destructor (the root process waits for the worker processes)
+                ///
+                virtual ~process_group_t();
+
+                ///
+                /// \brief fork <size - 1> worker processes, returns false if failed
+                ///
+                /// NB: it must be called before starting any thread (e.g. the thread pool),
+                ///     as only the calling thread is duplicated by fork.
+                /// NB: the random number generators are seeded identically in all processes,
+                ///     but the processes may still draw different random numbers (e.g. on different code paths),
+                ///     so the initial state should be broadcasted from the root process (e.g. see sync_params).
+                ///
+                bool spawn(std::size_t size);
+
+                ///
+                /// \brief sum the given buffer across processes (ring allreduce: reduce-scatter & all-gather),
+                ///     such that all processes receive bitwise identical results
+                ///
+                bool allreduce(double* data, std::size_t count);
+                bool allreduce(float* data, std::size_t count);
+                bool allreduce(long double* data, std::size_t count);
+
+                ///
+                /// \brief compute the element-wise maximum of the given buffer across processes (ring allreduce)
+                ///
+                bool allreduce_max(double* data, std::size_t count);
+                bool allreduce_max(float* data, std::size_t count);
+                bool allreduce_max(long double* data, std::size_t count);
+
+                ///
+                /// \brief copy the root's buffer to all processes (passed along the ring)
+                ///
+                bool broadcast(double* data, std::size_t count);
+                bool broadcast(float* data, std::size_t count);
+                bool broadcast(long double* data, std::size_t count);
+                bool broadcast(std::uint64_t* data, std::size_t count);
+
+                ///
+                /// \brief wait for all processes to reach this point
+                ///
+                bool barrier();
+
+                ///
+                /// \brief wait for the worker processes to finish (root process),
+                ///     returns false if any of them failed
+                ///
+                bool join();
+
+                ///
+                /// \brief index of the current process (0 = root)
+                ///
+                std::size_t rank() const { return m_rank; }
+
+                ///
+                /// \brief number of processes
+                ///
+                std::size_t size() const { return m_size; }
+
+                ///
+                /// \brief check if the current process is the root process
+                ///
+                bool root() const { return m_rank == 0; }
+
+        private:
+
+                template
+                <
+                        typename tscalar,
+                        typename toperator
+                >
+                bool _allreduce(tscalar* data, std::size_t count, const toperator& op);
+
+                bool _broadcast(void* data, std::size_t size);
+
+                ///
+                /// \brief send & receive concurrently (to avoid deadlocks when all processes send at once)
+                ///
+                bool sendrecv(const void* sdata, std::size_t ssize, void* rdata, std::size_t rsize);
+
+        private:
+
+                // attributes
+                std::size_t             m_rank;         ///< index of the current process
+                std::size_t             m_size;         ///< number of processes
+                int                     m_sendfd;       ///< socket to the next process in the ring
+                int                     m_recvfd;       ///< socket from the previous process in the ring
+                std::vector<int>        m_children;     ///< worker processes (root process)
+        };
+
+        ///
+        /// \brief the process-wide group
+        ///
+        NANOCV_PUBLIC process_group_t& get_process_group();
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "pool.h"
+#include "nanocv/text/enum_string.hpp"
+#include <algorithm>
+#include <atomic>
+
+namespace ncv
+{
+        ///
+        /// \brief how to split a loop computation between the tasks of a thread pool
+        ///
+        enum class thread_schedule : int
+        {
+                fixed = 0,              ///< one contiguous chunk of equal size per task (lowest overhead)
+                dynamic,                ///< chunks of a fixed size claimed on demand by the tasks (atomic counter)
+                guided                  ///< chunks of decreasing size (with the remaining work) claimed on demand
+        };
+
+        // string cast for enumerations
+        namespace text
+        {
+                template <>
+                inline std::map<thread_schedule, std::string> enum_string<thread_schedule>()
+                {
+                        return
+                        {
+                                { thread_schedule::fixed,       "fixed" },
+                                { thread_schedule::dynamic,     "dynamic" },
+                                { thread_schedule::guided,      "guided" }
+                        };
+                }
+        }
+
+        ///
+        /// \brief split a loop computation of the given size in contiguous chunks using a thread pool
+        ///     with at most the given number of concurrent tasks (0 = all workers)
+        ///     and the given scheduling (the chunk size is a hint: 0 = automatic, otherwise
+        ///     the size of the chunks for the dynamic schedule and the minimum size for the guided schedule)
+        /// NB: the operator receives the range of samples to process and the assigned task index: op(begin, end, t)
+        /// NB: the operator may be called multiple times by the same task for the dynamic & guided schedules.
+        ///
+        template
+        <
+                typename tsize,
+                class toperator
+        >
+        void thread_loops(tsize N, thread_pool_t& pool, tsize nthreads, thread_schedule schedule, tsize chunk,
+                toperator op)
+        {
+                const tsize n_tasks = static_cast<tsize>(pool.concurrency(nthreads));
+
+                thread_pool_t::group_t group;
+
+                // NB: the next chunk to claim (dynamic & guided schedules), alive until all tasks are done
+                std::atomic<tsize> next(0);
+
+                // NB: the i-th task is run by the i-th worker if pinned (e.g. to reuse the per-task buffers
+                //      allocated on the worker's NUMA node), otherwise by the first available worker
+                const auto enqueue = [&] (tsize t, const auto& f)
+                {
+                        if (pool.pinned())
+                        {
+                                pool.enqueue(group, static_cast<std::size_t>(t), f);
+                        }
+                        else
+                        {
+                                pool.enqueue(group, f);
+                        }
+                };
+
+                switch (schedule)
+                {
+                case thread_schedule::dynamic:
+                case thread_schedule::guided:
+                        {
+                                // NB: ~8 chunks per task by default to balance the load with a small overhead
+                                const tsize dchunk = (chunk > 0) ? chunk : std::max(tsize(1), N / (8 * n_tasks));
+                                const tsize gchunk = (chunk > 0) ? chunk : tsize(1);
+
+                                for (tsize t = 0; t < n_tasks; t ++)
+                                {
+                                        enqueue(t, [=,&next,&op]()
+                                        {
+                                                while (true)
+                                                {
+                                                        tsize begin, end;
+                                                        if (schedule == thread_schedule::dynamic)
+                                                        {
+                                                                begin = next.fetch_add(dchunk);
+                                                                if (begin >= N)
+                                                                {
+                                                                        break;
+                                                                }
+                                                                end = std::min(begin + dchunk, N);
+                                                        }
+                                                        else
+                                                        {
+                                                                begin = next.load();
+                                                                do
+                                                                {
+                                                                        const tsize size = std::max(gchunk, (N - std::min(begin, N)) / (2 * n_tasks));
+                                                                        end = std::min(begin + size, N);
+                                                                }
+                                                                while (begin < N && !next.compare_exchange_weak(begin, end));
+
+                                                                if (begin >= N)
+                                                                {
+                                                                        break;
+                                                                }
+                                                        }
+
+                                                        op(begin, end, t);
+                                                }
+                                        });
+                                }
+                        }
+                        break;
+
+                case thread_schedule::fixed:
+                default:
+                        {
+                                const tsize task_size = (N + n_tasks - 1) / n_tasks;
+
+                                for (tsize t = 0; t < n_tasks; t ++)
+                                {
+                                        enqueue(t, [=,&op]()
+                                        {
+                                                const tsize begin = std::min(t * task_size, N);
+                                                const tsize end = std::min(begin + task_size, N);
+                                                if (begin < end)
+                                                {
+                                                        op(begin, end, t);
+                                                }
+                                        });
+                                }
+                        }
+                        break;
+                }
+
+                pool.wait(group);
+        }
+}
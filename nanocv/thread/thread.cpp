@@ -1,8 +1,81 @@
 #include "thread.h"
+#include "nanocv/text/algorithms.h"
+#include <set>
+#include <tuple>
 #include <thread>
+#include <fstream>
+#include <algorithm>
+#ifdef __linux__
+        #include <pthread.h>
+        #include <sched.h>
+#endif
 
 namespace ncv
 {
+        namespace
+        {
+                // upper bound of the logical CPU indices (NB: as supported by the affinity masks)
+#ifdef __linux__
+                const std::size_t max_cpus = CPU_SETSIZE;
+#else
+                const std::size_t max_cpus = 1024;
+#endif
+
+                // parse an index (NB: the over-long numbers are rejected, as they cannot be CPU indices)
+                bool parse_index(const std::string& str, std::size_t& index)
+                {
+                        if (str.empty() || str.size() > 9 || str.find_first_not_of("0123456789") != std::string::npos)
+                        {
+                                return false;
+                        }
+
+                        index = std::stoul(str);
+                        return true;
+                }
+
+                // parse a list of (ranges of) indices (e.g. "0,2,4-7" as used by Linux' sysfs),
+                //      keeping only the indices up to the given maximum
+                std::vector<std::size_t> parse_list(const std::string& list, std::size_t max_index)
+                {
+                        std::vector<std::size_t> indices;
+                        for (const std::string& token : text::split(list, ", \n"))
+                        {
+                                const std::vector<std::string> range = text::split(token, "-");
+
+                                std::size_t first, last;
+                                if (token.empty() || range.empty() || range.size() > 2 ||
+                                    !parse_index(range[0], first) ||
+                                    !parse_index(range[range.size() - 1], last))
+                                {
+                                        continue;
+                                }
+
+                                for (std::size_t i = first; i <= std::min(last, max_index); i ++)
+                                {
+                                        indices.push_back(i);
+                                }
+                        }
+
+                        return indices;
+                }
+
+                // read the first line of a (sysfs) file
+                bool read_line(const std::string& path, std::string& line)
+                {
+                        std::ifstream in(path);
+                        return std::getline(in, line) ? true : false;
+                }
+
+                // read an index from a (sysfs) file
+                std::size_t read_index(const std::string& path, std::size_t fallback)
+                {
+                        std::string line;
+                        return  (read_line(path, line) && !line.empty() &&
+                                line.find_first_not_of("0123456789") == std::string::npos) ?
+                                std::stoul(line) : fallback;
+                }
+        }
+
         std::size_t n_threads()
         {
                 return static_cast<std::size_t>(std::thread::hardware_concurrency());
@@ -12,4 +85,194 @@ namespace ncv
         {
                 return n_threads() * 8;
         }
+
+        std::string cpu_model()
+        {
+                std::ifstream in("/proc/cpuinfo");
+
+                std::string line;
+                while (std::getline(in, line))
+                {
+                        const std::string::size_type pos = line.find_first_not_of(" \t", line.find(':') + 1);
+                        if (line.compare(0, 10, "model name") == 0 && line.find(':') != std::string::npos &&
+                            pos != std::string::npos)
+                        {
+                                return line.substr(pos);
+                        }
+                }
+
+                return "unknown";
+        }
+
+        cpus_t cpu_topology()
+        {
+                const std::string sysfs = "/sys/devices/system/";
+
+                std::string line;
+                std::vector<std::size_t> indices;
+                if (read_line(sysfs + "cpu/online", line))
+                {
+                        indices = parse_list(line, max_cpus - 1);
+                }
+                if (indices.empty())
+                {
+                        for (std::size_t i = 0; i < std::max(std::size_t(1), n_threads()); i ++)
+                        {
+                                indices.push_back(i);
+                        }
+                }
+
+                cpus_t cpus;
+                for (std::size_t i : indices)
+                {
+                        const std::string path = sysfs + "cpu/cpu" + std::to_string(i) + "/topology/";
+
+                        cpu_t cpu;
+                        cpu.m_cpu = i;
+                        cpu.m_core = read_index(path + "core_id", i);
+                        cpu.m_package = read_index(path + "physical_package_id", 0);
+                        cpu.m_node = 0;
+                        cpus.push_back(cpu);
+                }
+
+                // NUMA nodes
+                if (read_line(sysfs + "node/online", line))
+                {
+                        for (std::size_t node : parse_list(line, max_cpus - 1))
+                        {
+                                std::string cpulist;
+                                if (read_line(sysfs + "node/node" + std::to_string(node) + "/cpulist", cpulist))
+                                {
+                                        for (std::size_t i : parse_list(cpulist, max_cpus - 1))
+                                        {
+                                                for (cpu_t& cpu : cpus)
+                                                {
+                                                        if (cpu.m_cpu == i)
+                                                        {
+                                                                cpu.m_node = node;
+                                                        }
+                                                }
+                                        }
+                                }
+                        }
+                }
+
+                return cpus;
+        }
+
+        std::vector<std::size_t> affinity_cpus(const std::string& policy)
+        {
+                std::vector<std::size_t> indices;
+
+                if (policy.empty() || text::iequals(policy, "none"))
+                {
+                        return indices;
+                }
+
+                cpus_t cpus = cpu_topology();
+
+                // compact: the hyper-threads of a core, then the cores of a node, then the next node
+                if (text::iequals(policy, "compact"))
+                {
+                        std::sort(cpus.begin(), cpus.end(), [] (const cpu_t& c1, const cpu_t& c2)
+                        {
+                                return  std::make_tuple(c1.m_node, c1.m_package, c1.m_core, c1.m_cpu) <
+                                        std::make_tuple(c2.m_node, c2.m_package, c2.m_core, c2.m_cpu);
+                        });
+
+                        for (const cpu_t& cpu : cpus)
+                        {
+                                indices.push_back(cpu.m_cpu);
+                        }
+                }
+
+                // scatter: round-robin over the NUMA nodes, using the physical cores before their hyper-threads
+                else if (text::iequals(policy, "scatter"))
+                {
+                        // rank of each logical CPU within its physical core
+                        std::vector<std::size_t> ranks(cpus.size(), 0);
+                        for (std::size_t i = 0; i < cpus.size(); i ++)
+                        {
+                                for (std::size_t j = 0; j < i; j ++)
+                                {
+                                        if (    cpus[j].m_node == cpus[i].m_node &&
+                                                cpus[j].m_package == cpus[i].m_package &&
+                                                cpus[j].m_core == cpus[i].m_core)
+                                        {
+                                                ranks[i] ++;
+                                        }
+                                }
+                        }
+
+                        // position of each logical CPU within its NUMA node (in the order to use them)
+                        std::vector<std::size_t> order(cpus.size());
+                        for (std::size_t i = 0; i < cpus.size(); i ++)
+                        {
+                                order[i] = i;
+                        }
+
+                        std::sort(order.begin(), order.end(), [&] (std::size_t i1, std::size_t i2)
+                        {
+                                return  std::make_tuple(cpus[i1].m_node, ranks[i1], cpus[i1].m_package, cpus[i1].m_core) <
+                                        std::make_tuple(cpus[i2].m_node, ranks[i2], cpus[i2].m_package, cpus[i2].m_core);
+                        });
+
+                        std::vector<std::size_t> positions(cpus.size(), 0);
+                        for (std::size_t k = 1; k < order.size(); k ++)
+                        {
+                                const std::size_t i = order[k], p = order[k - 1];
+                                positions[i] = (cpus[i].m_node == cpus[p].m_node) ? positions[p] + 1 : 0;
+                        }
+
+                        std::sort(order.begin(), order.end(), [&] (std::size_t i1, std::size_t i2)
+                        {
+                                return  std::make_pair(positions[i1], cpus[i1].m_node) <
+                                        std::make_pair(positions[i2], cpus[i2].m_node);
+                        });
+
+                        for (std::size_t i : order)
+                        {
+                                indices.push_back(cpus[i].m_cpu);
+                        }
+                }
+
+                // explicit list of logical CPUs
+                else
+                {
+                        std::set<std::size_t> online;
+                        for (const cpu_t& cpu : cpus)
+                        {
+                                online.insert(cpu.m_cpu);
+                        }
+
+                        for (std::size_t i : parse_list(policy, *online.rbegin()))
+                        {
+                                if (online.find(i) != online.end())
+                                {
+                                        indices.push_back(i);
+                                }
+                        }
+                }
+
+                return indices;
+        }
+
+        bool set_affinity(std::thread& thread, std::size_t cpu)
+        {
+#ifdef __linux__
+                if (cpu >= CPU_SETSIZE)
+                {
+                        return false;
+                }
+
+                cpu_set_t cpuset;
+                CPU_ZERO(&cpuset);
+                CPU_SET(cpu, &cpuset);
+
+                return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+#else
+                NANOCV_UNUSED2(thread, cpu);
+                return false;
+#endif
+        }
 }
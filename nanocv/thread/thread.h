@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <thread>
+#include <vector>
 #include <utility>
 #include "nanocv/arch.h"
 
@@ -14,4 +17,45 @@ namespace ncv
         /// \brief maximum number of supported threads
         ///
         NANOCV_PUBLIC std::size_t max_n_threads();
+
+        ///
+        /// \brief the CPU model name (e.g. to key hardware-specific tuning results)
+        ///
+        NANOCV_PUBLIC std::string cpu_model();
+
+        ///
+        /// \brief logical CPU and its location: physical core, package (socket) and NUMA node
+        ///
+        struct cpu_t
+        {
+                std::size_t     m_cpu;          ///< logical CPU (as used by the OS)
+                std::size_t     m_core;         ///< physical core (unique within the package)
+                std::size_t     m_package;      ///< package (socket)
+                std::size_t     m_node;         ///< NUMA node
+        };
+
+        typedef std::vector<cpu_t>      cpus_t;
+
+        ///
+        /// \brief the online logical CPUs (sorted by index)
+        ///
+        /// NB: if the topology cannot be detected (e.g. not Linux), then
+        ///     each logical CPU is assumed to be a separate core on the same package & NUMA node.
+        ///
+        NANOCV_PUBLIC cpus_t cpu_topology();
+
+        ///
+        /// \brief the logical CPUs to pin the worker threads to (in order) for the given placement policy:
+        ///     "compact" (fill the cores & the NUMA nodes one at a time),
+        ///     "scatter" (spread over the NUMA nodes & the physical cores first) or
+        ///     an explicit list of logical CPUs (e.g. "0,2,4-7").
+        ///
+        /// NB: an empty list (e.g. "none" or an empty policy) means no pinning.
+        ///
+        NANOCV_PUBLIC std::vector<std::size_t> affinity_cpus(const std::string& policy);
+
+        ///
+        /// \brief pin the given thread to a logical CPU (returns false if not supported or not possible)
+        ///
+        NANOCV_PUBLIC bool set_affinity(std::thread& thread, std::size_t cpu);
 }
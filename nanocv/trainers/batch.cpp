@@ -31,7 +31,7 @@ namespace ncv
                                 const scalar_t terror_var = data.m_gacc.var_error();
 
                                 // validation samples: loss value
-                                data.m_lacc.set_params(state.x);
+                                data.m_lacc.set_params(state.x.cast<scalar_t>());
                                 data.m_lacc.update(data.m_task, data.m_vsampler.get(), data.m_loss);
                                 const scalar_t vvalue = data.m_lacc.value();
                                 const scalar_t verror_avg = data.m_lacc.avg_error();
@@ -39,7 +39,7 @@ namespace ncv
 
                                 // update the optimum state
                                 const auto ret = result.update(
-                                        state.x, tvalue, terror_avg, terror_var, vvalue, verror_avg, verror_var,
+                                        state.x.cast<scalar_t>(), tvalue, terror_avg, terror_var, vvalue, verror_avg, verror_var,
                                         ++ iteration, scalars_t({ data.lambda() }));
 
                                 if (verbose)
@@ -59,7 +59,7 @@ namespace ncv
 
                         // assembly optimization problem & optimize the model
                         return ncv::minimize(fn_size, fn_fval, fn_grad, fn_wlog, fn_elog, fn_ulog,
-                                             data.m_x0, optimizer, iterations, epsilon);
+                                             data.m_x0.cast<opt_scalar_t>(), optimizer, iterations, epsilon);
                 }
         }
         
@@ -2,6 +2,7 @@
 #include "nanocv/model.h"
 #include "nanocv/logger.h"
 #include "nanocv/sampler.h"
+#include "trainer_sync.h"
 #include "nanocv/math/numeric.hpp"
 #include "batch.h"
 
@@ -26,6 +27,13 @@ namespace ncv
                 model.resize(task, true);
                 model.random_params();
 
+                // NB: the data-parallel processes start from the root's parameters
+                if (!ncv::sync_params(model))
+                {
+                        log_error() << "batch trainer: failed to synchronize the processes!";
+                        return trainer_result_t();
+                }
+
                 // prune training & validation data
                 sampler_t tsampler(task);
                 tsampler.setup(fold).setup(sampler_t::atype::annotated);
@@ -33,6 +41,12 @@ namespace ncv
                 sampler_t vsampler(task);
                 tsampler.split(80, vsampler);
 
+                if (!ncv::check_samples(tsampler, vsampler))
+                {
+                        log_error() << "batch trainer: the processes use different training samples!";
+                        return trainer_result_t();
+                }
+
                 if (tsampler.empty() || vsampler.empty())
                 {
                         log_error() << "batch trainer: no annotated training samples!";
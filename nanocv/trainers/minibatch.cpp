@@ -6,7 +6,10 @@
 #include "nanocv/accumulator.h"
 #include "nanocv/log_search.hpp"
 #include "nanocv/thread/thread.h"
+#include "nanocv/thread/process_group.h"
+#include "trainer_evaluator.h"
 #include <tuple>
+#include <memory>
 
 namespace ncv
 {
@@ -49,7 +52,7 @@ namespace ncv
                 }
 
                 trainer_result_t train(
-                        trainer_data_t& data,
+                        trainer_data_t& data, accumulator_t* eacc, bool async,
                         optim::batch_optimizer optimizer,
                         size_t epochs, size_t batch, size_t iterations, scalar_t epsilon,
                         bool verbose)
@@ -70,6 +73,27 @@ namespace ncv
                         auto fn_elog = verbose ? ncv::make_opelog() : nullptr;
                         auto fn_ulog = nullptr;
 
+                        const scalar_t lambda = data.lambda();
+
+                        // evaluate the training & the validation samples after each epoch
+                        auto fn_elog_state = [&] (const vector_t& x, size_t epoch,
+                                                  const trainer_state_t& state, trainer_result_return_t ret)
+                        {
+                                if (verbose)
+                                log_info()
+                                        << "[train = " << state.m_tvalue << "/" << state.m_terror_avg
+                                        << ", valid = " << state.m_vvalue << "/" << state.m_verror_avg
+                                        << " (" << text::to_string(ret) << ")"
+                                        << ", xnorm = " << x.lpNorm<Eigen::Infinity>()
+                                        << ", epoch = " << epoch << "/" << epochs
+                                        << ", batch = " << batch
+                                        << ", iters = " << iterations
+                                        << ", lambda = " << lambda
+                                        << "] done in " << timer.elapsed() << ".";
+                        };
+
+                        trainer_evaluator_t evaluator(data, async ? *eacc : data.m_lacc, result, async, fn_elog_state);
+
                         // optimize the model
                         vector_t x = data.m_x0;
 
@@ -79,56 +103,33 @@ namespace ncv
                                 {
                                         const opt_state_t state = ncv::minimize(
                                                 fn_size, fn_fval, fn_grad, fn_wlog, fn_elog, fn_ulog,
-                                                x, optimizer, iterations, epsilon, history_size);
+                                                x.cast<opt_scalar_t>(), optimizer, iterations, epsilon, history_size);
 
-                                        x = state.x;
+                                        x = state.x.cast<scalar_t>();
                                 });
 
-                                // training samples: loss value
-                                data.m_lacc.set_params(x);
-                                data.m_lacc.update(data.m_task, data.m_tsampler.all(), data.m_loss);
-                                const scalar_t tvalue = data.m_lacc.value();
-                                const scalar_t terror_avg = data.m_lacc.avg_error();
-                                const scalar_t terror_var = data.m_lacc.var_error();
-
-                                // validation samples: loss value
-                                data.m_lacc.set_params(x);
-                                data.m_lacc.update(data.m_task, data.m_vsampler.get(), data.m_loss);
-                                const scalar_t vvalue = data.m_lacc.value();
-                                const scalar_t verror_avg = data.m_lacc.avg_error();
-                                const scalar_t verror_var = data.m_lacc.var_error();
-
-                                // update the optimum state
-                                const auto ret = result.update(
-                                        x, tvalue, terror_avg, terror_var, vvalue, verror_avg, verror_var,
-                                        epoch, scalars_t({ static_cast<scalar_t>(batch),
-                                                           static_cast<scalar_t>(iterations),
-                                                           data.lambda() }));
+                                // update the optimum state (NB: the evaluation may run while the next epoch proceeds)
+                                const bool ret = evaluator.update(
+                                        x, epoch, scalars_t({ static_cast<scalar_t>(batch),
+                                                              static_cast<scalar_t>(iterations),
+                                                              lambda }));
 
-                                if (verbose)
-                                log_info()
-                                        << "[train = " << tvalue << "/" << terror_avg
-                                        << ", valid = " << vvalue << "/" << verror_avg
-                                        << " (" << text::to_string(ret) << ")"
-                                        << ", xnorm = " << x.lpNorm<Eigen::Infinity>()
-                                        << ", epoch = " << epoch << "/" << epochs
-                                        << ", batch = " << batch
-                                        << ", iters = " << iterations
-                                        << ", lambda = " << data.lambda()
-                                        << "] done in " << timer.elapsed() << ".";
-
-                                if (ret == trainer_result_return_t::overfitting)
+                                if (!ret)
                                 {
                                         break;
                                 }
                         }
 
+                        // NB: the last evaluation may still be running
+                        evaluator.wait();
+
                         return result;
                 }
 
                 // <result, batch size, iterations per batch>
                 std::tuple<trainer_result_t, size_t, size_t> tune_minibatch(
-                        trainer_data_t& data, optim::batch_optimizer optimizer, scalar_t epsilon,
+                        trainer_data_t& data, accumulator_t* eacc, bool async,
+                        optim::batch_optimizer optimizer, scalar_t epsilon,
                         bool verbose)
                 {
                         const size_t min_batch = 16 * ncv::n_threads();
@@ -149,7 +150,7 @@ namespace ncv
 
                                         const size_t epochs = 1;
                                         const trainer_result_t result =
-                                                train(data, optimizer, epochs, batch, iterations, epsilon, false);
+                                                train(data, eacc, async, optimizer, epochs, batch, iterations, epsilon, false);
 
                                         const trainer_state_t state = result.optimum_state();
 
@@ -180,15 +181,22 @@ namespace ncv
                 const model_t& model,
                 const task_t& task, const sampler_t& tsampler, const sampler_t& vsampler, size_t nthreads,
                 const loss_t& loss, const string_t& criterion,
-                optim::batch_optimizer optimizer, size_t epochs, scalar_t epsilon, bool verbose)
+                optim::batch_optimizer optimizer, size_t epochs, scalar_t epsilon, bool async, bool verbose)
         {
                 vector_t x0;
                 model.save_params(x0);
 
+                // NB: the data-parallel processes must sum their statistics in the same order
+                async = async && ncv::get_process_group().size() == 1;
+
                 // setup acumulators
                 accumulator_t lacc(model, nthreads, criterion, criterion_t::type::value);
                 accumulator_t gacc(model, nthreads, criterion, criterion_t::type::vgrad);
 
+                // NB: a separate accumulator is needed only if evaluating asynchronously
+                const std::unique_ptr<accumulator_t> eacc = async ?
+                        std::make_unique<accumulator_t>(model, nthreads, criterion, criterion_t::type::value) : nullptr;
+
                 trainer_data_t data(task, tsampler, vsampler, loss, x0, lacc, gacc);
 
                 // tune the regularization factor (if needed)
@@ -196,12 +204,12 @@ namespace ncv
                 {
                         data.set_lambda(lambda);
 
-                        const auto ret = tune_minibatch(data, optimizer, epsilon, verbose);
+                        const auto ret = tune_minibatch(data, eacc.get(), async, optimizer, epsilon, verbose);
 
                         const size_t opt_batch = std::get<1>(ret);
                         const size_t opt_iterations = std::get<2>(ret);
 
-                        return train(data, optimizer, epochs, opt_batch, opt_iterations, epsilon, verbose);
+                        return train(data, eacc.get(), async, optimizer, epochs, opt_batch, opt_iterations, epsilon, verbose);
                 };
 
                 if (data.m_lacc.can_regularize())
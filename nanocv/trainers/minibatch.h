@@ -9,9 +9,11 @@ namespace ncv
 
         ///
         /// \brief minibatch train the given model
+        ///     (optionally evaluating each epoch asynchronously, while the next epoch proceeds)
         ///
         NANOCV_PUBLIC trainer_result_t minibatch_train(
                 const model_t&, const task_t&, const sampler_t& tsampler, const sampler_t& vsampler, size_t nthreads,
                 const loss_t&, const string_t& criterion,
-                optim::batch_optimizer optimizer, size_t epochs, scalar_t epsilon, bool verbose = true);
+                optim::batch_optimizer optimizer, size_t epochs, scalar_t epsilon, bool async = false,
+                bool verbose = true);
 }
@@ -3,6 +3,8 @@
 #include "nanocv/model.h"
 #include "nanocv/logger.h"
 #include "nanocv/sampler.h"
+#include "trainer_sync.h"
+#include "trainer_evaluator.h"
 #include "nanocv/math/numeric.hpp"
 
 namespace ncv
@@ -26,6 +28,13 @@ namespace ncv
                 model.resize(task, true);
                 model.random_params();
 
+                // NB: the data-parallel processes start from the root's parameters
+                if (!ncv::sync_params(model))
+                {
+                        log_error() << "minibatch trainer: failed to synchronize the processes!";
+                        return trainer_result_t();
+                }
+
                 // prune training & validation data
                 sampler_t tsampler(task);
                 tsampler.setup(fold).setup(sampler_t::atype::annotated);
@@ -33,6 +42,12 @@ namespace ncv
                 sampler_t vsampler(task);
                 tsampler.split(80, vsampler);
 
+                if (!ncv::check_samples(tsampler, vsampler))
+                {
+                        log_error() << "minibatch trainer: the processes use different training samples!";
+                        return trainer_result_t();
+                }
+
                 if (tsampler.empty() || vsampler.empty())
                 {
                         log_error() << "minibatch trainer: no annotated training samples!";
@@ -42,6 +57,9 @@ namespace ncv
                 // parameters
                 const size_t epochs = math::clamp(text::from_params<size_t>(configuration(), "epoch", 16), 1, 1024);
                 const scalar_t epsilon = math::clamp(text::from_params<scalar_t>(configuration(), "eps", 1e-4), 1e-8, 1e-3);
+                const eval_mode evaluation = text::from_string<eval_mode>
+                        (text::from_params<string_t>(configuration(), "eval", "sync"));
+                const bool async = evaluation == eval_mode::async;
 
                 const optim::batch_optimizer optimizer = text::from_string<optim::batch_optimizer>
                         (text::from_params<string_t>(configuration(), "opt", "gd"));
@@ -49,7 +67,7 @@ namespace ncv
                 // train the model
                 const trainer_result_t result = ncv::minibatch_train(
                         model, task, tsampler, vsampler, nthreads,
-                        loss, criterion, optimizer, epochs, epsilon);
+                        loss, criterion, optimizer, epochs, epsilon, async);
 
                 const trainer_state_t state = result.optimum_state();
 
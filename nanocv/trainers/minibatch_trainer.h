@@ -11,13 +11,15 @@ namespace ncv
         ///     opt=gd[,lbfgs,cgd]              - optimization method
         ///     epoch=16[1,1024]                - #epochs (~ #samples)
         ///     eps=1e-4[1e-8,1e-3]             - convergence
+        ///     eval=sync[,async]               - evaluate each epoch while the next one proceeds (async),
+        ///                                       such that early stopping is applied one epoch late
         ///
         class minibatch_trainer_t : public trainer_t
         {
         public:
 
                 NANOCV_MAKE_CLONABLE(minibatch_trainer_t,
-                                     "parameters: opt=gd[,lbfgs,cgd],epoch=16[1,1024],eps=1e-4[1e-8,1e-3]")
+                                     "parameters: opt=gd[,lbfgs,cgd],epoch=16[1,1024],eps=1e-4[1e-8,1e-3],eval=sync[,async]")
 
                 // constructor
                 minibatch_trainer_t(const string_t& parameters = string_t());
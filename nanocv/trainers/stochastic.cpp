@@ -5,15 +5,52 @@
 #include "nanocv/minimize.h"
 #include "nanocv/accumulator.h"
 #include "nanocv/log_search.hpp"
+#include "nanocv/math/random.hpp"
+#include "nanocv/math/numeric.hpp"
+#include "nanocv/thread/loopi.hpp"
 #include "nanocv/thread/thread.h"
+#include "nanocv/thread/process_group.h"
+#include "trainer_evaluator.h"
 #include <tuple>
+#include <memory>
 
 namespace ncv
 {
         namespace
         {
+                ///
+                /// \brief buffers to train a model (e.g. one per tuning candidate trained concurrently)
+                ///
+                struct context_t : private noncopyable_t
+                {
+                        context_t(const model_t& model, const task_t& task,
+                                  const sampler_t& tsampler, const sampler_t& vsampler, const loss_t& loss,
+                                  const vector_t& x0, size_t nthreads, const string_t& criterion, bool async)
+                                :       m_lacc(model, nthreads, criterion, criterion_t::type::value),
+                                        m_gacc(model, nthreads, criterion, criterion_t::type::vgrad),
+                                        m_eacc(async ? std::make_unique<accumulator_t>(
+                                                model, nthreads, criterion, criterion_t::type::value) : nullptr),
+                                        m_data(task, tsampler, vsampler, loss, x0, m_lacc, m_gacc)
+                        {
+                        }
+
+                        ///
+                        /// \brief accumulator to evaluate the model after each epoch
+                        ///     (NB: a separate one only if evaluating asynchronously)
+                        ///
+                        accumulator_t& eacc() { return m_eacc ? *m_eacc : m_lacc; }
+
+                        accumulator_t                   m_lacc;         ///< cumulated loss value
+                        accumulator_t                   m_gacc;         ///< cumulated loss gradient
+                        std::unique_ptr<accumulator_t>  m_eacc;         ///< cumulated loss value (asynchronous evaluation)
+                        trainer_data_t                  m_data;
+                };
+
+                typedef std::unique_ptr<context_t>      rcontext_t;
+                typedef std::vector<rcontext_t>         rcontexts_t;
+
                 trainer_result_t train(
-                        trainer_data_t& data,
+                        trainer_data_t& data, accumulator_t& eacc, bool async,
                         optim::stoch_optimizer optimizer, size_t epochs, size_t batch, scalar_t alpha0, scalar_t decay,
                         bool verbose)
                 {
@@ -33,58 +70,53 @@ namespace ncv
 
                         auto fn_wlog = verbose ? ncv::make_opwlog() : nullptr;
                         auto fn_elog = verbose ? ncv::make_opelog() : nullptr;
-                        auto fn_ulog = [&] (const opt_state_t& state)
-                        {
-                                // evaluate training samples
-                                data.m_lacc.set_params(state.x);
-                                data.m_lacc.update(data.m_task, data.m_tsampler.all(), data.m_loss);
-                                const scalar_t tvalue = data.m_lacc.value();
-                                const scalar_t terror_avg = data.m_lacc.avg_error();
-                                const scalar_t terror_var = data.m_lacc.var_error();
-
-                                // evaluate validation samples
-                                data.m_lacc.set_params(state.x);
-                                data.m_lacc.update(data.m_task, data.m_vsampler.all(), data.m_loss);
-                                const scalar_t vvalue = data.m_lacc.value();
-                                const scalar_t verror_avg = data.m_lacc.avg_error();
-                                const scalar_t verror_var = data.m_lacc.var_error();
-
-                                epoch ++;
-
-                                // OK, update the optimum solution
-                                const auto ret = result.update(
-                                        state.x, tvalue, terror_avg, terror_var, vvalue, verror_avg, verror_var,
-                                        epoch, scalars_t({ static_cast<scalar_t>(batch),
-                                                           alpha0,
-                                                           decay,
-                                                           data.lambda() }));
+                        const scalar_t lambda = data.lambda();
 
+                        // evaluate the training & the validation samples after each epoch
+                        auto fn_elog_state = [&] (const vector_t& x, size_t xepoch,
+                                                  const trainer_state_t& state, trainer_result_return_t ret)
+                        {
                                 if (verbose)
                                 log_info()
-                                        << "[train = " << tvalue << "/" << terror_avg
-                                        << ", valid = " << vvalue << "/" << verror_avg
+                                        << "[train = " << state.m_tvalue << "/" << state.m_terror_avg
+                                        << ", valid = " << state.m_vvalue << "/" << state.m_verror_avg
                                         << " (" << text::to_string(ret) << ")"
-                                        << ", xnorm = " << state.x.lpNorm<Eigen::Infinity>()
-                                        << ", epoch = " << epoch << "/" << epochs
+                                        << ", xnorm = " << x.lpNorm<Eigen::Infinity>()
+                                        << ", epoch = " << xepoch << "/" << epochs
                                         << ", batch = " << batch
                                         << ", alpha = " << alpha0
                                         << ", decay = " << decay
-                                        << ", lambda = " << data.lambda()
+                                        << ", lambda = " << lambda
                                         << "] done in " << timer.elapsed() << ".";
+                        };
 
-                                return ret != trainer_result_return_t::overfitting;
+                        trainer_evaluator_t evaluator(data, eacc, result, async, fn_elog_state);
+
+                        auto fn_ulog = [&] (const opt_state_t& state)
+                        {
+                                epoch ++;
+
+                                return evaluator.update(
+                                        state.x.cast<scalar_t>(),
+                                        epoch, scalars_t({ static_cast<scalar_t>(batch),
+                                                           alpha0,
+                                                           decay,
+                                                           lambda }));
                         };
 
                         // OK, optimize the model
                         ncv::minimize(fn_size, fn_fval, fn_grad, fn_wlog, fn_elog, fn_ulog,
-                                      data.m_x0, optimizer, epochs, epoch_size, alpha0, decay);
+                                      data.m_x0.cast<opt_scalar_t>(), optimizer, epochs, epoch_size, alpha0, decay);
+
+                        // NB: the last evaluation may still be running
+                        evaluator.wait();
 
                         return result;
                 }
 
                 // <result, batch size, decay rate>
                 std::tuple<trainer_result_t, size_t, scalar_t> tune_batch_decay(
-                        trainer_data_t& data,
+                        const rcontexts_t& contexts, bool async,
                         optim::stoch_optimizer optimizer, scalar_t alpha,
                         bool verbose)
                 {
@@ -107,38 +139,81 @@ namespace ncv
                                 break;
                         }
 
+                        // tune the batch size
+                        const size_t min_batch = 16 * ncv::n_threads();
+                        const size_t max_batch = 16 * min_batch;
+
+                        // <decay rate, batch size> candidates
+                        std::vector<std::pair<scalar_t, size_t>> params;
                         for (scalar_t decay : decays)
                         {
-                                // tune the batch size
-                                const size_t min_batch = 16 * ncv::n_threads();
-                                const size_t max_batch = 16 * min_batch;
-
                                 for (size_t batch = min_batch; batch <= max_batch; batch *= 2)
                                 {
+                                        params.emplace_back(decay, batch);
+                                }
+                        }
+
+                        // train the candidates: each context trains every <contexts.size()>-th candidate
+                        std::vector<trainer_result_t> results(params.size());
+                        strings_t durations(params.size());
+
+                        // NB: the i-th candidate draws its random numbers (e.g. the sample order) from seeds
+                        //      derived from its index, so that they do not depend on which context trains it & when
+                        const std::uint64_t seed = ncv::random_seed();
+                        const std::uint64_t seed_stride = std::uint64_t(1) << 32;
+
+                        const auto op = [&] (size_t c)
+                        {
+                                context_t& context = *contexts[c];
+
+                                for (size_t i = c; i < params.size(); i += contexts.size())
+                                {
+                                        const random_seed_scope_t seed_scope(seed + i * seed_stride);
                                         const ncv::timer_t timer;
 
                                         const size_t epochs = 1;
-                                        const trainer_result_t result = train(
-                                                data, optimizer, epochs, batch, alpha, decay, false);
-
-                                        const trainer_state_t state = result.optimum_state();
-
-                                        if (verbose)
-                                        log_info()
-                                                << "[tuning: train = " << state.m_tvalue << "/" << state.m_terror_avg
-                                                << ", valid = " << state.m_vvalue << "/" << state.m_verror_avg
-                                                << ", batch = " << batch
-                                                << ", alpha = " << alpha
-                                                << ", decay = " << decay
-                                                << ", lambda = " << data.lambda()
-                                                << "] done in " << timer.elapsed() << ".";
-
-                                        if (result < opt_result)
-                                        {
-                                                opt_result = result;
-                                                opt_batch = batch;
-                                                opt_decay = decay;
-                                        }
+                                        results[i] = train(
+                                                context.m_data, context.eacc(), async,
+                                                optimizer, epochs, params[i].second, alpha, params[i].first, false);
+
+                                        durations[i] = timer.elapsed();
+                                }
+                        };
+
+                        if (contexts.size() == 1)
+                        {
+                                op(0);
+                        }
+                        else
+                        {
+                                thread_loopi(contexts.size(), ncv::get_thread_pool(), contexts.size(), op);
+                        }
+
+                        // select the optimum candidate in the same order as the sequential search
+                        // NB: the contexts may use fewer threads, so the results may differ in the last bits.
+                        for (size_t i = 0; i < params.size(); i ++)
+                        {
+                                const trainer_result_t& result = results[i];
+                                const trainer_state_t state = result.optimum_state();
+
+                                const scalar_t decay = params[i].first;
+                                const size_t batch = params[i].second;
+
+                                if (verbose)
+                                log_info()
+                                        << "[tuning: train = " << state.m_tvalue << "/" << state.m_terror_avg
+                                        << ", valid = " << state.m_vvalue << "/" << state.m_verror_avg
+                                        << ", batch = " << batch
+                                        << ", alpha = " << alpha
+                                        << ", decay = " << decay
+                                        << ", lambda = " << contexts[0]->m_data.lambda()
+                                        << "] done in " << durations[i] << ".";
+
+                                if (result < opt_result)
+                                {
+                                        opt_result = result;
+                                        opt_batch = batch;
+                                        opt_decay = decay;
                                 }
                         }
 
@@ -148,13 +223,13 @@ namespace ncv
 
                 // <result, batch size, decay rate, learning rate>
                 std::tuple<trainer_result_t, size_t, scalar_t, scalar_t> tune_batch_decay_lrate(
-                        trainer_data_t& data,
+                        const rcontexts_t& contexts, bool async,
                         optim::stoch_optimizer optimizer,
                         bool verbose)
                 {
                         const auto op = [&] (scalar_t alpha)
                         {
-                                const auto ret = tune_batch_decay(data, optimizer, alpha, verbose);
+                                const auto ret = tune_batch_decay(contexts, async, optimizer, alpha, verbose);
                                 return std::tuple_cat(ret, std::make_tuple(alpha));
                         };
 
@@ -171,19 +246,22 @@ namespace ncv
 
                 // <result, batch size, decay rate, learning rate, regularization weight>
                 std::tuple<trainer_result_t, size_t, scalar_t, scalar_t, scalar_t> tune_lambda(
-                        trainer_data_t& data,
+                        const rcontexts_t& contexts, bool async,
                         optim::stoch_optimizer optimizer,
                         bool verbose)
                 {
                         const auto op = [&] (scalar_t lambda)
                         {
-                                data.set_lambda(lambda);
+                                for (const rcontext_t& context : contexts)
+                                {
+                                        context->m_data.set_lambda(lambda);
+                                }
 
-                                const auto ret = tune_batch_decay_lrate(data, optimizer, verbose);
+                                const auto ret = tune_batch_decay_lrate(contexts, async, optimizer, verbose);
                                 return std::tuple_cat(ret, std::make_tuple(lambda));
                         };
 
-                        if (data.m_lacc.can_regularize())
+                        if (contexts[0]->m_lacc.can_regularize())
                         {
                                 return log10_min_search(op, -6.0, +0.0, 0.5, 4).first;
                         }
@@ -198,19 +276,42 @@ namespace ncv
                 const model_t& model,
                 const task_t& task, const sampler_t& tsampler, const sampler_t& vsampler, size_t nthreads,
                 const loss_t& loss, const string_t& criterion,
-                optim::stoch_optimizer optimizer, size_t epochs, bool verbose)
+                optim::stoch_optimizer optimizer, size_t epochs, bool async, size_t ncandidates, bool verbose)
         {
                 vector_t x0;
                 model.save_params(x0);
 
-                // setup accumulators
-                accumulator_t lacc(model, nthreads, criterion, criterion_t::type::value);
-                accumulator_t gacc(model, nthreads, criterion, criterion_t::type::vgrad);
+                const size_t nworkers = ncv::get_thread_pool().concurrency(nthreads);
+                ncandidates = math::clamp(ncandidates, size_t(1), nworkers);
+
+                // NB: the data-parallel processes must sum their statistics in the same order
+                if (ncv::get_process_group().size() > 1)
+                {
+                        async = false;
+                        ncandidates = 1;
+                }
+
+                // setup the buffers to train with all threads ...
+                rcontexts_t contexts;
+                contexts.emplace_back(std::make_unique<context_t>(
+                        model, task, tsampler, vsampler, loss, x0, nthreads, criterion, async));
+
+                // ... and to train the tuning candidates concurrently (if requested) with a part of the threads each
+                rcontexts_t tcontexts;
+                if (ncandidates > 1)
+                {
+                        for (size_t c = 0; c < ncandidates; c ++)
+                        {
+                                tcontexts.emplace_back(std::make_unique<context_t>(
+                                        model, task, tsampler, vsampler, loss, x0, nworkers / ncandidates, criterion, async));
+                        }
+                }
 
-                trainer_data_t data(task, tsampler, vsampler, loss, x0, lacc, gacc);
+                context_t& context = *contexts[0];
+                trainer_data_t& data = context.m_data;
 
                 // tune the regularization factor (if needed)
-                const auto ret = tune_lambda(data, optimizer, verbose);
+                const auto ret = tune_lambda(ncandidates > 1 ? tcontexts : contexts, async, optimizer, verbose);
 
                 const size_t opt_batch = std::get<1>(ret);
                 const scalar_t opt_decay = std::get<2>(ret);
@@ -219,6 +320,6 @@ namespace ncv
 
                 data.set_lambda(opt_lambda);
 
-                return train(data, optimizer, epochs, opt_batch, opt_alpha, opt_decay, verbose);
+                return train(data, context.eacc(), async, optimizer, epochs, opt_batch, opt_alpha, opt_decay, verbose);
         }
 }
@@ -9,10 +9,14 @@ namespace ncv
 
         ///
         /// \brief stochastically train the given model
+        ///     (optionally evaluating each epoch asynchronously, while the next epoch proceeds)
+        ///
+        /// NB: the hyper-parameters are tuned by training <ncandidates> candidates concurrently,
+        ///     each using #threads / <ncandidates> threads.
         ///
         NANOCV_PUBLIC trainer_result_t stochastic_train(
                 const model_t&, const task_t&, const sampler_t& tsampler, const sampler_t& vsampler, size_t nthreads,
                 const loss_t&, const string_t& criterion,
-                optim::stoch_optimizer optimizer, size_t epochs,
+                optim::stoch_optimizer optimizer, size_t epochs, bool async = false, size_t ncandidates = 1,
                 bool verbose = true);
 }
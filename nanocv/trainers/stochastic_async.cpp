@@ -0,0 +1,283 @@
+#include "stochastic_async.h"
+#include "trainer_evaluator.h"
+#include "nanocv/timer.h"
+#include "nanocv/logger.h"
+#include "nanocv/sampler.h"
+#include "nanocv/criterion.h"
+#include "nanocv/accumulator.h"
+#include "nanocv/log_search.hpp"
+#include "nanocv/math/random.hpp"
+#include "nanocv/optim/decay.hpp"
+#include "nanocv/thread/loopi.hpp"
+#include <atomic>
+#include <tuple>
+#include <cassert>
+
+namespace ncv
+{
+        namespace
+        {
+                typedef std::vector<rcriterion_t>       rcriteria_t;
+
+                ///
+                /// \brief the parameters shared (without locking) by the workers
+                ///
+                /// NB: the concurrent updates may overwrite each other (and the reads may be stale),
+                ///     which the lock-free SGD tolerates, but the accesses are relaxed atomics (no data race).
+                ///
+                typedef std::vector<std::atomic<scalar_t>>      shared_params_t;
+
+                void load(const shared_params_t& xs, vector_t& x)
+                {
+                        x.resize(static_cast<vector_t::Index>(xs.size()));
+                        for (size_t p = 0; p < xs.size(); p ++)
+                        {
+                                x(p) = xs[p].load(std::memory_order_relaxed);
+                        }
+                }
+
+                void store(const vector_t& x, shared_params_t& xs)
+                {
+                        for (size_t p = 0; p < xs.size(); p ++)
+                        {
+                                xs[p].store(x(p), std::memory_order_relaxed);
+                        }
+                }
+
+                ///
+                /// \brief run an epoch: each worker updates the shared parameters <xs> (without locking)
+                ///     using the gradients of its own random mini-batches
+                ///
+                void train_epoch(const trainer_data_t& data, const rcriteria_t& caches,
+                        size_t batch, scalar_t alpha0, scalar_t decay, std::atomic<size_t>& iter, shared_params_t& xs)
+                {
+                        const samples_t& tsamples = data.m_tsampler.all();
+                        assert(!tsamples.empty());
+
+                        const size_t nworkers = caches.size();
+                        const size_t epoch_size = (tsamples.size() + batch - 1) / batch;
+                        const size_t worker_size = (epoch_size + nworkers - 1) / nworkers;
+
+                        thread_loopi(nworkers, ncv::get_thread_pool(), nworkers, [&] (size_t w)
+                        {
+                                criterion_t& cache = *caches[w];
+
+                                random_t<size_t> rng(0, tsamples.size() - 1);
+
+                                vector_t x;
+                                samples_t samples;
+                                for (size_t i = 0; i < worker_size; i ++)
+                                {
+                                        samples.clear();
+                                        for (size_t s = 0; s < batch; s ++)
+                                        {
+                                                samples.push_back(tsamples[rng()]);
+                                        }
+
+                                        // NB: the shared parameters may be modified by the other workers meanwhile,
+                                        //      so the gradient may be computed with partially updated (stale) parameters
+                                        load(xs, x);
+                                        cache.reset(x);
+                                        cache.update(data.m_task, samples, 0, samples.size(), data.m_loss);
+
+                                        const acc_vector_t g = cache.vgrad();
+
+                                        // learning rate
+                                        const scalar_t alpha = optim::decay(alpha0, iter ++, decay);
+
+                                        // update the shared parameters (lock-free)
+                                        for (size_t p = 0; p < xs.size(); p ++)
+                                        {
+                                                const scalar_t xp = xs[p].load(std::memory_order_relaxed);
+                                                xs[p].store(xp - alpha * static_cast<scalar_t>(g(p)), std::memory_order_relaxed);
+                                        }
+                                }
+                        });
+                }
+
+                trainer_result_t train(
+                        trainer_data_t& data, const rcriteria_t& caches,
+                        size_t epochs, size_t batch, scalar_t alpha0, scalar_t decay,
+                        bool verbose)
+                {
+                        trainer_result_t result;
+
+                        const ncv::timer_t timer;
+
+                        const scalar_t lambda = data.lambda();
+                        for (const rcriterion_t& cache : caches)
+                        {
+                                cache->reset(lambda);
+                        }
+
+                        // evaluate the training & the validation samples after each epoch
+                        auto fn_elog_state = [&] (const vector_t& x, size_t epoch,
+                                                  const trainer_state_t& state, trainer_result_return_t ret)
+                        {
+                                if (verbose)
+                                log_info()
+                                        << "[train = " << state.m_tvalue << "/" << state.m_terror_avg
+                                        << ", valid = " << state.m_vvalue << "/" << state.m_verror_avg
+                                        << " (" << text::to_string(ret) << ")"
+                                        << ", xnorm = " << x.lpNorm<Eigen::Infinity>()
+                                        << ", epoch = " << epoch << "/" << epochs
+                                        << ", batch = " << batch
+                                        << ", workers = " << caches.size()
+                                        << ", alpha = " << alpha0
+                                        << ", decay = " << decay
+                                        << ", lambda = " << lambda
+                                        << "] done in " << timer.elapsed() << ".";
+                        };
+
+                        trainer_evaluator_t evaluator(data, data.m_lacc, result, false, fn_elog_state);
+
+                        // optimize the model
+                        vector_t x = data.m_x0;
+                        shared_params_t xs(static_cast<size_t>(x.size()));
+                        store(x, xs);
+
+                        std::atomic<size_t> iter(0);
+
+                        for (size_t epoch = 1; epoch <= epochs; epoch ++)
+                        {
+                                train_epoch(data, caches, batch, alpha0, decay, iter, xs);
+                                load(xs, x);
+
+                                const bool ret = evaluator.update(
+                                        x, epoch, scalars_t({ static_cast<scalar_t>(batch),
+                                                              alpha0,
+                                                              decay,
+                                                              lambda }));
+
+                                if (!ret)
+                                {
+                                        break;
+                                }
+                        }
+
+                        return result;
+                }
+
+                // <result, decay rate>
+                std::tuple<trainer_result_t, scalar_t> tune_decay(
+                        trainer_data_t& data, const rcriteria_t& caches, size_t batch, scalar_t alpha,
+                        bool verbose)
+                {
+                        trainer_result_t opt_result;
+                        scalar_t opt_decay = 0.50;
+
+                        const scalars_t decays = { 0.0, 0.10, 0.20, 0.50, 0.75, 1.00 };
+                        for (scalar_t decay : decays)
+                        {
+                                const ncv::timer_t timer;
+
+                                const size_t epochs = 1;
+                                const trainer_result_t result = train(
+                                        data, caches, epochs, batch, alpha, decay, false);
+
+                                const trainer_state_t state = result.optimum_state();
+
+                                if (verbose)
+                                log_info()
+                                        << "[tuning: train = " << state.m_tvalue << "/" << state.m_terror_avg
+                                        << ", valid = " << state.m_vvalue << "/" << state.m_verror_avg
+                                        << ", batch = " << batch
+                                        << ", alpha = " << alpha
+                                        << ", decay = " << decay
+                                        << ", lambda = " << data.lambda()
+                                        << "] done in " << timer.elapsed() << ".";
+
+                                if (result < opt_result)
+                                {
+                                        opt_result = result;
+                                        opt_decay = decay;
+                                }
+                        }
+
+                        // OK
+                        return std::make_tuple(opt_result, opt_decay);
+                }
+
+                // <result, decay rate, learning rate>
+                std::tuple<trainer_result_t, scalar_t, scalar_t> tune_decay_lrate(
+                        trainer_data_t& data, const rcriteria_t& caches, size_t batch,
+                        bool verbose)
+                {
+                        const auto op = [&] (scalar_t alpha)
+                        {
+                                const auto ret = tune_decay(data, caches, batch, alpha, verbose);
+                                return std::tuple_cat(ret, std::make_tuple(alpha));
+                        };
+
+                        return log10_min_search(op, -4.0, +2.0, 0.5, 4).first;
+                }
+
+                // <result, decay rate, learning rate, regularization weight>
+                std::tuple<trainer_result_t, scalar_t, scalar_t, scalar_t> tune_lambda(
+                        trainer_data_t& data, const rcriteria_t& caches, size_t batch,
+                        bool verbose)
+                {
+                        const auto op = [&] (scalar_t lambda)
+                        {
+                                data.set_lambda(lambda);
+
+                                const auto ret = tune_decay_lrate(data, caches, batch, verbose);
+                                return std::tuple_cat(ret, std::make_tuple(lambda));
+                        };
+
+                        if (data.m_lacc.can_regularize())
+                        {
+                                return log10_min_search(op, -6.0, +0.0, 0.5, 4).first;
+                        }
+                        else
+                        {
+                                return op(0.0);
+                        }
+                }
+        }
+
+        trainer_result_t stochastic_async_train(
+                const model_t& model,
+                const task_t& task, const sampler_t& tsampler, const sampler_t& vsampler, size_t nthreads,
+                const loss_t& loss, const string_t& criterion,
+                size_t epochs, size_t batch, bool verbose)
+        {
+                if (tsampler.all().empty())
+                {
+                        log_error() << "stochastic-async trainer: no training samples!";
+                        return trainer_result_t();
+                }
+
+                vector_t x0;
+                model.save_params(x0);
+
+                // setup accumulators (NB: the gradients are computed by the workers)
+                accumulator_t lacc(model, nthreads, criterion, criterion_t::type::value);
+
+                trainer_data_t data(task, tsampler, vsampler, loss, x0, lacc, lacc);
+
+                // setup the workers: a model clone & buffers each
+                // NB: each one is created by the thread that is likely to use it (e.g. first-touch on its NUMA node)
+                rcriteria_t caches(ncv::get_thread_pool().concurrency(nthreads));
+                thread_loopi(caches.size(), ncv::get_thread_pool(), caches.size(), [&] (size_t i)
+                {
+                        const rcriterion_t cache = ncv::get_criteria().get(criterion);
+                        cache->reset(model);
+                        cache->reset(criterion_t::type::vgrad);
+                        caches[i] = cache;
+                });
+
+                batch = std::max(batch, size_t(1));
+
+                // tune the regularization factor (if needed)
+                const auto ret = tune_lambda(data, caches, batch, verbose);
+
+                const scalar_t opt_decay = std::get<1>(ret);
+                const scalar_t opt_alpha = std::get<2>(ret);
+                const scalar_t opt_lambda = std::get<3>(ret);
+
+                data.set_lambda(opt_lambda);
+
+                return train(data, caches, epochs, batch, opt_alpha, opt_decay, verbose);
+        }
+}
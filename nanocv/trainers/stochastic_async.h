@@ -0,0 +1,23 @@
+#pragma once
+
+#include "trainer_data.h"
+#include "trainer_result.h"
+
+namespace ncv
+{
+        class model_t;
+
+        ///
+        /// \brief asynchronously (Hogwild) train the given model:
+        ///     each worker thread draws its own mini-batches, computes the gradient on its own model clone
+        ///     and updates the shared parameters without locking
+        ///
+        /// NB: "Hogwild!: A Lock-Free Approach to Parallelizing Stochastic Gradient Descent"
+        ///     - Feng Niu, Benjamin Recht, Christopher Re, Stephen J. Wright
+        ///
+        NANOCV_PUBLIC trainer_result_t stochastic_async_train(
+                const model_t&, const task_t&, const sampler_t& tsampler, const sampler_t& vsampler, size_t nthreads,
+                const loss_t&, const string_t& criterion,
+                size_t epochs, size_t batch,
+                bool verbose = true);
+}
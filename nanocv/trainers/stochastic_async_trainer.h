@@ -0,0 +1,34 @@
+#pragma once
+
+#include "nanocv/trainer.h"
+
+namespace ncv
+{
+        ///
+        /// asynchronous stochastic trainer (Hogwild): each thread draws its own random mini-batches and
+        ///     updates the shared parameters without locking, using a polynomially decreasing learning rate
+        ///     (alpha0 / (iteration + 1)^decay, see optim::decay).
+        ///
+        /// parameters:
+        ///     epoch=16[1,1024]                        - #epochs (~ #samples)
+        ///     batch=16[1,1024]                        - #samples per gradient update (per thread)
+        ///
+        /// NB: "Hogwild!: A Lock-Free Approach to Parallelizing Stochastic Gradient Descent"
+        ///     - Feng Niu, Benjamin Recht, Christopher Re, Stephen J. Wright
+        ///
+        class stochastic_async_trainer_t : public trainer_t
+        {
+        public:
+
+                NANOCV_MAKE_CLONABLE(stochastic_async_trainer_t,
+                                     "parameters: epoch=16[1,1024],batch=16[1,1024]")
+
+                // constructor
+                stochastic_async_trainer_t(const string_t& parameters = string_t());
+
+                // train the model
+                virtual trainer_result_t train(
+                        const task_t&, const fold_t&, const loss_t&, size_t nthreads, const string_t& criterion,
+                        model_t&) const override;
+        };
+}
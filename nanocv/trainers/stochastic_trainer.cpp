@@ -2,6 +2,8 @@
 #include "nanocv/model.h"
 #include "nanocv/logger.h"
 #include "nanocv/sampler.h"
+#include "trainer_sync.h"
+#include "trainer_evaluator.h"
 #include "nanocv/math/numeric.hpp"
 #include "stochastic.h"
 
@@ -26,6 +28,13 @@ namespace ncv
                 model.resize(task, true);
                 model.random_params();
 
+                // NB: the data-parallel processes start from the root's parameters
+                if (!ncv::sync_params(model))
+                {
+                        log_error() << "stochastic trainer: failed to synchronize the processes!";
+                        return trainer_result_t();
+                }
+
                 // prune training & validation data
                 sampler_t tsampler(task);
                 tsampler.setup(fold).setup(sampler_t::atype::annotated);
@@ -33,6 +42,12 @@ namespace ncv
                 sampler_t vsampler(task);
                 tsampler.split(80, vsampler);
 
+                if (!ncv::check_samples(tsampler, vsampler))
+                {
+                        log_error() << "stochastic trainer: the processes use different training samples!";
+                        return trainer_result_t();
+                }
+
                 if (tsampler.empty() || vsampler.empty())
                 {
                         log_error() << "stochastic trainer: no annotated training samples!";
@@ -41,6 +56,10 @@ namespace ncv
 
                 // parameters
                 const size_t epochs = math::clamp(text::from_params<size_t>(configuration(), "epoch", 16), 1, 1024);
+                const eval_mode evaluation = text::from_string<eval_mode>
+                        (text::from_params<string_t>(configuration(), "eval", "sync"));
+                const bool async = evaluation == eval_mode::async;
+                const size_t ncandidates = math::clamp(text::from_params<size_t>(configuration(), "cands", 1), 1, 64);
 
                 const optim::stoch_optimizer optimizer = text::from_string<optim::stoch_optimizer>
                         (text::from_params<string_t>(configuration(), "opt", "sg"));
@@ -48,7 +67,7 @@ namespace ncv
                 // train the model
                 const trainer_result_t result = ncv::stochastic_train(
                         model, task, tsampler, vsampler, nthreads,
-                        loss, criterion, optimizer, epochs);
+                        loss, criterion, optimizer, epochs, async, ncandidates);
 
                 const trainer_state_t state = result.optimum_state();
 
@@ -11,6 +11,10 @@ namespace ncv
         /// parameters:
         ///     opt=sg[,sga,sia,nag,adagrad,adadelta]   - optimization method: SG, SGA, SIA, NAG, ADAGRAD, ADADELTA
         ///     epoch=16[1,1024]                        - #epochs (~ #samples)
+        ///     eval=sync[,async]                       - evaluate each epoch while the next one proceeds (async),
+        ///                                               such that early stopping is applied one epoch late
+        ///     cands=1[1,64]                           - #tuning candidates to train concurrently
+        ///                                               (each with #threads / cands threads)
         ///
         /// NB: "Minimizing Finite Sums with the Stochastic Average Gradient"
         ///     - Mark Schmidth, Nicolas Le Roux, Francis Bach
@@ -20,7 +24,7 @@ namespace ncv
         public:
 
                 NANOCV_MAKE_CLONABLE(stochastic_trainer_t,
-                                     "parameters: opt=sg[,sga,sia,nag,adagrad,adadelta],epoch=16[1,1024]")
+                                     "parameters: opt=sg[,sga,sia,nag,adagrad,adadelta],epoch=16[1,1024],eval=sync[,async],cands=1[1,64]")
 
                 // constructor
                 stochastic_trainer_t(const string_t& parameters = string_t());
@@ -59,9 +59,9 @@ namespace ncv
 
         opt_opfval_t make_opfval(const trainer_data_t& data)
         {
-                return [&] (const vector_t& x)
+                return [&] (const opt_vector_t& x)
                 {
-                        data.m_lacc.set_params(x);
+                        data.m_lacc.set_params(x.cast<scalar_t>());
                         data.m_lacc.update(data.m_task, data.m_tsampler.get(), data.m_loss);
 
                         return data.m_lacc.value();
@@ -70,9 +70,9 @@ namespace ncv
 
         opt_opgrad_t make_opgrad(const trainer_data_t& data)
         {
-                return [&] (const vector_t& x, vector_t& gx)
+                return [&] (const opt_vector_t& x, opt_vector_t& gx)
                 {
-                        data.m_gacc.set_params(x);
+                        data.m_gacc.set_params(x.cast<scalar_t>());
                         data.m_gacc.update(data.m_task, data.m_tsampler.get(), data.m_loss);
 
                         gx = data.m_gacc.vgrad();
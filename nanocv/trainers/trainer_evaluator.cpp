@@ -0,0 +1,87 @@
+#include "trainer_evaluator.h"
+#include "nanocv/accumulator.h"
+
+namespace ncv
+{
+        trainer_evaluator_t::trainer_evaluator_t(
+                const trainer_data_t& data, accumulator_t& acc, trainer_result_t& result,
+                bool async, const oplog_t& oplog)
+                :       m_data(data),
+                        m_acc(acc),
+                        m_result(result),
+                        m_async(async),
+                        m_oplog(oplog),
+                        m_ret(trainer_result_return_t::better)
+        {
+        }
+
+        trainer_evaluator_t::~trainer_evaluator_t()
+        {
+                wait();
+        }
+
+        bool trainer_evaluator_t::update(const vector_t& params, size_t epoch, const scalars_t& config)
+        {
+                // NB: the samples (e.g. mini-batches) & the regularization weight may change meanwhile
+                const samples_t tsamples = m_data.m_tsampler.all();
+                const samples_t vsamples = m_data.m_vsampler.all();
+
+                if (!m_async)
+                {
+                        evaluate(params, tsamples, vsamples, epoch, config);
+                        return m_ret != trainer_result_return_t::overfitting;
+                }
+
+                else
+                {
+                        // the decision of the previous evaluation ...
+                        const bool ret = wait();
+
+                        // ... while the current one is running in the background
+                        m_acc.set_lambda(m_data.lambda());
+                        ncv::get_thread_pool().enqueue(m_group, [=] ()
+                        {
+                                evaluate(params, tsamples, vsamples, epoch, config);
+                        });
+
+                        return ret;
+                }
+        }
+
+        bool trainer_evaluator_t::wait()
+        {
+                ncv::get_thread_pool().wait(m_group);
+
+                return m_ret != trainer_result_return_t::overfitting;
+        }
+
+        void trainer_evaluator_t::evaluate(const vector_t& params, const samples_t& tsamples, const samples_t& vsamples,
+                size_t epoch, const scalars_t& config)
+        {
+                // evaluate training samples
+                m_acc.set_params(params);
+                m_acc.update(m_data.m_task, tsamples, m_data.m_loss);
+                const scalar_t tvalue = m_acc.value();
+                const scalar_t terror_avg = m_acc.avg_error();
+                const scalar_t terror_var = m_acc.var_error();
+
+                // evaluate validation samples
+                m_acc.set_params(params);
+                m_acc.update(m_data.m_task, vsamples, m_data.m_loss);
+                const scalar_t vvalue = m_acc.value();
+                const scalar_t verror_avg = m_acc.avg_error();
+                const scalar_t verror_var = m_acc.var_error();
+
+                // OK, update the optimum solution
+                m_ret = m_result.update(
+                        params, tvalue, terror_avg, terror_var, vvalue, verror_avg, verror_var,
+                        epoch, config);
+
+                if (m_oplog)
+                {
+                        m_oplog(params, epoch,
+                                trainer_state_t(tvalue, terror_avg, terror_var, vvalue, verror_avg, verror_var),
+                                m_ret);
+                }
+        }
+}
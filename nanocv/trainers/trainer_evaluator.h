@@ -0,0 +1,97 @@
+#pragma once
+
+#include "trainer_data.h"
+#include "trainer_result.h"
+#include "nanocv/thread/pool.h"
+#include "nanocv/text/enum_string.hpp"
+#include <functional>
+
+namespace ncv
+{
+        ///
+        /// \brief when to evaluate the model parameters after each epoch (see trainer_evaluator_t)
+        ///
+        enum class eval_mode
+        {
+                sync,                   ///< before the next epoch starts
+                async                   ///< in the background, while the next epoch proceeds
+        };
+
+        // string cast for enumerations
+        namespace text
+        {
+                template <>
+                inline std::map<eval_mode, std::string> enum_string<eval_mode>()
+                {
+                        return
+                        {
+                                { eval_mode::sync,      "sync" },
+                                { eval_mode::async,     "async" }
+                        };
+                }
+        }
+
+        ///
+        /// \brief evaluates the model parameters (e.g. after each epoch) on all training & validation samples
+        ///     and updates the training result:
+        ///     - synchronously, or
+        ///     - asynchronously: a snapshot of the parameters is evaluated in the background using
+        ///     a separate accumulator, while the optimization continues (e.g. with the next epoch).
+        ///
+        /// NB: the asynchronous (early-stopping) decisions are applied one evaluation late or on request (see ::wait).
+        ///
+        class NANOCV_PUBLIC trainer_evaluator_t : private noncopyable_t
+        {
+        public:
+
+                ///
+                /// \brief callback with the evaluated parameters, epoch, state & its effect on the training result
+                ///
+                typedef std::function<void(const vector_t& params, size_t epoch,
+                                           const trainer_state_t&, trainer_result_return_t)> oplog_t;
+
+                ///
+                /// \brief constructor
+                ///
+                trainer_evaluator_t(const trainer_data_t& data, accumulator_t& acc, trainer_result_t& result,
+                                    bool async, const oplog_t& oplog = oplog_t());
+
+                ///
+                /// \brief destructor (waits for the pending evaluation)
+                ///
+                virtual ~trainer_evaluator_t();
+
+                ///
+                /// \brief evaluate the given parameters,
+                ///     returns false if the optimization should be stopped (e.g. overfitting detected)
+                ///
+                /// NB: if asynchronous, the decision is based on the previous evaluation.
+                ///
+                bool update(const vector_t& params, size_t epoch, const scalars_t& config);
+
+                ///
+                /// \brief wait for the pending evaluation (if any),
+                ///     returns false if the optimization should be stopped (e.g. overfitting detected)
+                ///
+                bool wait();
+
+        private:
+
+                ///
+                /// \brief evaluate the given parameters & update the training result (synchronously)
+                ///
+                void evaluate(const vector_t& params, const samples_t& tsamples, const samples_t& vsamples,
+                              size_t epoch, const scalars_t& config);
+
+        private:
+
+                // attributes
+                const trainer_data_t&           m_data;         ///< training data (e.g. the samples to evaluate)
+                accumulator_t&                  m_acc;          ///< accumulator to evaluate the parameters with
+                trainer_result_t&               m_result;       ///< training result to update
+                bool                            m_async;        ///< evaluate in the background
+                oplog_t                         m_oplog;        ///< logging callback
+                thread_pool_t::group_t          m_group;        ///< pending evaluation (if asynchronous)
+                trainer_result_return_t         m_ret;          ///< effect of the last evaluation
+        };
+}
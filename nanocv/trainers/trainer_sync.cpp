@@ -0,0 +1,81 @@
+#include "trainer_sync.h"
+#include "nanocv/model.h"
+#include "nanocv/sampler.h"
+#include "nanocv/math/random.hpp"
+#include "nanocv/thread/process_group.h"
+
+namespace ncv
+{
+        namespace
+        {
+                // FNV-1a hash of the image indices & regions
+                std::uint64_t checksum(const samples_t& samples, std::uint64_t hash)
+                {
+                        const auto update = [&] (std::uint64_t value)
+                        {
+                                hash ^= value;
+                                hash *= 1099511628211ULL;
+                        };
+
+                        update(samples.size());
+                        for (const sample_t& sample : samples)
+                        {
+                                update(sample.m_index);
+                                update(static_cast<std::uint64_t>(sample.m_region.left()));
+                                update(static_cast<std::uint64_t>(sample.m_region.top()));
+                                update(static_cast<std::uint64_t>(sample.m_region.cols()));
+                                update(static_cast<std::uint64_t>(sample.m_region.rows()));
+                        }
+
+                        return hash;
+                }
+        }
+
+        bool sync_params(model_t& model)
+        {
+                process_group_t& group = ncv::get_process_group();
+                if (group.size() == 1)
+                {
+                        return true;
+                }
+
+                // the root's parameters ...
+                vector_t params;
+                if (    !model.save_params(params) ||
+                        !group.broadcast(params.data(), static_cast<std::size_t>(params.size())) ||
+                        !model.load_params(params))
+                {
+                        return false;
+                }
+
+                // ... and random sequences (e.g. to split the samples & to shuffle them identically)
+                std::uint64_t seed = ncv::random_seed();
+                if (!group.broadcast(&seed, 1))
+                {
+                        return false;
+                }
+
+                ncv::set_random_seed(seed);
+                return true;
+        }
+
+        bool check_samples(const sampler_t& tsampler, const sampler_t& vsampler)
+        {
+                process_group_t& group = ncv::get_process_group();
+                if (group.size() == 1)
+                {
+                        return true;
+                }
+
+                const std::uint64_t hash = checksum(vsampler.all(), checksum(tsampler.all(), 14695981039346656037ULL));
+
+                // NB: all processes agree on the result (to stop together)
+                std::uint64_t root_hash = hash;
+                const bool ok = group.broadcast(&root_hash, 1);
+
+                double mismatches = (ok && root_hash == hash) ? 0.0 : 1.0;
+
+                return  group.allreduce(&mismatches, 1) &&
+                        mismatches == 0.0;
+        }
+}
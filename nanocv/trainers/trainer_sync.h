@@ -0,0 +1,23 @@
+#pragma once
+
+#include "nanocv/arch.h"
+
+namespace ncv
+{
+        class model_t;
+        class sampler_t;
+
+        ///
+        /// \brief start the data-parallel processes from the root's initial parameters & random sequences
+        ///
+        /// NB: the processes may draw different random numbers before (e.g. when tuning the convolutions),
+        ///     so the seeds cannot be relied upon to produce the same initial parameters.
+        ///
+        NANOCV_PUBLIC bool sync_params(model_t& model);
+
+        ///
+        /// \brief check that the data-parallel processes use the same training & validation samples,
+        ///     returns false in all processes if any differs
+        ///
+        NANOCV_PUBLIC bool check_samples(const sampler_t& tsampler, const sampler_t& vsampler);
+}
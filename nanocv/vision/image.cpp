@@ -188,6 +188,33 @@ namespace ncv
         }
 
         tensor_t image_t::to_tensor(const rect_t& region) const
+        {
+                tensor_t data;
+                to_tensor(region, data);
+                return data;
+        }
+
+        void image_t::to_tensor(const rect_t& region, tensor_t& data) const
+        {
+                switch (m_mode)
+                {
+                case color_mode::luma:
+                        data.resize(1, region.rows(), region.cols());
+                        to_tensor(region, data.data());
+                        break;
+
+                case color_mode::rgba:
+                        data.resize(3, region.rows(), region.cols());
+                        to_tensor(region, data.data());
+                        break;
+
+                default:
+                        data.resize(0, 0, 0);
+                        break;
+                }
+        }
+
+        void image_t::to_tensor(const rect_t& region, scalar_t* data) const
         {
                 const coord_t top = region.top();
                 const coord_t left = region.left();
@@ -200,23 +227,20 @@ namespace ncv
                 {
                 case color_mode::luma:
                         {
-                                tensor_t data(1, rows, cols);
-                                auto gmap = data.matrix(0);
+                                auto gmap = tensor::map_matrix(data, rows, cols);
 
                                 tensor::transform(m_luma.block(top, left, rows, cols), gmap, [=] (luma_t luma)
                                 {
                                         return scale * luma;
                                 });
-
-                                return data;
                         }
+                        break;
 
                 case color_mode::rgba:
                         {
-                                tensor_t data(3, rows, cols);
-                                auto rmap = data.matrix(0);
-                                auto gmap = data.matrix(1);
-                                auto bmap = data.matrix(2);
+                                auto rmap = tensor::map_matrix(data + 0 * rows * cols, rows, cols);
+                                auto gmap = tensor::map_matrix(data + 1 * rows * cols, rows, cols);
+                                auto bmap = tensor::map_matrix(data + 2 * rows * cols, rows, cols);
 
                                 tensor::transform(m_rgba.block(top, left, rows, cols), rmap, [=] (rgba_t rgba)
                                 {
@@ -230,13 +254,11 @@ namespace ncv
                                 {
                                         return scale * color::get_blue(rgba);
                                 });
-
-                                return data;
                         }
                         break;
 
                 default:
-                        return tensor_t();
+                        break;
                 }
         }
 
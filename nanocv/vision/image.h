@@ -67,6 +67,18 @@ namespace ncv
                 tensor_t to_tensor() const;
                 tensor_t to_tensor(const rect_t& region) const;
 
+                ///
+                /// \brief save image region to the given scaled [0, 1] tensor
+                ///     (NB: no allocation if it has already the right size)
+                ///
+                void to_tensor(const rect_t& region, tensor_t& data) const;
+
+                ///
+                /// \brief save image region to the given buffer of 1 (luma) or 3 (rgba) x rows x cols scaled [0, 1] values
+                ///     (NB: no allocation)
+                ///
+                void to_tensor(const rect_t& region, scalar_t* data) const;
+
                 ///
                 /// \brief transform between color mode
                 ///
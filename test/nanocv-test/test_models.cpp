@@ -10,6 +10,8 @@ namespace test
         namespace
         {
                 const strings_t conv_layer_ids { "", "conv" };
+                const strings_t conv_mode_ids { "direct", "dot", "mad", "im2col", "winograd", "fft", "auto", "blocked" };
+                const strings_t conv_step_ids { "", ",stride=2", ",dilation=2" };
                 const strings_t pool_layer_ids { "", "pool-max", "pool-min", "pool-avg" };
                 const strings_t full_layer_ids { "", "linear" };
                 const strings_t actv_layer_ids { "", "act-unit", "act-tanh", "act-snorm", "act-splus" };
@@ -38,6 +40,16 @@ namespace test
                                 params += "dims=" + text::to_string(rgen());
                                 params += (rgen() % 2 == 0) ? ",rows=2,cols=2" : ",rows=3,cols=3";
 
+                                random_t<size_t> mgen(0, conv_mode_ids.size() - 1);
+                                params += ",mode=" + conv_mode_ids[mgen()];
+
+                                if (n_layers == 1)
+                                {
+                                        // NB: the input is too small to stack strided or dilated convolutions
+                                        random_t<size_t> sgen(0, conv_step_ids.size() - 1);
+                                        params += conv_step_ids[sgen()];
+                                }
+
                                 desc += conv_layer_id + ":" + params + ";";
                                 if (l == 0)
                                 {
@@ -70,6 +82,7 @@ namespace test
                 // evaluate the analytical gradient vs. the finite difference approximation for various:
                 //      * convolution layers
                 //      * convolution connection types
+                //      * convolution methods (randomly selected)
                 //      * pooling layers
                 //      * fully connected layers
                 //      * activation layers
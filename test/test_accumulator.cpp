@@ -89,18 +89,29 @@ BOOST_AUTO_TEST_CASE(test_accumulator)
                         BOOST_CHECK_EQUAL(gacc.set_lambda(lambda), lambda);
 
                         lacc.update(task, samples, *loss);
-                        const scalar_t value1 = lacc.value();
+                        const acc_scalar_t value1 = lacc.value();
 
                         BOOST_CHECK_EQUAL(lacc.count(), cmd_samples);
 
                         gacc.update(task, samples, *loss);
-                        const scalar_t vgrad1 = gacc.value();
-                        const vector_t pgrad1 = gacc.vgrad();
+                        const acc_scalar_t vgrad1 = gacc.value();
+                        const acc_vector_t pgrad1 = gacc.vgrad();
 
                         BOOST_CHECK_EQUAL(gacc.count(), cmd_samples);
                         BOOST_CHECK(std::isfinite(vgrad1));
                         BOOST_CHECK_LE(math::abs(vgrad1 - value1), cmd_epsilon);
 
+                        // check the batched evaluation against the per-sample one
+                        accumulator_t gacc1(*model, 1, criterion, criterion_t::type::vgrad, lambda);
+                        for (const sample_t& sample : samples)
+                        {
+                                gacc1.update(task, sample, *loss);
+                        }
+
+                        BOOST_CHECK_EQUAL(gacc1.count(), cmd_samples);
+                        BOOST_CHECK_LE(math::abs(gacc1.value() - vgrad1), cmd_epsilon);
+                        BOOST_CHECK_LE((gacc1.vgrad() - pgrad1).lpNorm<Eigen::Infinity>(), cmd_epsilon);
+
                         // check results with multiple threads
                         for (size_t nthreads = 2; nthreads < 8 * ncv::n_threads(); nthreads ++)
                         {
@@ -123,6 +134,41 @@ BOOST_AUTO_TEST_CASE(test_accumulator)
                                 BOOST_CHECK_EQUAL(gaccx.count(), cmd_samples);
                                 BOOST_CHECK_LE(math::abs(gaccx.value() - vgrad1), cmd_epsilon);
                                 BOOST_CHECK_LE((gaccx.vgrad() - pgrad1).lpNorm<Eigen::Infinity>(), cmd_epsilon);
+
+                                // check that the (parallel) reduction is deterministic
+                                accumulator_t gaccy(*model, nthreads, criterion, criterion_t::type::vgrad, lambda);
+                                gaccy.update(task, samples, *loss);
+
+                                BOOST_CHECK_EQUAL(gaccy.count(), cmd_samples);
+                                BOOST_CHECK_EQUAL(gaccy.value(), gaccx.value());
+                                BOOST_CHECK_EQUAL((gaccy.vgrad() - gaccx.vgrad()).lpNorm<Eigen::Infinity>(), 0);
+
+                                // check that the samples are cumulated only once
+                                gaccy.update(task, samples, *loss);
+
+                                BOOST_CHECK_EQUAL(gaccy.count(), 2 * cmd_samples);
+                                BOOST_CHECK_LE(math::abs(gaccy.value() - vgrad1), cmd_epsilon);
+
+                                // check that the reduction is deterministic for the dynamic & guided schedules
+                                for (thread_schedule schedule : { thread_schedule::dynamic, thread_schedule::guided })
+                                {
+                                        accumulator_t gaccd(*model, nthreads, criterion, criterion_t::type::vgrad, lambda);
+                                        accumulator_t gacce(*model, nthreads, criterion, criterion_t::type::vgrad, lambda);
+                                        gaccd.set_schedule(schedule, 1);
+                                        gacce.set_schedule(schedule, 1);
+
+                                        gaccd.update(task, samples, *loss);
+                                        gacce.update(task, samples, *loss);
+
+                                        BOOST_CHECK_EQUAL(gaccd.count(), cmd_samples);
+                                        BOOST_CHECK_LE(math::abs(gaccd.value() - vgrad1), cmd_epsilon);
+                                        BOOST_CHECK_LE((gaccd.vgrad() - pgrad1).lpNorm<Eigen::Infinity>(), cmd_epsilon);
+
+                                        BOOST_CHECK_EQUAL(gacce.count(), cmd_samples);
+                                        BOOST_CHECK_EQUAL(gacce.value(), gaccd.value());
+                                        BOOST_CHECK_EQUAL((gacce.vgrad() - gaccd.vgrad()).lpNorm<Eigen::Infinity>(), 0);
+                                        BOOST_CHECK_EQUAL(gacce.avg_error(), gaccd.avg_error());
+                                }
                         }
                 }
         }
@@ -0,0 +1,74 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "test_chunk_buffer"
+
+#include <boost/test/unit_test.hpp>
+#include "nanocv/file/chunk.h"
+#include <algorithm>
+
+namespace test
+{
+        using namespace ncv;
+
+        // decode a header followed by fixed-size records from a stream of bytes written in pieces
+        void check_records(size_t header_size, size_t record_size, size_t n_records, size_t capacity, size_t piece)
+        {
+                io::data_t data(header_size + n_records * record_size + record_size / 2);
+                for (size_t i = 0; i < data.size(); i ++)
+                {
+                        data[i] = static_cast<char>(i % 127);
+                }
+
+                size_t header = header_size;
+                io::data_t decoded_header, decoded_records;
+                size_t max_chunk = 0;
+
+                const auto op = [&] (const std::string& filename, const char* bdata, size_t bsize, size_t& used)
+                {
+                        BOOST_CHECK_EQUAL(filename, "file");
+
+                        max_chunk = std::max(max_chunk, bsize);
+                        if (header > 0)
+                        {
+                                used = std::min(header, bsize);
+                                header -= used;
+                                decoded_header.insert(decoded_header.end(), bdata, bdata + used);
+                        }
+                        else
+                        {
+                                used = (bsize / record_size) * record_size;
+                                decoded_records.insert(decoded_records.end(), bdata, bdata + used);
+                        }
+                        return true;
+                };
+
+                io::chunk_buffer_t buffer("file", op, capacity);
+                for (size_t i = 0; i < data.size(); i += piece)
+                {
+                        BOOST_REQUIRE(buffer.write(data.data() + i, std::min(piece, data.size() - i)));
+                }
+                BOOST_REQUIRE(buffer.flush());
+
+                // the header & all the whole records are decoded in order (the incomplete record is discarded)
+                BOOST_CHECK_EQUAL(buffer.count(), data.size());
+                BOOST_CHECK_EQUAL(decoded_header.size(), header_size);
+                BOOST_CHECK_EQUAL(decoded_records.size(), n_records * record_size);
+                BOOST_CHECK(std::equal(decoded_header.begin(), decoded_header.end(), data.begin()));
+                BOOST_CHECK(std::equal(decoded_records.begin(), decoded_records.end(), data.begin() + header_size));
+
+                // the buffer is bounded (it grows only to fit a whole record)
+                BOOST_CHECK_LE(max_chunk, std::max(capacity, 2 * record_size));
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_chunk_buffer)
+{
+        for (size_t capacity : { 1, 7, 64, 1024 })
+        {
+                for (size_t piece : { 1, 5, 100, 10000 })
+                {
+                        test::check_records(0, 1, 100, capacity, piece);
+                        test::check_records(16, 28, 100, capacity, piece);
+                        test::check_records(3, 100, 37, capacity, piece);
+                }
+        }
+}
@@ -7,6 +7,8 @@
 #include "nanocv/math/close.hpp"
 #include "nanocv/math/conv2d.hpp"
 #include "nanocv/math/epsilon.hpp"
+#include "nanocv/math/winograd.hpp"
+#include "nanocv/math/conv2d_fft.hpp"
 
 namespace test
 {
@@ -48,6 +50,7 @@ namespace test
                 const scalar_t convcpu_dot = test_cpu(ncv::math::conv2d_dot<matrix_t>, idata, kdata, odata);
                 const scalar_t convcpu_mad = test_cpu(ncv::math::conv2d_mad<matrix_t>, idata, kdata, odata);
                 const scalar_t convcpu_dyn = test_cpu(ncv::math::conv2d_dyn<matrix_t>, idata, kdata, odata);
+                const scalar_t convcpu_fft = test_cpu(ncv::math::conv2d_fft<matrix_t>, idata, kdata, odata);
 
                 const scalar_t epsilon = math::epsilon1<scalar_t>();
 
@@ -56,6 +59,31 @@ namespace test
                 BOOST_CHECK_LE(math::abs(convcpu_dot - convcpu_eig), epsilon);
                 BOOST_CHECK_LE(math::abs(convcpu_mad - convcpu_eig), epsilon);
                 BOOST_CHECK_LE(math::abs(convcpu_dyn - convcpu_eig), epsilon);
+                BOOST_CHECK_LE(math::abs(convcpu_fft - convcpu_eig), epsilon);
+        }
+
+        template
+        <
+                typename top
+        >
+        void test_winograd(top op, int isize, int ksize)
+        {
+                const int osize = isize - ksize + 1;
+
+                matrix_t idata(isize, isize);
+                matrix_t kdata(ksize, ksize);
+                matrix_t odata_cpp(osize, osize);
+                matrix_t odata_win(osize, osize);
+
+                idata.setRandom();
+                kdata.setRandom();
+                odata_cpp.setRandom();
+                odata_win = odata_cpp;
+
+                ncv::math::conv2d_cpp(idata, kdata, odata_cpp);
+                op(idata, kdata, odata_win);
+
+                BOOST_CHECK_LE((odata_cpp - odata_win).lpNorm<Eigen::Infinity>(), math::epsilon1<scalar_t>());
         }
 }
 
@@ -80,3 +108,24 @@ BOOST_AUTO_TEST_CASE(test_conv2d)
         }
 }
 
+BOOST_AUTO_TEST_CASE(test_conv2d_winograd)
+{
+        using namespace ncv;
+
+        const int n_tests = 16;
+
+        // NB: odd output sizes to check the partial tiles as well
+        for (int isize = 6; isize <= 33; isize ++)
+        {
+                for (int t = 0; t < n_tests; t ++)
+                {
+                        test::test_winograd(ncv::math::conv2d_winograd<2, 3, matrix_t>, isize, 3);
+                        test::test_winograd(ncv::math::conv2d_winograd<4, 3, matrix_t>, isize, 3);
+                        test::test_winograd(ncv::math::conv2d_winograd<2, 5, matrix_t>, isize, 5);
+                        test::test_winograd(ncv::math::conv2d_wino<matrix_t>, isize, 3);
+                        test::test_winograd(ncv::math::conv2d_wino<matrix_t>, isize, 5);
+                        test::test_winograd(ncv::math::conv2d_wino<matrix_t>, isize, 4);
+                }
+        }
+}
+
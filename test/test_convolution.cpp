@@ -0,0 +1,406 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "test_convolution"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include "nanocv/nanocv.h"
+#include "nanocv/math/abs.hpp"
+#include "nanocv/math/random.hpp"
+#include "nanocv/math/epsilon.hpp"
+#include "nanocv/tensor/blocked.hpp"
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+
+namespace test
+{
+        using namespace ncv;
+
+        rlayer_t make_layer(size_t odims, size_t ksize, const string_t& mode, const tensor_t& input,
+                size_t stride = 1, size_t dilation = 1)
+        {
+                const string_t params =
+                        "dims=" + text::to_string(odims) +
+                        ",rows=" + text::to_string(ksize) +
+                        ",cols=" + text::to_string(ksize) +
+                        ",mode=" + mode +
+                        ",stride=" + text::to_string(stride) +
+                        ",dilation=" + text::to_string(dilation);
+
+                const rlayer_t layer = ncv::get_layers().get("conv", params);
+                layer->resize(input);
+                return layer;
+        }
+
+        void test_convolution(size_t idims, size_t isize, size_t odims, size_t ksize, const string_t& mode)
+        {
+                tensor_t input(idims, isize, isize);
+                input.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                const rlayer_t layer_ref = make_layer(odims, ksize, "direct", input);
+                const rlayer_t layer = make_layer(odims, ksize, mode, input);
+
+                BOOST_REQUIRE_EQUAL(layer->psize(), layer_ref->psize());
+                BOOST_REQUIRE_EQUAL(layer->odims(), layer_ref->odims());
+                BOOST_REQUIRE_EQUAL(layer->orows(), layer_ref->orows());
+                BOOST_REQUIRE_EQUAL(layer->ocols(), layer_ref->ocols());
+
+                vector_t params(layer->psize());
+                params.setRandom();
+                layer_ref->load_params(params.data());
+                layer->load_params(params.data());
+
+                tensor_t output(layer->odims(), layer->orows(), layer->ocols());
+                output.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                const scalar_t epsilon = math::epsilon1<scalar_t>();
+
+                // output
+                const tensor_t output_ref = layer_ref->output(input);
+                const tensor_t output_mod = layer->output(input);
+
+                BOOST_CHECK_LE((output_ref.vector() - output_mod.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+
+                // output (plane by plane)
+                tensor_t output_pln;
+                for (size_t o = 0; o < layer->odims(); o ++)
+                {
+                        output_pln = layer->output_plane(input, o);
+                }
+
+                BOOST_CHECK_LE((output_ref.vector() - output_pln.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+
+                // gradient wrt parameters
+                vector_t gparam_ref(layer->psize()), gparam_mod(layer->psize());
+                layer_ref->gparam(output, gparam_ref.data());
+                layer->gparam(output, gparam_mod.data());
+
+                BOOST_CHECK_LE((gparam_ref - gparam_mod).lpNorm<Eigen::Infinity>(), epsilon);
+
+                // gradient wrt inputs
+                const tensor_t ginput_ref = layer_ref->ginput(output);
+                const tensor_t ginput_mod = layer->ginput(output);
+
+                BOOST_CHECK_LE((ginput_ref.vector() - ginput_mod.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+        }
+
+        void test_convolution_batch(size_t idims, size_t isize, size_t odims, size_t ksize, const string_t& mode)
+        {
+                const size_t count = 3;
+
+                tensor_t inputs(count * idims, isize, isize);
+                inputs.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                tensor_t input(idims, isize, isize);
+                const rlayer_t layer = make_layer(odims, ksize, mode, input);
+
+                vector_t params(layer->psize());
+                params.setRandom();
+                layer->load_params(params.data());
+
+                tensor_t outputs(count * layer->odims(), layer->orows(), layer->ocols());
+                outputs.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                tensor_t output(layer->odims(), layer->orows(), layer->ocols());
+
+                const scalar_t epsilon = math::epsilon1<scalar_t>();
+
+                // batch vs. sample by sample
+                const tensor_t outputs_bat = layer->output(inputs, count);
+                const tensor_t ginputs_bat = layer->ginput(outputs, count);
+
+                vector_t gparam_bat(layer->psize());
+                layer->gparam(outputs, count, gparam_bat.data());
+
+                vector_t gparam_sum(layer->psize());
+                gparam_sum.setZero();
+
+                for (size_t s = 0; s < count; s ++)
+                {
+                        input.vector() = inputs.vector().segment(s * input.size(), input.size());
+                        output.vector() = outputs.vector().segment(s * output.size(), output.size());
+
+                        const tensor_t output_ref = layer->output(input);
+
+                        vector_t gparam_ref(layer->psize());
+                        layer->gparam(output, gparam_ref.data());
+                        gparam_sum += gparam_ref;
+
+                        const tensor_t ginput_ref = layer->ginput(output);
+
+                        BOOST_CHECK_LE((output_ref.vector() -
+                                outputs_bat.vector().segment(s * output.size(), output.size())).lpNorm<Eigen::Infinity>(), epsilon);
+                        BOOST_CHECK_LE((ginput_ref.vector() -
+                                ginputs_bat.vector().segment(s * input.size(), input.size())).lpNorm<Eigen::Infinity>(), epsilon);
+                }
+
+                BOOST_CHECK_LE((gparam_sum - gparam_bat).lpNorm<Eigen::Infinity>(), epsilon);
+        }
+
+        void test_convolution_strided(size_t idims, size_t isize, size_t odims, size_t ksize, size_t stride, size_t dilation)
+        {
+                tensor_t input(idims, isize, isize);
+                input.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                const rlayer_t layer = make_layer(odims, ksize, "auto", input, stride, dilation);
+
+                const size_t osize = (isize - dilation * (ksize - 1) - 1) / stride + 1;
+                BOOST_REQUIRE_EQUAL(layer->orows(), osize);
+                BOOST_REQUIRE_EQUAL(layer->ocols(), osize);
+
+                vector_t params(layer->psize());
+                params.setRandom();
+                layer->load_params(params.data());
+
+                const size_t ksizes = odims * idims * ksize * ksize;
+                const auto kdata = params.segment(0, ksizes);
+                const auto bdata = params.segment(ksizes, odims);
+
+                const scalar_t epsilon = math::epsilon1<scalar_t>();
+
+                // output vs. the definition
+                const tensor_t output = layer->output(input);
+
+                tensor_t output_ref(odims, osize, osize);
+                for (size_t o = 0; o < odims; o ++)
+                {
+                        for (size_t r = 0; r < osize; r ++)
+                        {
+                                for (size_t c = 0; c < osize; c ++)
+                                {
+                                        scalar_t sum = bdata(o);
+                                        for (size_t i = 0; i < idims; i ++)
+                                        {
+                                                for (size_t kr = 0; kr < ksize; kr ++)
+                                                {
+                                                        for (size_t kc = 0; kc < ksize; kc ++)
+                                                        {
+                                                                sum +=  kdata(((o * idims + i) * ksize + kr) * ksize + kc) *
+                                                                        input.matrix(i)(r * stride + kr * dilation, c * stride + kc * dilation);
+                                                        }
+                                                }
+                                        }
+
+                                        output_ref.matrix(o)(r, c) = sum;
+                                }
+                        }
+                }
+
+                BOOST_CHECK_LE((output_ref.vector() - output.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+
+                // gradients vs. the adjoint of the (linear) convolution: <conv(x), g> = <x, ginput(g)> = <k, gparam(g)>
+                tensor_t goutput(odims, osize, osize);
+                goutput.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                vector_t gparam(layer->psize());
+                layer->gparam(goutput, gparam.data());
+                const tensor_t ginput = layer->ginput(goutput);
+
+                scalar_t bias_dot = 0;
+                for (size_t o = 0; o < odims; o ++)
+                {
+                        bias_dot += bdata(o) * goutput.vector(o).sum();
+                        BOOST_CHECK_LE(std::fabs(gparam(ksizes + o) - goutput.vector(o).sum()), epsilon);
+                }
+
+                const scalar_t conv_dot = output.vector().dot(goutput.vector()) - bias_dot;
+
+                BOOST_CHECK_LE(std::fabs(conv_dot - input.vector().dot(ginput.vector())), epsilon);
+                BOOST_CHECK_LE(std::fabs(conv_dot - kdata.dot(gparam.segment(0, ksizes))), epsilon);
+        }
+
+        void test_layer_blocked(const rlayer_t& layer, const tensor_t& input, size_t block)
+        {
+                const scalar_t epsilon = math::epsilon1<scalar_t>();
+
+                tensor_t goutput(layer->odims(), layer->orows(), layer->ocols());
+                goutput.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                // planar layout
+                const tensor_t output_ref = layer->output(input);
+                const tensor_t ginput_ref = layer->ginput(goutput);
+
+                // channel-blocked layout (the gradients are computed as after the planar output)
+                tensor_t binput, output;
+                tensor::block(input, block, binput);
+                tensor::unblock(layer->output_blocked(binput, block), layer->odims(), block, output);
+
+                const tensor_t ginput = layer->ginput(goutput);
+
+                BOOST_CHECK_LE((output_ref.vector() - output.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+                BOOST_CHECK_LE((ginput_ref.vector() - ginput.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+        }
+
+        void test_convolution_blocked(size_t idims, size_t isize, size_t odims, size_t ksize, size_t block)
+        {
+                tensor_t input(idims, isize, isize);
+                input.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                const rlayer_t layer_ref = make_layer(odims, ksize, "direct", input);
+                const rlayer_t layer = make_layer(odims, ksize, "blocked", input);
+
+                vector_t params(layer->psize());
+                params.setRandom();
+                layer_ref->load_params(params.data());
+                layer->load_params(params.data());
+
+                BOOST_CHECK(layer->blockable());
+
+                test_layer_blocked(layer, input, block);
+
+                // the blocked convolution should match the direct method
+                tensor_t binput, output;
+                tensor::block(input, block, binput);
+                tensor::unblock(layer->output_blocked(binput, block), odims, block, output);
+
+                BOOST_CHECK_LE((layer_ref->output(input).vector() - output.vector()).lpNorm<Eigen::Infinity>(),
+                        math::epsilon1<scalar_t>());
+
+                // the plane-wise layers following a blocked convolution
+                for (const string_t& id : strings_t{ "act-tanh", "act-splus", "pool-max", "pool-avg" })
+                {
+                        const rlayer_t player = ncv::get_layers().get(id);
+                        player->resize(output);
+
+                        BOOST_CHECK(player->blockable());
+
+                        test_layer_blocked(player, output, block);
+                }
+        }
+
+        void test_layer_parallel(const rlayer_t& layer, const tensor_t& input)
+        {
+                const scalar_t epsilon = math::epsilon1<scalar_t>();
+
+                tensor_t goutput(layer->odims(), layer->orows(), layer->ocols());
+                goutput.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                const tensor_t output_ref = layer->output(input);
+                const tensor_t ginput_ref = layer->ginput(goutput);
+
+                // split between threads (the gradients are computed as after the sequential output)
+                for (size_t nthreads = 0; nthreads <= 4; nthreads ++)
+                {
+                        const tensor_t output = layer->output_parallel(input, nthreads);
+                        const tensor_t ginput = layer->ginput(goutput);
+
+                        BOOST_CHECK_LE((output_ref.vector() - output.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+                        BOOST_CHECK_LE((ginput_ref.vector() - ginput.vector()).lpNorm<Eigen::Infinity>(), epsilon);
+                }
+        }
+
+        void test_convolution_parallel(size_t idims, size_t isize, size_t odims, size_t ksize, const string_t& mode)
+        {
+                tensor_t input(idims, isize, isize);
+                input.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                const rlayer_t layer = make_layer(odims, ksize, mode, input);
+
+                vector_t params(layer->psize());
+                params.setRandom();
+                layer->load_params(params.data());
+
+                test_layer_parallel(layer, input);
+
+                // the layers following a convolution
+                const tensor_t output = layer->output(input);
+                for (const string_t& id : strings_t{ "act-tanh", "act-splus", "pool-max", "pool-avg", "linear" })
+                {
+                        const rlayer_t player = ncv::get_layers().get(id, id == "linear" ? "dims=7" : "");
+                        player->resize(output);
+
+                        vector_t pparams(player->psize());
+                        pparams.setRandom();
+                        player->load_params(pparams.data());
+
+                        test_layer_parallel(player, output);
+                }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_convolution)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        // NB: keep the tuning results local to the test (in a temporary file)
+        const string_t tuning_path = (boost::filesystem::temp_directory_path() /
+                boost::filesystem::unique_path("test_convolution-%%%%-%%%%.tuning")).string();
+        setenv("NANOCV_TUNING_CACHE", tuning_path.c_str(), 1);
+
+        const strings_t modes = { "direct", "dot", "mad", "im2col", "winograd", "fft", "auto", "tune", "blocked" };
+
+        for (const string_t& mode : modes)
+        {
+                for (size_t idims = 1; idims <= 4; idims += 3)
+                {
+                        for (size_t ksize = 1; ksize <= 9; ksize += 2)
+                        {
+                                test::test_convolution(idims, 16, 8, ksize, mode);
+                                test::test_convolution(idims, 28, 3, ksize, mode);
+                                test::test_convolution_batch(idims, 16, 8, ksize, mode);
+                        }
+                }
+        }
+
+        // the tuning results should be stored once per shape
+        std::ifstream in(tuning_path.c_str());
+        const size_t n_lines = std::count(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>(), '\n');
+        BOOST_CHECK_EQUAL(n_lines, 2 * 2 * 5);
+
+        std::remove(tuning_path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(test_convolution_strided)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        for (size_t stride = 1; stride <= 3; stride ++)
+        {
+                for (size_t dilation = 1; dilation <= 3; dilation ++)
+                {
+                        for (size_t ksize = 1; ksize <= 5; ksize += 2)
+                        {
+                                test::test_convolution_strided(1, 16, 4, ksize, stride, dilation);
+                                test::test_convolution_strided(3, 17, 2, ksize, stride, dilation);
+                        }
+                }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_convolution_blocked)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        for (size_t block : { size_t(4), size_t(8), size_t(16), layer_block_size() })
+        {
+                for (size_t ksize = 1; ksize <= 5; ksize += 2)
+                {
+                        test::test_convolution_blocked(1, 16, 8, ksize, block);
+                        test::test_convolution_blocked(5, 17, 3, ksize, block);
+                        test::test_convolution_blocked(16, 12, 20, ksize, block);
+                }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_convolution_parallel)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        for (const string_t& mode : strings_t{ "direct", "dot", "mad", "im2col", "winograd", "fft", "blocked" })
+        {
+                for (size_t ksize = 1; ksize <= 5; ksize += 2)
+                {
+                        test::test_convolution_parallel(1, 16, 8, ksize, mode);
+                        test::test_convolution_parallel(5, 27, 3, ksize, mode);
+                        test::test_convolution_parallel(16, 12, 20, ksize, mode);
+                }
+        }
+}
@@ -4,6 +4,7 @@
 #include <boost/test/unit_test.hpp>
 #include "nanocv/tensor.h"
 #include "nanocv/math/dot.hpp"
+#include "nanocv/math/simd.h"
 #include "nanocv/math/abs.hpp"
 #include "nanocv/math/epsilon.hpp"
 #include "nanocv/tensor/dot.hpp"
@@ -41,6 +42,7 @@ namespace test
                 const scalar_t dotul7 = test_dot(ncv::math::dot_unroll<scalar_t, 7>, vec1, vec2);
                 const scalar_t dotul8 = test_dot(ncv::math::dot_unroll<scalar_t, 8>, vec1, vec2);
                 const scalar_t doteig = test_dot(ncv::tensor::dot<scalar_t>, vec1, vec2);
+                const scalar_t dotsimd = test_dot(ncv::math::dot_simd<scalar_t>, vec1, vec2);
 
                 BOOST_CHECK_LE(math::abs(dot - dot), math::epsilon1<scalar_t>());
                 BOOST_CHECK_LE(math::abs(dot - dotul2), math::epsilon1<scalar_t>());
@@ -51,6 +53,17 @@ namespace test
                 BOOST_CHECK_LE(math::abs(dot - dotul7), math::epsilon1<scalar_t>());
                 BOOST_CHECK_LE(math::abs(dot - dotul8), math::epsilon1<scalar_t>());
                 BOOST_CHECK_LE(math::abs(dot - doteig), math::epsilon1<scalar_t>());
+                BOOST_CHECK_LE(math::abs(dot - dotsimd), math::epsilon1<scalar_t>());
+
+                // check all SIMD kernels supported by the CPU
+                for (auto isa : { math::simd_isa::none, math::simd_isa::sse2, math::simd_isa::avx2, math::simd_isa::avx512 })
+                {
+                        if (math::simd_supported(isa))
+                        {
+                                const scalar_t dotisa = test_dot(ncv::math::simd_dot<scalar_t>(isa), vec1, vec2);
+                                BOOST_CHECK_LE(math::abs(dot - dotisa), math::epsilon1<scalar_t>());
+                        }
+                }
         }
 }
 
@@ -65,5 +78,11 @@ BOOST_AUTO_TEST_CASE(test_dot)
         {
                 test::test_dot(size);
         }
+
+        // small and odd sizes (to check the vectorized kernels' tails)
+        for (size_t size = 1; size <= 67; size ++)
+        {
+                test::test_dot(size);
+        }
 }
 
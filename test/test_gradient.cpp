@@ -16,6 +16,16 @@ namespace test
 {
         using namespace ncv;
 
+        // NB: check the gradients with the precision of the model (not of the optimization state)
+        typedef optim::problem_t
+        <
+                scalar_t,
+                size_t,
+                std::function<size_t(void)>,
+                std::function<scalar_t(const vector_t&)>,
+                std::function<scalar_t(const vector_t&, vector_t&)>
+        >                                               problem_t;
+
         thread_pool_t::mutex_t mutex;
 
         size_t n_checks = 0;
@@ -54,7 +64,7 @@ namespace test
                         acc_params.set_params(x);
                         acc_params.update(inputs, targets, loss);
 
-                        return acc_params.value();
+                        return scalar_t(acc_params.value());
                 };
 
                 // optimization problem (wrt parameters & inputs): function value & gradient
@@ -63,12 +73,12 @@ namespace test
                         acc_params.set_params(x);
                         acc_params.update(inputs, targets, loss);
 
-                        gx = acc_params.vgrad();
-                        return acc_params.value();
+                        gx = acc_params.vgrad().cast<scalar_t>();
+                        return scalar_t(acc_params.value());
                 };
 
                 // construct optimization problem: analytic gradient and finite difference approximation
-                const opt_problem_t problem(fn_params_size, fn_params_fval, fn_params_grad);
+                const problem_t problem(fn_params_size, fn_params_fval, fn_params_grad);
 
                 for (size_t t = 0; t < n_tests; t ++)
                 {
@@ -170,8 +180,8 @@ namespace test
                 };
 
                 // construct optimization problem: analytic gradient and finite difference approximation
-                const opt_problem_t problem_analytic_inputs(fn_inputs_size, fn_inputs_fval, fn_inputs_grad);
-                const opt_problem_t problem_aproxdif_inputs(fn_inputs_size, fn_inputs_fval);
+                const problem_t problem_analytic_inputs(fn_inputs_size, fn_inputs_fval, fn_inputs_grad);
+                const problem_t problem_aproxdif_inputs(fn_inputs_size, fn_inputs_fval);
 
                 for (size_t t = 0; t < n_tests; t ++)
                 {
@@ -36,6 +36,10 @@ namespace test
                 // check optimum parameters
                 BOOST_CHECK_LE(math::abs(ret1.second - a), epsilon);
                 BOOST_CHECK_LE(math::abs(retx.second - a), epsilon);
+
+                // check that the concurrent evaluation finds the same optimum
+                BOOST_CHECK_EQUAL(ret1.first, retx.first);
+                BOOST_CHECK_EQUAL(ret1.second, retx.second);
         }
 }
 
@@ -11,6 +11,16 @@ namespace test
 {
         using namespace ncv;
 
+        // NB: check the gradients with the precision of the loss (not of the optimization state)
+        typedef optim::problem_t
+        <
+                scalar_t,
+                size_t,
+                std::function<size_t(void)>,
+                std::function<scalar_t(const vector_t&)>,
+                std::function<scalar_t(const vector_t&, vector_t&)>
+        >                                               problem_t;
+
         void check_grad(const string_t& loss_id, size_t n_dims, size_t n_tests)
         {
                 const rloss_t loss = ncv::get_losses().get(loss_id);
@@ -42,7 +52,7 @@ namespace test
                 };
 
                 // construct optimization problem
-                const opt_problem_t problem(opt_fn_size, opt_fn_fval, opt_fn_grad);
+                const problem_t problem(opt_fn_size, opt_fn_fval, opt_fn_grad);
 
                 // check the gradient using random parameters
                 for (size_t t = 0; t < n_tests; t ++)
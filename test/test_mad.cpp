@@ -4,6 +4,7 @@
 #include <boost/test/unit_test.hpp>
 #include "nanocv/tensor.h"
 #include "nanocv/math/mad.hpp"
+#include "nanocv/math/simd.h"
 #include "nanocv/math/abs.hpp"
 #include "nanocv/math/epsilon.hpp"
 #include "nanocv/tensor/mad.hpp"
@@ -45,6 +46,7 @@ namespace test
                 const scalar_t madul7 = test_mad(ncv::math::mad_unroll<scalar_t, 7>, vec1, vec2, wei);
                 const scalar_t madul8 = test_mad(ncv::math::mad_unroll<scalar_t, 8>, vec1, vec2, wei);
                 const scalar_t madeig = test_mad(ncv::tensor::mad<scalar_t>, vec1, vec2, wei);
+                const scalar_t madsimd = test_mad(ncv::math::mad_simd<scalar_t>, vec1, vec2, wei);
 
                 const scalar_t epsilon = math::epsilon1<scalar_t>();
 
@@ -57,6 +59,17 @@ namespace test
                 BOOST_CHECK_LE(math::abs(mad - madul7), epsilon);
                 BOOST_CHECK_LE(math::abs(mad - madul8), epsilon);
                 BOOST_CHECK_LE(math::abs(mad - madeig), epsilon);
+                BOOST_CHECK_LE(math::abs(mad - madsimd), epsilon);
+
+                // check all SIMD kernels supported by the CPU
+                for (auto isa : { math::simd_isa::none, math::simd_isa::sse2, math::simd_isa::avx2, math::simd_isa::avx512 })
+                {
+                        if (math::simd_supported(isa))
+                        {
+                                const scalar_t madisa = test_mad(ncv::math::simd_mad<scalar_t>(isa), vec1, vec2, wei);
+                                BOOST_CHECK_LE(math::abs(mad - madisa), epsilon);
+                        }
+                }
         }
 }
 
@@ -71,5 +84,11 @@ BOOST_AUTO_TEST_CASE(test_mad)
         {
                 test::test_mad(size);
         }
+
+        // small and odd sizes (to check the vectorized kernels' tails)
+        for (size_t size = 4; size <= 67; size ++)
+        {
+                test::test_mad(size);
+        }
 }
 
@@ -6,6 +6,8 @@
 #include "nanocv/tester.h"
 #include "nanocv/logger.h"
 #include "nanocv/tasks/task_synthetic_shapes.h"
+#include "nanocv/math/random.hpp"
+#include "nanocv/math/epsilon.hpp"
 #include <cstdio>
 
 BOOST_AUTO_TEST_CASE(test_model_io)
@@ -105,3 +107,50 @@ BOOST_AUTO_TEST_CASE(test_model_io)
                 }
         }
 }
+
+BOOST_AUTO_TEST_CASE(test_model_parallel)
+{
+        ncv::init();
+
+        using namespace ncv;
+
+        const size_t rows = 28, cols = 28, outputs = 10;
+        const scalar_t epsilon = math::epsilon1<scalar_t>();
+
+        const string_t outlayer = "linear:dims=" + text::to_string(outputs) + ";";
+
+        const strings_t cmd_networks =
+        {
+                "linear:dims=100;act-snorm;" + outlayer,
+                "conv:dims=16,rows=9,cols=9;pool-max;act-snorm;conv:dims=32,rows=5,cols=5;act-snorm;" + outlayer,
+                "conv:dims=16,rows=9,cols=9,mode=im2col;pool-max;act-snorm;" + outlayer,
+                "conv:dims=16,rows=9,cols=9,mode=blocked;pool-max;act-snorm;" + outlayer
+        };
+
+        for (const string_t& cmd_network : cmd_networks)
+        {
+                const rmodel_t model = ncv::get_models().get("forward-network", cmd_network);
+                BOOST_REQUIRE(model.operator bool());
+                BOOST_REQUIRE(model->resize(rows, cols, outputs, color_mode::rgba, false));
+                model->random_params();
+
+                // the single-sample output split between threads should match the sequential (fused) output
+                const rmodel_t pmodel = model->clone();
+                for (size_t nthreads : { size_t(0), size_t(2), size_t(4) })
+                {
+                        pmodel->set_threads(nthreads);
+                        BOOST_CHECK_EQUAL(pmodel->threads(), nthreads);
+
+                        for (size_t t = 0; t < 8; t ++)
+                        {
+                                tensor_t input(model->idims(), rows, cols);
+                                input.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                                const vector_t output = model->output(input).vector();
+                                const vector_t poutput = pmodel->output(input).vector();
+
+                                BOOST_CHECK_LE((output - poutput).lpNorm<Eigen::Infinity>(), epsilon);
+                        }
+                }
+        }
+}
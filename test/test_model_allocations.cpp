@@ -0,0 +1,229 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "test_model_allocations"
+
+#include <boost/test/unit_test.hpp>
+#include "nanocv/tasks/task_synthetic_shapes.h"
+#include "nanocv/nanocv.h"
+#include "nanocv/accumulator.h"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+
+// NB: the allocations are counted by replacing the glibc allocation functions (not possible with the sanitizers)
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+        #define TEST_COUNT_ALLOCATIONS
+#endif
+
+namespace test
+{
+        // counting allocator: the number of heap allocations (of any kind, e.g. std::vector, Eigen, new)
+        std::atomic<size_t> allocations(0);
+
+        void count()
+        {
+                allocations ++;
+        }
+}
+
+#if defined(TEST_COUNT_ALLOCATIONS)
+
+// NB: replace the C allocation functions (used by the Eigen & the C++ allocators) to count the allocations
+extern "C"
+{
+        void* __libc_malloc(size_t size);
+        void* __libc_calloc(size_t count, size_t size);
+        void* __libc_realloc(void* ptr, size_t size);
+        void* __libc_memalign(size_t alignment, size_t size);
+        void __libc_free(void* ptr);
+
+        void* malloc(size_t size) noexcept
+        {
+                test::count();
+                return __libc_malloc(size);
+        }
+
+        void* calloc(size_t count, size_t size) noexcept
+        {
+                test::count();
+                return __libc_calloc(count, size);
+        }
+
+        void* realloc(void* ptr, size_t size) noexcept
+        {
+                test::count();
+                return __libc_realloc(ptr, size);
+        }
+
+        void* memalign(size_t alignment, size_t size) noexcept
+        {
+                test::count();
+                return __libc_memalign(alignment, size);
+        }
+
+        void* aligned_alloc(size_t alignment, size_t size) noexcept
+        {
+                test::count();
+                return __libc_memalign(alignment, size);
+        }
+
+        int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept
+        {
+                test::count();
+                *ptr = __libc_memalign(alignment, size);
+                return *ptr ? 0 : ENOMEM;
+        }
+
+        void free(void* ptr) noexcept
+        {
+                __libc_free(ptr);
+        }
+}
+
+#endif
+
+BOOST_AUTO_TEST_CASE(test_model_allocations)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        const size_t cmd_outputs = 4;
+        const size_t cmd_trials = 8;
+
+#if !defined(TEST_COUNT_ALLOCATIONS)
+        BOOST_TEST_MESSAGE("the allocations are not counted in this build!");
+#endif
+
+        string_t cmodel;
+        cmodel = cmodel + "conv:dims=4,rows=5,cols=5;pool-max;act-snorm;";
+        cmodel = cmodel + "conv:dims=8,rows=3,cols=3;act-snorm;";
+
+        const strings_t cmd_networks =
+        {
+                "linear:dims=" + text::to_string(cmd_outputs) + ";",
+                "linear:dims=16;act-snorm;linear:dims=" + text::to_string(cmd_outputs) + ";",
+                cmodel + "linear:dims=" + text::to_string(cmd_outputs) + ";"
+        };
+
+        for (color_mode mode : { color_mode::luma, color_mode::rgba })
+        {
+                synthetic_shapes_task_t task(16, 16, cmd_outputs, mode, 16);
+                BOOST_REQUIRE(task.load(""));
+                BOOST_REQUIRE(!task.tensor_cache());    // NB: the input tensors are converted for each sample
+
+                for (const string_t& cmd_network : cmd_networks)
+                {
+                        const rmodel_t model = ncv::get_models().get("forward-network", cmd_network);
+                        BOOST_REQUIRE(model);
+                        BOOST_REQUIRE(model->resize(task, false));
+                        model->random_params();
+
+                        // caller-provided workspaces
+                        tensor_t input;
+                        vector_t vinput, gradient;
+                        const vector_t ograd = vector_t::Constant(cmd_outputs, 0.5);
+
+                        // the criteria evaluate the loss values & gradients for each sample
+                        std::vector<std::pair<rloss_t, rcriterion_t>> criteria;
+                        for (const string_t& cmd_loss : ncv::get_losses().ids())
+                        {
+                                const rloss_t loss = ncv::get_losses().get(cmd_loss);
+                                const rcriterion_t criterion = ncv::get_criteria().get("avg");
+                                BOOST_REQUIRE(loss);
+                                BOOST_REQUIRE(criterion);
+
+                                criterion->reset(*model);
+                                criterion->reset(criterion_t::type::vgrad);
+                                criteria.emplace_back(loss, criterion);
+                        }
+
+                        const auto evaluate = [&] (const sample_t& sample)
+                        {
+                                const image_t& image = task.image(sample.m_index);
+
+                                model->make_input(image, sample.m_region, input);
+                                model->output(input);
+                                model->gparam(ograd, gradient);
+
+                                model->output(input);
+                                model->ginput(ograd);
+
+                                vinput = input.vector();
+                                model->output(vinput);
+                                model->output(image, sample.m_region);
+
+                                for (const auto& criterion : criteria)
+                                {
+                                        criterion.second->update(task, sample, *criterion.first);
+                                }
+                        };
+
+                        // steady-state: no allocation once the workspaces are sized (after the first evaluation)
+                        evaluate(task.samples()[0]);
+
+                        const size_t allocations = test::allocations;
+                        for (size_t t = 0; t < cmd_trials; t ++)
+                        {
+                                evaluate(task.samples()[t % task.samples().size()]);
+                        }
+
+                        BOOST_CHECK_EQUAL(test::allocations - allocations, 0);
+
+                        // the accumulators evaluate the loss values & gradients in batches (for each criterion)
+                        std::vector<std::pair<rloss_t, std::unique_ptr<accumulator_t>>> accumulators;
+                        for (const string_t& cmd_loss : ncv::get_losses().ids())
+                        {
+                                for (const string_t& cmd_criterion : ncv::get_criteria().ids())
+                                {
+                                        const rloss_t loss = ncv::get_losses().get(cmd_loss);
+                                        BOOST_REQUIRE(loss);
+
+                                        accumulators.emplace_back(loss, std::make_unique<accumulator_t>(
+                                                *model, 1, cmd_criterion, criterion_t::type::vgrad, 0.1));
+                                }
+                        }
+
+                        const samples_t& samples = task.samples();
+                        const auto evaluate_batch = [&] ()
+                        {
+                                for (const auto& accumulator : accumulators)
+                                {
+                                        accumulator.second->reset();
+                                        accumulator.second->update(task, samples, *accumulator.first);
+                                }
+                        };
+
+                        // steady-state: no allocation once the workspaces are sized (after the first evaluation)
+                        evaluate_batch();
+
+                        const size_t ballocations = test::allocations;
+                        for (size_t t = 0; t < cmd_trials; t ++)
+                        {
+                                evaluate_batch();
+                        }
+
+                        BOOST_CHECK_EQUAL(test::allocations - ballocations, 0);
+
+                        // the workspace overloads compute the same values as the allocating ones
+                        const sample_t& sample = task.samples()[1];
+
+                        const size_t xallocations = test::allocations;
+                        const tensor_t xinput = model->make_input(task.image(sample.m_index), sample.m_region);
+#if defined(TEST_COUNT_ALLOCATIONS)
+                        BOOST_CHECK_GT(test::allocations - xallocations, 0);    // NB: the allocations are counted
+#endif
+                        model->make_input(task.image(sample.m_index), sample.m_region, input);
+
+                        BOOST_CHECK_EQUAL((xinput.vector() - input.vector()).lpNorm<Eigen::Infinity>(), 0);
+
+                        // NB: the backward step overwrites the layers' buffers, so the output is computed again
+                        model->output(xinput);
+                        const vector_t xgradient = model->gparam(ograd);
+
+                        model->output(input);
+                        model->gparam(ograd, gradient);
+
+                        BOOST_CHECK_EQUAL((xgradient - gradient).lpNorm<Eigen::Infinity>(), 0);
+                }
+        }
+}
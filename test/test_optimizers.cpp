@@ -31,18 +31,18 @@ namespace test
         using namespace ncv;
 
         static void check_solution(const string_t&, const string_t&,
-                const opt_state_t& state, const std::vector<std::pair<vector_t, scalar_t>>& solutions)
+                const opt_state_t& state, const std::vector<std::pair<opt_vector_t, opt_scalar_t>>& solutions)
         {
                 // Check convergence
-                BOOST_CHECK_LE(state.g.lpNorm<Eigen::Infinity>(), math::epsilon3<scalar_t>());
+                BOOST_CHECK_LE(state.g.lpNorm<Eigen::Infinity>(), math::epsilon3<opt_scalar_t>());
 
                 // Find the closest solution
                 size_t best_index = std::string::npos;
-                scalar_t best_distance = std::numeric_limits<scalar_t>::max();
+                opt_scalar_t best_distance = std::numeric_limits<opt_scalar_t>::max();
 
                 for (size_t index = 0; index < solutions.size(); index ++)
                 {
-                        const scalar_t distance = (state.x - solutions[index].first).lpNorm<Eigen::Infinity>();
+                        const opt_scalar_t distance = (state.x - solutions[index].first).lpNorm<Eigen::Infinity>();
                         if (distance < best_distance)
                         {
                                 best_distance = distance;
@@ -54,13 +54,13 @@ namespace test
                 BOOST_CHECK_LT(best_index, solutions.size());
                 if (best_index < solutions.size())
                 {
-                        const scalar_t dfx = math::abs(state.f - solutions[best_index].second);
-                        const scalar_t dx = (state.x - solutions[best_index].first).lpNorm<Eigen::Infinity>();
+                        const opt_scalar_t dfx = math::abs(state.f - solutions[best_index].second);
+                        const opt_scalar_t dx = (state.x - solutions[best_index].first).lpNorm<Eigen::Infinity>();
 
-                        BOOST_CHECK_LE(dfx, math::epsilon3<scalar_t>());
-                        BOOST_CHECK_LE(dx, math::epsilon3<scalar_t>());
+                        BOOST_CHECK_LE(dfx, math::epsilon3<opt_scalar_t>());
+                        BOOST_CHECK_LE(dx, math::epsilon3<opt_scalar_t>());
 
-//                        if (dx > math::epsilon3<scalar_t>())
+//                        if (dx > math::epsilon3<opt_scalar_t>())
 //                        {
 //                                log_info() << problem_name
 //                                           << ", x = (" << state.x.transpose() << ")"
@@ -75,21 +75,21 @@ namespace test
         static void check_problem(
                 const string_t& problem_name,
                 const opt_opsize_t& fn_size, const opt_opfval_t& fn_fval, const opt_opgrad_t& fn_grad,
-                const std::vector<std::pair<vector_t, scalar_t>>& solutions)
+                const std::vector<std::pair<opt_vector_t, opt_scalar_t>>& solutions)
         {
                 const size_t iterations = 64 * 1024;
-                const scalar_t epsilon = math::epsilon2<scalar_t>();
+                const opt_scalar_t epsilon = math::epsilon2<opt_scalar_t>();
                 const size_t trials = 1024;
 
                 const size_t dims = fn_size();
 
                 // generate fixed random trials
-                vectors_t x0s;
+                std::vector<opt_vector_t> x0s;
                 for (size_t t = 0; t < trials; t ++)
                 {
-                        random_t<scalar_t> rgen(-1.0, +1.0);
+                        random_t<opt_scalar_t> rgen(-1.0, +1.0);
 
-                        vector_t x0(dims);
+                        opt_vector_t x0(dims);
                         rgen(x0.data(), x0.data() + x0.size());
 
                         x0s.push_back(x0);
@@ -107,11 +107,11 @@ namespace test
                 {
                         for (size_t t = 0; t < trials; t ++)
                         {
-                                const vector_t& x0 = x0s[t];
+                                const opt_vector_t& x0 = x0s[t];
 
                                 // check gradient
                                 const opt_problem_t problem(fn_size, fn_fval, fn_grad);
-                                BOOST_CHECK_LE(problem.grad_accuracy(x0), math::epsilon2<scalar_t>());
+                                BOOST_CHECK_LE(problem.grad_accuracy(x0), math::epsilon2<opt_scalar_t>());
 
                                 // optimize
                                 const opt_state_t state = ncv::minimize(
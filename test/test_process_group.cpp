@@ -0,0 +1,184 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "test_process_group"
+
+#include <boost/test/unit_test.hpp>
+#include "nanocv/tasks/task_synthetic_shapes.h"
+#include "nanocv/nanocv.h"
+#include "nanocv/math/abs.hpp"
+#include "nanocv/math/epsilon.hpp"
+#include "nanocv/math/random.hpp"
+#include "nanocv/accumulator.h"
+#include "nanocv/thread/process_group.h"
+#include "nanocv/trainers/trainer_sync.h"
+#include "nanocv/sampler.h"
+#include <unistd.h>
+
+namespace test
+{
+        using namespace ncv;
+
+        // sum buffers of various sizes (e.g. smaller than the number of processes) & take their maximum
+        bool check_allreduce(process_group_t& group)
+        {
+                bool ok = true;
+                for (size_t count : { 1, 2, 3, 7, 1000 })
+                {
+                        std::vector<double> data(count);
+                        for (size_t i = 0; i < count; i ++)
+                        {
+                                data[i] = static_cast<double>(group.rank() + 1) * static_cast<double>(i + 1);
+                        }
+
+                        ok = group.allreduce(data.data(), data.size()) && ok;
+
+                        const double ranks = static_cast<double>(group.size() * (group.size() + 1) / 2);
+                        for (size_t i = 0; i < count; i ++)
+                        {
+                                ok = (data[i] == ranks * static_cast<double>(i + 1)) && ok;
+                        }
+                }
+
+                // the maximum across processes
+                std::vector<double> data = { static_cast<double>(group.rank()), -static_cast<double>(group.rank()) };
+                ok = group.allreduce_max(data.data(), data.size()) && ok;
+                ok = (data[0] == static_cast<double>(group.size() - 1)) && ok;
+                ok = (data[1] == 0.0) && ok;
+
+                return ok && group.barrier();
+        }
+
+        // copy the root's buffer to all processes
+        bool check_broadcast(process_group_t& group)
+        {
+                bool ok = true;
+                for (size_t count : { 1, 2, 3, 7, 1000 })
+                {
+                        std::vector<double> data(count);
+                        for (size_t i = 0; i < count; i ++)
+                        {
+                                data[i] = static_cast<double>(group.rank() + 1) * static_cast<double>(i + 1);
+                        }
+
+                        ok = group.broadcast(data.data(), data.size()) && ok;
+
+                        for (size_t i = 0; i < count; i ++)
+                        {
+                                ok = (data[i] == static_cast<double>(i + 1)) && ok;
+                        }
+                }
+
+                return ok && group.barrier();
+        }
+
+        // check if the given parameters are bitwise identical in all processes
+        bool check_same(process_group_t& group, const vector_t& params)
+        {
+                vector_t root_params = params;
+                const bool ok = group.broadcast(root_params.data(), static_cast<size_t>(root_params.size()));
+
+                double mismatches = (ok && root_params == params) ? 0.0 : 1.0;
+                return  group.allreduce(&mismatches, 1) &&
+                        mismatches == 0.0;
+        }
+
+        // the data-parallel accumulator should match the single-process criterion
+        bool check_accumulator(const task_t& task, const model_t& model, const loss_t& loss, const string_t& criterion)
+        {
+                const samples_t samples = task.samples();
+                const scalar_t lambda = 0.1;
+                const scalar_t epsilon = math::epsilon1<scalar_t>();
+
+                const rcriterion_t cache = ncv::get_criteria().get(criterion);
+                cache->reset(model);
+                cache->reset(lambda);
+                cache->reset(criterion_t::type::vgrad);
+                cache->update(task, samples, 0, samples.size(), loss);
+
+                bool ok = true;
+                for (size_t nthreads : { 1, 2 })
+                {
+                        accumulator_t lacc(model, nthreads, criterion, criterion_t::type::value, lambda);
+                        accumulator_t gacc(model, nthreads, criterion, criterion_t::type::vgrad, lambda);
+
+                        lacc.update(task, samples, loss);
+                        gacc.update(task, samples, loss);
+
+                        ok = (lacc.count() == samples.size()) && ok;
+                        ok = (gacc.count() == samples.size()) && ok;
+
+                        ok = (math::abs(lacc.value() - cache->value()) < epsilon) && ok;
+                        ok = (math::abs(gacc.value() - cache->value()) < epsilon) && ok;
+                        ok = (math::abs(gacc.avg_error() - cache->avg_error()) < epsilon) && ok;
+                        ok = (math::abs(gacc.min_error() - cache->min_error()) < epsilon) && ok;
+                        ok = (math::abs(gacc.max_error() - cache->max_error()) < epsilon) && ok;
+                        ok = ((gacc.vgrad() - cache->vgrad()).lpNorm<Eigen::Infinity>() < epsilon) && ok;
+                }
+
+                return ok;
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_process_group)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        // NB: the processes are started before any thread
+        process_group_t& group = ncv::get_process_group();
+        BOOST_REQUIRE_EQUAL(group.spawn(3), true);
+        BOOST_REQUIRE_EQUAL(group.size(), 3);
+
+        bool ok = test::check_allreduce(group);
+        ok = test::check_broadcast(group) && ok;
+
+        // NB: the random seeds are the same, so all processes generate the same samples & parameters
+        const size_t cmd_outputs = 4;
+        synthetic_shapes_task_t task(16, 16, cmd_outputs, color_mode::luma, 256);
+        ok = task.load("") && ok;
+
+        const rloss_t loss = ncv::get_losses().get("logistic");
+        const rmodel_t model = ncv::get_models().get("forward-network",
+                "linear:dims=8;act-snorm;linear:dims=" + text::to_string(cmd_outputs) + ";");
+        ok = model->resize(task, false) && ok;
+
+        // NB: the processes may draw different random numbers (e.g. on different code paths) ...
+        for (size_t r = 0; r < group.rank(); r ++)
+        {
+                random_t<size_t> rng(0, 1);
+                rng();
+        }
+        model->random_params();
+
+        vector_t params;
+        ok = model->save_params(params) && ok;
+        ok = (group.size() == 1 || !test::check_same(group, params)) && ok;
+
+        // ... so the root's parameters & random sequences are broadcasted
+        ok = ncv::sync_params(*model) && ok;
+        ok = model->save_params(params) && ok;
+        ok = test::check_same(group, params) && ok;
+
+        sampler_t tsampler(task), vsampler(task);
+        tsampler.split(80, vsampler);
+        ok = ncv::check_samples(tsampler, vsampler) && ok;
+
+        // the processes detect different training samples
+        sampler_t xsampler(task), ysampler(task);
+        xsampler.split(group.root() ? 80 : 70, ysampler);
+        ok = !ncv::check_samples(xsampler, ysampler) && ok;
+
+        for (const string_t& criterion : ncv::get_criteria().ids())
+        {
+                ok = test::check_accumulator(task, *model, *loss, criterion) && ok;
+        }
+
+        // the worker processes report only through their exit status
+        if (!group.root())
+        {
+                ::_exit(ok ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+
+        BOOST_CHECK_EQUAL(ok, true);
+        BOOST_CHECK_EQUAL(group.join(), true);
+}
@@ -28,3 +28,28 @@ BOOST_AUTO_TEST_CASE(test_random)
                 }
         }
 }
+
+BOOST_AUTO_TEST_CASE(test_random_seed_scope)
+{
+        using namespace ncv;
+
+        // the generators created within a scope draw the same sequences for the same seed ...
+        const auto draw = [] (std::uint64_t seed)
+        {
+                const random_seed_scope_t scope(seed);
+
+                ncv::random_t<int32_t> rgen1(0, 1000000), rgen2(0, 1000000);
+                return std::make_pair(rgen1(), rgen2());
+        };
+
+        const auto values1 = draw(42);
+        const auto values2 = draw(42);
+        BOOST_CHECK(values1 == values2);
+
+        // ... even if the scopes are nested
+        {
+                const random_seed_scope_t scope(7);
+                BOOST_CHECK(draw(42) == values1);
+                BOOST_CHECK_EQUAL(ncv::random_seed(), 7);
+        }
+}
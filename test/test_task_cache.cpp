@@ -0,0 +1,131 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "test_task_cache"
+
+#include <boost/test/unit_test.hpp>
+#include "nanocv/tasks/task_synthetic_shapes.h"
+#include "nanocv/nanocv.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace test
+{
+        using namespace ncv;
+
+        // synthetic task cached as if decoded from the given source file
+        class cached_task_t : public synthetic_shapes_task_t
+        {
+        public:
+
+                cached_task_t(const string_t& source, color_mode mode)
+                        :       synthetic_shapes_task_t(16, 16, 4, mode, 256),
+                                m_source(source),
+                                m_decoded(0)
+                {
+                }
+
+                virtual bool load(const string_t& dir) override
+                {
+                        return load_cached({ m_source }, [&] ()
+                        {
+                                m_decoded ++;
+                                return synthetic_shapes_task_t::load(dir);
+                        });
+                }
+
+                size_t decoded() const { return m_decoded; }
+
+        private:
+
+                string_t        m_source;
+                size_t          m_decoded;
+        };
+
+        bool check_same(const task_t& task1, const task_t& task2)
+        {
+                bool ok = task1.n_images() == task2.n_images() && task1.samples().size() == task2.samples().size();
+
+                for (size_t i = 0; i < task1.n_images() && ok; i ++)
+                {
+                        const image_t& image1 = task1.image(i);
+                        const image_t& image2 = task2.image(i);
+
+                        ok =    image1.mode() == image2.mode() &&
+                                image1.rows() == image2.rows() &&
+                                image1.cols() == image2.cols() &&
+                                (image1.is_rgba() ? image1.rgba() == image2.rgba() : image1.luma() == image2.luma());
+                }
+
+                for (size_t i = 0; i < task1.samples().size() && ok; i ++)
+                {
+                        const sample_t& sample1 = task1.samples()[i];
+                        const sample_t& sample2 = task2.samples()[i];
+
+                        ok =    sample1.m_index == sample2.m_index &&
+                                sample1.m_region == sample2.m_region &&
+                                sample1.m_label == sample2.m_label &&
+                                sample1.m_target == sample2.m_target &&
+                                sample1.m_fold == sample2.m_fold;
+                }
+
+                return ok;
+        }
+
+        void write_source(const string_t& path, const string_t& content)
+        {
+                std::ofstream os(path.c_str(), std::ios::out | std::ios::trunc);
+                os << content;
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_task_cache)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        for (color_mode mode : { color_mode::luma, color_mode::rgba })
+        {
+                const boost::filesystem::path dir = boost::filesystem::temp_directory_path() /
+                        boost::filesystem::unique_path("test_task_cache-%%%%-%%%%");
+                BOOST_REQUIRE(boost::filesystem::create_directories(dir));
+
+                const string_t source = (dir / "source.bin").string();
+                test::write_source(source, "source");
+
+                // first load: decode & save the cache
+                test::cached_task_t task1(source, mode);
+                BOOST_REQUIRE(task1.load(""));
+                BOOST_CHECK_EQUAL(task1.decoded(), 1);
+                BOOST_CHECK(boost::filesystem::exists(source + ".cache"));
+
+                // second load: from the cache
+                test::cached_task_t task2(source, mode);
+                BOOST_REQUIRE(task2.load(""));
+                BOOST_CHECK_EQUAL(task2.decoded(), 0);
+                BOOST_CHECK(test::check_same(task1, task2));
+
+                // modified source: decode again
+                test::write_source(source, "modified source");
+
+                test::cached_task_t task3(source, mode);
+                BOOST_REQUIRE(task3.load(""));
+                BOOST_CHECK_EQUAL(task3.decoded(), 1);
+
+                // corrupted cache: decode again
+                test::write_source(source + ".cache", "corrupted cache");
+
+                test::cached_task_t task4(source, mode);
+                BOOST_REQUIRE(task4.load(""));
+                BOOST_CHECK_EQUAL(task4.decoded(), 1);
+
+                // missing source (e.g. the common prefix of the actual files): decode without caching
+                const string_t prefix = (dir / "source").string();
+
+                test::cached_task_t task5(prefix, mode);
+                BOOST_REQUIRE(task5.load(""));
+                BOOST_CHECK_EQUAL(task5.decoded(), 1);
+                BOOST_CHECK(!boost::filesystem::exists(prefix + ".cache"));
+
+                boost::filesystem::remove_all(dir);
+        }
+}
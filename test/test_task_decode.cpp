@@ -0,0 +1,122 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "test_task_decode"
+
+#include <boost/test/unit_test.hpp>
+#include "nanocv/tasks/task_cifar10.h"
+#include "nanocv/nanocv.h"
+#include "nanocv/file/chunk.h"
+#include "nanocv/thread/pool.h"
+
+namespace test
+{
+        using namespace ncv;
+
+        // CIFAR-10 records (label + 32x32 RGB planes), some with invalid labels (to be skipped)
+        io::data_t make_records(size_t n_records)
+        {
+                const size_t record_size = 1 + 32 * 32 * 3;
+
+                io::data_t data(n_records * record_size);
+                for (size_t i = 0; i < n_records; i ++)
+                {
+                        data[i * record_size] = static_cast<char>((i * 7) % 12);
+                        for (size_t k = 1; k < record_size; k ++)
+                        {
+                                data[i * record_size + k] = static_cast<char>((i * 31 + k * 17) % 256);
+                        }
+                }
+
+                return data;
+        }
+
+        // decode the records passed in chunks (not aligned to the records) using the given thread pool
+        bool decode(const io::data_t& data, size_t capacity, thread_pool_t& pool, cifar10_task_t& task, size_t& count)
+        {
+                task.set_thread_pool(pool);
+
+                count = 0;
+                const auto op = [&] (const std::string&, const char* bdata, size_t bsize, size_t& used)
+                {
+                        used = task.decode(bdata, bsize, protocol::train, count);
+                        return true;
+                };
+
+                const size_t piece = 1000;
+
+                io::chunk_buffer_t buffer("data_batch_1.bin", op, capacity);
+                for (size_t i = 0; i < data.size(); i += piece)
+                {
+                        if (!buffer.write(data.data() + i, std::min(piece, data.size() - i)))
+                        {
+                                return false;
+                        }
+                }
+
+                return buffer.flush();
+        }
+
+        bool check_same(const task_t& task1, const task_t& task2)
+        {
+                bool ok = task1.n_images() == task2.n_images() && task1.samples().size() == task2.samples().size();
+
+                for (size_t i = 0; i < task1.n_images() && ok; i ++)
+                {
+                        const image_t& image1 = task1.image(i);
+                        const image_t& image2 = task2.image(i);
+
+                        ok =    image1.mode() == image2.mode() &&
+                                image1.rows() == image2.rows() &&
+                                image1.cols() == image2.cols() &&
+                                image1.rgba() == image2.rgba();
+                }
+
+                for (size_t i = 0; i < task1.samples().size() && ok; i ++)
+                {
+                        const sample_t& sample1 = task1.samples()[i];
+                        const sample_t& sample2 = task2.samples()[i];
+
+                        ok =    sample1.m_index == sample2.m_index &&
+                                sample1.m_region == sample2.m_region &&
+                                sample1.m_label == sample2.m_label &&
+                                sample1.m_target == sample2.m_target &&
+                                sample1.m_fold == sample2.m_fold;
+                }
+
+                return ok;
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_task_decode)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        const size_t n_records = 301;
+        const io::data_t data = test::make_records(n_records);
+
+        size_t n_valid = 0;
+        for (size_t i = 0; i < n_records; i ++)
+        {
+                n_valid += ((i * 7) % 12 < 10) ? 1 : 0;
+        }
+
+        thread_pool_t pool1(1);
+        thread_pool_t pooln(8);
+
+        // the images & the samples should be the same (and in the same order) for any number of threads
+        for (size_t capacity : { 1000, 10000, 1024 * 1024 })
+        {
+                cifar10_task_t task1, taskn;
+                size_t count1 = 0, countn = 0;
+
+                BOOST_REQUIRE(test::decode(data, capacity, pool1, task1, count1));
+                BOOST_REQUIRE(test::decode(data, capacity, pooln, taskn, countn));
+
+                BOOST_CHECK_EQUAL(count1, n_valid);
+                BOOST_CHECK_EQUAL(countn, n_valid);
+                BOOST_CHECK_EQUAL(task1.n_images(), n_valid);
+                BOOST_CHECK_EQUAL(task1.samples().size(), n_valid);
+                BOOST_CHECK(test::check_same(task1, taskn));
+        }
+}
@@ -3,6 +3,8 @@
 
 #include <boost/test/unit_test.hpp>
 #include "nanocv/tensor.h"
+#include "nanocv/tensor/blocked.hpp"
+#include "nanocv/math/random.hpp"
 
 namespace
 {
@@ -48,3 +50,49 @@ BOOST_AUTO_TEST_CASE(test_tensor)
         check_tensor(tensor, dims, 3 * rows, 7 * cols, -2.3);
 }
 
+
+BOOST_AUTO_TEST_CASE(test_tensor_blocked)
+{
+        using namespace ncv;
+
+        const size_t rows = 7;
+        const size_t cols = 3;
+
+        for (size_t block : { 4, 8, 16 })
+        {
+                for (size_t dims = 1; dims <= 2 * block + 1; dims ++)
+                {
+                        tensor_t tensor(dims, rows, cols);
+                        tensor.setRandom(random_t<scalar_t>(-1.0, +1.0));
+
+                        tensor_t btensor;
+                        tensor::block(tensor, block, btensor);
+
+                        BOOST_CHECK_EQUAL(btensor.dims(), (dims + block - 1) / block);
+                        BOOST_CHECK_EQUAL(btensor.rows(), rows);
+                        BOOST_CHECK_EQUAL(btensor.cols(), cols * block);
+
+                        // the coefficients of the same pixel are interleaved & the padded planes are zero
+                        for (size_t d = 0; d < btensor.dims() * block; d ++)
+                        {
+                                for (size_t r = 0; r < rows; r ++)
+                                {
+                                        for (size_t c = 0; c < cols; c ++)
+                                        {
+                                                BOOST_CHECK_EQUAL(
+                                                        btensor.matrix(d / block)(r, c * block + d % block),
+                                                        d < dims ? tensor.matrix(d)(r, c) : scalar_t(0));
+                                        }
+                                }
+                        }
+
+                        tensor_t utensor;
+                        tensor::unblock(btensor, dims, block, utensor);
+
+                        BOOST_CHECK_EQUAL(utensor.dims(), dims);
+                        BOOST_CHECK_EQUAL(utensor.rows(), rows);
+                        BOOST_CHECK_EQUAL(utensor.cols(), cols);
+                        BOOST_CHECK_EQUAL((utensor.vector() - tensor.vector()).lpNorm<Eigen::Infinity>(), scalar_t(0));
+                }
+        }
+}
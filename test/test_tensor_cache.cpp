@@ -0,0 +1,138 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "test_tensor_cache"
+
+#include <boost/test/unit_test.hpp>
+#include "nanocv/tasks/task_synthetic_shapes.h"
+#include "nanocv/nanocv.h"
+#include "nanocv/accumulator.h"
+#include "nanocv/tensor_cache.h"
+
+namespace test
+{
+        using namespace ncv;
+
+        // load the input tensor of the given sample through the cache
+        tensor_t load(tensor_cache_t& cache, const task_t& task, const sample_t& sample)
+        {
+                const tensor_t expected = task.image(sample.m_index).to_tensor(sample.m_region);
+
+                tensor_t input(expected.dims(), expected.rows(), expected.cols());
+                cache.load(sample.m_index, task.image(sample.m_index), sample.m_region, input.data());
+                return input;
+        }
+
+        // max absolute difference between the cached tensor and the one converted from the image
+        scalar_t check(tensor_cache_t& cache, const task_t& task, const sample_t& sample)
+        {
+                const tensor_t expected = task.image(sample.m_index).to_tensor(sample.m_region);
+                const tensor_t input = load(cache, task, sample);
+
+                return (input.vector() - expected.vector()).lpNorm<Eigen::Infinity>();
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_tensor_cache)
+{
+        using namespace ncv;
+
+        ncv::init();
+
+        const size_t cmd_samples = 64;
+
+        for (color_mode mode : { color_mode::luma, color_mode::rgba })
+        {
+                synthetic_shapes_task_t task(16, 16, 4, mode, cmd_samples);
+                BOOST_REQUIRE(task.load(""));
+
+                const samples_t& samples = task.samples();
+                const size_t n_samples = samples.size();
+
+                // the scalar & the uint8 tensors are restored exactly, the float32 ones up to the float precision
+                for (tensor_cache_type type : { tensor_cache_type::scalar, tensor_cache_type::uint8, tensor_cache_type::float32 })
+                {
+                        const scalar_t epsilon = (type == tensor_cache_type::float32) ? scalar_t(1e-6) : scalar_t(0);
+
+                        tensor_cache_t cache(16 * 1024 * 1024, type);
+                        for (size_t pass = 0; pass < 2; pass ++)
+                        {
+                                for (const sample_t& sample : samples)
+                                {
+                                        BOOST_CHECK_LE(test::check(cache, task, sample), epsilon);
+                                }
+                        }
+
+                        BOOST_CHECK_EQUAL(cache.count(), n_samples);
+                        BOOST_CHECK_EQUAL(cache.misses(), n_samples);
+                        BOOST_CHECK_EQUAL(cache.hits(), n_samples);
+                        BOOST_CHECK_LE(cache.size(), cache.budget());
+
+                        cache.clear();
+                        BOOST_CHECK_EQUAL(cache.count(), 0);
+                        BOOST_CHECK_EQUAL(cache.size(), 0);
+                }
+
+                // the least recently used tensors are evicted to stay within the budget
+                {
+                        tensor_cache_t cache0(1024 * 1024, tensor_cache_type::uint8);
+                        test::load(cache0, task, samples[0]);
+
+                        tensor_cache_t cache(3 * cache0.size(), tensor_cache_type::uint8);
+                        test::load(cache, task, samples[0]);
+                        test::load(cache, task, samples[1]);
+                        test::load(cache, task, samples[2]);
+                        BOOST_CHECK_EQUAL(cache.count(), 3);
+                        BOOST_CHECK_EQUAL(cache.misses(), 3);
+
+                        test::load(cache, task, samples[0]);    // hit:     0, 2, 1
+                        test::load(cache, task, samples[3]);    // evict 1: 3, 0, 2
+                        test::load(cache, task, samples[1]);    // evict 2: 1, 3, 0
+                        test::load(cache, task, samples[0]);    // hit:     0, 1, 3
+                        BOOST_CHECK_EQUAL(cache.count(), 3);
+                        BOOST_CHECK_EQUAL(cache.hits(), 2);
+                        BOOST_CHECK_EQUAL(cache.misses(), 5);
+                        BOOST_CHECK_LE(cache.size(), cache.budget());
+
+                        test::load(cache, task, samples[2]);    // evict 3: 2, 0, 1
+                        BOOST_CHECK_EQUAL(cache.misses(), 6);
+                        test::load(cache, task, samples[1]);
+                        test::load(cache, task, samples[0]);
+                        BOOST_CHECK_EQUAL(cache.hits(), 4);
+                }
+
+                // the criteria evaluate the same loss with & without the (uint8) tensor cache
+                const rloss_t loss = ncv::get_losses().get("logistic");
+                const rmodel_t model = ncv::get_models().get("forward-network", "linear:dims=4;");
+                BOOST_REQUIRE(model->resize(task, false));
+                model->random_params();
+
+                accumulator_t acc0(*model, 1, "avg", criterion_t::type::vgrad, 0.0);
+                acc0.update(task, samples, *loss);
+
+                task.set_tensor_cache(16 * 1024 * 1024, tensor_cache_type::uint8);
+                BOOST_REQUIRE(task.tensor_cache());
+
+                for (size_t pass = 0; pass < 2; pass ++)
+                {
+                        accumulator_t acc(*model, 1, "avg", criterion_t::type::vgrad, 0.0);
+                        acc.update(task, samples, *loss);
+
+                        BOOST_CHECK_EQUAL(acc.value(), acc0.value());
+                        BOOST_CHECK_EQUAL((acc.vgrad() - acc0.vgrad()).lpNorm<Eigen::Infinity>(), 0);
+                }
+
+                BOOST_CHECK_EQUAL(task.tensor_cache()->misses(), n_samples);
+                BOOST_CHECK_EQUAL(task.tensor_cache()->hits(), n_samples);
+
+                // the single-sample evaluation uses the cache as well
+                accumulator_t acc1(*model, 1, "avg", criterion_t::type::vgrad, 0.0);
+                for (const sample_t& sample : samples)
+                {
+                        acc1.update(task, sample, *loss);
+                }
+
+                BOOST_CHECK_EQUAL(task.tensor_cache()->hits(), 2 * n_samples);
+
+                task.set_tensor_cache(0);
+                BOOST_CHECK(!task.tensor_cache());
+        }
+}
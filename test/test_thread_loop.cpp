@@ -9,6 +9,8 @@
 #include "nanocv/math/abs.hpp"
 #include "nanocv/math/stats.hpp"
 #include "nanocv/thread/loopi.hpp"
+#include "nanocv/thread/loopit.hpp"
+#include <algorithm>
 #include <iostream>
 #include <numeric>
 
@@ -191,3 +193,199 @@ BOOST_AUTO_TEST_CASE(test_thread_loop)
 
         table.print(std::cout);
 }
+
+BOOST_AUTO_TEST_CASE(test_thread_loop_nested)
+{
+        using namespace ncv;
+
+        thread_pool_t pool;
+
+        const size_t outer = 4 * pool.n_workers() + 3;
+        const size_t inner = 37;
+
+        std::vector<size_t> results(outer * inner, 0);
+
+        // the inner loops are scheduled on the same pool (while the outer tasks help running them)
+        thread_loopi(outer, pool, [&] (size_t i)
+        {
+                thread_loopi(inner, pool, [&] (size_t j)
+                {
+                        results[i * inner + j] = i * j + 1;
+                });
+        });
+
+        for (size_t i = 0; i < outer; i ++)
+        {
+                for (size_t j = 0; j < inner; j ++)
+                {
+                        BOOST_CHECK_EQUAL(results[i * inner + j], i * j + 1);
+                }
+        }
+
+        BOOST_CHECK_EQUAL(pool.n_tasks(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_loop_dispatch)
+{
+        using namespace ncv;
+
+        const size_t trials = 1024;
+        const size_t max_threads = std::min(ncv::max_n_threads(), std::max(size_t(32), ncv::n_threads()));
+
+        tabulator_t table("threads\\latency [us/loop]");
+        table.header() << "nanocv(pool)" << "nanocv(pool, nested)";
+
+        // measure the latency of dispatching small loops (e.g. per minibatch or per layer)
+        for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        {
+                thread_pool_t pool(n_threads);
+
+                const size_t size = pool.n_workers();
+                std::vector<size_t> results(size, 0);
+
+                const ncv::timer_t timer_flat;
+                for (size_t t = 0; t < trials; t ++)
+                {
+                        thread_loopi(size, pool, [&] (size_t i) { results[i] ++; });
+                }
+                const size_t usec_flat = timer_flat.microseconds();
+
+                const ncv::timer_t timer_nested;
+                pool.enqueue([&] ()
+                {
+                        for (size_t t = 0; t < trials; t ++)
+                        {
+                                thread_loopi(size, pool, [&] (size_t i) { results[i] ++; });
+                        }
+                });
+                pool.wait();
+                const size_t usec_nested = timer_nested.microseconds();
+
+                for (size_t i = 0; i < size; i ++)
+                {
+                        BOOST_CHECK_EQUAL(results[i], 2 * trials);
+                }
+
+                table.append(text::to_string(pool.n_workers()))
+                        << text::to_string(scalar_t(usec_flat) / trials)
+                        << text::to_string(scalar_t(usec_nested) / trials);
+        }
+
+        table.print(std::cout);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_loop_schedule)
+{
+        using namespace ncv;
+
+        thread_pool_t& pool = ncv::get_thread_pool();
+
+        const size_t size = 1013;
+        const size_t trials = 16;
+
+        const auto schedules = { thread_schedule::fixed, thread_schedule::dynamic, thread_schedule::guided };
+
+        // check that each sample is processed exactly once by a valid task
+        for (thread_schedule schedule : schedules)
+        {
+                for (size_t chunk : { 0, 1, 7, 64, 2048 })
+                {
+                        for (size_t nthreads = 1; nthreads <= pool.n_workers(); nthreads ++)
+                        {
+                                std::vector<std::atomic<size_t>> counts(size);
+                                std::vector<size_t> threads(size, size);
+
+                                for (auto& count : counts)
+                                {
+                                        count = 0;
+                                }
+
+                                thread_loopit(size, pool, nthreads, schedule, chunk, [&] (size_t i, size_t t)
+                                {
+                                        counts[i] ++;
+                                        threads[i] = t;
+                                });
+
+                                for (size_t i = 0; i < size; i ++)
+                                {
+                                        BOOST_CHECK_EQUAL(counts[i], 1);
+                                        BOOST_CHECK_LT(threads[i], nthreads);
+                                }
+                        }
+                }
+        }
+
+        // compare the schedules on an unbalanced workload (the cost increases with the index)
+        tabulator_t table("schedule\\threads");
+        for (size_t nthreads = 1; nthreads <= pool.n_workers(); nthreads ++)
+        {
+                table.header() << (text::to_string(nthreads) + "xCPU [ms]");
+        }
+
+        for (thread_schedule schedule : schedules)
+        {
+                tabulator_t::row_t& row = table.append(text::to_string(schedule));
+
+                for (size_t nthreads = 1; nthreads <= pool.n_workers(); nthreads ++)
+                {
+                        scalars_t results(size, 0.0);
+
+                        stats_t<scalar_t> timings;
+                        for (size_t t = 0; t < trials; t ++)
+                        {
+                                const ncv::timer_t timer;
+
+                                thread_loopi(size, pool, nthreads, schedule, size_t(0), [&] (size_t i)
+                                {
+                                        scalar_t temp = 0.0;
+                                        for (size_t j = 0; j < i; j ++)
+                                        {
+                                                temp += std::cos(i + j + 0.0);
+                                        }
+                                        results[i] = temp;
+                                });
+
+                                timings(timer.miliseconds());
+                        }
+
+                        row << test::to_string(timings);
+                }
+        }
+
+        table.print(std::cout);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_loop_schedule_claims)
+{
+        using namespace ncv;
+
+        // NB: more workers than CPUs & many more chunks than workers, so that the workers still claim chunks
+        //      (from the shared counter) while the calling thread waits for them to finish
+        thread_pool_t pool(8);
+
+        const size_t size = 4099;
+        const size_t trials = 64;
+
+        for (thread_schedule schedule : { thread_schedule::dynamic, thread_schedule::guided })
+        {
+                for (size_t chunk : { 0, 1, 3 })
+                {
+                        for (size_t trial = 0; trial < trials; trial ++)
+                        {
+                                std::vector<std::atomic<size_t>> counts(size);
+                                for (auto& count : counts)
+                                {
+                                        count = 0;
+                                }
+
+                                thread_loopit(size, pool, size_t(0), schedule, chunk, [&] (size_t i, size_t)
+                                {
+                                        counts[i] ++;
+                                });
+
+                                BOOST_CHECK(std::all_of(counts.begin(), counts.end(),
+                                        [] (const std::atomic<size_t>& count) { return count == 1; }));
+                        }
+                }
+        }
+}
@@ -2,9 +2,14 @@
 #define BOOST_TEST_MODULE "test_thread_pool"
 
 #include <boost/test/unit_test.hpp>
+#include "nanocv/timer.h"
 #include "nanocv/logger.h"
+#include "nanocv/tabulator.h"
 #include "nanocv/thread/pool.h"
+#include "nanocv/thread/loopit.hpp"
 #include "nanocv/math/random.hpp"
+#include <algorithm>
+#include <iostream>
 
 BOOST_AUTO_TEST_CASE(test_thread_pool)
 {
@@ -71,3 +76,153 @@ BOOST_AUTO_TEST_CASE(test_thread_pool)
                 BOOST_CHECK_EQUAL(pool.n_tasks(), 0);
         }
 }
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_global)
+{
+        using namespace ncv;
+
+        thread_pool_t& pool = ncv::get_thread_pool();
+
+        // the process-wide pool is created once with all available threads
+        BOOST_CHECK_EQUAL(&pool, &ncv::get_thread_pool());
+        BOOST_CHECK_EQUAL(pool.n_workers(), ncv::n_threads());
+
+        BOOST_CHECK_EQUAL(pool.concurrency(0), pool.n_workers());
+        BOOST_CHECK_EQUAL(pool.concurrency(1), 1);
+        BOOST_CHECK_EQUAL(pool.concurrency(pool.n_workers() + 1), pool.n_workers());
+
+        // check that the loops are split in (at most) the requested number of concurrent tasks
+        for (size_t nthreads = 1; nthreads <= pool.n_workers(); nthreads ++)
+        {
+                const size_t size = 1000;
+
+                std::vector<size_t> threads(size, size);
+                thread_loopit(size, nthreads, [&] (size_t i, size_t t)
+                {
+                        threads[i] = t;
+                });
+
+                BOOST_CHECK_LT(*std::max_element(threads.begin(), threads.end()), nthreads);
+                BOOST_CHECK_EQUAL(pool.n_tasks(), 0);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_contention)
+{
+        using namespace ncv;
+
+        const size_t n_tasks = 64 * 1024;
+        const size_t max_threads = std::min(ncv::max_n_threads(), std::max(size_t(32), ncv::n_threads()));
+
+        tabulator_t table("threads\\latency [ns/task]");
+        table.header() << "enqueue (main)" << "dispatch (main)" << "dispatch (workers)";
+
+        // measure the enqueue & dispatch latency of (almost) empty tasks for an increasing number of threads
+        for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2)
+        {
+                thread_pool_t pool(n_threads);
+
+                std::atomic<size_t> count(0);
+                const auto task = [&count] () { count ++; };
+
+                // all tasks enqueued by the main thread
+                const ncv::timer_t timer_main;
+                for (size_t j = 0; j < n_tasks; j ++)
+                {
+                        pool.enqueue(task);
+                }
+                const size_t usec_enqueue = timer_main.microseconds();
+                pool.wait();
+                const size_t usec_main = timer_main.microseconds();
+
+                BOOST_CHECK_EQUAL(count, n_tasks);
+                BOOST_CHECK_EQUAL(pool.n_tasks(), 0);
+
+                // all tasks enqueued concurrently by the workers (nested)
+                count = 0;
+
+                const ncv::timer_t timer_workers;
+                for (size_t w = 0; w < pool.n_workers(); w ++)
+                {
+                        pool.enqueue([&] ()
+                        {
+                                thread_pool_t::group_t group;
+                                for (size_t j = 0; j < n_tasks / pool.n_workers(); j ++)
+                                {
+                                        pool.enqueue(group, task);
+                                }
+                                pool.wait(group);
+                        });
+                }
+                pool.wait();
+                const size_t usec_workers = timer_workers.microseconds();
+
+                BOOST_CHECK_EQUAL(count, (n_tasks / pool.n_workers()) * pool.n_workers());
+                BOOST_CHECK_EQUAL(pool.n_tasks(), 0);
+
+                table.append(text::to_string(pool.n_workers()))
+                        << (usec_enqueue * 1000 / n_tasks)
+                        << (usec_main * 1000 / n_tasks)
+                        << (usec_workers * 1000 / n_tasks);
+        }
+
+        table.print(std::cout);
+}
+
+BOOST_AUTO_TEST_CASE(test_thread_pool_affinity)
+{
+        using namespace ncv;
+
+        const cpus_t cpus = ncv::cpu_topology();
+        BOOST_REQUIRE(!cpus.empty());
+
+        std::vector<size_t> online;
+        for (const cpu_t& cpu : cpus)
+        {
+                online.push_back(cpu.m_cpu);
+        }
+
+        // the placement policies are permutations of the online logical CPUs
+        for (const char* policy : { "compact", "scatter" })
+        {
+                std::vector<size_t> pcpus = ncv::affinity_cpus(policy);
+                std::sort(pcpus.begin(), pcpus.end());
+
+                BOOST_CHECK(pcpus == online);
+        }
+
+        // explicit lists (restricted to the online logical CPUs)
+        BOOST_CHECK(ncv::affinity_cpus("none").empty());
+        BOOST_CHECK(ncv::affinity_cpus("").empty());
+        BOOST_CHECK(ncv::affinity_cpus(text::to_string(online[0])) == std::vector<size_t>(1, online[0]));
+        BOOST_CHECK(ncv::affinity_cpus(text::to_string(online[0]) + "-" + text::to_string(online.back())) == online);
+
+        // the loops run correctly with pinned workers (e.g. the tasks enqueued for a given worker)
+        for (const char* policy : { "compact", "scatter" })
+        {
+                thread_pool_t pool(4);
+                BOOST_CHECK(!pool.pinned());
+
+                if (!pool.pin(ncv::affinity_cpus(policy)))
+                {
+                        continue;
+                }
+                BOOST_CHECK(pool.pinned());
+
+                for (auto schedule : { thread_schedule::fixed, thread_schedule::dynamic, thread_schedule::guided })
+                {
+                        const size_t size = 1000;
+
+                        std::vector<size_t> counts(size, 0), threads(size, size);
+                        thread_loopit(size, pool, pool.n_workers(), schedule, size_t(0), [&] (size_t i, size_t t)
+                        {
+                                threads[i] = t;
+                                counts[i] ++;
+                        });
+
+                        BOOST_CHECK(std::all_of(counts.begin(), counts.end(), [] (size_t c) { return c == 1; }));
+                        BOOST_CHECK_LT(*std::max_element(threads.begin(), threads.end()), pool.n_workers());
+                        BOOST_CHECK_EQUAL(pool.n_tasks(), 0);
+                }
+        }
+}